@@ -92,7 +92,8 @@ Agent::Agent(ReceivedMessage& message) :
         { PacketType::MixedAudio, PacketType::SilentAudioFrame },
         this, "handleAudioPacket");
     packetReceiver.registerListenerForTypes(
-        { PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase },
+        { PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase,
+          PacketType::OctreeCompressionDictionary },
         this, "handleOctreePacket");
     packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
 
@@ -122,6 +123,11 @@ void Agent::playAvatarSound(SharedSoundPointer sound) {
 void Agent::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     auto packetType = message->getType();
 
+    if (packetType == PacketType::OctreeCompressionDictionary) {
+        _entityViewer.processCompressionDictionary(*message, senderNode);
+        return;
+    }
+
     if (packetType == PacketType::OctreeStats) {
 
         int statsMessageLength = OctreeHeadlessViewer::parseOctreeStats(message, senderNode);
@@ -252,8 +258,19 @@ void Agent::nodeActivated(SharedNodePointer activatedNode) {
 
 void Agent::nodeKilled(SharedNodePointer killedNode) {
     if (killedNode->getType() == NodeType::EntityServer) {
-        // an entity server has gone away, ask the headless viewer to clear its tree
-        _entityViewer.clear();
+        _entityViewer.removeCompressionDictionary(killedNode->getUUID());
+
+        // when the domain's entities are split between several entity servers, only this one's go with it
+        auto nodeList = DependencyManager::get<NodeList>();
+        auto otherEntityServer = nodeList->nodeMatchingPredicate([&killedNode](const SharedNodePointer& node) {
+            return node->getType() == NodeType::EntityServer && node->getUUID() != killedNode->getUUID();
+        });
+        if (otherEntityServer) {
+            _entityViewer.removeEntitiesFromServer(killedNode->getUUID());
+        } else {
+            // our only entity server has gone away, ask the headless viewer to clear its tree
+            _entityViewer.clear();
+        }
     }
 }
 
@@ -20,6 +20,7 @@
 #include <HifiConfigVariantMap.h>
 #include <SharedUtil.h>
 #include <ShutdownEventListener.h>
+#include <udt/SendScheduler.h>
 
 #include "Assignment.h"
 #include "AssignmentClient.h"
@@ -96,6 +97,11 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     const QCommandLineOption parentPIDOption(PARENT_PID_OPTION, "PID of the parent process", "parent-pid");
     parser.addOption(parentPIDOption);
 
+    const QCommandLineOption sendThreadsOption(ASSIGNMENT_SEND_THREADS_OPTION,
+                                               "number of threads that send reliable packets to all connections",
+                                               "thread-count");
+    parser.addOption(sendThreadsOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -199,6 +205,20 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         listenPort = parser.value(portOption).toUInt();
     }
 
+    unsigned int sendThreadCount = 0;
+    if (argumentVariantMap.contains(ASSIGNMENT_SEND_THREADS_OPTION)) {
+        sendThreadCount = argumentVariantMap.value(ASSIGNMENT_SEND_THREADS_OPTION).toUInt();
+    }
+
+    if (parser.isSet(sendThreadsOption)) {
+        sendThreadCount = parser.value(sendThreadsOption).toUInt();
+    }
+
+    if (sendThreadCount > 0) {
+        // must happen before any connection creates a send queue
+        udt::SendScheduler::setThreadCount(sendThreadCount);
+    }
+
     if (parser.isSet(numChildsOption)) {
         if (minForks && minForks > numForks) {
             qCritical() << "--min can't be more than -n";
@@ -230,7 +250,8 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         AssignmentClientMonitor* monitor =  new AssignmentClientMonitor(numForks, minForks, maxForks,
                                                                         requestAssignmentType, assignmentPool,
                                                                         listenPort, walletUUID, assignmentServerHostname,
-                                                                        assignmentServerPort, httpStatusPort, logDirectory);
+                                                                        assignmentServerPort, httpStatusPort, logDirectory,
+                                                                        sendThreadCount);
         monitor->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, monitor, &AssignmentClientMonitor::aboutToQuit);
     } else {
@@ -38,7 +38,8 @@ public:
     AssignmentClientMonitor(const unsigned int numAssignmentClientForks, const unsigned int minAssignmentClientForks,
                             const unsigned int maxAssignmentClientForks, Assignment::Type requestAssignmentType,
                             QString assignmentPool, quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                            quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory);
+                            quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory,
+                            unsigned int sendThreadCount);
     ~AssignmentClientMonitor();
 
     void stopChildProcesses();
@@ -71,6 +72,7 @@ private:
     QUuid _walletUUID;
     QString _assignmentServerHostname;
     quint16 _assignmentServerPort;
+    unsigned int _sendThreadCount; // 0 leaves children with the default send scheduler pool size
 
     QMap<qint64, ACProcess> _childProcesses;
 
@@ -0,0 +1,179 @@
+//
+//  AssetCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCache.h"
+
+#include "AssetServerLogging.h"
+
+MappedAsset::MappedAsset(const QString& filePath) :
+    _file(filePath)
+{
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    _size = _file.size();
+
+    // an empty file can't be mapped, but is a perfectly good asset
+    if (_size > 0) {
+        _data = _file.map(0, _size);
+        if (!_data) {
+            qCWarning(asset_server) << "Could not map asset file" << filePath << "-" << _file.errorString();
+            return;
+        }
+    }
+
+    _valid = true;
+}
+
+MappedAsset::MappedAsset(const QByteArray& assembledData) :
+    _assembledData(assembledData),
+    _data(reinterpret_cast<uchar*>(const_cast<char*>(_assembledData.constData()))),
+    _size(_assembledData.size()),
+    _valid(true)
+{
+}
+
+MappedAsset::~MappedAsset() {
+    if (_data && _file.isOpen()) {
+        _file.unmap(_data);
+    }
+}
+
+AssetCache::AssetCache(qint64 maxSize) :
+    _maxSize(maxSize)
+{
+}
+
+void AssetCache::setFilesDirectory(const QDir& filesDirectory) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _filesDirectory = filesDirectory;
+}
+
+void AssetCache::setChunkStore(std::shared_ptr<ChunkStore> chunkStore) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _chunkStore = chunkStore;
+}
+
+void AssetCache::setMaxSize(qint64 maxSize) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxSize = maxSize;
+    evictUntil(_maxSize);
+}
+
+MappedAssetPointer AssetCache::get(const AssetUtils::AssetHash& hash, bool* wasCached) {
+    if (wasCached) {
+        *wasCached = false;
+    }
+
+    QString filePath;
+    std::shared_ptr<ChunkStore> chunkStore;
+    qint64 maxAssetSize;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.requests;
+
+        auto it = _entries.find(hash);
+        if (it != _entries.end()) {
+            ++_stats.hits;
+            _lru.splice(_lru.begin(), _lru, it->lruPosition);
+            if (wasCached) {
+                *wasCached = true;
+            }
+            return it->asset;
+        }
+
+        filePath = _filesDirectory.filePath(hash);
+        chunkStore = _chunkStore;
+        maxAssetSize = _maxSize / MAX_ASSET_SHARE_OF_CACHE;
+    }
+
+    // map the file outside of the lock, so other requests aren't held up by the disk
+    std::shared_ptr<const MappedAsset> asset;
+    if (QFile::exists(filePath) || !chunkStore || !chunkStore->hasAsset(hash)) {
+        asset = std::make_shared<const MappedAsset>(filePath);
+    } else {
+        auto size = chunkStore->getAssetSize(hash);
+        QByteArray data;
+        if (size < 0 || size > maxAssetSize || !chunkStore->readAsset(hash, data)) {
+            return nullptr;
+        }
+        asset = std::make_shared<const MappedAsset>(data);
+    }
+
+    if (!asset->isValid()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (asset->getSize() > _maxSize / MAX_ASSET_SHARE_OF_CACHE) {
+        return asset;
+    }
+
+    // another request may have mapped the same asset in the meantime
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        return it->asset;
+    }
+
+    evictUntil(_maxSize - asset->getSize());
+
+    _lru.push_front(hash);
+    _entries.insert(hash, { asset, _lru.begin() });
+    ++_stats.cachedAssets;
+    _stats.cachedBytes += asset->getSize();
+
+    return asset;
+}
+
+void AssetCache::remove(const AssetUtils::AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        --_stats.cachedAssets;
+        _stats.cachedBytes -= it->asset->getSize();
+        _lru.erase(it->lruPosition);
+        _entries.erase(it);
+    }
+}
+
+void AssetCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _lru.clear();
+    _stats.cachedAssets = 0;
+    _stats.cachedBytes = 0;
+}
+
+void AssetCache::recordServed(qint64 bytes, bool fromMemory) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.bytesServed += bytes;
+    if (fromMemory) {
+        _stats.bytesServedFromMemory += bytes;
+    }
+}
+
+AssetCache::Stats AssetCache::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void AssetCache::evictUntil(qint64 maxSize) {
+    while (!_lru.empty() && (qint64)_stats.cachedBytes > maxSize) {
+        auto it = _entries.find(_lru.back());
+        --_stats.cachedAssets;
+        _stats.cachedBytes -= it->asset->getSize();
+        ++_stats.evictions;
+        _entries.erase(it);
+        _lru.pop_back();
+    }
+}
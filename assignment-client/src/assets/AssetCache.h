@@ -0,0 +1,107 @@
+//
+//  AssetCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCache_h
+#define hifi_AssetCache_h
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+#include <AssetUtils.h>
+
+#include "ChunkStore.h"
+
+// An asset file mapped into memory. Replies are written straight from the mapping, so serving an asset never reads it
+// into an intermediate buffer. The mapping lives as long as anyone holds on to it, even once the cache has let it go.
+// Assets kept in the chunk store have no file to map, they are held put back together instead.
+class MappedAsset {
+public:
+    MappedAsset(const QString& filePath);
+    MappedAsset(const QByteArray& assembledData);
+    ~MappedAsset();
+
+    bool isValid() const { return _valid; }
+
+    const char* getData() const { return reinterpret_cast<const char*>(_data); }
+    qint64 getSize() const { return _size; }
+
+private:
+    QFile _file;
+    QByteArray _assembledData;
+    uchar* _data { nullptr };
+    qint64 _size { 0 };
+    bool _valid { false };
+};
+
+using MappedAssetPointer = std::shared_ptr<const MappedAsset>;
+
+// Keeps the most recently requested assets mapped, up to a total size, so an asset that many clients ask for at once
+// is served from memory instead of being read from disk again for each of them. Assets are keyed by their content
+// hash, so a cached asset can only go stale if its file is deleted or rewritten - callers doing that remove it first.
+class AssetCache {
+public:
+    struct Stats {
+        uint64_t requests { 0 };
+        uint64_t hits { 0 };
+        uint64_t evictions { 0 };
+        uint64_t bytesServed { 0 };
+        uint64_t bytesServedFromMemory { 0 };
+        uint64_t cachedAssets { 0 };
+        uint64_t cachedBytes { 0 };
+    };
+
+    // assets bigger than this share of the cache are served from a mapping that is not kept
+    static const int MAX_ASSET_SHARE_OF_CACHE = 4;
+
+    AssetCache(qint64 maxSize);
+
+    void setFilesDirectory(const QDir& filesDirectory);
+    void setChunkStore(std::shared_ptr<ChunkStore> chunkStore);
+    void setMaxSize(qint64 maxSize);
+
+    // Returns the mapped asset, or nullptr if there is no file for that hash. wasCached is set if the asset was
+    // already mapped by the cache. Assets from the chunk store too big to be cached are not put together, they
+    // return nullptr as well and should be read from the chunk store a range at a time.
+    MappedAssetPointer get(const AssetUtils::AssetHash& hash, bool* wasCached = nullptr);
+
+    // Drops the asset, must be called before its file is deleted or rewritten
+    void remove(const AssetUtils::AssetHash& hash);
+
+    void clear();
+
+    void recordServed(qint64 bytes, bool fromMemory);
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        MappedAssetPointer asset;
+        std::list<AssetUtils::AssetHash>::iterator lruPosition;
+    };
+
+    void evictUntil(qint64 maxSize);
+
+    mutable std::mutex _mutex;
+    QDir _filesDirectory;
+    std::shared_ptr<ChunkStore> _chunkStore;
+    qint64 _maxSize;
+
+    QHash<AssetUtils::AssetHash, Entry> _entries;
+    std::list<AssetUtils::AssetHash> _lru; // most recently used first
+
+    Stats _stats;
+};
+
+#endif // hifi_AssetCache_h
@@ -24,12 +24,14 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QString>
+#include <QtCore/QThread>
 #include <QtGui/QImageReader>
 #include <QtCore/QVector>
 #include <QtCore/QUrlQuery>
 
 #include <ClientServerUtils.h>
 #include <NodeType.h>
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <PathUtils.h>
 #include <image/Image.h>
@@ -55,6 +57,14 @@ static const QString BAKED_MODEL_SIMPLE_NAME = "asset.fbx";
 static const QString BAKED_TEXTURE_SIMPLE_NAME = "texture.ktx";
 static const QString BAKED_SCRIPT_SIMPLE_NAME = "asset.js";
 
+static const qint64 BYTES_PER_MEGABYTE = 1000 * 1000;
+static const qint64 DEFAULT_ASSET_CACHE_SIZE_MB = 256;
+static const QString ASSET_CHUNKS_SUBDIR = "chunks";
+static const QString BAKE_QUEUE_FILE_NAME = "bake_queue.json";
+
+// bakes are CPU heavy, leave half the cores to the rest of the server
+static const int DEFAULT_BAKE_WORKERS = std::max(QThread::idealThreadCount() / 2, 1);
+
 void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath) {
     qDebug() << "Starting bake for: " << assetPath << assetHash;
     auto it = _pendingBakes.find(assetHash);
@@ -83,6 +93,10 @@ std::pair<AssetUtils::BakingStatus, QString> AssetServer::getAssetStatus(const A
         return { (*it)->isBaking() ? AssetUtils::Baking : AssetUtils::Pending, "" };
     }
 
+    if (_bakeQueue.contains(hash)) {
+        return { AssetUtils::Pending, "" };
+    }
+
     if (path.startsWith(AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER)) {
         return { AssetUtils::Baked, "" };
     }
@@ -132,15 +146,125 @@ void AssetServer::bakeAssets() {
     for (; it != _fileMappings.cend(); ++it) {
         auto path = it->first;
         auto hash = it->second;
-        maybeBake(path, hash);
+        if (needsToBeBaked(path, hash)) {
+            _bakeQueue.push(hash, path);
+        }
     }
+
+    qCInfo(asset_server) << _bakeQueue.getNumWaiting() << "assets are queued to be baked.";
+    startNextBakes();
 }
 
 void AssetServer::maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) {
     if (needsToBeBaked(path, hash)) {
         qDebug() << "Queuing bake of: " << path;
-        bakeAsset(hash, path, getPathToAssetHash(hash));
+        _bakeQueue.push(hash, path);
+        startNextBakes();
+    }
+}
+
+void AssetServer::startNextBakes() {
+    // don't start anything new while the assignment is shutting down, what is still queued is resumed next time
+    if (_isFinished) {
+        return;
+    }
+
+    BakeQueue::Job job;
+    while (_pendingBakes.size() < _bakingTaskPool.maxThreadCount() && _bakeQueue.takeNext(job)) {
+        auto it = _fileMappings.find(job.path);
+        if (it == _fileMappings.end() || it->second != job.hash || !needsToBeBaked(job.path, job.hash)) {
+            // the asset was re-mapped, deleted or baked since the job was queued
+            _bakeQueue.remove(job.hash);
+            continue;
+        }
+
+        if (job.attempts > BakeQueue::MAX_ATTEMPTS) {
+            qCWarning(asset_server) << "Giving up on baking" << job.path << "since it was interrupted"
+                << BakeQueue::MAX_ATTEMPTS << "times";
+            AssetMeta meta;
+            meta.failedLastBake = true;
+            meta.lastBakeErrors = "Baking was interrupted too many times";
+            writeMetaFile(job.hash, meta);
+
+            _bakeQueue.remove(job.hash);
+            ++_numFailedBakes;
+            continue;
+        }
+
+        auto filePath = getPathToAssetHash(job.hash);
+        if (_chunkStore && !QFile::exists(filePath) && _chunkStore->hasAsset(job.hash)) {
+            // the bakers read their input from a file, so put a chunked asset back together in one for the bake
+            filePath = materializeBakeInput(job.hash);
+            if (filePath.isEmpty()) {
+                qCWarning(asset_server) << "Could not read chunked asset" << job.hash << "to bake it";
+                _bakeQueue.remove(job.hash);
+                continue;
+            }
+        }
+
+        bakeAsset(job.hash, job.path, filePath);
+    }
+
+    _bakeQueue.save();
+}
+
+void AssetServer::finishBake(const AssetUtils::AssetHash& hash) {
+    auto it = _pendingBakes.find(hash);
+    if (it != _pendingBakes.end()) {
+        // the stage timings of successful bakes go in the stats
+        auto stageTimings = (*it)->getStageTimings();
+        for (auto jt = stageTimings.begin(); jt != stageTimings.end(); ++jt) {
+            auto& timing = _bakeStageTimings[jt.key()];
+            timing.totalUsecs += jt.value();
+            ++timing.count;
+        }
+        _pendingBakes.erase(it);
+    }
+
+    removeMaterializedBakeInput(hash);
+    _bakeQueue.remove(hash);
+    startNextBakes();
+}
+
+QString AssetServer::materializeBakeInput(const AssetUtils::AssetHash& hash) {
+    auto it = _materializedBakeInputs.find(hash);
+    if (it != _materializedBakeInputs.end()) {
+        return it.value();
+    }
+
+    QByteArray data;
+    if (!_chunkStore->readAsset(hash, data)) {
+        return QString();
+    }
+
+    auto filePath = QDir::temp().absoluteFilePath("hifi-asset-bake-" + hash);
+    QFile file { filePath };
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+        file.remove();
+        return QString();
+    }
+
+    _materializedBakeInputs[hash] = filePath;
+    return filePath;
+}
+
+void AssetServer::removeMaterializedBakeInput(const AssetUtils::AssetHash& hash) {
+    auto filePath = _materializedBakeInputs.take(hash);
+    if (!filePath.isEmpty() && !QFile::remove(filePath)) {
+        qCWarning(asset_server) << "Failed to remove temporary bake input:" << filePath;
+    }
+}
+
+bool AssetServer::deleteAsset(const AssetUtils::AssetHash& hash) {
+    // drop the cached copy first, it may keep the file mapped
+    _assetCache->remove(hash);
+
+    QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
+    if (removeableFile.exists()) {
+        return removeableFile.remove();
     }
+
+    return _chunkStore && _chunkStore->removeAsset(hash);
 }
 
 void AssetServer::createEmptyMetaFile(const AssetUtils::AssetHash& hash) {
@@ -232,6 +356,7 @@ void updateConsumedCores() {
 
 AssetServer::AssetServer(ReceivedMessage& message) :
     ThreadedAssignment(message),
+    _assetCache(std::make_shared<AssetCache>(DEFAULT_ASSET_CACHE_SIZE_MB * BYTES_PER_MEGABYTE)),
     _transferTaskPool(this),
     _bakingTaskPool(this),
     _filesizeLimit(AssetUtils::MAX_UPLOAD_SIZE)
@@ -255,7 +380,7 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     // so the ideal is greater than the number of cores on the system.
     static const int TASK_POOL_THREAD_COUNT = 50;
     _transferTaskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
-    _bakingTaskPool.setMaxThreadCount(1);
+    _bakingTaskPool.setMaxThreadCount(DEFAULT_BAKE_WORKERS);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
@@ -289,6 +414,7 @@ void AssetServer::aboutToFinish() {
         auto pendingRunnable =  _bakingTaskPool.tryTake(it->get());
 
         if (pendingRunnable) {
+            _bakeQueue.requeue(it.key());
             it = _pendingBakes.erase(it);
         } else {
             it.value()->abort();
@@ -301,6 +427,9 @@ void AssetServer::aboutToFinish() {
         QCoreApplication::processEvents();
     }
 
+    // the bakes that didn't get to finish are picked up again when the asset server next starts
+    _bakeQueue.save();
+
     // re-set defaults in image library
     image::setColorTexturesCompressionEnabled(_wasCubeTextureCompressionEnabled);
     image::setGrayscaleTexturesCompressionEnabled(_wasGrayscaleTextureCompressionEnabled);
@@ -382,6 +511,46 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    _assetCache->setFilesDirectory(_filesDirectory);
+
+    // keep new assets in the deduplicating chunk store, unless that is turned off
+    static const QString DEDUPLICATE_ASSETS_OPTION = "deduplicate_assets";
+    if (assetServerObject[DEDUPLICATE_ASSETS_OPTION].toBool(true)) {
+        QDir chunksDirectory = _resourcesDirectory;
+        if (!_resourcesDirectory.mkpath(ASSET_CHUNKS_SUBDIR) || !chunksDirectory.cd(ASSET_CHUNKS_SUBDIR)) {
+            qCCritical(asset_server) << "Unable to create chunk directory for asset-server files. Stopping assignment.";
+            setFinished(true);
+            return;
+        }
+
+        // assets already stored in the chunk store are always readable, even with deduplication turned off
+        _chunkStore = std::make_shared<ChunkStore>(_filesDirectory, chunksDirectory);
+    } else if (QDir(_resourcesDirectory.absoluteFilePath(ASSET_CHUNKS_SUBDIR)).exists()) {
+        QDir chunksDirectory = _resourcesDirectory;
+        chunksDirectory.cd(ASSET_CHUNKS_SUBDIR);
+        _chunkStore = std::make_shared<ChunkStore>(_filesDirectory, chunksDirectory);
+        _storeNewAssetsAsChunks = false;
+    }
+
+    if (_chunkStore) {
+        if (!_chunkStore->load()) {
+            qCCritical(asset_server) << "Unable to load the asset chunk store. Stopping assignment.";
+            setFinished(true);
+            return;
+        }
+        _assetCache->setChunkStore(_chunkStore);
+    }
+
+    // how many assets can be baked at once, each bake is run in its own oven process
+    static const QString BAKE_WORKERS_OPTION = "bake_workers";
+    auto bakeWorkers = assetServerObject[BAKE_WORKERS_OPTION].toInt(DEFAULT_BAKE_WORKERS);
+    if (bakeWorkers > 0) {
+        _bakingTaskPool.setMaxThreadCount(bakeWorkers);
+    }
+
+    // pick up the bakes that were queued when the asset server last stopped
+    _bakeQueue.load(_resourcesDirectory.absoluteFilePath(BAKE_QUEUE_FILE_NAME));
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qCInfo(asset_server) << "Serving files from: " << _filesDirectory.path();
@@ -415,12 +584,22 @@ void AssetServer::completeSetup() {
         _filesizeLimit = assetsFilesizeLimit * BITS_PER_MEGABITS;
     }
 
+    // get the amount of memory hot assets can be kept mapped in
+    static const QString ASSET_CACHE_SIZE_OPTION = "asset_cache_size";
+    auto assetCacheSizeMB = (qint64)assetServerObject[ASSET_CACHE_SIZE_OPTION].toInt(DEFAULT_ASSET_CACHE_SIZE_MB);
+    if (assetCacheSizeMB >= 0) {
+        _assetCache->setMaxSize(assetCacheSizeMB * BYTES_PER_MEGABYTE);
+        qCInfo(asset_server) << "Keeping up to" << assetCacheSizeMB << "MB of recently requested assets in memory.";
+    }
+
     PathUtils::removeTemporaryApplicationDirs();
     PathUtils::removeTemporaryApplicationDirs("Oven");
 }
 
 void AssetServer::cleanupUnmappedFiles() {
-    QRegExp hashFileRegex { "^[a-f0-9]{" + QString::number(AssetUtils::SHA256_HASH_HEX_LENGTH) + "}" };
+    // asset files are named by their hash, chunked assets by their hash and the recipe extension
+    QRegExp hashFileRegex { "^[a-f0-9]{" + QString::number(AssetUtils::SHA256_HASH_HEX_LENGTH) + "}" +
+                            "(" + QRegExp::escape(ChunkStore::RECIPE_EXTENSION) + ")?" };
 
     auto files = _filesDirectory.entryInfoList(QDir::Files);
 
@@ -429,23 +608,22 @@ void AssetServer::cleanupUnmappedFiles() {
     for (const auto& fileInfo : files) {
         auto filename = fileInfo.fileName();
         if (hashFileRegex.exactMatch(filename)) {
+            auto hash = filename.left(AssetUtils::SHA256_HASH_HEX_LENGTH);
             bool matched { false };
             for (auto& pair : _fileMappings) {
-                if (pair.second == filename) {
+                if (pair.second == hash) {
                     matched = true;
                     break;
                 }
             }
             if (!matched) {
                 // remove the unmapped file
-                QFile removeableFile { fileInfo.absoluteFilePath() };
-
-                if (removeableFile.remove()) {
-                    qCDebug(asset_server) << "\tDeleted" << filename << "from asset files directory since it is unmapped.";
+                if (deleteAsset(hash)) {
+                    qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is unmapped.";
 
-                    removeBakedPathsForDeletedAsset(filename);
+                    removeBakedPathsForDeletedAsset(hash);
                 } else {
-                    qCDebug(asset_server) << "\tAttempt to delete unmapped file" << filename << "failed";
+                    qCDebug(asset_server) << "\tAttempt to delete unmapped file" << hash << "failed";
                 }
             }
         }
@@ -711,10 +889,14 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
     QString fileName = QString(hexHash);
     QFileInfo fileInfo { _filesDirectory.filePath(fileName) };
 
+    qint64 chunkedSize = -1;
     if (fileInfo.exists() && fileInfo.isReadable()) {
         qCDebug(asset_server) << "Opening file: " << fileInfo.filePath();
         replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
         replyPacket->writePrimitive(fileInfo.size());
+    } else if (_chunkStore && (chunkedSize = _chunkStore->getAssetSize(fileName)) >= 0) {
+        replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
+        replyPacket->writePrimitive(chunkedSize);
     } else {
         qCDebug(asset_server) << "Asset not found: " << QString(hexHash);
         replyPacket->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
@@ -733,8 +915,20 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
         return;
     }
 
+    // count requests for the start of each asset, so the most requested assets are baked first
+    MessageID messageID;
+    AssetUtils::DataOffset start;
+    message->readPrimitive(&messageID);
+    AssetUtils::AssetHash hash = QString(message->read(AssetUtils::SHA256_HASH_LENGTH).toHex());
+    message->readPrimitive(&start);
+    message->seek(0);
+
+    if (start == 0) {
+        _bakeQueue.recordRequest(hash);
+    }
+
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _assetCache, _chunkStore);
     _transferTaskPool.start(task);
 }
 
@@ -743,7 +937,8 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     if (senderNode->getCanWriteToAssetServer()) {
         qCDebug(asset_server) << "Starting an UploadAssetTask for upload from" << uuidStringWithoutCurlyBraces(senderNode->getUUID());
 
-        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit);
+        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit, _assetCache,
+                                        _storeNewAssetsAsChunks ? _chunkStore : nullptr);
         _transferTaskPool.start(task);
     } else {
         // this is a node the domain told us is not allowed to rez entities
@@ -816,6 +1011,20 @@ void AssetServer::sendStatsPacket() {
         downstreamStats["8. Duplicates"] = events[Events::Duplicate];
         nodeStats["Downstream Stats"] = downstreamStats;
 
+        static const std::array<QString, udt::NUM_STREAMS> STREAM_NAMES {{ "Urgent", "Default", "Bulk" }};
+        QJsonObject streamStats;
+        for (int i = 0; i < udt::NUM_STREAMS; ++i) {
+            const auto& stream = stat.second.streams[i];
+            QJsonObject singleStreamStats;
+            singleStreamStats["1. Sent Packets"] = stream.sentPackets;
+            singleStreamStats["2. Up (Mb/s)"] = stream.sentUtilBytes * megabitsPerSecPerByte;
+            singleStreamStats["3. Retransmitted"] = stream.retransmissions;
+            singleStreamStats["4. Recvd Packets"] = stream.receivedPackets;
+            singleStreamStats["5. Recvd Messages"] = stream.receivedMessages;
+            streamStats[QString("%1. %2").arg(i + 1).arg(STREAM_NAMES[i])] = singleStreamStats;
+        }
+        nodeStats["Stream Stats"] = streamStats;
+
         QString uuid;
         auto nodelist = DependencyManager::get<NodeList>();
         if (stat.first == nodelist->getDomainHandler().getSockAddr()) {
@@ -830,6 +1039,54 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
 
+    // the kernel counts the datagrams it drops for the whole socket, it can't tell which node they came from
+    QJsonObject socketStats;
+    socketStats["1. Kernel Receive Drops"] = DependencyManager::get<NodeList>()->sampleKernelReceiveDrops();
+    serverStats["Socket"] = socketStats;
+
+    auto cacheStats = _assetCache->getStats();
+    QJsonObject assetCacheStats;
+    assetCacheStats["1. Requests"] = (double)cacheStats.requests;
+    assetCacheStats["2. Hit Rate (%)"] = cacheStats.requests > 0 ? 100.0 * cacheStats.hits / cacheStats.requests : 0.0;
+    assetCacheStats["3. Served (MB)"] = (double)cacheStats.bytesServed / BYTES_PER_MEGABYTE;
+    assetCacheStats["4. Served From Memory (MB)"] = (double)cacheStats.bytesServedFromMemory / BYTES_PER_MEGABYTE;
+    assetCacheStats["5. Cached Assets"] = (double)cacheStats.cachedAssets;
+    assetCacheStats["6. Cached (MB)"] = (double)cacheStats.cachedBytes / BYTES_PER_MEGABYTE;
+    assetCacheStats["7. Evictions"] = (double)cacheStats.evictions;
+    serverStats["Asset Cache"] = assetCacheStats;
+
+    if (_chunkStore) {
+        auto chunkStats = _chunkStore->getStats();
+        QJsonObject chunkStoreStats;
+        chunkStoreStats["1. Assets"] = (double)chunkStats.assets;
+        chunkStoreStats["2. Unique Chunks"] = (double)chunkStats.uniqueChunks;
+        chunkStoreStats["3. Logical Size (MB)"] = (double)chunkStats.logicalBytes / BYTES_PER_MEGABYTE;
+        chunkStoreStats["4. Stored Size (MB)"] = (double)chunkStats.storedBytes / BYTES_PER_MEGABYTE;
+        chunkStoreStats["5. Deduplication Ratio"] = chunkStats.storedBytes > 0 ?
+            (double)chunkStats.logicalBytes / chunkStats.storedBytes : 1.0;
+        // the chunk files opened per asset read, where a plain file store opens one
+        chunkStoreStats["6. Read Amplification"] = chunkStats.reads > 0 ?
+            (double)chunkStats.chunksRead / chunkStats.reads : 1.0;
+        chunkStoreStats["7. Chunks Read"] = (double)chunkStats.chunksRead;
+        chunkStoreStats["8. Read From Chunks (MB)"] = (double)chunkStats.chunkBytesRead / BYTES_PER_MEGABYTE;
+        serverStats["Chunk Store"] = chunkStoreStats;
+    }
+
+    QJsonObject bakingStats;
+    bakingStats["1. Queued"] = _bakeQueue.getNumWaiting();
+    bakingStats["2. Baking"] = _bakeQueue.getNumStarted();
+    bakingStats["3. Completed"] = _numCompletedBakes;
+    bakingStats["4. Failed"] = _numFailedBakes;
+    bakingStats["5. Resumed After Restart"] = _bakeQueue.getNumResumed();
+
+    // the average time a bake spent in each stage, the textures of a model are summed
+    QJsonObject stageStats;
+    for (auto it = _bakeStageTimings.begin(); it != _bakeStageTimings.end(); ++it) {
+        stageStats[it.key()] = (double)it->totalUsecs / it->count / USECS_PER_MSEC;
+    }
+    bakingStats["6. Average Stage Times (ms)"] = stageStats;
+    serverStats["Baking"] = bakingStats;
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -970,6 +1227,9 @@ void AssetServer::removeBakedPathsForDeletedAsset(AssetUtils::AssetHash hash) {
     // by calling deleteMappings for the hidden baked content folder for this hash
     AssetUtils::AssetPathList hiddenBakedFolder { AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER + hash + "/" };
 
+    // and there's no point baking it anymore
+    _bakeQueue.remove(hash);
+
     qCDebug(asset_server) << "Deleting baked content below" << hiddenBakedFolder << "since" << hash << "was deleted";
 
     deleteMappings(hiddenBakedFolder);
@@ -1039,9 +1299,7 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
         // we now have a set of hashes that are unmapped - we will delete those asset files
         for (auto& hash : hashesToCheckForDeletion) {
             // remove the unmapped file
-            QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
-
-            if (removeableFile.remove()) {
+            if (deleteAsset(hash)) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
 
                 removeBakedPathsForDeletedAsset(hash);
@@ -1182,7 +1440,8 @@ void AssetServer::handleFailedBake(QString originalAssetHash, QString assetPath,
 
     writeMetaFile(originalAssetHash, meta);
 
-    _pendingBakes.remove(originalAssetHash);
+    ++_numFailedBakes;
+    finishBake(originalAssetHash);
 }
 
 void AssetServer::handleCompletedBake(QString originalAssetHash, QString originalAssetPath,
@@ -1214,7 +1473,15 @@ void AssetServer::handleCompletedBake(QString originalAssetHash, QString origina
 
             // first check that we don't already have this bake file in our list
             auto bakeFileDestination = _filesDirectory.absoluteFilePath(bakedFileHash);
-            if (!QFile::exists(bakeFileDestination)) {
+            if (_storeNewAssetsAsChunks && _chunkStore && !QFile::exists(bakeFileDestination)) {
+                if (!_chunkStore->hasAsset(bakedFileHash) &&
+                    !(file.seek(0) && _chunkStore->storeAsset(bakedFileHash, file.readAll()))) {
+                    // stop handling this bake, couldn't store the bake file in the chunk store
+                    errorCompletingBake = true;
+                    errorReason = "Failed to copy baked assets to asset server";
+                    break;
+                }
+            } else if (!QFile::exists(bakeFileDestination) && !(_chunkStore && _chunkStore->hasAsset(bakedFileHash))) {
                 // copy each to our files folder (with the hash as their filename)
                 if (!file.copy(_filesDirectory.absoluteFilePath(bakedFileHash))) {
                     // stop handling this bake, couldn't copy the bake file into our files directory
@@ -1279,12 +1546,20 @@ void AssetServer::handleCompletedBake(QString originalAssetHash, QString origina
         writeMetaFile(originalAssetHash, meta);
     }
 
-    _pendingBakes.remove(originalAssetHash);
+    if (errorCompletingBake) {
+        ++_numFailedBakes;
+    } else {
+        ++_numCompletedBakes;
+    }
+    finishBake(originalAssetHash);
 }
 
 void AssetServer::handleAbortedBake(QString originalAssetHash, QString assetPath) {
-    // for an aborted bake we don't do anything but remove the BakeAssetTask from our pending bakes
+    // for an aborted bake we don't do anything but remove the BakeAssetTask from our pending bakes,
+    // the job stays queued so it is baked again
+    removeMaterializedBakeInput(originalAssetHash);
     _pendingBakes.remove(originalAssetHash);
+    _bakeQueue.requeue(originalAssetHash);
 }
 
 static const QString BAKE_VERSION_KEY = "bake_version";
@@ -18,7 +18,10 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetCache.h"
 #include "AssetUtils.h"
+#include "BakeQueue.h"
+#include "ChunkStore.h"
 #include "ReceivedMessage.h"
 
 namespace std {
@@ -87,17 +90,30 @@ private:
     /// Delete any unmapped files from the local asset directory
     void cleanupUnmappedFiles();
 
+    /// Delete an asset's file or chunks, whichever it is stored as
+    bool deleteAsset(const AssetUtils::AssetHash& hash);
+
     QString getPathToAssetHash(const AssetUtils::AssetHash& assetHash);
 
     std::pair<AssetUtils::BakingStatus, QString> getAssetStatus(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
 
     void bakeAssets();
     void maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
+
+    /// Start bakes from the queue, most requested first, until all the bake workers are busy
+    void startNextBakes();
+
+    /// Forget a bake that completed or failed and start the next
+    void finishBake(const AssetUtils::AssetHash& hash);
     void createEmptyMetaFile(const AssetUtils::AssetHash& hash);
     bool hasMetaFile(const AssetUtils::AssetHash& hash);
     bool needsToBeBaked(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& assetHash);
     void bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath);
 
+    /// Write a chunked asset to a temporary file the bakers can read, returns its path or an empty string on failure
+    QString materializeBakeInput(const AssetUtils::AssetHash& hash);
+    void removeMaterializedBakeInput(const AssetUtils::AssetHash& hash);
+
     /// Move baked content for asset to baked directory and update baked status
     void handleCompletedBake(QString originalAssetHash, QString assetPath, QString bakedTempOutputDir,
                              QVector<QString> bakedFilePaths);
@@ -116,12 +132,32 @@ private:
     QDir _resourcesDirectory;
     QDir _filesDirectory;
 
+    /// Recently requested assets, mapped in memory for the send tasks
+    std::shared_ptr<AssetCache> _assetCache;
+
+    /// Deduplicated storage for assets, null if there are no chunked assets and deduplication is turned off
+    std::shared_ptr<ChunkStore> _chunkStore;
+    bool _storeNewAssetsAsChunks { true };
+
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
+    /// The bakes that are running, the rest of the bakes wait in the queue
     QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
+    BakeQueue _bakeQueue;
     QThreadPool _bakingTaskPool;
 
+    /// Temporary files holding chunked assets while they are baked
+    QHash<AssetUtils::AssetHash, QString> _materializedBakeInputs;
+
+    struct BakeStageTiming {
+        quint64 totalUsecs { 0 };
+        quint64 count { 0 };
+    };
+    QHash<QString, BakeStageTiming> _bakeStageTimings;
+    int _numCompletedBakes { 0 };
+    int _numFailedBakes { 0 };
+
     bool _wasColorTextureCompressionEnabled { false };
     bool _wasGrayscaleTextureCompressionEnabled { false  };
     bool _wasNormalTextureCompressionEnabled { false };
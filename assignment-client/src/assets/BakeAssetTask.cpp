@@ -13,15 +13,21 @@
 
 #include <mutex>
 
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QThread>
 #include <QCoreApplication>
 
 #include <PathUtils.h>
+#include <SharedUtil.h>
 
 static const int OVEN_STATUS_CODE_SUCCESS { 0 };
 static const int OVEN_STATUS_CODE_FAIL { 1 };
 static const int OVEN_STATUS_CODE_ABORT { 2 };
 
+static const QString OVEN_TIMINGS_FILENAME = "timings.json";
+static const QString BAKE_STAGE_TOTAL = "total";
+
 std::once_flag registerMetaTypesFlag;
 
 BakeAssetTask::BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath) :
@@ -69,8 +75,10 @@ void BakeAssetTask::run() {
 
     _ovenProcess.reset(new QProcess());
 
+    auto bakeStart = usecTimestampNow();
+
     connect(_ovenProcess.get(), static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-            this, [this, tempOutputDir](int exitCode, QProcess::ExitStatus exitStatus) {
+            this, [this, tempOutputDir, bakeStart](int exitCode, QProcess::ExitStatus exitStatus) {
         qDebug() << "Baking process finished: " << exitCode << exitStatus;
 
         if (exitStatus == QProcess::CrashExit) {
@@ -82,6 +90,19 @@ void BakeAssetTask::run() {
             }
         } else if (exitCode == OVEN_STATUS_CODE_SUCCESS) {
             QDir outputDir = tempOutputDir;
+
+            // the oven leaves the time each stage took beside the baked files
+            QFile timingsFile { outputDir.absoluteFilePath(OVEN_TIMINGS_FILENAME) };
+            if (timingsFile.open(QIODevice::ReadOnly)) {
+                auto timings = QJsonDocument::fromJson(timingsFile.readAll()).object();
+                for (auto it = timings.begin(); it != timings.end(); ++it) {
+                    _stageTimings[it.key()] = (quint64)it.value().toDouble();
+                }
+                timingsFile.close();
+                timingsFile.remove();
+            }
+            _stageTimings[BAKE_STAGE_TOTAL] = usecTimestampNow() - bakeStart;
+
             auto files = outputDir.entryInfoList(QDir::Files);
             QVector<QString> outputFiles;
             for (auto& file : files) {
@@ -15,6 +15,7 @@
 #include <memory>
 
 #include <QtCore/QDebug>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QRunnable>
 #include <QDir>
@@ -34,6 +35,9 @@ public:
     void abort();
     bool wasAborted() const { return _wasAborted.load(); }
 
+    // how long each stage of a completed bake took in the oven, in microseconds, with the whole bake as "total"
+    QHash<QString, quint64> getStageTimings() const { return _stageTimings; }
+
 signals:
     void bakeComplete(QString assetHash, QString assetPath, QString tempOutputDir, QVector<QString> outputFiles);
     void bakeFailed(QString assetHash, QString assetPath, QString errors);
@@ -46,6 +50,7 @@ private:
     QString _filePath;
     std::unique_ptr<QProcess> _ovenProcess { nullptr };
     std::atomic<bool> _wasAborted { false };
+    QHash<QString, quint64> _stageTimings;
 };
 
 #endif // hifi_BakeAssetTask_h
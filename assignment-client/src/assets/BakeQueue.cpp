@@ -0,0 +1,223 @@
+//
+//  BakeQueue.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeQueue.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+#include "AssetServerLogging.h"
+
+static const int BAKE_QUEUE_VERSION = 1;
+
+static const QString VERSION_KEY = "version";
+static const QString JOBS_KEY = "jobs";
+static const QString HASH_KEY = "hash";
+static const QString PATH_KEY = "path";
+static const QString REQUESTS_KEY = "requests";
+static const QString ATTEMPTS_KEY = "attempts";
+static const QString STARTED_KEY = "started";
+
+bool BakeQueue::load(const QString& filePath) {
+    _filePath = filePath;
+
+    QFile file { _filePath };
+    if (!file.exists()) {
+        qCInfo(asset_server) << "No bake queue to resume, no file was found at" << _filePath;
+        return true;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(asset_server) << "Failed to open bake queue file at" << _filePath;
+        return false;
+    }
+
+    QJsonParseError error;
+    auto jsonDocument = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !jsonDocument.isObject()) {
+        qCWarning(asset_server) << "Failed to read bake queue file at" << _filePath;
+        return false;
+    }
+
+    auto root = jsonDocument.object();
+    if (root[VERSION_KEY].toInt() != BAKE_QUEUE_VERSION) {
+        qCWarning(asset_server) << "Ignoring bake queue file at" << _filePath << "with unknown version" << root[VERSION_KEY];
+        return true;
+    }
+
+    // the jobs are saved in the order they were queued
+    for (const auto& value : root[JOBS_KEY].toArray()) {
+        auto object = value.toObject();
+
+        Entry entry;
+        entry.job.hash = object[HASH_KEY].toString();
+        entry.job.path = object[PATH_KEY].toString();
+        entry.job.attempts = object[ATTEMPTS_KEY].toInt();
+
+        if (!AssetUtils::isValidHash(entry.job.hash) || _jobs.contains(entry.job.hash)) {
+            continue;
+        }
+
+        if (object[STARTED_KEY].toBool()) {
+            // this bake was running when the server went down
+            ++_numResumed;
+            _dirty = true;
+        }
+
+        _requestCounts[entry.job.hash] = (quint32)object[REQUESTS_KEY].toDouble();
+
+        entry.sequence = _nextSequence++;
+        _jobs[entry.job.hash] = entry;
+        addWaiting(entry);
+    }
+
+    qCInfo(asset_server) << "Loaded" << _jobs.size() << "queued bakes from" << _filePath << "-" << _numResumed
+        << "of them were interrupted";
+    return true;
+}
+
+bool BakeQueue::save() {
+    if (!_dirty || _filePath.isEmpty()) {
+        return true;
+    }
+
+    std::vector<const Entry*> entries;
+    entries.reserve(_jobs.size());
+    for (const auto& entry : _jobs) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+        return a->sequence < b->sequence;
+    });
+
+    QJsonArray jobs;
+    for (auto entry : entries) {
+        QJsonObject object;
+        object[HASH_KEY] = entry->job.hash;
+        object[PATH_KEY] = entry->job.path;
+        object[REQUESTS_KEY] = (double)_requestCounts.value(entry->job.hash);
+        object[ATTEMPTS_KEY] = entry->job.attempts;
+        object[STARTED_KEY] = entry->job.started;
+        jobs.append(object);
+    }
+
+    QJsonObject root;
+    root[VERSION_KEY] = BAKE_QUEUE_VERSION;
+    root[JOBS_KEY] = jobs;
+
+    // replace the old file in one go, so a crash while saving doesn't lose the queue
+    QSaveFile file { _filePath };
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) == -1 ||
+        !file.commit()) {
+        qCWarning(asset_server) << "Failed to write bake queue file at" << _filePath;
+        return false;
+    }
+
+    _dirty = false;
+    return true;
+}
+
+void BakeQueue::push(const AssetUtils::AssetHash& hash, const AssetUtils::AssetPath& path) {
+    auto it = _jobs.find(hash);
+    if (it != _jobs.end()) {
+        if (it->job.path != path) {
+            it->job.path = path;
+            _dirty = true;
+        }
+        return;
+    }
+
+    Entry entry;
+    entry.job.hash = hash;
+    entry.job.path = path;
+    entry.sequence = _nextSequence++;
+
+    _jobs[hash] = entry;
+    addWaiting(entry);
+    _dirty = true;
+}
+
+bool BakeQueue::takeNext(Job& job) {
+    if (_waiting.empty()) {
+        return false;
+    }
+
+    auto hash = _waiting.begin()->hash;
+    _waiting.erase(_waiting.begin());
+
+    auto& entry = _jobs[hash];
+    entry.job.started = true;
+    ++entry.job.attempts;
+    _dirty = true;
+
+    job = entry.job;
+    return true;
+}
+
+void BakeQueue::remove(const AssetUtils::AssetHash& hash) {
+    auto it = _jobs.find(hash);
+    if (it == _jobs.end()) {
+        return;
+    }
+
+    if (!it->job.started) {
+        _waiting.erase(keyFor(*it));
+    }
+
+    _jobs.erase(it);
+    _dirty = true;
+}
+
+void BakeQueue::requeue(const AssetUtils::AssetHash& hash) {
+    auto it = _jobs.find(hash);
+    if (it == _jobs.end() || !it->job.started) {
+        return;
+    }
+
+    it->job.started = false;
+    it->job.attempts = std::max(it->job.attempts - 1, 0);
+    addWaiting(*it);
+    _dirty = true;
+}
+
+void BakeQueue::recordRequest(const AssetUtils::AssetHash& hash) {
+    auto it = _jobs.find(hash);
+    bool isWaiting = it != _jobs.end() && !it->job.started;
+
+    // the order depends on the count, so take a waiting job out while it changes
+    if (isWaiting) {
+        _waiting.erase(keyFor(*it));
+    }
+
+    auto& requests = _requestCounts[hash];
+    if (requests < std::numeric_limits<quint32>::max()) {
+        ++requests;
+    }
+
+    if (isWaiting) {
+        addWaiting(*it);
+        // the counts are only a guide to the order, they are saved with the next change to the jobs
+    }
+}
+
+BakeQueue::WaitingKey BakeQueue::keyFor(const Entry& entry) const {
+    return { _requestCounts.value(entry.job.hash), entry.sequence, entry.job.hash };
+}
+
+void BakeQueue::addWaiting(const Entry& entry) {
+    _waiting.insert(keyFor(entry));
+}
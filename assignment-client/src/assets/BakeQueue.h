@@ -0,0 +1,93 @@
+//
+//  BakeQueue.h
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeQueue_h
+#define hifi_BakeQueue_h
+
+#include <set>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include <AssetUtils.h>
+
+// The assets waiting to be baked, most requested first. The queue is saved to a file so a restart picks up where it
+// left off: jobs that were baking when the server went down are queued again, and a job that keeps getting
+// interrupted (because the bake takes the server down with it, say) is given up on after MAX_ATTEMPTS.
+class BakeQueue {
+public:
+    struct Job {
+        AssetUtils::AssetHash hash;
+        AssetUtils::AssetPath path;
+        int attempts { 0 }; // how many times the bake was started
+        bool started { false };
+    };
+
+    static const int MAX_ATTEMPTS = 3;
+
+    // reads the jobs saved to a file and keeps saving them there, jobs that were started are queued again
+    bool load(const QString& filePath);
+
+    // writes the jobs out if anything changed since the last save, does nothing before a load
+    bool save();
+
+    // queues a bake of an asset - if it is already queued only the path it is baked as changes
+    void push(const AssetUtils::AssetHash& hash, const AssetUtils::AssetPath& path);
+
+    bool contains(const AssetUtils::AssetHash& hash) const { return _jobs.contains(hash); }
+
+    // takes the waiting job for the most requested asset and marks it started, returns false if none are waiting
+    bool takeNext(Job& job);
+
+    // removes a job, when its bake is done (or failed) or the asset is gone
+    void remove(const AssetUtils::AssetHash& hash);
+
+    // puts a started job back in the queue without counting the attempt, for a bake that was aborted
+    void requeue(const AssetUtils::AssetHash& hash);
+
+    // counts a request for an asset, queued bakes of more requested assets go first
+    void recordRequest(const AssetUtils::AssetHash& hash);
+
+    int getNumWaiting() const { return (int)_waiting.size(); }
+    int getNumStarted() const { return _jobs.size() - (int)_waiting.size(); }
+    int getNumResumed() const { return _numResumed; }
+
+private:
+    // the order of the waiting jobs, by requests (most first) then by when they were queued
+    struct WaitingKey {
+        quint32 requests;
+        quint64 sequence;
+        AssetUtils::AssetHash hash;
+
+        bool operator<(const WaitingKey& other) const {
+            return requests != other.requests ? requests > other.requests : sequence < other.sequence;
+        }
+    };
+
+    struct Entry {
+        Job job;
+        quint64 sequence;
+    };
+
+    WaitingKey keyFor(const Entry& entry) const;
+    void addWaiting(const Entry& entry);
+
+    QString _filePath;
+
+    QHash<AssetUtils::AssetHash, Entry> _jobs;
+    std::set<WaitingKey> _waiting;
+    QHash<AssetUtils::AssetHash, quint32> _requestCounts;
+
+    quint64 _nextSequence { 0 };
+    int _numResumed { 0 };
+    bool _dirty { false };
+};
+
+#endif // hifi_BakeQueue_h
@@ -0,0 +1,367 @@
+//
+//  ChunkStore.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ChunkStore.h"
+
+#include <algorithm>
+#include <array>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+#include "AssetServerLogging.h"
+
+const QString ChunkStore::RECIPE_EXTENSION = ".chunks";
+
+static const quint32 RECIPE_MAGIC = 0x48464352; // "HFCR"
+static const quint32 RECIPE_VERSION = 1;
+static const qint64 RECIPE_CHUNK_SIZE = AssetUtils::SHA256_HASH_LENGTH + sizeof(quint32); // hash and size of each chunk
+
+// the rolling hash shifts one bit per byte, so its top bits only depend on the last 64 bytes
+static const int AVERAGE_CHUNK_SIZE_BITS = 16;
+static const uint64_t CUT_MASK = ~uint64_t(0) << (64 - AVERAGE_CHUNK_SIZE_BITS);
+
+static_assert(ChunkStore::AVERAGE_CHUNK_SIZE == 1 << AVERAGE_CHUNK_SIZE_BITS, "CUT_MASK doesn't match the average size");
+
+// a random value for each byte, the same every run so the same content is always cut the same way
+static const std::array<uint64_t, 256> GEAR_TABLE = [] {
+    std::array<uint64_t, 256> table;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (auto& value : table) {
+        // splitmix64
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}();
+
+std::vector<int> ChunkStore::findChunkBoundaries(const QByteArray& data) {
+    std::vector<int> boundaries;
+
+    auto bytes = reinterpret_cast<const uint8_t*>(data.constData());
+    int size = data.size();
+    int start = 0;
+
+    while (start < size) {
+        int end = std::min(start + MAX_CHUNK_SIZE, size);
+        int cut = end;
+
+        // no point looking for a boundary before the minimum size
+        uint64_t hash = 0;
+        for (int i = start + MIN_CHUNK_SIZE; i < end; ++i) {
+            hash = (hash << 1) + GEAR_TABLE[bytes[i]];
+            if ((hash & CUT_MASK) == 0) {
+                cut = i + 1;
+                break;
+            }
+        }
+
+        boundaries.push_back(cut);
+        start = cut;
+    }
+
+    return boundaries;
+}
+
+ChunkStore::ChunkStore(const QDir& filesDirectory, const QDir& chunksDirectory) :
+    _filesDirectory(filesDirectory),
+    _chunksDirectory(chunksDirectory)
+{
+}
+
+QString ChunkStore::recipePath(const AssetUtils::AssetHash& hash) const {
+    return _filesDirectory.absoluteFilePath(hash + RECIPE_EXTENSION);
+}
+
+QString ChunkStore::chunkPath(const QByteArray& chunkHash) const {
+    // spread the chunks over subdirectories so no single directory gets millions of entries
+    auto hexHash = chunkHash.toHex();
+    return _chunksDirectory.absoluteFilePath(hexHash.left(2) + "/" + hexHash);
+}
+
+bool ChunkStore::readRecipe(const QString& path, Recipe& recipe) {
+    QFile file { path };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream { &file };
+    quint32 magic, version, numChunks;
+    stream >> magic >> version >> recipe.size >> numChunks;
+    if (magic != RECIPE_MAGIC || version != RECIPE_VERSION || stream.status() != QDataStream::Ok) {
+        qCWarning(asset_server) << "Chunk recipe" << path << "is not readable";
+        return false;
+    }
+
+    // the count comes from the file, only trust it as far as the file has room for that many chunks
+    if (numChunks > (file.size() - file.pos()) / RECIPE_CHUNK_SIZE) {
+        qCWarning(asset_server) << "Chunk recipe" << path << "is truncated";
+        return false;
+    }
+
+    recipe.chunks.clear();
+    recipe.chunks.reserve(numChunks);
+
+    qint64 total = 0;
+    for (quint32 i = 0; i < numChunks; ++i) {
+        ChunkRef chunk;
+        chunk.hash.resize(AssetUtils::SHA256_HASH_LENGTH);
+        stream.readRawData(chunk.hash.data(), chunk.hash.size());
+        stream >> chunk.size;
+        total += chunk.size;
+        recipe.chunks.push_back(chunk);
+    }
+
+    if (stream.status() != QDataStream::Ok || total != recipe.size) {
+        qCWarning(asset_server) << "Chunk recipe" << path << "is truncated";
+        return false;
+    }
+
+    return true;
+}
+
+bool ChunkStore::writeRecipe(const QString& path, const Recipe& recipe) {
+    QSaveFile file { path };
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream { &file };
+    stream << RECIPE_MAGIC << RECIPE_VERSION << recipe.size << (quint32)recipe.chunks.size();
+    for (const auto& chunk : recipe.chunks) {
+        stream.writeRawData(chunk.hash.constData(), chunk.hash.size());
+        stream << chunk.size;
+    }
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool ChunkStore::load() {
+    if (!_chunksDirectory.mkpath(".")) {
+        qCCritical(asset_server) << "Unable to create the chunk directory" << _chunksDirectory.path();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _chunkReferences.clear();
+    _stats = Stats();
+
+    auto recipes = _filesDirectory.entryList({ "*" + RECIPE_EXTENSION }, QDir::Files);
+    for (const auto& recipeName : recipes) {
+        Recipe recipe;
+        if (!readRecipe(_filesDirectory.absoluteFilePath(recipeName), recipe)) {
+            continue;
+        }
+
+        ++_stats.assets;
+        _stats.logicalBytes += recipe.size;
+
+        for (const auto& chunk : recipe.chunks) {
+            auto& references = _chunkReferences[chunk.hash];
+            if (references++ == 0) {
+                ++_stats.uniqueChunks;
+                _stats.storedBytes += chunk.size;
+            }
+        }
+    }
+
+    qCInfo(asset_server) << "Chunk store has" << _stats.assets << "assets in" << _stats.uniqueChunks << "chunks,"
+        << _stats.logicalBytes << "bytes stored in" << _stats.storedBytes;
+
+    return true;
+}
+
+bool ChunkStore::hasAsset(const AssetUtils::AssetHash& hash) const {
+    return QFile::exists(recipePath(hash));
+}
+
+qint64 ChunkStore::getAssetSize(const AssetUtils::AssetHash& hash) const {
+    Recipe recipe;
+    return readRecipe(recipePath(hash), recipe) ? recipe.size : -1;
+}
+
+bool ChunkStore::storeAsset(const AssetUtils::AssetHash& hash, const QByteArray& data) {
+    // cut and hash the data before taking the lock, that is most of the work
+    Recipe recipe;
+    recipe.size = data.size();
+
+    int start = 0;
+    for (auto end : findChunkBoundaries(data)) {
+        auto chunkHash = QCryptographicHash::hash(QByteArray::fromRawData(data.constData() + start, end - start),
+                                                  QCryptographicHash::Sha256);
+        recipe.chunks.push_back({ chunkHash, (quint32)(end - start) });
+        start = end;
+    }
+
+    // the lock makes sure a chunk can't be removed between us finding it and the recipe using it
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (hasAsset(hash)) {
+        return true;
+    }
+
+    start = 0;
+    std::vector<ChunkRef> addedChunks;
+    bool failed = false;
+
+    for (const auto& chunk : recipe.chunks) {
+        if (!_chunkReferences.contains(chunk.hash)) {
+            auto path = chunkPath(chunk.hash);
+            QDir().mkpath(QFileInfo(path).path());
+
+            QSaveFile file { path };
+            if (!file.open(QIODevice::WriteOnly) || file.write(data.constData() + start, chunk.size) != chunk.size ||
+                !file.commit()) {
+                qCWarning(asset_server) << "Failed to write chunk" << path << "-" << file.errorString();
+                failed = true;
+                break;
+            }
+
+            _chunkReferences[chunk.hash] = 0;
+            addedChunks.push_back(chunk);
+            ++_stats.uniqueChunks;
+            _stats.storedBytes += chunk.size;
+        }
+        start += chunk.size;
+    }
+
+    if (!failed && writeRecipe(recipePath(hash), recipe)) {
+        for (const auto& chunk : recipe.chunks) {
+            ++_chunkReferences[chunk.hash];
+        }
+        ++_stats.assets;
+        _stats.logicalBytes += recipe.size;
+        return true;
+    }
+
+    qCWarning(asset_server) << "Failed to store" << hash << "in the chunk store";
+
+    // don't leave the chunks that were only written for this asset behind
+    for (const auto& chunk : addedChunks) {
+        QFile::remove(chunkPath(chunk.hash));
+        _chunkReferences.remove(chunk.hash);
+        --_stats.uniqueChunks;
+        _stats.storedBytes -= chunk.size;
+    }
+
+    return false;
+}
+
+bool ChunkStore::readAsset(const AssetUtils::AssetHash& hash, QByteArray& data, qint64 offset, qint64 size) {
+    QReadLocker chunkFilesLocker(&_chunkFilesLock);
+
+    Recipe recipe;
+    if (!readRecipe(recipePath(hash), recipe)) {
+        return false;
+    }
+
+    if (size < 0) {
+        size = recipe.size - offset;
+    }
+    if (offset < 0 || size < 0 || offset + size > recipe.size) {
+        return false;
+    }
+
+    data.resize(size);
+
+    qint64 chunkStart = 0;
+    qint64 written = 0;
+    uint64_t chunkBytesRead = 0;
+    uint64_t chunksRead = 0;
+
+    for (const auto& chunk : recipe.chunks) {
+        if (written == size) {
+            break;
+        }
+
+        qint64 chunkEnd = chunkStart + chunk.size;
+        if (chunkEnd > offset) {
+            // only the part of the chunk that was asked for is read
+            QFile file { chunkPath(chunk.hash) };
+            if (!file.open(QIODevice::ReadOnly)) {
+                qCWarning(asset_server) << "Chunk" << chunk.hash.toHex() << "of" << hash << "is missing";
+                return false;
+            }
+
+            auto from = std::max(offset - chunkStart, (qint64)0);
+            auto length = std::min((qint64)chunk.size - from, size - written);
+
+            if (!file.seek(from) || file.read(data.data() + written, length) != length) {
+                qCWarning(asset_server) << "Chunk" << chunk.hash.toHex() << "of" << hash << "is truncated";
+                return false;
+            }
+
+            written += length;
+            chunkBytesRead += length;
+            ++chunksRead;
+        }
+
+        chunkStart = chunkEnd;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_stats.reads;
+    _stats.bytesRequested += size;
+    _stats.chunkBytesRead += chunkBytesRead;
+    _stats.chunksRead += chunksRead;
+
+    return true;
+}
+
+bool ChunkStore::removeAsset(const AssetUtils::AssetHash& hash) {
+    QWriteLocker chunkFilesLocker(&_chunkFilesLock);
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto path = recipePath(hash);
+
+    Recipe recipe;
+    bool readable = readRecipe(path, recipe);
+
+    if (!QFile::remove(path)) {
+        return false;
+    }
+
+    if (!readable) {
+        return true;
+    }
+
+    --_stats.assets;
+    _stats.logicalBytes -= recipe.size;
+
+    for (const auto& chunk : recipe.chunks) {
+        auto it = _chunkReferences.find(chunk.hash);
+        if (it == _chunkReferences.end()) {
+            continue;
+        }
+
+        if (--it.value() == 0) {
+            _chunkReferences.erase(it);
+            --_stats.uniqueChunks;
+            _stats.storedBytes -= chunk.size;
+
+            if (!QFile::remove(chunkPath(chunk.hash))) {
+                qCWarning(asset_server) << "Failed to remove unused chunk" << chunk.hash.toHex();
+            }
+        }
+    }
+
+    return true;
+}
+
+ChunkStore::Stats ChunkStore::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
@@ -0,0 +1,100 @@
+//
+//  ChunkStore.h
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ChunkStore_h
+#define hifi_ChunkStore_h
+
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+
+#include <AssetUtils.h>
+
+// Stores assets deduplicated: each asset is cut into chunks where its content says to (with a rolling hash, so an
+// edit only changes the chunks around it), every distinct chunk is stored once under its own hash, and the asset is
+// kept as a recipe listing its chunks. Assets keep their identity - the recipe is named after the hash of the whole
+// asset, next to where the plain file would be - and are put back together when read.
+class ChunkStore {
+public:
+    struct ChunkRef {
+        QByteArray hash; // SHA-256 of the chunk, raw
+        quint32 size;
+    };
+
+    struct Recipe {
+        qint64 size { 0 };
+        std::vector<ChunkRef> chunks;
+    };
+
+    struct Stats {
+        uint64_t assets { 0 };
+        uint64_t logicalBytes { 0 }; // the size of all the assets
+        uint64_t uniqueChunks { 0 };
+        uint64_t storedBytes { 0 }; // the size of the distinct chunks
+        uint64_t reads { 0 };
+        uint64_t bytesRequested { 0 }; // asset bytes asked for by reads
+        uint64_t chunkBytesRead { 0 }; // bytes read from chunk files to answer them
+        uint64_t chunksRead { 0 }; // chunk files opened to answer them, where a plain file store opens one per read
+    };
+
+    static const QString RECIPE_EXTENSION;
+
+    // chunk sizes - the average comes from how many bits of the rolling hash have to be zero for a cut
+    static const int MIN_CHUNK_SIZE = 16 * 1024;
+    static const int AVERAGE_CHUNK_SIZE = 64 * 1024;
+    static const int MAX_CHUNK_SIZE = 256 * 1024;
+
+    // Splits data at content defined boundaries, returning where each chunk ends
+    static std::vector<int> findChunkBoundaries(const QByteArray& data);
+
+    ChunkStore(const QDir& filesDirectory, const QDir& chunksDirectory);
+
+    // Reads every recipe to learn which chunks are in use, call once before using the store
+    bool load();
+
+    bool hasAsset(const AssetUtils::AssetHash& hash) const;
+
+    // Returns -1 if there is no such asset
+    qint64 getAssetSize(const AssetUtils::AssetHash& hash) const;
+
+    // Stores the asset unless it already is, only chunks the store doesn't have yet are written
+    bool storeAsset(const AssetUtils::AssetHash& hash, const QByteArray& data);
+
+    // Reads size bytes at offset, only touching the chunks that hold them. A size of -1 reads to the end.
+    bool readAsset(const AssetUtils::AssetHash& hash, QByteArray& data, qint64 offset = 0, qint64 size = -1);
+
+    // Drops the asset, along with the chunks no other asset uses
+    bool removeAsset(const AssetUtils::AssetHash& hash);
+
+    Stats getStats() const;
+
+private:
+    QString recipePath(const AssetUtils::AssetHash& hash) const;
+    QString chunkPath(const QByteArray& chunkHash) const;
+
+    static bool readRecipe(const QString& path, Recipe& recipe);
+    static bool writeRecipe(const QString& path, const Recipe& recipe);
+
+    QDir _filesDirectory;
+    QDir _chunksDirectory;
+
+    mutable std::mutex _mutex;
+    // held for reading while an asset is read, so removing an asset can't take its chunks away halfway through
+    QReadWriteLock _chunkFilesLock;
+    QHash<QByteArray, quint32> _chunkReferences; // chunk hash => number of assets using it
+
+    Stats _stats;
+};
+
+#endif // hifi_ChunkStore_h
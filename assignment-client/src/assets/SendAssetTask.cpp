@@ -13,8 +13,6 @@
 
 #include <cmath>
 
-#include <QFile>
-
 #include <DependencyManager.h>
 #include <NetworkLogging.h>
 #include <NLPacket.h>
@@ -26,11 +24,13 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode,
+                             std::shared_ptr<AssetCache> assetCache, std::shared_ptr<ChunkStore> chunkStore) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _assetCache(assetCache),
+    _chunkStore(chunkStore)
 {
     
 }
@@ -63,18 +63,19 @@ void SendAssetTask::run() {
     if (!byteRange.isValid()) {
         replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
     } else {
-        QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
+        bool wasCached = false;
+        auto asset = _assetCache->get(hexHash, &wasCached);
 
-        if (file.open(QIODevice::ReadOnly)) {
+        // assets in the chunk store that are too big for the cache are read a range at a time
+        qint64 fileSize = asset ? asset->getSize() : (_chunkStore ? _chunkStore->getAssetSize(hexHash) : -1);
 
+        if (fileSize >= 0) {
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(fileSize);
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (fileSize < byteRange.fromInclusive || fileSize < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -82,31 +83,36 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
+                // a positive range starts that far into the file, a negative one that far back from its end
+                auto start = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : fileSize + byteRange.fromInclusive;
 
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
+                if (asset) {
                     replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
-                } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
 
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
+                    // the packets are filled straight from the mapped file, without reading it into a buffer first
+                    replyPacketList->write(asset->getData() + start, size);
 
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
+                    _assetCache->recordServed(size, wasCached);
 
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
+                    qCDebug(networking) << "Sending asset: " << hexHash << (wasCached ? "from memory" : "");
+                } else {
+                    QByteArray data;
+                    if (_chunkStore->readAsset(hexHash, data, start, size)) {
+                        replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+                        replyPacketList->writePrimitive(size);
+                        replyPacketList->write(data);
+
+                        _assetCache->recordServed(size, false);
+
+                        qCDebug(networking) << "Sending asset: " << hexHash << "from chunks";
+                    } else {
+                        replyPacketList->writePrimitive(AssetUtils::AssetServerError::FileOperationFailed);
+                    }
                 }
-
-                qCDebug(networking) << "Sending asset: " << hexHash;
             }
-            file.close();
         } else {
-            qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
+            qCDebug(networking) << "Asset not found: " << hexHash;
             replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
         }
     }
@@ -11,8 +11,8 @@
 
 #include "UploadAssetTask.h"
 
-#include <QtCore/QBuffer>
 #include <QtCore/QFile>
+#include <QtCore/QSaveFile>
 
 #include <AssetUtils.h>
 #include <NodeList.h>
@@ -21,26 +21,26 @@
 #include "ClientServerUtils.h"
 
 UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir, uint64_t filesizeLimit) :
+                                 const QDir& resourcesDir, uint64_t filesizeLimit,
+                                 std::shared_ptr<AssetCache> assetCache, std::shared_ptr<ChunkStore> chunkStore) :
     _receivedMessage(receivedMessage),
     _senderNode(senderNode),
     _resourcesDir(resourcesDir),
-    _filesizeLimit(filesizeLimit)
+    _filesizeLimit(filesizeLimit),
+    _assetCache(assetCache),
+    _chunkStore(chunkStore)
 {
     
 }
 
 void UploadAssetTask::run() {
-    auto data = _receivedMessage->getMessage();
-    
-    QBuffer buffer { &data };
-    buffer.open(QIODevice::ReadOnly);
-    
+    _receivedMessage->seek(0);
+
     MessageID messageID;
-    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
+    _receivedMessage->readPrimitive(&messageID);
     
     uint64_t fileSize;
-    buffer.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    _receivedMessage->readPrimitive(&fileSize);
     
     qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes from"
         << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
@@ -51,7 +51,8 @@ void UploadAssetTask::run() {
     if (fileSize > _filesizeLimit) {
         replyPacket->writePrimitive(AssetUtils::AssetServerError::AssetTooLarge);
     } else {
-        QByteArray fileData = buffer.read(fileSize);
+        // read straight out of the packets the upload arrived in
+        QByteArray fileData = _receivedMessage->read(fileSize);
         
         auto hash = AssetUtils::hashData(fileData);
         auto hexHash = hash.toHex();
@@ -63,7 +64,15 @@ void UploadAssetTask::run() {
 
         bool existingCorrectFile = false;
         
-        if (file.exists()) {
+        if (_chunkStore && _chunkStore->hasAsset(QString(hexHash))) {
+            // the chunks of a stored asset are checked against their own hashes, so it has the right contents
+            qDebug() << "Not overwriting existing chunked file: " << hexHash;
+
+            existingCorrectFile = true;
+
+            replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
+            replyPacket->write(hash);
+        } else if (file.exists()) {
             // check if the local file has the correct contents, otherwise we overwrite
             if (file.open(QIODevice::ReadOnly) && AssetUtils::hashData(file.readAll()) == hash) {
                 qDebug() << "Not overwriting existing verified file: " << hexHash;
@@ -78,10 +87,30 @@ void UploadAssetTask::run() {
             }
         }
 
-        if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
+        if (!existingCorrectFile && _chunkStore) {
+            // with a chunk store only the parts of the upload that aren't already stored get written
+            if (fileData.size() == qint64(fileSize) && _chunkStore->storeAsset(QString(hexHash), fileData)) {
+                qDebug() << "Stored file" << hexHash << "in the chunk store. Upload complete";
+
+                // drop an old plain file with the wrong contents, the chunked asset replaces it
+                if (file.exists()) {
+                    _assetCache->remove(QString(hexHash));
+                    file.remove();
+                }
+
+                replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
+                replyPacket->write(hash);
+            } else {
+                qWarning() << "Failed to store file" << hexHash << "in the chunk store - upload failed.";
+                replyPacket->writePrimitive(AssetUtils::AssetServerError::FileOperationFailed);
+            }
+        } else if (!existingCorrectFile) {
+            // write to a new file that replaces the old one, which may be mapped by the asset cache and can't change
+            // under a send task that is still using it
+            QSaveFile saveFile { file.fileName() };
+            if (saveFile.open(QIODevice::WriteOnly) && saveFile.write(fileData) == qint64(fileSize) && saveFile.commit()) {
                 qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
-                file.close();
+                _assetCache->remove(QString(hexHash));
 
                 replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
                 replyPacket->write(hash);
@@ -89,6 +118,7 @@ void UploadAssetTask::run() {
                 qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
 
                 // upload has failed - remove the file and return an error
+                _assetCache->remove(QString(hexHash));
                 auto removed = file.remove();
 
                 if (!removed) {
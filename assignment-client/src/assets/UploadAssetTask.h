@@ -21,13 +21,17 @@
 
 #include "ReceivedMessage.h"
 
+#include "AssetCache.h"
+#include "ChunkStore.h"
+
 class NLPacketList;
 class Node;
 
 class UploadAssetTask : public QRunnable {
 public:
     UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, 
-                    const QDir& resourcesDir, uint64_t filesizeLimit);
+                    const QDir& resourcesDir, uint64_t filesizeLimit, std::shared_ptr<AssetCache> assetCache,
+                    std::shared_ptr<ChunkStore> chunkStore);
 
     void run() override;
 
@@ -36,6 +40,8 @@ private:
     QSharedPointer<Node> _senderNode;
     QDir _resourcesDir;
     uint64_t _filesizeLimit;
+    std::shared_ptr<AssetCache> _assetCache;
+    std::shared_ptr<ChunkStore> _chunkStore;
 };
 
 #endif // hifi_UploadAssetTask_h
@@ -9,7 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtCore/QDir>
 #include <QtCore/QEventLoop>
+#include <QtCore/QFileInfo>
 #include <QTimer>
 #include <EntityTree.h>
 #include <SimpleEntitySimulation.h>
@@ -20,6 +22,7 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <AddressManager.h>
+#include <PathUtils.h>
 
 #include "AssignmentParentFinder.h"
 #include "EntityNodeData.h"
@@ -53,6 +56,8 @@ EntityServer::EntityServer(ReceivedMessage& message) :
 
     connect(&_dynamicDomainVerificationTimer, &QTimer::timeout, this, &EntityServer::startDynamicDomainVerification);
     _dynamicDomainVerificationTimer.setSingleShot(true);
+
+    connect(&_compressionDictionaryTimer, &QTimer::timeout, this, &EntityServer::trainCompressionDictionary);
 }
 
 EntityServer::~EntityServer() {
@@ -68,6 +73,11 @@ EntityServer::~EntityServer() {
 void EntityServer::aboutToFinish() {
     DependencyManager::get<ResourceManager>()->cleanup();
 
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    if (tree && tree->getShard().isSharded()) {
+        _handOffPacketSender.terminate();
+    }
+
     OctreeServer::aboutToFinish();
 }
 
@@ -85,6 +95,7 @@ OctreePointer EntityServer::createTree() {
     EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
     tree->createRootElement();
     tree->addNewlyCreatedHook(this);
+    connect(tree.get(), &EntityTree::entityLeftShard, this, &EntityServer::handOffEntity, Qt::QueuedConnection);
     if (!_entitySimulation) {
         SimpleEntitySimulationPointer simpleSimulation { new SimpleEntitySimulation() };
         simpleSimulation->setEntityTree(tree);
@@ -111,6 +122,80 @@ void EntityServer::beforeRun() {
 
     DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
     connect(&domainHandler, &DomainHandler::settingsReceiveFail, this, &EntityServer::domainSettingsRequestFailed);
+
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    if (tree->getShard().isSharded()) {
+        _handOffPacketSender.initialize(true);
+
+        if (_wantPersist) {
+            // the first time a domain is sharded each shard starts from the file the single entity-server was using,
+            // and keeps only the entities in its part of the tree when it loads it
+            auto absolutePersistPath = [](const QString& path) {
+                return QDir(path).isRelative() ?
+                    QDir(PathUtils::getAppDataFilePath("entities/")).absoluteFilePath(path) : QDir(path).absolutePath();
+            };
+            QString shardPersistPath = absolutePersistPath(_persistFilePath);
+            QString unshardedPersistPath = absolutePersistPath(_unshardedPersistFilePath);
+
+            if (!QFile::exists(shardPersistPath) && QFile::exists(unshardedPersistPath)) {
+                qDebug() << "Seeding shard persist file" << shardPersistPath << "from" << unshardedPersistPath;
+                QDir().mkpath(QFileInfo(shardPersistPath).absolutePath());
+                QFile::copy(unshardedPersistPath, shardPersistPath);
+            }
+        }
+    }
+}
+
+void EntityServer::handOffEntity(const EntityItemPointer& entity) {
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    const EntityTreeShard& shard = tree->getShard();
+
+    if (!entity || !entity->getElement() || !entity->getParentID().isNull()
+        || shard.ownsPosition(entity->getWorldPosition())) {
+        // it was deleted, re-parented or moved back into our part of the tree since it left
+        return;
+    }
+
+    // only hand off when all of the other shards are up - otherwise hold on to it until the next time it moves,
+    // rather than risk sending it to nobody
+    int connectedShards = 0;
+    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& node) {
+        if (node->getType() == NodeType::EntityServer && node->getActiveSocket()) {
+            ++connectedShards;
+        }
+    });
+    if (connectedShards < shard.getShardCount() - 1) {
+        qDebug() << "Not handing off entity" << entity->getID() << "- only" << connectedShards << "of"
+            << shard.getShardCount() - 1 << "other shards are connected";
+        return;
+    }
+
+    // the new shard needs the entity and all of its descendants, parents before children
+    QVector<EntityItemPointer> entitiesToHandOff { entity };
+    tree->withReadLock([&] {
+        for (int i = 0; i < entitiesToHandOff.size(); ++i) {
+            entitiesToHandOff[i]->forEachChild([&](SpatiallyNestablePointer child) {
+                if (child->getNestableType() == NestableType::Entity) {
+                    entitiesToHandOff << std::static_pointer_cast<EntityItem>(child);
+                }
+            });
+        }
+
+        for (auto& entityToHandOff : entitiesToHandOff) {
+            EntityItemProperties properties = entityToHandOff->getProperties();
+            properties.markAllChanged();
+            _handOffPacketSender.queueEditEntityMessage(PacketType::EntityAdd, tree,
+                                                        entityToHandOff->getEntityItemID(), properties);
+        }
+    });
+    _handOffPacketSender.releaseQueuedMessages();
+
+    qDebug() << "Handing off entity" << entity->getID() << "and" << entitiesToHandOff.size() - 1
+        << "descendants to shard" << shard.shardForPosition(entity->getWorldPosition()) + 1;
+
+    tree->withWriteLock([&] {
+        tree->handOffEntity(entity->getEntityItemID());
+    });
 }
 
 void EntityServer::entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
@@ -297,6 +382,24 @@ void EntityServer::pruneDeletedEntities() {
 }
 
 void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectionObject) {
+    // the domain-server hands each shard its index and the shard count in the assignment payload
+    int shardIndex = 0;
+    int shardCount = 1;
+    readOptionInt(QString("shardIndex"), settingsSectionObject, shardIndex);
+    readOptionInt(QString("shardCount"), settingsSectionObject, shardCount);
+    EntityTreeShard shard(shardIndex, shardCount);
+    std::static_pointer_cast<EntityTree>(_tree)->setShard(shard);
+
+    if (shard.isSharded()) {
+        qDebug() << "Entity server is shard" << shard.getShardIndex() + 1 << "of" << shard.getShardCount();
+
+        _unshardedPersistFilePath = _persistFilePath;
+        _persistFilePath = shard.shardPersistFilePath(_persistFilePath);
+
+        // we need to know about the other shards so we can hand entities off to them
+        DependencyManager::get<NodeList>()->addSetOfNodeTypesToNodeInterestSet({ NodeType::EntityServer });
+    }
+
     bool wantEditLogging = false;
     readOptionBool(QString("wantEditLogging"), settingsSectionObject, wantEditLogging);
     qDebug("wantEditLogging=%s", debug::valueOf(wantEditLogging));
@@ -326,6 +429,14 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
 
     startDynamicDomainVerification();
 
+    readOptionInt("compressionDictionarySize", settingsSectionObject, _compressionDictionarySize);
+    qDebug() << "compressionDictionarySize=" << _compressionDictionarySize;
+    if (_compressionDictionarySize > 0) {
+        // poll until the initial load is complete, trainCompressionDictionary then slows the timer down
+        const int COMPRESSION_DICTIONARY_LOAD_CHECK_MSECS = 1000;
+        _compressionDictionaryTimer.start(COMPRESSION_DICTIONARY_LOAD_CHECK_MSECS);
+    }
+
     tree->setWantEditLogging(wantEditLogging);
     tree->setWantTerseEditLogging(wantTerseEditLogging);
 
@@ -359,7 +470,10 @@ void EntityServer::entityFilterAdded(EntityItemID id, bool success) {
 
 void EntityServer::nodeAdded(SharedNodePointer node) {
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
-    tree->knowAvatarID(node->getUUID());
+    if (node->getType() != NodeType::EntityServer) {
+        // other shards of a sharded domain don't have avatars
+        tree->knowAvatarID(node->getUUID());
+    }
     OctreeServer::nodeAdded(node);
 }
 
@@ -397,6 +511,14 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    auto compressionDictionary = getCompressionDictionary();
+    if (compressionDictionary) {
+        statsString += "<b>Entity Server Compression Dictionary</b>\r\n";
+        statsString += QString().sprintf("     Dictionary ID... %u\r\n", compressionDictionary->getID());
+        statsString += QString().sprintf("   Dictionary size... %d bytes\r\n", compressionDictionary->getBytes().size());
+        statsString += "\r\n\r\n";
+    }
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
@@ -450,6 +572,28 @@ void EntityServer::domainSettingsRequestFailed() {
     startDynamicDomainVerification();
 }
 
+void EntityServer::trainCompressionDictionary() {
+    if (!isInitialLoadComplete()) {
+        return;
+    }
+
+    quint64 trainStart = usecTimestampNow();
+
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    auto dictionary = OctreeCompressionDictionary::train(tree->getCompressionDictionarySamples(), _compressionDictionarySize);
+
+    // every client has to fetch a new dictionary before we can use it for them, so only switch if it actually changed
+    auto currentDictionary = getCompressionDictionary();
+    if (dictionary && (!currentDictionary || currentDictionary->getID() != dictionary->getID())) {
+        qDebug() << "Trained" << dictionary->getBytes().size() << "byte compression dictionary" << dictionary->getID()
+            << "in" << (usecTimestampNow() - trainStart) << "usecs";
+        setCompressionDictionary(dictionary);
+    }
+
+    const int COMPRESSION_DICTIONARY_RETRAIN_MSECS = 60 * 60 * 1000; // 1h
+    _compressionDictionaryTimer.setInterval(COMPRESSION_DICTIONARY_RETRAIN_MSECS);
+}
+
 void EntityServer::startDynamicDomainVerification() {
     qCDebug(entities) << "Starting Dynamic Domain Verification...";
 
@@ -16,6 +16,8 @@
 
 #include <memory>
 
+#include <EntityEditPacketSender.h>
+
 #include "EntityItem.h"
 #include "EntityServerConsts.h"
 #include "EntityTree.h"
@@ -74,6 +76,7 @@ protected:
 private slots:
     void handleEntityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void domainSettingsRequestFailed();
+    void handOffEntity(const EntityItemPointer& entity);
 
 private:
     SimpleEntitySimulationPointer _entitySimulation;
@@ -88,6 +91,16 @@ private:
     int _MAXIMUM_DYNAMIC_DOMAIN_VERIFICATION_TIMER_MS = DEFAULT_MAXIMUM_DYNAMIC_DOMAIN_VERIFICATION_TIMER_MS; // 1h
     QTimer _dynamicDomainVerificationTimer;
     void startDynamicDomainVerification();
+
+    // the dictionary our send threads compress with is trained from the scene once it has loaded, and then retrained
+    // now and then as the content changes. A size of 0 turns it off.
+    int _compressionDictionarySize { OctreeCompressionDictionary::DEFAULT_DICTIONARY_SIZE };
+    QTimer _compressionDictionaryTimer;
+    void trainCompressionDictionary();
+
+    // used when this server is one shard of the domain, to pass entities that leave our part of the tree to their new shard
+    EntityEditPacketSender _handOffPacketSender;
+    QString _unshardedPersistFilePath;
 };
 
 #endif // hifi_EntityServer_h
@@ -42,3 +42,12 @@ void EntityTreeHeadlessViewer::update() {
 void EntityTreeHeadlessViewer::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
     std::static_pointer_cast<EntityTree>(_tree)->processEraseMessage(message, sourceNode);
 }
+
+void EntityTreeHeadlessViewer::removeEntitiesFromServer(const QUuid& serverID) {
+    if (_tree) {
+        EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+        tree->withWriteLock([&] {
+            tree->deleteEntitiesFromServer(serverID);
+        });
+    }
+}
@@ -40,6 +40,9 @@ public:
 
     void processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
 
+    // drops what one of the domain's entity servers sent, when it has gone away and others are still up
+    void removeEntitiesFromServer(const QUuid& serverID);
+
     virtual void init() override;
 
 protected:
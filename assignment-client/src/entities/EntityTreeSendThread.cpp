@@ -43,6 +43,11 @@ void EntityTreeSendThread::preDistributionProcessing() {
     if (nodeData) {
         auto jsonQuery = nodeData->getJSONParameters();
 
+        // only re-compile the filter when the query has actually changed
+        if (jsonQuery != _queryFilter.getJSONFilters()) {
+            _queryFilter = EntityQueryFilter(jsonQuery);
+        }
+
         // check if we have a JSON query with flags
         auto flags = jsonQuery[EntityJSONQueryProperties::FLAGS_PROPERTY].toObject();
         if (!flags.isEmpty()) {
@@ -102,6 +107,17 @@ void EntityTreeSendThread::preDistributionProcessing() {
 
 void EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene) {
+    if (!nodeData->getUsesFrustum() && _queryFilter.isIndexable()) {
+        // this is a filtered query with no view (a bot or agent script, for example) - the index can tell us
+        // which entities could match, so there is no reason to walk the whole tree
+        quint64 startTime = usecTimestampNow();
+        queueIndexedEntities(*static_cast<EntityNodeData*>(nodeData));
+        OctreeServer::trackTreeTraverseTime((float)(usecTimestampNow() - startTime));
+
+        OctreeSendThread::traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
+        return;
+    }
+
     if (viewFrustumChanged || _traversal.finished()) {
         ViewFrustum viewFrustum;
         nodeData->copyCurrentViewFrustum(viewFrustum);
@@ -215,6 +231,31 @@ bool EntityTreeSendThread::addDescendantsToExtraFlaggedEntities(const QUuid& fil
     return hasNewChild || hasNewDescendants;
 }
 
+void EntityTreeSendThread::queueIndexedEntities(EntityNodeData& nodeData) {
+    auto entityTree = std::static_pointer_cast<EntityTree>(_myServer->getOctree());
+
+    QVector<EntityItemID> candidateIDs = entityTree->getQueryIndex().findCandidates(_queryFilter);
+
+    // extra entities flagged by includeAncestors/includeDescendants won't be in the index results, so add them here
+    foreach(const QUuid& extraEntityID, nodeData.getFlaggedExtraEntityIDs()) {
+        candidateIDs << extraEntityID;
+    }
+
+    foreach(const EntityItemID& entityID, candidateIDs) {
+        EntityItemPointer entity = entityTree->findEntityByEntityItemID(entityID);
+        if (!entity || _entitiesInQueue.find(entity.get()) != _entitiesInQueue.end()) {
+            continue;
+        }
+
+        // same rule as a Repeat traversal - send what the client doesn't know about or what has changed since
+        auto knownTimestamp = _knownState.find(entity.get());
+        if (knownTimestamp == _knownState.end() || entity->getLastEdited() > knownTimestamp->second) {
+            _sendQueue.push(PrioritizedEntity(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY));
+            _entitiesInQueue.insert(entity.get());
+        }
+    }
+}
+
 void EntityTreeSendThread::startNewTraversal(const ViewFrustum& view, EntityTreeElementPointer root, int32_t lodLevelOffset, 
         bool usesViewFrustum) {
 
@@ -443,7 +484,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
         EntityItemPointer entity = queuedItem.getEntity();
         if (entity) {
             // Only send entities that match the jsonFilters, but keep track of everything we've tried to send so we don't try to send it again
-            bool entityMatchesFilters = entity->matchesJSONFilters(jsonFilters);
+            bool entityMatchesFilters = _queryFilter.matches(*entity);
             if (entityMatchesFilters || entityNodeData->isEntityFlaggedAsExtra(entity->getID())) {
                 if (!jsonFilters.isEmpty() && entityMatchesFilters) {
                     // Record explicitly filtered-in entity so that extra entities can be flagged.
@@ -17,6 +17,7 @@
 #include "../octree/OctreeSendThread.h"
 
 #include <DiffTraversal.h>
+#include <EntityQueryFilter.h>
 
 #include "EntityPriorityQueue.h"
 
@@ -43,6 +44,9 @@ private:
 
     void startNewTraversal(const ViewFrustum& viewFrustum, EntityTreeElementPointer root, int32_t lodLevelOffset, 
         bool usesViewFrustum);
+
+    // queues the entities matching an indexable filter straight from the EntityQueryIndex, without an octree traversal
+    void queueIndexedEntities(EntityNodeData& nodeData);
     bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) override;
 
     void preDistributionProcessing() override;
@@ -56,6 +60,7 @@ private:
     std::unordered_set<EntityItem*> _entitiesInQueue;
     std::unordered_map<EntityItem*, uint64_t> _knownState;
     ConicalView _conicalView; // cached optimized view for fast priority calculations
+    EntityQueryFilter _queryFilter; // compiled form of the JSON filter in the current query
 
     // packet construction stuff
     EntityTreeElementExtraEncodeDataPointer _extraEncodeData { new EntityTreeElementExtraEncodeData() };
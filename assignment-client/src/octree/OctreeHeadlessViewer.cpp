@@ -36,9 +36,12 @@ void OctreeHeadlessViewer::queryOctree() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    auto node = nodeList->soloNodeOfType(serverType);
-    if (node && node->getActiveSocket()) {
+    // a sharded domain has several servers of this type - each of them gets the same query
+    nodeList->eachMatchingNode([serverType](const SharedNodePointer& node) {
+        return node->getType() == serverType && node->getActiveSocket();
+    }, [&](const SharedNodePointer& node) {
         _octreeQuery.setMaxQueryPacketsPerSecond(getMaxPacketsPerSecond());
+        _octreeQuery.setCompressionDictionaryID(getCompressionDictionaryID(node->getUUID()));
 
         auto queryPacket = NLPacket::create(packetType);
 
@@ -47,9 +50,8 @@ void OctreeHeadlessViewer::queryOctree() {
         int packetSize = _octreeQuery.getBroadcastData(packetData);
         queryPacket->setPayloadSize(packetSize);
 
-        // make sure we still have an active socket
         nodeList->sendUnreliablePacket(*queryPacket, *node);
-    }
+    });
 }
 
 
@@ -131,6 +131,34 @@ AtomicUIntStat OctreeSendThread::_totalSpecialBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalSpecialPackets { 0 };
 
 
+OctreeCompressionDictionaryPointer OctreeSendThread::compressionDictionaryForNode(const SharedNodePointer& node,
+                                                                                 OctreeQueryNode* nodeData) {
+    auto dictionary = _myServer->getCompressionDictionary();
+    if (!dictionary) {
+        return nullptr;
+    }
+
+    if (nodeData->getCompressionDictionaryID() == dictionary->getID()) {
+        return dictionary;
+    }
+
+    // the client doesn't have our current dictionary, so send it and hold off on using it until its query says it has it
+    // the dictionary is sent reliably, so we only send it again if the client seems to have lost track of it
+    const quint64 COMPRESSION_DICTIONARY_RESEND_USECS = 30 * USECS_PER_SECOND;
+    quint64 now = usecTimestampNow();
+    if (nodeData->getCompressionDictionarySentID() != dictionary->getID() ||
+        now - nodeData->getCompressionDictionarySentAt() > COMPRESSION_DICTIONARY_RESEND_USECS) {
+
+        auto dictionaryPacketList = NLPacketList::create(PacketType::OctreeCompressionDictionary, QByteArray(), true, true);
+        dictionaryPacketList->write(dictionary->getBytes());
+        DependencyManager::get<NodeList>()->sendPacketList(std::move(dictionaryPacketList), *node);
+
+        nodeData->setCompressionDictionarySent(dictionary->getID(), now);
+    }
+
+    return nullptr;
+}
+
 int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, bool dontSuppressDuplicate) {
     OctreeServer::didHandlePacketSend(this);
 
@@ -361,6 +389,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
 
     _packetData.changeSettings(true, targetSize); // FIXME - eventually support only compressed packets
+    _packetData.setCompressionDictionary(compressionDictionaryForNode(node, nodeData));
 
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
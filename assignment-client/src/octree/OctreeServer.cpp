@@ -887,6 +887,16 @@ OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePo
     return sendThread;
 }
 
+OctreeCompressionDictionaryPointer OctreeServer::getCompressionDictionary() const {
+    std::lock_guard<std::mutex> lock(_compressionDictionaryMutex);
+    return _compressionDictionary;
+}
+
+void OctreeServer::setCompressionDictionary(const OctreeCompressionDictionaryPointer& dictionary) {
+    std::lock_guard<std::mutex> lock(_compressionDictionaryMutex);
+    _compressionDictionary = dictionary;
+}
+
 void OctreeServer::removeSendThread() {
     // If the object has been deleted since the event was queued, sender() will return nullptr
     if (auto sendThread = qobject_cast<OctreeSendThread*>(sender())) {
@@ -13,6 +13,7 @@
 #define hifi_OctreeServer_h
 
 #include <memory>
+#include <mutex>
 
 #include <QStringList>
 #include <QDateTime>
@@ -63,6 +64,10 @@ public:
     QString getPersistFileMimeType() const { return (_persistThread) ? _persistThread->getPersistFileMimeType() : "text/plain"; }
     QByteArray getPersistFileContents() const { return (_persistThread) ? _persistThread->getPersistFileContents() : QByteArray(); }
 
+    // the preset dictionary send threads compress with for clients that have it, nullptr if there isn't one
+    OctreeCompressionDictionaryPointer getCompressionDictionary() const;
+    void setCompressionDictionary(const OctreeCompressionDictionaryPointer& dictionary);
+
     // Subclasses must implement these methods
     virtual std::unique_ptr<OctreeQueryNode> createOctreeQueryNode() = 0;
     virtual char getMyNodeType() const = 0;
@@ -204,6 +209,9 @@ protected:
     
     SendThreads _sendThreads;
 
+    mutable std::mutex _compressionDictionaryMutex;
+    OctreeCompressionDictionaryPointer _compressionDictionary;
+
     static int _clientCount;
     static SimpleMovingAverage _averageLoopTime;
 
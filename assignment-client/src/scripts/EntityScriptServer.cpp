@@ -77,7 +77,8 @@ EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssig
     DebugDraw::getInstance();
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListenerForTypes({ PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase },
+    packetReceiver.registerListenerForTypes({ PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase,
+                                              PacketType::OctreeCompressionDictionary },
                                             this, "handleOctreePacket");
     packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
 
@@ -348,27 +349,22 @@ void EntityScriptServer::nodeActivated(SharedNodePointer activatedNode) {
 void EntityScriptServer::nodeKilled(SharedNodePointer killedNode) {
     switch (killedNode->getType()) {
         case NodeType::EntityServer: {
-            // Before we clear, make sure this was our only entity server.
-            // Otherwise we're assuming that we have "trading" entity servers
-            // (an old one going away and a new one coming onboard)
-            // and that we shouldn't clear here because we're still doing work.
-            bool hasAnotherEntityServer = false;
-            auto nodeList = DependencyManager::get<NodeList>();
-
-            nodeList->eachNodeBreakable([&hasAnotherEntityServer, &killedNode](const SharedNodePointer& node){
-                if (node->getType() == NodeType::EntityServer && node->getUUID() != killedNode->getUUID()) {
-                    // we're talking to > 1 entity servers, we know we won't clear
-                    hasAnotherEntityServer = true;
-                    return false;
-                }
+            _entityViewer.removeCompressionDictionary(killedNode->getUUID());
 
-                return true;
+            // Only clear everything if this was our only entity server. Otherwise the domain either splits its
+            // entities between several of them, or an old one is trading places with a new one - either way what
+            // this one sent goes (unloading its entities' scripts) and the rest stays.
+            auto nodeList = DependencyManager::get<NodeList>();
+            auto otherEntityServer = nodeList->nodeMatchingPredicate([&killedNode](const SharedNodePointer& node) {
+                return node->getType() == NodeType::EntityServer && node->getUUID() != killedNode->getUUID();
             });
 
-            if (!hasAnotherEntityServer) {
+            if (otherEntityServer) {
+                _entityViewer.removeEntitiesFromServer(killedNode->getUUID());
+            } else {
                 clear();
             }
-            
+
             break;
         }
         case NodeType::Agent: {
@@ -536,6 +532,11 @@ void EntityScriptServer::sendStatsPacket() {
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     auto packetType = message->getType();
 
+    if (packetType == PacketType::OctreeCompressionDictionary) {
+        _entityViewer.processCompressionDictionary(*message, senderNode);
+        return;
+    }
+
     if (packetType == PacketType::OctreeStats) {
 
         int statsMessageLength = OctreeHeadlessViewer::parseOctreeStats(message, senderNode);
@@ -79,6 +79,8 @@ var viewHelpers = {
           }
 
           form_group += "<input type='" + input_type + "'" +  common_attrs() +
+            (_.has(setting, 'min') ? "min='" + setting.min + "' " : "") +
+            (_.has(setting, 'max') ? "max='" + setting.max + "' " : "") +
             "placeholder='" + (_.has(setting, 'placeholder') ? setting.placeholder : "") +
             "' value='" + (_.has(setting, 'password_placeholder') ? setting.password_placeholder : setting_value) + "'/>"
         }
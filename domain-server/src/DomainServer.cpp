@@ -28,6 +28,7 @@
 #include <AccountManager.h>
 #include <BuildInfo.h>
 #include <DependencyManager.h>
+#include <EntityTreeShard.h>
 #include <HifiConfigVariantMap.h>
 #include <HTTPConnection.h>
 #include <LogUtils.h>
@@ -960,6 +961,29 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
                 }
             }
 
+            if (defaultedType == Assignment::EntityServerType) {
+                // a domain can split its entities between several entity-servers - each one gets its shard index
+                // in the payload and reads the shard count from the entity-server settings
+                static const QString ENTITY_SERVER_SHARD_COUNT_KEYPATH = "entity_server_settings.shardCount";
+                int shardCount = _settingsManager.valueOrDefaultValueForKeyPath(ENTITY_SERVER_SHARD_COUNT_KEYPATH).toInt();
+
+                // there is one shard per top-level octant at most, more would just be servers sharing the last one
+                if (shardCount > EntityTreeShard::MAX_SHARD_COUNT) {
+                    qWarning() << "Entity-server shard count" << shardCount << "is more than the maximum of"
+                        << EntityTreeShard::MAX_SHARD_COUNT << "- using" << EntityTreeShard::MAX_SHARD_COUNT;
+                    shardCount = EntityTreeShard::MAX_SHARD_COUNT;
+                }
+
+                if (shardCount > 1) {
+                    for (int shardIndex = 0; shardIndex < shardCount; ++shardIndex) {
+                        Assignment* shardAssignment = new Assignment(Assignment::CreateCommand, Assignment::EntityServerType);
+                        shardAssignment->setPayload(QString("--shardIndex %1").arg(shardIndex).toUtf8());
+                        addStaticAssignmentToAssignmentHash(shardAssignment);
+                    }
+                    continue;
+                }
+            }
+
             // type has not been set from a command line or config file config, use the default
             // by clearing whatever exists and writing a single default assignment with no payload
             Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
@@ -216,7 +216,8 @@ Item {
                     StatText {
                         visible: root.expanded;
                         text: "Downloads: " + root.downloads + "/" + root.downloadLimit +
-                              ", Pending: " + root.downloadsPending;
+                              ", Pending: " + root.downloadsPending + ", Wait: " + root.downloadsWaitMs + " ms" +
+                              ", Preempted: " + root.downloadsPreempted;
                     }
                     StatText {
                         visible: root.expanded;
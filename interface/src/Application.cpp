@@ -119,6 +119,7 @@
 #include <UpdateSceneTask.h>
 #include <RenderViewTask.h>
 #include <SecondaryCamera.h>
+#include <ResourceAccessLog.h>
 #include <ResourceCache.h>
 #include <ResourceRequest.h>
 #include <SandboxUtils.h>
@@ -657,6 +658,18 @@ bool setupEssentials(int& argc, char** argv, bool runningMarkerExisted) {
         qApp->setProperty(hifi::properties::APP_LOCAL_DATA_PATH, cacheDir);
     }
 
+    // pick how the resource caches decide what to keep, and record what they are asked for to compare the choices
+    static const auto RESOURCE_EVICTION_POLICY_SWITCH = "--resource-eviction-policy";
+    QString evictionPolicy = getCmdOption(argc, constArgv, RESOURCE_EVICTION_POLICY_SWITCH);
+    if (!evictionPolicy.isEmpty()) {
+        ResourceCache::setDefaultEvictionPolicy(evictionPolicy);
+    }
+    static const auto RESOURCE_ACCESS_LOG_SWITCH = "--resource-access-log";
+    QString resourceAccessLog = getCmdOption(argc, constArgv, RESOURCE_ACCESS_LOG_SWITCH);
+    if (!resourceAccessLog.isEmpty()) {
+        ResourceAccessLog::start(resourceAccessLog);
+    }
+
     // FIXME fix the OSX installer to install the resources.rcc binary instead of resource files and remove
     // this conditional exclusion
 #if !defined(Q_OS_OSX)
@@ -1655,12 +1668,18 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
         properties["atp_in_kbps"] = bandwidthRecorder->getAverageInputKilobitsPerSecond(NodeType::AssetServer);
 
         auto nodeList = DependencyManager::get<NodeList>();
-        SharedNodePointer entityServerNode = nodeList->soloNodeOfType(NodeType::EntityServer);
         SharedNodePointer audioMixerNode = nodeList->soloNodeOfType(NodeType::AudioMixer);
         SharedNodePointer avatarMixerNode = nodeList->soloNodeOfType(NodeType::AvatarMixer);
         SharedNodePointer assetServerNode = nodeList->soloNodeOfType(NodeType::AssetServer);
         SharedNodePointer messagesMixerNode = nodeList->soloNodeOfType(NodeType::MessagesMixer);
-        properties["entity_ping"] = entityServerNode ? entityServerNode->getPingMs() : -1;
+        // with the domain's entities split between several entity servers, the slowest of them holds things up
+        int entityPing = -1;
+        nodeList->eachMatchingNode([](const SharedNodePointer& node) {
+            return node->getType() == NodeType::EntityServer;
+        }, [&entityPing](const SharedNodePointer& node) {
+            entityPing = std::max(entityPing, node->getPingMs());
+        });
+        properties["entity_ping"] = entityPing;
         properties["audio_ping"] = audioMixerNode ? audioMixerNode->getPingMs() : -1;
         properties["avatar_ping"] = avatarMixerNode ? avatarMixerNode->getPingMs() : -1;
         properties["asset_ping"] = assetServerNode ? assetServerNode->getPingMs() : -1;
@@ -1864,8 +1883,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     }
 
     EntityTreeRenderer::setEntitiesShouldFadeFunction([this]() {
-        SharedNodePointer entityServerNode = DependencyManager::get<NodeList>()->soloNodeOfType(NodeType::EntityServer);
-        return entityServerNode && !isPhysicsEnabled();
+        return hasEntityServer() && !isPhysicsEnabled();
     });
 
     _snapshotSound = DependencyManager::get<SoundCache>()->getSound(PathUtils::resourcesUrl("sounds/snap.wav"));
@@ -2332,6 +2350,12 @@ void Application::initializeGL() {
     // create thread for parsing of octree data independent of the main network and rendering threads
     _octreeProcessor.initialize(_enableProcessOctreeThread);
     connect(&_octreeProcessor, &OctreePacketProcessor::packetVersionMismatch, this, &Application::notifyPacketVersionMismatch);
+
+    // query again as soon as we have a new compression dictionary, so the server can start using it
+    connect(&_octreeProcessor, &OctreePacketProcessor::compressionDictionaryReceived, this, [this] {
+        _lastQueriedTime = 0;
+    });
+
     _entityEditSender.initialize(_enableProcessOctreeThread);
 
     _idleLoopStdev.reset();
@@ -5175,6 +5199,7 @@ void Application::update(float deltaTime) {
     quint64 now = usecTimestampNow();
 
     // Update my voxel servers with my current voxel query...
+    bool viewChanged = false;
     {
         PROFILE_RANGE_EX(app, "QueryOctree", 0xffff0000, (uint64_t)getActiveDisplayPlugin()->presentCount());
         PerformanceTimer perfTimer("queryOctree");
@@ -5191,9 +5216,15 @@ void Application::update(float deltaTime) {
             }
             sendAvatarViewFrustum();
             _lastQueriedViewFrustum = _viewFrustum;
+            viewChanged = viewIsDifferentEnough;
         }
     }
 
+    // what is worth downloading first depends on where we are looking from
+    if (viewChanged) {
+        ResourceCache::reprioritizeRequests();
+    }
+
     // sent nack packets containing missing sequence numbers of received packets from nodes
     {
         quint64 sinceLastNack = now - _lastNackTime;
@@ -5442,9 +5473,13 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType) {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    auto node = nodeList->soloNodeOfType(serverType);
-    if (node && node->getActiveSocket()) {
+    // a domain may split its entities between several servers, each of which only sends what it owns
+    // so the same query goes to all of them
+    nodeList->eachMatchingNode([serverType](const SharedNodePointer& node) {
+        return node->getType() == serverType && node->getActiveSocket();
+    }, [&](const SharedNodePointer& node) {
         _octreeQuery.setMaxQueryPacketsPerSecond(getMaxOctreePacketsPerSecond());
+        _octreeQuery.setCompressionDictionaryID(getEntities()->getCompressionDictionaryID(node->getUUID()));
 
         auto queryPacket = NLPacket::create(packetType);
 
@@ -5453,9 +5488,8 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType) {
         int packetSize = _octreeQuery.getBroadcastData(packetData);
         queryPacket->setPayloadSize(packetSize);
 
-        // make sure we still have an active socket
         nodeList->sendUnreliablePacket(*queryPacket, *node);
-    }
+    });
 }
 
 
@@ -5559,6 +5593,14 @@ void Application::updateWindowTitle() const {
     DependencyManager::get< MessagesClient >()->sendLocalMessage("Toolbar-DomainChanged", "");
 }
 
+bool Application::hasEntityServer() const {
+    // any of the domain's entity servers, which may split its entities between them
+    auto entityServerNode = DependencyManager::get<NodeList>()->nodeMatchingPredicate([](const SharedNodePointer& node) {
+        return node->getType() == NodeType::EntityServer;
+    });
+    return (bool)entityServerNode;
+}
+
 void Application::clearDomainOctreeDetails() {
 
     // if we're about to quit, we really don't need to do any of these things...
@@ -5668,8 +5710,24 @@ void Application::nodeKilled(SharedNodePointer node) {
     if (node->getType() == NodeType::AudioMixer) {
         QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "audioMixerKilled");
     } else if (node->getType() == NodeType::EntityServer) {
-        // we lost an entity server, clear all of the domain octree details
-        clearDomainOctreeDetails();
+        getEntities()->removeCompressionDictionary(node->getUUID());
+
+        auto otherEntityServer = DependencyManager::get<NodeList>()->nodeMatchingPredicate([&node](const SharedNodePointer& other) {
+            return other->getType() == NodeType::EntityServer && other->getUUID() != node->getUUID();
+        });
+        if (otherEntityServer) {
+            // the domain splits its entities between several entity servers - only the ones this one sent go
+            _octreeServerSceneStats.withWriteLock([&] {
+                _octreeServerSceneStats.erase(node->getUUID());
+            });
+            auto tree = getEntities()->getTree();
+            tree->withWriteLock([&] {
+                tree->deleteEntitiesFromServer(node->getUUID());
+            });
+        } else {
+            // we lost our entity server, clear all of the domain octree details
+            clearDomainOctreeDetails();
+        }
     } else if (node->getType() == NodeType::AvatarMixer) {
         // our avatar mixer has gone away - clear the hash of avatars
         DependencyManager::get<AvatarManager>()->clearOtherAvatars();
@@ -5801,8 +5859,7 @@ void Application::addingEntityWithCertificate(const QString& certificateID, cons
 void Application::registerScriptEngineWithApplicationServices(ScriptEnginePointer scriptEngine) {
 
     scriptEngine->setEmitScriptUpdatesFunction([this]() {
-        SharedNodePointer entityServerNode = DependencyManager::get<NodeList>()->soloNodeOfType(NodeType::EntityServer);
-        return !entityServerNode || isPhysicsEnabled();
+        return !hasEntityServer() || isPhysicsEnabled();
     });
 
     // setup the packet sender of the script engine's scripting interfaces so
@@ -454,6 +454,7 @@ private:
     void updateDialogs(float deltaTime) const;
 
     void queryOctree(NodeType_t serverType, PacketType packetType);
+    bool hasEntityServer() const;
 
     int sendNackPackets();
     void sendAvatarViewFrustum();
@@ -19,7 +19,8 @@
 OctreePacketProcessor::OctreePacketProcessor() {
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     
-    packetReceiver.registerDirectListenerForTypes({ PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase },
+    packetReceiver.registerDirectListenerForTypes({ PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase,
+                                                    PacketType::OctreeCompressionDictionary },
                                                   this, "handleOctreePacket");
 }
 
@@ -41,6 +42,16 @@ void OctreePacketProcessor::processPacket(QSharedPointer<ReceivedMessage> messag
 
     PacketType octreePacketType = message->getType();
 
+    // the compression dictionary isn't octree data, so it has no sequence number to track and nothing piggybacked on it
+    if (octreePacketType == PacketType::OctreeCompressionDictionary) {
+        auto renderer = qApp->getEntities();
+        if (renderer) {
+            renderer->processCompressionDictionary(*message, sendingNode);
+            emit compressionDictionaryReceived();
+        }
+        return;
+    }
+
     // note: PacketType_OCTREE_STATS can have PacketType_VOXEL_DATA
     // immediately following them inside the same packet. So, we process the PacketType_OCTREE_STATS first
     // then process any remaining bytes as if it was another packet
@@ -24,6 +24,7 @@ public:
 
 signals:
     void packetVersionMismatch();
+    void compressionDictionaryReceived();
 
 protected:
     virtual void processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) override;
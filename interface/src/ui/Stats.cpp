@@ -252,7 +252,10 @@ void Stats::updateStats(bool force) {
         auto loadingRequests = ResourceCache::getLoadingRequests();
         STAT_UPDATE(downloads, loadingRequests.size());
         STAT_UPDATE(downloadLimit, ResourceCache::getRequestLimit())
-        STAT_UPDATE(downloadsPending, ResourceCache::getPendingRequestCount());
+        auto requestStats = ResourceCache::getRequestStats();
+        STAT_UPDATE(downloadsPending, (int)requestStats.pending);
+        STAT_UPDATE(downloadsWaitMs, (int)(requestStats.averageWaitUsecs / USECS_PER_MSEC));
+        STAT_UPDATE(downloadsPreempted, (int)requestStats.preempted);
         STAT_UPDATE(processing, DependencyManager::get<StatTracker>()->getStat("Processing").toInt());
         STAT_UPDATE(processingPending, DependencyManager::get<StatTracker>()->getStat("PendingProcessing").toInt());
         
@@ -87,6 +87,8 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, downloads, 0)
     STATS_PROPERTY(int, downloadLimit, 0)
     STATS_PROPERTY(int, downloadsPending, 0)
+    STATS_PROPERTY(int, downloadsWaitMs, 0)
+    STATS_PROPERTY(int, downloadsPreempted, 0)
     Q_PROPERTY(QStringList downloadUrls READ downloadUrls NOTIFY downloadUrlsChanged)
     STATS_PROPERTY(int, processing, 0)
     STATS_PROPERTY(int, processingPending, 0)
@@ -214,6 +216,8 @@ signals:
     void downloadsChanged();
     void downloadLimitChanged();
     void downloadsPendingChanged();
+    void downloadsWaitMsChanged();
+    void downloadsPreemptedChanged();
     void downloadUrlsChanged();
     void processingChanged();
     void processingPendingChanged();
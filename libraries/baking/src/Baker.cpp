@@ -44,6 +44,12 @@ void Baker::handleWarning(const QString& warning) {
     _warningList.append(warning);
 }
 
+void Baker::addStageTimes(const QHash<QString, quint64>& timings) {
+    for (auto it = timings.begin(); it != timings.end(); ++it) {
+        addStageTime(it.key(), it.value());
+    }
+}
+
 void Baker::setIsFinished(bool isFinished) {
     _isFinished.store(isFinished);
 
@@ -12,8 +12,17 @@
 #ifndef hifi_Baker_h
 #define hifi_Baker_h
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 
+// the stages of a bake that are timed
+static const QString BAKE_STAGE_PARSE = "parse";
+static const QString BAKE_STAGE_MESH_OPTIMIZE = "mesh optimize";
+static const QString BAKE_STAGE_MESH_COMPRESS = "mesh compress";
+static const QString BAKE_STAGE_TEXTURE_DECODE = "texture decode";
+static const QString BAKE_STAGE_TEXTURE_COMPRESS = "texture compress";
+static const QString BAKE_STAGE_WRITE = "write";
+
 class Baker : public QObject {
     Q_OBJECT
 
@@ -30,6 +39,10 @@ public:
 
     std::vector<QString> getOutputFiles() const { return _outputFiles; }
 
+    // How long each stage of the bake took, in microseconds. Stages that ran more than once (a texture compress for
+    // each texture of a model) are summed.
+    QHash<QString, quint64> getStageTimings() const { return _stageTimings; }
+
     virtual void setIsFinished(bool isFinished);
     bool isFinished() const { return _isFinished.load(); }
 
@@ -51,6 +64,9 @@ protected:
 
     void handleErrors(const QStringList& errors);
 
+    void addStageTime(const QString& stage, quint64 usecs) { _stageTimings[stage] += usecs; }
+    void addStageTimes(const QHash<QString, quint64>& timings);
+
     // List of baked output files. For instance, for an FBX this would
     // include the .fbx and all of its texture files.
     std::vector<QString> _outputFiles;
@@ -58,6 +74,8 @@ protected:
     QStringList _errorList;
     QStringList _warningList;
 
+    QHash<QString, quint64> _stageTimings;
+
     std::atomic<bool> _isFinished { false };
 
     std::atomic<bool> _shouldAbort { false };
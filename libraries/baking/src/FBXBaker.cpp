@@ -28,6 +28,7 @@
 #include <FBXReader.h>
 #include <FBXWriter.h>
 
+#include "MeshOptimizer.h"
 #include "ModelBakingLoggingCategory.h"
 #include "TextureBaker.h"
 
@@ -108,7 +109,9 @@ void FBXBaker::bake() {
 
 void FBXBaker::bakeSourceCopy() {
     // load the scene from the FBX file
+    auto stageStart = usecTimestampNow();
     importScene();
+    addStageTime(BAKE_STAGE_PARSE, usecTimestampNow() - stageStart);
 
     if (shouldStop()) {
         return;
@@ -121,14 +124,21 @@ void FBXBaker::bakeSourceCopy() {
         return;
     }
 
+    // the meshes are optimized as they are compressed, and that is timed on its own
+    stageStart = usecTimestampNow();
+    auto optimizeUsecs = _stageTimings.value(BAKE_STAGE_MESH_OPTIMIZE);
     rewriteAndBakeSceneModels();
+    optimizeUsecs = _stageTimings.value(BAKE_STAGE_MESH_OPTIMIZE) - optimizeUsecs;
+    addStageTime(BAKE_STAGE_MESH_COMPRESS, usecTimestampNow() - stageStart - optimizeUsecs);
 
     if (shouldStop()) {
         return;
     }
 
     // export the FBX with re-written texture references
+    stageStart = usecTimestampNow();
     exportScene();
+    addStageTime(BAKE_STAGE_WRITE, usecTimestampNow() - stageStart);
 
     if (shouldStop()) {
         return;
@@ -323,6 +333,11 @@ QUrl FBXBaker::getTextureURL(const QFileInfo& textureFileInfo, QString relativeF
 
 void FBXBaker::rewriteAndBakeSceneModels() {
     unsigned int meshIndex = 0;
+    MeshOptimizer::CacheStats statsBefore;
+    MeshOptimizer::CacheStats statsAfter;
+    // the size of the meshes with draco's default edgebreaker encoding and as they are baked
+    size_t bytesBefore { 0 };
+    size_t bytesAfter { 0 };
     bool hasDeformers { false };
     for (FBXNode& rootChild : _rootNode.children) {
         if (rootChild.name == "Objects") {
@@ -355,16 +370,89 @@ void FBXBaker::rewriteAndBakeSceneModels() {
                     Q_ASSERT(mesh.colors.size() == 0 || mesh.colors.size() == mesh.vertices.size());
                     Q_ASSERT(mesh.texCoords.size() == 0 || mesh.texCoords.size() == mesh.vertices.size());
 
+                    bool hasNormals { mesh.normals.size() > 0 };
+                    bool hasColors { mesh.colors.size() > 0 };
+                    bool hasTexCoords { mesh.texCoords.size() > 0 };
+                    bool hasTexCoords1 { mesh.texCoords1.size() > 0 };
+                    bool hasPerFaceMaterials { mesh.parts.size() > 1
+                        || extractedMesh.partMaterialTextures[0].first != 0 };
+                    bool needsOriginalIndices { hasDeformers };
+
+                    auto optimizeStart = usecTimestampNow();
+
+                    // The extracted mesh has a vertex for each corner of each polygon, so the vertices that are the
+                    // same in every attribute are welded together first, otherwise no vertex is ever used twice
+                    QVector<int> welded(mesh.vertices.size());
+                    QVector<int> representatives;
+                    QVector<glm::vec3> weldedPositions;
+                    {
+                        QHash<QByteArray, int> weldedByValue;
+                        weldedByValue.reserve(mesh.vertices.size());
+                        for (int i = 0; i < mesh.vertices.size(); ++i) {
+                            QByteArray value((const char*)&mesh.vertices[i], sizeof(glm::vec3));
+                            if (hasNormals) {
+                                value.append((const char*)&mesh.normals[i], sizeof(glm::vec3));
+                            }
+                            if (hasColors) {
+                                value.append((const char*)&mesh.colors[i], sizeof(glm::vec3));
+                            }
+                            if (hasTexCoords) {
+                                value.append((const char*)&mesh.texCoords[i], sizeof(glm::vec2));
+                            }
+                            if (hasTexCoords1) {
+                                value.append((const char*)&mesh.texCoords1[i], sizeof(glm::vec2));
+                            }
+                            if (needsOriginalIndices) {
+                                value.append((const char*)&mesh.originalIndices[i], sizeof(int));
+                            }
+
+                            auto it = weldedByValue.find(value);
+                            if (it == weldedByValue.end()) {
+                                it = weldedByValue.insert(value, representatives.size());
+                                representatives.append(i);
+                                weldedPositions.append(mesh.vertices[i]);
+                            }
+                            welded[i] = it.value();
+                        }
+                    }
+
+                    // when optimizing, each part's triangles are reordered for the vertex cache and then for overdraw,
+                    // and draco keeps the vertices in the order those triangles first use them
                     int64_t numTriangles { 0 };
+                    QVector<QVector<int>> partTriangles;
                     for (auto& part : mesh.parts) {
-                        if ((part.quadTrianglesIndices.size() % 3) != 0 || (part.triangleIndices.size() % 3) != 0) {
+                        QVector<int> triangles;
+                        bool isValid = (part.quadTrianglesIndices.size() % 3) == 0 && (part.triangleIndices.size() % 3) == 0;
+                        if (isValid) {
+                            triangles.reserve(part.quadTrianglesIndices.size() + part.triangleIndices.size());
+                            for (int index : part.quadTrianglesIndices + part.triangleIndices) {
+                                if (index < 0 || index >= welded.size()) {
+                                    isValid = false;
+                                    break;
+                                }
+                                triangles.append(welded[index]);
+                            }
+                        }
+                        if (!isValid) {
                             handleWarning("Found a mesh part with invalid index data, skipping");
+                            partTriangles.append(QVector<int>());
                             continue;
                         }
-                        numTriangles += part.quadTrianglesIndices.size() / 3;
-                        numTriangles += part.triangleIndices.size() / 3;
+
+                        statsBefore += MeshOptimizer::analyzeVertexCache(triangles, representatives.size());
+
+                        if (_shouldOptimizeMeshes) {
+                            triangles = MeshOptimizer::optimizeVertexCache(triangles, representatives.size());
+                            triangles = MeshOptimizer::optimizeOverdraw(triangles, weldedPositions);
+                        }
+                        statsAfter += MeshOptimizer::analyzeVertexCache(triangles, representatives.size());
+
+                        numTriangles += triangles.size() / 3;
+                        partTriangles.append(triangles);
                     }
 
+                    addStageTime(BAKE_STAGE_MESH_OPTIMIZE, usecTimestampNow() - optimizeStart);
+
                     if (numTriangles == 0) {
                         continue;
                     }
@@ -373,14 +461,6 @@ void FBXBaker::rewriteAndBakeSceneModels() {
 
                     meshBuilder.Start(numTriangles);
 
-                    bool hasNormals { mesh.normals.size() > 0 };
-                    bool hasColors { mesh.colors.size() > 0 };
-                    bool hasTexCoords { mesh.texCoords.size() > 0 };
-                    bool hasTexCoords1 { mesh.texCoords1.size() > 0 };
-                    bool hasPerFaceMaterials { mesh.parts.size() > 1
-                        || extractedMesh.partMaterialTextures[0].first != 0 };
-                    bool needsOriginalIndices { hasDeformers };
-
                     int normalsAttributeID { -1 };
                     int colorsAttributeID { -1 };
                     int texCoordsAttributeID { -1 };
@@ -426,10 +506,10 @@ void FBXBaker::rewriteAndBakeSceneModels() {
                         const auto& matTex = extractedMesh.partMaterialTextures[partIndex];
                         uint16_t materialID = matTex.first;
 
-                        auto addFace = [&](QVector<int>& indices, int index, draco::FaceIndex face) {
-                            int32_t idx0 = indices[index];
-                            int32_t idx1 = indices[index + 1];
-                            int32_t idx2 = indices[index + 2];
+                        auto addFace = [&](const QVector<int>& indices, int index, draco::FaceIndex face) {
+                            int32_t idx0 = representatives[indices[index]];
+                            int32_t idx1 = representatives[indices[index + 1]];
+                            int32_t idx2 = representatives[indices[index + 2]];
 
                             if (hasPerFaceMaterials) {
                                 meshBuilder.SetPerFaceAttributeValueForFace(faceMaterialAttributeID, face, &materialID);
@@ -467,12 +547,9 @@ void FBXBaker::rewriteAndBakeSceneModels() {
                             }
                         };
 
-                        for (int i = 0; (i + 2) < part.quadTrianglesIndices.size(); i += 3) {
-                            addFace(part.quadTrianglesIndices, i, face++);
-                        }
-
-                        for (int i = 0; (i + 2) < part.triangleIndices.size(); i += 3) {
-                            addFace(part.triangleIndices, i, face++);
+                        const auto& triangles = partTriangles[partIndex];
+                        for (int i = 0; (i + 2) < triangles.size(); i += 3) {
+                            addFace(triangles, i, face++);
                         }
 
                         partIndex++;
@@ -508,6 +585,17 @@ void FBXBaker::rewriteAndBakeSceneModels() {
 
                     draco::EncoderBuffer buffer;
                     encoder.EncodeMeshToBuffer(*dracoMesh, &buffer);
+                    bytesBefore += buffer.size();
+
+                    if (_shouldOptimizeMeshes) {
+                        // edgebreaker would reorder the faces and vertices we just optimized, so keep them as they are,
+                        // at the cost of some compression - the edgebreaker encoding above is only kept for its size
+                        encoder.SetEncodingMethod(draco::MESH_SEQUENTIAL_ENCODING);
+                        draco::EncoderBuffer sequentialBuffer;
+                        encoder.EncodeMeshToBuffer(*dracoMesh, &sequentialBuffer);
+                        buffer = std::move(sequentialBuffer);
+                    }
+                    bytesAfter += buffer.size();
 
                     FBXNode dracoMeshNode;
                     dracoMeshNode.name = "DracoMesh";
@@ -547,6 +635,13 @@ void FBXBaker::rewriteAndBakeSceneModels() {
             }
         }
     }
+
+    if (statsBefore.triangles > 0) {
+        qCInfo(model_baking) << (_shouldOptimizeMeshes ? "Optimized the meshes of" : "Baked the meshes of") << _fbxURL
+            << "- vertices transformed per triangle" << statsBefore.getACMR() << "->" << statsAfter.getACMR()
+            << ", per vertex" << statsBefore.getATVR() << "->" << statsAfter.getATVR()
+            << ", compressed bytes" << bytesBefore << "->" << bytesAfter;
+    }
 }
 
 void FBXBaker::rewriteAndBakeSceneTextures() {
@@ -696,6 +791,9 @@ void FBXBaker::handleBakedTexture() {
 
     // make sure we haven't already run into errors, and that this is a valid texture
     if (bakedTexture) {
+        // the textures bake on their own threads, their time counts towards this bake
+        addStageTimes(bakedTexture->getStageTimings());
+
         if (!shouldStop()) {
             if (!bakedTexture->hasErrors()) {
                 if (!_originalOutputDir.isEmpty()) {
@@ -42,6 +42,10 @@ public:
 
     virtual void setWasAborted(bool wasAborted) override;
 
+    // Reorder the triangles of the baked meshes for the vertex cache and overdraw, and keep that order by encoding
+    // them sequentially. Off by default: sequential encoding compresses less than edgebreaker.
+    void setShouldOptimizeMeshes(bool shouldOptimizeMeshes) { _shouldOptimizeMeshes = shouldOptimizeMeshes; }
+
 public slots:
     virtual void bake() override;
     virtual void abort() override;
@@ -97,6 +101,8 @@ private:
     TextureBakerThreadGetter _textureThreadGetter;
 
     bool _pendingErrorEmission { false };
+
+    bool _shouldOptimizeMeshes { false };
 };
 
 #endif // hifi_FBXBaker_h
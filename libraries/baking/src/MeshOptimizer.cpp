@@ -0,0 +1,298 @@
+//
+//  MeshOptimizer.cpp
+//  libraries/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+// the cache the triangles are ordered for - bigger than most real caches, which the order still suits
+static const int FORSYTH_CACHE_SIZE = 32;
+static const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+static const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+MeshOptimizer::CacheStats& MeshOptimizer::CacheStats::operator+=(const CacheStats& other) {
+    triangles += other.triangles;
+    vertices += other.vertices;
+    misses += other.misses;
+    return *this;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(const QVector<int>& indices, int numVertices, int cacheSize) {
+    CacheStats stats;
+    stats.triangles = indices.size() / 3;
+
+    std::vector<bool> isUsed(numVertices, false);
+    std::vector<bool> isCached(numVertices, false);
+    std::deque<int> cache;
+
+    for (int index : indices) {
+        if (index < 0 || index >= numVertices) {
+            continue;
+        }
+        if (!isUsed[index]) {
+            isUsed[index] = true;
+            ++stats.vertices;
+        }
+        if (isCached[index]) {
+            continue;
+        }
+
+        ++stats.misses;
+        cache.push_back(index);
+        isCached[index] = true;
+        if ((int)cache.size() > cacheSize) {
+            isCached[cache.front()] = false;
+            cache.pop_front();
+        }
+    }
+
+    return stats;
+}
+
+// how much a vertex adds to the score of its triangles: more if it's in the cache, and more if few triangles are
+// left to use it, so those are finished off before the vertex leaves the cache
+static float getVertexScore(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // the vertices of the last triangle are scored the same, so it doesn't matter which way it was turned
+            score = FORSYTH_LAST_TRIANGLE_SCORE;
+        } else {
+            const float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = powf(1.0f - (cachePosition - 3) * scale, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+
+    score += FORSYTH_VALENCE_BOOST_SCALE * powf((float)remainingTriangles, -FORSYTH_VALENCE_BOOST_POWER);
+    return score;
+}
+
+QVector<int> MeshOptimizer::optimizeVertexCache(const QVector<int>& indices, int numVertices) {
+    const int numTriangles = indices.size() / 3;
+    for (int i = 0; i < numTriangles * 3; ++i) {
+        if (indices[i] < 0 || indices[i] >= numVertices) {
+            return indices;
+        }
+    }
+
+    // the triangles each vertex is in, those that are still to be added first
+    std::vector<int> adjacencyOffsets(numVertices + 1, 0);
+    for (int i = 0; i < numTriangles * 3; ++i) {
+        ++adjacencyOffsets[indices[i] + 1];
+    }
+    for (int i = 0; i < numVertices; ++i) {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+    std::vector<int> adjacency(numTriangles * 3);
+    std::vector<int> remainingTriangles(numVertices, 0);
+    for (int triangle = 0; triangle < numTriangles; ++triangle) {
+        for (int corner = 0; corner < 3; ++corner) {
+            int vertex = indices[triangle * 3 + corner];
+            adjacency[adjacencyOffsets[vertex] + remainingTriangles[vertex]++] = triangle;
+        }
+    }
+
+    std::vector<int> cachePositions(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+    for (int vertex = 0; vertex < numVertices; ++vertex) {
+        vertexScores[vertex] = getVertexScore(-1, remainingTriangles[vertex]);
+    }
+
+    std::vector<float> triangleScores(numTriangles);
+    std::vector<bool> isAdded(numTriangles, false);
+    int bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (int triangle = 0; triangle < numTriangles; ++triangle) {
+        const int* vertices = indices.constData() + triangle * 3;
+        triangleScores[triangle] = vertexScores[vertices[0]] + vertexScores[vertices[1]] + vertexScores[vertices[2]];
+        if (triangleScores[triangle] > bestScore) {
+            bestScore = triangleScores[triangle];
+            bestTriangle = triangle;
+        }
+    }
+
+    QVector<int> result;
+    result.reserve(numTriangles * 3);
+
+    std::vector<int> cache;
+    std::vector<int> nextCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+    int nextUnaddedTriangle = 0;
+
+    while (result.size() < numTriangles * 3) {
+        if (bestTriangle == -1) {
+            // nothing in the cache leads anywhere, carry on with the first triangle that's left
+            while (isAdded[nextUnaddedTriangle]) {
+                ++nextUnaddedTriangle;
+            }
+            bestTriangle = nextUnaddedTriangle;
+        }
+
+        const int* vertices = indices.constData() + bestTriangle * 3;
+        isAdded[bestTriangle] = true;
+        nextCache.clear();
+        for (int corner = 0; corner < 3; ++corner) {
+            int vertex = vertices[corner];
+            result.append(vertex);
+
+            // the triangle no longer counts for its vertices
+            int* begin = adjacency.data() + adjacencyOffsets[vertex];
+            int* end = begin + remainingTriangles[vertex];
+            int* it = std::find(begin, end, bestTriangle);
+            if (it != end) {
+                std::swap(*it, *(end - 1));
+                --remainingTriangles[vertex];
+            }
+
+            if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end()) {
+                nextCache.push_back(vertex);
+            }
+        }
+
+        // the vertices of the triangle go to the front of the cache, the rest move back
+        const size_t numTriangleVertices = nextCache.size();
+        for (int vertex : cache) {
+            auto triangleVerticesEnd = nextCache.begin() + numTriangleVertices;
+            if (std::find(nextCache.begin(), triangleVerticesEnd, vertex) == triangleVerticesEnd) {
+                nextCache.push_back(vertex);
+            }
+        }
+
+        // rescore what was in the cache (and just fell out of it) and look for the best triangle among theirs
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (int position = 0; position < (int)nextCache.size(); ++position) {
+            int vertex = nextCache[position];
+            cachePositions[vertex] = position < FORSYTH_CACHE_SIZE ? position : -1;
+            vertexScores[vertex] = getVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+        }
+        for (int vertex : nextCache) {
+            const int* begin = adjacency.data() + adjacencyOffsets[vertex];
+            const int* end = begin + remainingTriangles[vertex];
+            for (const int* it = begin; it != end; ++it) {
+                const int* triangleVertices = indices.constData() + *it * 3;
+                float score = vertexScores[triangleVertices[0]] + vertexScores[triangleVertices[1]] +
+                    vertexScores[triangleVertices[2]];
+                triangleScores[*it] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = *it;
+                }
+            }
+        }
+
+        if ((int)nextCache.size() > FORSYTH_CACHE_SIZE) {
+            nextCache.resize(FORSYTH_CACHE_SIZE);
+        }
+        cache.swap(nextCache);
+    }
+
+    return result;
+}
+
+QVector<int> MeshOptimizer::optimizeOverdraw(const QVector<int>& indices, const QVector<glm::vec3>& positions) {
+    const int numTriangles = indices.size() / 3;
+    const int numVertices = positions.size();
+    for (int i = 0; i < numTriangles * 3; ++i) {
+        if (indices[i] < 0 || indices[i] >= numVertices) {
+            return indices;
+        }
+    }
+
+    // a cluster starts with each triangle that misses the cache for all its vertices, as the cache is no help there
+    std::vector<int> clusterStarts;
+    std::vector<bool> isCached(numVertices, false);
+    std::deque<int> cache;
+    for (int triangle = 0; triangle < numTriangles; ++triangle) {
+        int misses = 0;
+        for (int corner = 0; corner < 3; ++corner) {
+            int vertex = indices[triangle * 3 + corner];
+            if (isCached[vertex]) {
+                continue;
+            }
+            ++misses;
+            cache.push_back(vertex);
+            isCached[vertex] = true;
+            if ((int)cache.size() > ANALYSIS_CACHE_SIZE) {
+                isCached[cache.front()] = false;
+                cache.pop_front();
+            }
+        }
+        if (misses == 3 || triangle == 0) {
+            clusterStarts.push_back(triangle);
+        }
+    }
+    clusterStarts.push_back(numTriangles);
+
+    struct Cluster {
+        int begin;
+        int end;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters;
+    clusters.reserve(clusterStarts.size() - 1);
+
+    // the clusters and the mesh are centered on their triangles' centroids, weighted by area
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> clusterCenters;
+    std::vector<glm::vec3> clusterNormals;
+    for (size_t i = 0; i + 1 < clusterStarts.size(); ++i) {
+        glm::vec3 center(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (int triangle = clusterStarts[i]; triangle < clusterStarts[i + 1]; ++triangle) {
+            const glm::vec3& a = positions[indices[triangle * 3]];
+            const glm::vec3& b = positions[indices[triangle * 3 + 1]];
+            const glm::vec3& c = positions[indices[triangle * 3 + 2]];
+            glm::vec3 scaledNormal = glm::cross(b - a, c - a);
+            float triangleArea = glm::length(scaledNormal);
+            center += (a + b + c) * (triangleArea / 3.0f);
+            normal += scaledNormal;
+            area += triangleArea;
+        }
+        meshCenter += center;
+        meshArea += area;
+        clusterCenters.push_back(area > 0.0f ? center / area : center);
+        clusterNormals.push_back(normal);
+        clusters.push_back({ clusterStarts[i], clusterStarts[i + 1], 0.0f });
+    }
+    if (meshArea > 0.0f) {
+        meshCenter /= meshArea;
+    }
+
+    // the further out a cluster is in the direction it faces, the more it hides and the less it is hidden
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        float length = glm::length(clusterNormals[i]);
+        clusters[i].sortKey = length > 0.0f ? glm::dot(clusterCenters[i] - meshCenter, clusterNormals[i] / length) : 0.0f;
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    QVector<int> result;
+    result.reserve(numTriangles * 3);
+    for (const auto& cluster : clusters) {
+        for (int i = cluster.begin * 3; i < cluster.end * 3; ++i) {
+            result.append(indices[i]);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,51 @@
+//
+//  MeshOptimizer.h
+//  libraries/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshOptimizer_h
+#define hifi_MeshOptimizer_h
+
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+// Reorders the triangles of a mesh for the GPU: first so they reuse the vertices it has just transformed, then so the
+// parts of the mesh that face outwards are drawn before those they are likely to hide. The vertices are then best
+// stored in the order the triangles first use them, which the baked draco meshes do by themselves.
+class MeshOptimizer {
+public:
+    // what a simulated FIFO post-transform cache of a typical size makes of a list of triangles
+    struct CacheStats {
+        int triangles { 0 };
+        int vertices { 0 }; // the vertices the triangles use
+        int misses { 0 }; // the vertices transformed, as they weren't in the cache
+
+        // average cache miss ratio, the vertices transformed per triangle (0.5 at best for a large grid, 3 at worst)
+        float getACMR() const { return triangles > 0 ? (float)misses / triangles : 0.0f; }
+        // average transform to vertex ratio, how many times each vertex is transformed (1 at best)
+        float getATVR() const { return vertices > 0 ? (float)misses / vertices : 0.0f; }
+
+        CacheStats& operator+=(const CacheStats& other);
+    };
+
+    static const int ANALYSIS_CACHE_SIZE = 16;
+
+    static CacheStats analyzeVertexCache(const QVector<int>& indices, int numVertices,
+                                         int cacheSize = ANALYSIS_CACHE_SIZE);
+
+    // orders the triangles to reuse the vertices in the cache, with Tom Forsyth's linear-speed vertex cache optimisation
+    static QVector<int> optimizeVertexCache(const QVector<int>& indices, int numVertices);
+
+    // Splits triangles ordered for the vertex cache where the cache starts over anyway and sorts the pieces so the
+    // ones facing away from the center of the mesh come first, after Sander et al. "Fast Triangle Reordering for
+    // Vertex Locality and Reduced Overdraw" - this costs next to nothing in cache misses.
+    static QVector<int> optimizeOverdraw(const QVector<int>& indices, const QVector<glm::vec3>& positions);
+};
+
+#endif // hifi_MeshOptimizer_h
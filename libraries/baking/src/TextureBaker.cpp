@@ -118,9 +118,12 @@ void TextureBaker::processTexture() {
     auto hashData = QCryptographicHash::hash(_originalTexture, QCryptographicHash::Md5);
     std::string hash = hashData.toHex().toStdString();
 
+    auto stageStart = usecTimestampNow();
+
     // IMPORTANT: _originalTexture is empty past this point
+    image::ProcessingTimings timings;
     auto processedTexture = image::processImage(std::move(_originalTexture), _textureURL.toString().toStdString(),
-                                                ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType, _abortProcessing);
+                                                ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType, _abortProcessing, &timings);
     processedTexture->setSourceHash(hash);
 
     if (shouldStop()) {
@@ -140,6 +143,10 @@ void TextureBaker::processTexture() {
         return;
     }
 
+    addStageTime(BAKE_STAGE_TEXTURE_DECODE, timings.decodeUsecs);
+    addStageTime(BAKE_STAGE_TEXTURE_COMPRESS, usecTimestampNow() - stageStart - timings.decodeUsecs);
+    stageStart = usecTimestampNow();
+
     const char* data = reinterpret_cast<const char*>(memKTX->_storage->data());
     const size_t length = memKTX->_storage->size();
 
@@ -153,6 +160,8 @@ void TextureBaker::processTexture() {
         _outputFiles.push_back(filePath);
     }
 
+    addStageTime(BAKE_STAGE_WRITE, usecTimestampNow() - stageStart);
+
     qCDebug(model_baking) << "Baked texture" << _textureURL;
     setIsFinished(true);
 }
@@ -1295,6 +1295,8 @@ void ModelEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePointer& sce
 
     // Nothing else to do unless the model is loaded
     if (!model->isLoaded()) {
+        // the priority changes as we move around, keep the download queue up to date with it
+        model->setLoadingPriority(EntityTreeRenderer::getEntityLoadingPriority(*entity));
         return;
     }
 
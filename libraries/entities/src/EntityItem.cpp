@@ -37,6 +37,7 @@
 #include "EntityTree.h"
 #include "EntitySimulation.h"
 #include "EntityDynamicFactoryInterface.h"
+#include "EntityQueryFilter.h"
 
 Q_DECLARE_METATYPE(EntityItemPointer);
 int entityItemPointernMetaTypeId = qRegisterMetaType<EntityItemPointer>();
@@ -2417,29 +2418,9 @@ void EntityItem::globalizeProperties(EntityItemProperties& properties, const QSt
 
 
 bool EntityItem::matchesJSONFilters(const QJsonObject& jsonFilters) const {
-
-    // The intention for the query JSON filter and this method is to be flexible to handle a variety of filters for
-    // ALL entity properties. Some work will need to be done to the property system so that it can be more flexible
-    // (to grab the value and default value of a property given the string representation of that property, for example)
-
-    // currently the only property filter we handle is '+' for serverScripts
-    // which means that we only handle a filtered query asking for entities where the serverScripts property is non-default
-
-    static const QString SERVER_SCRIPTS_PROPERTY = "serverScripts";
-
-    foreach(const auto& property, jsonFilters.keys()) {
-        if (property == SERVER_SCRIPTS_PROPERTY  && jsonFilters[property] == EntityQueryFilterSymbol::NonDefault) {
-            // check if this entity has a non-default value for serverScripts
-            if (_serverScripts != ENTITY_ITEM_DEFAULT_SERVER_SCRIPTS) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-    }
-
-    // the json filter syntax did not match what we expected, return a match
-    return true;
+    // callers that check many entities against the same filter should compile it once
+    // with EntityQueryFilter and call EntityQueryFilter::matches directly
+    return EntityQueryFilter(jsonFilters).matches(*this);
 }
 
 quint64 EntityItem::getLastSimulated() const {
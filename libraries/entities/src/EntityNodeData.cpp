@@ -28,3 +28,11 @@ bool EntityNodeData::isEntityFlaggedAsExtra(const QUuid& entityID) const {
 
     return false;
 }
+
+QSet<QUuid> EntityNodeData::getFlaggedExtraEntityIDs() const {
+    QSet<QUuid> extraEntityIDs;
+    foreach(const QSet<QUuid>& entitySet, _flaggedExtraEntities) {
+        extraEntityIDs.unite(entitySet);
+    }
+    return extraEntityIDs;
+}
@@ -18,6 +18,11 @@
 
 namespace EntityJSONQueryProperties {
     static const QString SERVER_SCRIPTS_PROPERTY = "serverScripts";
+    static const QString OWNING_AVATAR_ID_PROPERTY = "owningAvatarID";
+    static const QString TYPE_PROPERTY = "type";
+    static const QString LOCKED_PROPERTY = "locked";
+    static const QString VISIBLE_PROPERTY = "visible";
+    static const QString USER_DATA_KEYS_PROPERTY = "userDataKeys";
     static const QString FLAGS_PROPERTY = "flags";
     static const QString INCLUDE_ANCESTORS_PROPERTY = "includeAncestors";
     static const QString INCLUDE_DESCENDANTS_PROPERTY = "includeDescendants";
@@ -42,6 +47,7 @@ public:
     bool insertFlaggedExtraEntity(const QUuid& filteredEntityID, const QUuid& extraEntityID);
     
     bool isEntityFlaggedAsExtra(const QUuid& entityID) const;
+    QSet<QUuid> getFlaggedExtraEntityIDs() const;
     void resetFlaggedExtraEntities() { _previousFlaggedExtraEntities = _flaggedExtraEntities; _flaggedExtraEntities.clear(); }
 
 private:
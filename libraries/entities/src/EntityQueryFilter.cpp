@@ -0,0 +1,151 @@
+//
+//  EntityQueryFilter.cpp
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryFilter.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "EntityItem.h"
+#include "EntityItemPropertiesDefaults.h"
+#include "EntityNodeData.h"
+#include "EntityTree.h"
+
+EntityQueryFilter::EntityQueryFilter(const QJsonObject& jsonFilters) :
+    _jsonFilters(jsonFilters)
+{
+    using namespace EntityJSONQueryProperties;
+
+    for (auto it = jsonFilters.constBegin(); it != jsonFilters.constEnd(); ++it) {
+        const QString& property = it.key();
+        const QJsonValue& value = it.value();
+
+        Term term;
+        if (property == SERVER_SCRIPTS_PROPERTY) {
+            if (value.toString() != EntityQueryFilterSymbol::NonDefault) {
+                continue;
+            }
+            term.type = NonDefaultServerScripts;
+        } else if (property == OWNING_AVATAR_ID_PROPERTY) {
+            term.type = OwningAvatarID;
+            term.uuid = QUuid(value.toString());
+        } else if (property == TYPE_PROPERTY) {
+            term.type = Type;
+            term.entityType = EntityTypes::getEntityTypeFromName(value.toString());
+        } else if (property == LOCKED_PROPERTY && value.isBool()) {
+            term.type = Locked;
+            term.flag = value.toBool();
+        } else if (property == VISIBLE_PROPERTY && value.isBool()) {
+            term.type = Visible;
+            term.flag = value.toBool();
+        } else if (property == USER_DATA_KEYS_PROPERTY) {
+            QJsonArray keys = value.isArray() ? value.toArray() : QJsonArray { value };
+            for (const auto& key : keys) {
+                if (key.isString()) {
+                    Term keyTerm;
+                    keyTerm.type = UserDataKey;
+                    keyTerm.key = key.toString();
+                    _terms.push_back(keyTerm);
+                }
+            }
+            continue;
+        } else {
+            // not a property we know how to filter on (the flags object, for example)
+            continue;
+        }
+
+        _terms.push_back(term);
+    }
+}
+
+bool EntityQueryFilter::isIndexable() const {
+    // the index only keeps posting lists for the rare side of boolean properties (locked, invisible)
+    // so only those terms - and the exact-match terms - can seed a candidate set
+    for (const auto& term : _terms) {
+        switch (term.type) {
+            case NonDefaultServerScripts:
+            case OwningAvatarID:
+            case Type:
+            case UserDataKey:
+                return true;
+            case Locked:
+                if (term.flag) {
+                    return true;
+                }
+                break;
+            case Visible:
+                if (!term.flag) {
+                    return true;
+                }
+                break;
+        }
+    }
+    return false;
+}
+
+bool EntityQueryFilter::matches(const EntityItem& entity) const {
+    QStringList entityUserDataKeys;
+    bool haveUserDataKeys = false;
+
+    for (const auto& term : _terms) {
+        switch (term.type) {
+            case NonDefaultServerScripts:
+                if (entity.getServerScripts() == ENTITY_ITEM_DEFAULT_SERVER_SCRIPTS) {
+                    return false;
+                }
+                break;
+            case OwningAvatarID:
+                if (entity.getOwningAvatarID() != term.uuid) {
+                    return false;
+                }
+                break;
+            case Type:
+                if (entity.getType() != term.entityType) {
+                    return false;
+                }
+                break;
+            case Locked:
+                if (entity.getLocked() != term.flag) {
+                    return false;
+                }
+                break;
+            case Visible:
+                if (entity.getVisible() != term.flag) {
+                    return false;
+                }
+                break;
+            case UserDataKey:
+                if (!haveUserDataKeys) {
+                    // only parse the userData once, no matter how many keys we're asked about
+                    entityUserDataKeys = userDataKeys(entity.getUserData());
+                    haveUserDataKeys = true;
+                }
+                if (!entityUserDataKeys.contains(term.key)) {
+                    return false;
+                }
+                break;
+        }
+    }
+
+    return true;
+}
+
+QStringList EntityQueryFilter::userDataKeys(const QString& userData) {
+    if (userData.isEmpty()) {
+        return QStringList();
+    }
+
+    auto document = QJsonDocument::fromJson(userData.toUtf8());
+    if (!document.isObject()) {
+        return QStringList();
+    }
+
+    return document.object().keys();
+}
@@ -0,0 +1,81 @@
+//
+//  EntityQueryFilter.h
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryFilter_h
+#define hifi_EntityQueryFilter_h
+
+#include <vector>
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QUuid>
+
+#include "EntityTypes.h"
+
+class EntityItem;
+
+// A compiled form of the JSON filter an octree query can carry.
+//
+// The JSON filter is parsed once (when the query parameters change) into a flat list of terms, so that matching
+// an entity is a handful of member comparisons instead of a QJsonObject lookup per property per entity.
+// All terms must match for an entity to match. Unrecognized properties are ignored, as they always have been.
+//
+// Supported filter properties:
+//      "serverScripts": "+"             entity has a non-default serverScripts value
+//      "owningAvatarID": "<uuid>"       entity is an avatar entity owned by the given avatar
+//      "type": "Model"                  entity is of the given type
+//      "locked": true|false             entity locked state
+//      "visible": true|false            entity visible state
+//      "userDataKeys": ["a", "b"]       entity userData is a JSON object containing all of the given top-level keys
+class EntityQueryFilter {
+public:
+    enum TermType {
+        NonDefaultServerScripts,
+        OwningAvatarID,
+        Type,
+        Locked,
+        Visible,
+        UserDataKey
+    };
+
+    struct Term {
+        TermType type;
+        QUuid uuid;
+        EntityTypes::EntityType entityType { EntityTypes::Unknown };
+        bool flag { false };
+        QString key;
+    };
+
+    EntityQueryFilter() {}
+    explicit EntityQueryFilter(const QJsonObject& jsonFilters);
+
+    const QJsonObject& getJSONFilters() const { return _jsonFilters; }
+
+    // true if this filter has no terms and therefore matches every entity
+    bool isEmpty() const { return _terms.empty(); }
+
+    // true if at least one term can be answered by the EntityQueryIndex, so that the candidate set can be found without
+    // traversing the octree
+    bool isIndexable() const;
+
+    const std::vector<Term>& getTerms() const { return _terms; }
+
+    bool matches(const EntityItem& entity) const;
+
+    // returns the top-level keys of a userData JSON object, or an empty list if it isn't one
+    static QStringList userDataKeys(const QString& userData);
+
+private:
+    QJsonObject _jsonFilters;
+    std::vector<Term> _terms;
+};
+
+#endif // hifi_EntityQueryFilter_h
@@ -0,0 +1,190 @@
+//
+//  EntityQueryIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryIndex.h"
+
+#include <algorithm>
+
+#include "EntityItem.h"
+#include "EntityItemPropertiesDefaults.h"
+#include "EntityQueryFilter.h"
+
+void EntityQueryIndex::updateEntity(const EntityItem& entity) {
+    EntityItemID entityID = entity.getEntityItemID();
+
+    IndexedProperties properties;
+    properties.owningAvatarID = entity.getOwningAvatarID();
+    properties.type = entity.getType();
+    properties.locked = entity.getLocked();
+    properties.visible = entity.getVisible();
+    properties.hasServerScripts = entity.getServerScripts() != ENTITY_ITEM_DEFAULT_SERVER_SCRIPTS;
+    properties.userData = entity.getUserData();
+
+    QWriteLocker locker(&_lock);
+
+    auto existing = _indexedEntities.find(entityID);
+    if (existing != _indexedEntities.end()) {
+        // avoid re-parsing the userData JSON for edits that didn't touch it
+        if (existing->userData == properties.userData) {
+            properties.userDataKeys = existing->userDataKeys;
+        } else {
+            properties.userDataKeys = EntityQueryFilter::userDataKeys(properties.userData);
+        }
+        removePostings(entityID, *existing);
+    } else {
+        properties.userDataKeys = EntityQueryFilter::userDataKeys(properties.userData);
+    }
+
+    insertPostings(entityID, properties);
+    _indexedEntities.insert(entityID, properties);
+}
+
+void EntityQueryIndex::removeEntity(const EntityItemID& entityID) {
+    QWriteLocker locker(&_lock);
+
+    auto existing = _indexedEntities.find(entityID);
+    if (existing != _indexedEntities.end()) {
+        removePostings(entityID, *existing);
+        _indexedEntities.erase(existing);
+    }
+}
+
+void EntityQueryIndex::clear() {
+    QWriteLocker locker(&_lock);
+
+    _indexedEntities.clear();
+    _byOwningAvatarID.clear();
+    _byType.clear();
+    _byUserDataKey.clear();
+    _locked.clear();
+    _invisible.clear();
+    _withServerScripts.clear();
+}
+
+int EntityQueryIndex::getIndexedEntityCount() const {
+    QReadLocker locker(&_lock);
+    return _indexedEntities.size();
+}
+
+void EntityQueryIndex::insertPostings(const EntityItemID& entityID, const IndexedProperties& properties) {
+    if (!properties.owningAvatarID.isNull()) {
+        _byOwningAvatarID[properties.owningAvatarID].insert(entityID);
+    }
+
+    _byType[properties.type].insert(entityID);
+
+    foreach(const QString& key, properties.userDataKeys) {
+        _byUserDataKey[key].insert(entityID);
+    }
+
+    if (properties.locked) {
+        _locked.insert(entityID);
+    }
+
+    if (!properties.visible) {
+        _invisible.insert(entityID);
+    }
+
+    if (properties.hasServerScripts) {
+        _withServerScripts.insert(entityID);
+    }
+}
+
+template <typename K>
+static void removeFromPostingList(QHash<K, QSet<EntityItemID>>& index, const K& key, const EntityItemID& entityID) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->remove(entityID);
+        if (it->isEmpty()) {
+            index.erase(it);
+        }
+    }
+}
+
+void EntityQueryIndex::removePostings(const EntityItemID& entityID, const IndexedProperties& properties) {
+    if (!properties.owningAvatarID.isNull()) {
+        removeFromPostingList(_byOwningAvatarID, properties.owningAvatarID, entityID);
+    }
+
+    removeFromPostingList(_byType, (int)properties.type, entityID);
+
+    foreach(const QString& key, properties.userDataKeys) {
+        removeFromPostingList(_byUserDataKey, key, entityID);
+    }
+
+    _locked.remove(entityID);
+    _invisible.remove(entityID);
+    _withServerScripts.remove(entityID);
+}
+
+QVector<EntityItemID> EntityQueryIndex::findCandidates(const EntityQueryFilter& filter) const {
+    static const QSet<EntityItemID> EMPTY_POSTINGS;
+
+    QReadLocker locker(&_lock);
+
+    // collect the posting list for each term we have an index for
+    QVector<const QSet<EntityItemID>*> postings;
+    for (const auto& term : filter.getTerms()) {
+        switch (term.type) {
+            case EntityQueryFilter::NonDefaultServerScripts:
+                postings << &_withServerScripts;
+                break;
+            case EntityQueryFilter::OwningAvatarID: {
+                auto it = _byOwningAvatarID.find(term.uuid);
+                postings << (it != _byOwningAvatarID.end() ? &(*it) : &EMPTY_POSTINGS);
+                break;
+            }
+            case EntityQueryFilter::Type: {
+                auto it = _byType.find(term.entityType);
+                postings << (it != _byType.end() ? &(*it) : &EMPTY_POSTINGS);
+                break;
+            }
+            case EntityQueryFilter::UserDataKey: {
+                auto it = _byUserDataKey.find(term.key);
+                postings << (it != _byUserDataKey.end() ? &(*it) : &EMPTY_POSTINGS);
+                break;
+            }
+            case EntityQueryFilter::Locked:
+                if (term.flag) {
+                    postings << &_locked;
+                }
+                break;
+            case EntityQueryFilter::Visible:
+                if (!term.flag) {
+                    postings << &_invisible;
+                }
+                break;
+        }
+    }
+
+    QVector<EntityItemID> candidates;
+    if (postings.isEmpty()) {
+        return candidates;
+    }
+
+    // walk the smallest posting list and keep the IDs that appear in all of the others
+    std::sort(postings.begin(), postings.end(), [](const QSet<EntityItemID>* a, const QSet<EntityItemID>* b) {
+        return a->size() < b->size();
+    });
+
+    const QSet<EntityItemID>& smallest = *postings.first();
+    candidates.reserve(smallest.size());
+    foreach(const EntityItemID& entityID, smallest) {
+        bool inAll = true;
+        for (int i = 1; i < postings.size() && inAll; ++i) {
+            inAll = postings[i]->contains(entityID);
+        }
+        if (inAll) {
+            candidates << entityID;
+        }
+    }
+
+    return candidates;
+}
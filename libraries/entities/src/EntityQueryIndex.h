@@ -0,0 +1,67 @@
+//
+//  EntityQueryIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryIndex_h
+#define hifi_EntityQueryIndex_h
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include "EntityItemID.h"
+#include "EntityTypes.h"
+
+class EntityQueryFilter;
+
+// Secondary indexes over the properties a filtered octree query most commonly asks about.
+//
+// The entity server keeps this up to date as entities are added, edited and deleted, so that a filtered query
+// (bots, agent scripts, the entity script server) can find the handful of entities it cares about without walking
+// the whole octree. Boolean properties are only indexed on their rare side (locked, invisible).
+class EntityQueryIndex {
+public:
+    void updateEntity(const EntityItem& entity);
+    void removeEntity(const EntityItemID& entityID);
+    void clear();
+
+    // returns the IDs of entities that may match the filter, which is always a superset of the actual matches
+    // the caller must still check each candidate against EntityQueryFilter::matches
+    QVector<EntityItemID> findCandidates(const EntityQueryFilter& filter) const;
+
+    int getIndexedEntityCount() const;
+
+private:
+    struct IndexedProperties {
+        QUuid owningAvatarID;
+        EntityTypes::EntityType type { EntityTypes::Unknown };
+        bool locked { false };
+        bool visible { true };
+        bool hasServerScripts { false };
+        QString userData;
+        QStringList userDataKeys;
+    };
+
+    void insertPostings(const EntityItemID& entityID, const IndexedProperties& properties);
+    void removePostings(const EntityItemID& entityID, const IndexedProperties& properties);
+
+    mutable QReadWriteLock _lock;
+    QHash<EntityItemID, IndexedProperties> _indexedEntities;
+
+    QHash<QUuid, QSet<EntityItemID>> _byOwningAvatarID;
+    QHash<int, QSet<EntityItemID>> _byType;
+    QHash<QString, QSet<EntityItemID>> _byUserDataKey;
+    QSet<EntityItemID> _locked;
+    QSet<EntityItemID> _invisible;
+    QSet<EntityItemID> _withServerScripts;
+};
+
+#endif // hifi_EntityQueryIndex_h
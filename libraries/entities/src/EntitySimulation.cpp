@@ -167,6 +167,11 @@ void EntitySimulation::sortEntitiesThatMoved() {
         _entityTree->recurseTreeWithOperator(&moveOperator);
     }
 
+    // entities the server simulates can leave this shard's part of the tree as well as edited ones
+    for (auto& entity : _entitiesToSort) {
+        _entityTree->checkEntityShard(entity);
+    }
+
     _entitiesToSort.clear();
 }
 
@@ -26,6 +26,7 @@
 #include <Extents.h>
 #include <PerfStat.h>
 #include <Profile.h>
+#include <RegisteredMetaTypes.h>
 
 #include "EntitySimulation.h"
 #include "VariantMapToScriptValue.h"
@@ -100,6 +101,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     }
     QHash<EntityItemID, EntityItemPointer> localMap;
     localMap.swap(_entityMap);
+    _queryIndex.clear();
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
@@ -333,6 +335,9 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                 recurseTreeWithOperator(&theOperator);
                 if (entity->setProperties(tempProperties)) {
                     emit editingEntityPointer(entity);
+                    if (getIsServer()) {
+                        _queryIndex.updateEntity(*entity);
+                    }
                 }
                 _isDirty = true;
             }
@@ -410,8 +415,13 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
         recurseTreeWithOperator(&theOperator);
         if (entity->setProperties(properties)) {
             emit editingEntityPointer(entity);
+            if (getIsServer()) {
+                _queryIndex.updateEntity(*entity);
+            }
         }
 
+        checkEntityShard(entity);
+
         // if the entity has children, run UpdateEntityOperator on them.  If the children have children, recurse
         QQueue<SpatiallyNestablePointer> toProcess;
         foreach (SpatiallyNestablePointer child, entity->getChildren()) {
@@ -657,6 +667,48 @@ void EntityTree::deleteEntities(QSet<EntityItemID> entityIDs, bool force, bool i
     }
 }
 
+void EntityTree::handOffEntity(const EntityItemID& entityID) {
+    // NOTE: callers must lock the tree before using this method
+    _isHandingOffEntities = true;
+    deleteEntity(entityID, true, true);
+    _isHandingOffEntities = false;
+}
+
+void EntityTree::deleteEntitiesFromServer(const QUuid& serverID) {
+    // NOTE: callers must lock the tree before using this method
+    QSet<EntityItemID> entityIDs;
+    {
+        QReadLocker locker(&_entityMapLock);
+        foreach (const EntityItemPointer& entity, _entityMap) {
+            if (!entity->getClientOnly() && entity->matchesSourceUUID(serverID)) {
+                entityIDs << entity->getEntityItemID();
+            }
+        }
+    }
+    deleteEntities(entityIDs, true, true);
+}
+
+void EntityTree::checkEntityShard(const EntityItemPointer& entity) {
+    if (_shard.isSharded() && entity->getParentID().isNull() && !_shard.ownsPosition(entity->getWorldPosition())) {
+        // this entity moved into a part of the tree owned by another shard of the domain
+        emit entityLeftShard(entity);
+    }
+}
+
+bool EntityTree::shardOwnsNewEntity(const EntityItemProperties& properties) {
+    QUuid parentID = properties.getParentID();
+    if (parentID.isNull()) {
+        return _shard.ownsPosition(properties.getPosition());
+    }
+
+    if (_avatarIDs.contains(parentID)) {
+        return _shard.ownsAvatarChild(parentID);
+    }
+
+    // entity children stay with their parent - if we don't have the parent, the shard that does will take this one
+    return (bool)findEntityByID(parentID);
+}
+
 void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator) {
     quint64 deletedAt = usecTimestampNow();
     const RemovedEntities& entities = theOperator.getEntities();
@@ -684,9 +736,12 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
                 }
             }
 
-            // set up the deleted entities ID
-            QWriteLocker recentlyDeletedEntitiesLocker(&_recentlyDeletedEntitiesLock);
-            _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            // set up the deleted entities ID - unless it was handed off to another shard, in which case
+            // clients keep it and start hearing about it from that shard instead
+            if (!_isHandingOffEntities) {
+                QWriteLocker recentlyDeletedEntitiesLocker(&_recentlyDeletedEntitiesLock);
+                _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            }
         } else {
             // on the client side, we also remember that we deleted this entity, we don't care about the time
             trackDeletedEntity(theEntity->getEntityItemID());
@@ -1425,6 +1480,11 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                                                                                 entityItemID, properties);
             endDecode = usecTimestampNow();
 
+            if (isAdd && validEditPacket && _shard.isSharded() && !shardOwnsNewEntity(properties)) {
+                // every shard of the domain is sent this add, and it belongs in a part of the tree another one owns
+                return processedBytes;
+            }
+
             EntityItemPointer existingEntity;
             if (!isAdd) {
                 // search for the entity by EntityItemID
@@ -1962,6 +2022,53 @@ EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& en
     return EntityTreeElementPointer(nullptr);
 }
 
+QVector<QByteArray> EntityTree::getCompressionDictionarySamples() const {
+    QVector<EntityItemPointer> entities;
+    {
+        QReadLocker locker(&_entityMapLock);
+        entities.reserve(_entityMap.size());
+        foreach(const EntityItemPointer& entity, _entityMap) {
+            entities << entity;
+        }
+    }
+
+    EntityPropertyFlags desiredProperties;
+    desiredProperties += PROP_NAME;
+    desiredProperties += PROP_MODEL_URL;
+    desiredProperties += PROP_COMPOUND_SHAPE_URL;
+    desiredProperties += PROP_TEXTURES;
+    desiredProperties += PROP_SCRIPT;
+    desiredProperties += PROP_SERVER_SCRIPTS;
+    desiredProperties += PROP_USER_DATA;
+    desiredProperties += PROP_COLLISION_SOUND_URL;
+    desiredProperties += PROP_MARKETPLACE_ID;
+
+    QVector<QByteArray> samples;
+    samples.reserve(entities.size() * 4);
+
+    auto addSample = [&samples](const QString& value) {
+        if (!value.isEmpty()) {
+            samples << value.toUtf8();
+        }
+    };
+
+    for (const auto& entity : entities) {
+        EntityItemProperties properties = entity->getProperties(desiredProperties);
+        addSample(properties.getName());
+        addSample(properties.getModelURL());
+        addSample(properties.getSourceUrl());
+        addSample(properties.getCompoundShapeURL());
+        addSample(properties.getTextures());
+        addSample(properties.getScript());
+        addSample(properties.getServerScripts());
+        addSample(properties.getUserData());
+        addSample(properties.getCollisionSoundURL());
+        addSample(properties.getMarketplaceID());
+    }
+
+    return samples;
+}
+
 void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
     EntityItemID id = entity->getEntityItemID();
     QWriteLocker locker(&_entityMapLock);
@@ -1972,11 +2079,19 @@ void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
         return;
     }
     _entityMap.insert(id, entity);
+
+    if (getIsServer()) {
+        _queryIndex.updateEntity(*entity);
+    }
 }
 
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
     QWriteLocker locker(&_entityMapLock);
     _entityMap.remove(id);
+
+    if (getIsServer()) {
+        _queryIndex.removeEntity(id);
+    }
 }
 
 void EntityTree::debugDumpMap() {
@@ -2244,6 +2359,37 @@ bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer
     return true;
 }
 
+QSet<QUuid> EntityTree::findOtherShardEntityIDs(const QVariantList& entitiesQList) const {
+    QHash<QUuid, QUuid> parentIDs;
+    QHash<QUuid, glm::vec3> positions;
+    foreach (const QVariant& entityVariant, entitiesQList) {
+        QVariantMap entityMap = entityVariant.toMap();
+        QUuid entityID = QUuid(entityMap["id"].toString());
+        parentIDs[entityID] = QUuid(entityMap["parentID"].toString());
+        positions[entityID] = vec3FromVariant(entityMap["position"]);
+    }
+
+    QSet<QUuid> otherShardEntityIDs;
+    for (auto it = parentIDs.constBegin(); it != parentIDs.constEnd(); ++it) {
+        // walk up to the root of this entity's hierarchy (guarding against parent loops in bad content)
+        QUuid rootID = it.key();
+        int depth = 0;
+        while (!parentIDs.value(rootID).isNull() && parentIDs.contains(parentIDs.value(rootID)) &&
+               depth++ < (int)parentIDs.size()) {
+            rootID = parentIDs.value(rootID);
+        }
+
+        QUuid rootParentID = parentIDs.value(rootID);
+        bool isOurs = rootParentID.isNull() ?
+            _shard.ownsPosition(positions.value(rootID)) : _shard.ownsAvatarChild(rootParentID);
+        if (!isOurs) {
+            otherShardEntityIDs.insert(it.key());
+        }
+    }
+
+    return otherShardEntityIDs;
+}
+
 bool EntityTree::readFromMap(QVariantMap& map) {
     // These are needed to deal with older content (before adding inheritance modes)
     int contentVersion = map["Version"].toInt();
@@ -2261,11 +2407,22 @@ bool EntityTree::readFromMap(QVariantMap& map) {
         return false;
     }
 
+    // when this tree is one shard of the domain, the file may hold entities for the whole domain (the first time a
+    // domain is sharded, every shard starts from the same file) - so figure out which ones are ours up front
+    QSet<QUuid> otherShardEntityIDs;
+    if (_shard.isSharded()) {
+        otherShardEntityIDs = findOtherShardEntityIDs(entitiesQList);
+    }
+
     bool success = true;
     foreach (QVariant entityVariant, entitiesQList) {
         // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
         QVariantMap entityMap = entityVariant.toMap();
 
+        if (!otherShardEntityIDs.isEmpty() && otherShardEntityIDs.contains(QUuid(entityMap["id"].toString()))) {
+            continue;
+        }
+
         // handle parentJointName for wearables
         if (_myAvatar && entityMap.contains("parentJointName") && entityMap.contains("parentID") &&
             QUuid(entityMap["parentID"].toString()) == AVATAR_SELF_ID) {
@@ -25,6 +25,8 @@ using EntityTreePointer = std::shared_ptr<EntityTree>;
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
 #include "MovingEntitiesOperator.h"
+#include "EntityQueryIndex.h"
+#include "EntityTreeShard.h"
 
 class EntityEditFilters;
 class Model;
@@ -68,6 +70,12 @@ public:
     void setEntityMaxTmpLifetime(float maxTmpEntityLifetime) { _maxTmpEntityLifetime = maxTmpEntityLifetime; }
     void setEntityScriptSourceWhitelist(const QString& entityScriptSourceWhitelist);
 
+    // when the domain runs several entity-servers, the part of the tree this one owns
+    void setShard(const EntityTreeShard& shard) { _shard = shard; }
+    const EntityTreeShard& getShard() const { return _shard; }
+    // emits entityLeftShard if the entity has moved into a part of the tree another shard owns
+    void checkEntityShard(const EntityItemPointer& entity);
+
     /// Implements our type specific root element factory
     virtual OctreeElementPointer createNewElement(unsigned char* octalCode = NULL) override;
 
@@ -129,6 +137,12 @@ public:
     void deleteEntity(const EntityItemID& entityID, bool force = false, bool ignoreWarnings = true);
     void deleteEntities(QSet<EntityItemID> entityIDs, bool force = false, bool ignoreWarnings = true);
 
+    // removes an entity (and its descendants) that another shard has taken over, without telling clients it was deleted
+    void handOffEntity(const EntityItemID& entityID);
+
+    // removes the entities one entity server sent us, for when that server goes away while others of the domain stay
+    void deleteEntitiesFromServer(const QUuid& serverID);
+
     /// \param position point of query in world-frame (meters)
     /// \param targetRadius radius of query (meters)
     EntityItemPointer findClosestEntity(const glm::vec3& position, float targetRadius);
@@ -198,6 +212,14 @@ public:
     void addEntityMapEntry(EntityItemPointer entity);
     void clearEntityMapEntry(const EntityItemID& id);
     void debugDumpMap();
+
+    // secondary property indexes for filtered octree queries - only maintained in server trees
+    const EntityQueryIndex& getQueryIndex() const { return _queryIndex; }
+
+    // the values of the string properties that tend to repeat across a scene (URLs, scripts, userData), one per entity
+    // property, used by the server to train the compression dictionary it shares with its clients
+    QVector<QByteArray> getCompressionDictionarySamples() const;
+
     virtual void dumpTree() override;
     virtual void pruneTree() override;
 
@@ -290,6 +312,7 @@ signals:
     void newCollisionSoundURL(const QUrl& url, const EntityItemID& entityID);
     void clearingEntities();
     void killChallengeOwnershipTimeoutTimer(const QString& certID);
+    void entityLeftShard(const EntityItemPointer& entity);
 
 protected:
 
@@ -307,6 +330,8 @@ protected:
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
     bool isScriptInWhitelist(const QString& scriptURL);
+    bool shardOwnsNewEntity(const EntityItemProperties& properties);
+    QSet<QUuid> findOtherShardEntityIDs(const QVariantList& entitiesQList) const;
     
     QReadWriteLock _newlyCreatedHooksLock;
     QVector<NewlyCreatedEntityHook*> _newlyCreatedHooks;
@@ -330,6 +355,11 @@ protected:
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
 
+    EntityQueryIndex _queryIndex;
+
+    EntityTreeShard _shard;
+    bool _isHandingOffEntities { false };
+
     mutable QReadWriteLock _entityCertificateIDMapLock;
     QHash<QString, EntityItemID> _entityCertificateIDMap;
 
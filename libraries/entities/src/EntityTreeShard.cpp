@@ -0,0 +1,56 @@
+//
+//  EntityTreeShard.cpp
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeShard.h"
+
+#include <QHash>
+
+#include "EntitiesLogging.h"
+
+EntityTreeShard::EntityTreeShard(int shardIndex, int shardCount) {
+    if (shardCount < 1 || shardCount > MAX_SHARD_COUNT) {
+        qCWarning(entities) << "Invalid entity-server shard count" << shardCount << "- must be between 1 and" << MAX_SHARD_COUNT;
+        shardCount = glm::clamp(shardCount, 1, MAX_SHARD_COUNT);
+    }
+
+    if (shardIndex < 0 || shardIndex >= shardCount) {
+        qCWarning(entities) << "Invalid entity-server shard index" << shardIndex << "for" << shardCount << "shards";
+        shardIndex = glm::clamp(shardIndex, 0, shardCount - 1);
+    }
+
+    _shardIndex = shardIndex;
+    _shardCount = shardCount;
+}
+
+int EntityTreeShard::shardForPosition(const glm::vec3& position) const {
+    // the root element is centered on the origin, so the sign of each component picks the top-level octant
+    int octant = (position.x >= 0.0f ? 4 : 0) | (position.y >= 0.0f ? 2 : 0) | (position.z >= 0.0f ? 1 : 0);
+    return octant % _shardCount;
+}
+
+int EntityTreeShard::shardForAvatarID(const QUuid& avatarID) const {
+    return (int)(qHash(avatarID) % (uint)_shardCount);
+}
+
+QString EntityTreeShard::shardPersistFilePath(const QString& persistFilePath) const {
+    if (!isSharded()) {
+        return persistFilePath;
+    }
+
+    static const QString ENTITY_PERSIST_EXTENSION = ".json.gz";
+    QString shardSuffix = QString(".shard-%1-of-%2").arg(_shardIndex + 1).arg(_shardCount);
+
+    if (persistFilePath.endsWith(ENTITY_PERSIST_EXTENSION, Qt::CaseInsensitive)) {
+        QString basePath = persistFilePath.left(persistFilePath.length() - ENTITY_PERSIST_EXTENSION.length());
+        return basePath + shardSuffix + ENTITY_PERSIST_EXTENSION;
+    } else {
+        return persistFilePath + shardSuffix;
+    }
+}
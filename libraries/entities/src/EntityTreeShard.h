@@ -0,0 +1,52 @@
+//
+//  EntityTreeShard.h
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeShard_h
+#define hifi_EntityTreeShard_h
+
+#include <glm/glm.hpp>
+
+#include <QString>
+#include <QUuid>
+
+#include <OctreeConstants.h>
+
+// Describes which part of the domain's octree an entity-server owns when the domain runs several entity-servers.
+//
+// The top-level octants of the tree are dealt out round-robin to the shards, so a domain can have at most one shard per
+// octant. An entity without a parent belongs to the shard owning the octant its position is in. An entity parented to an
+// avatar belongs to a shard picked from the avatar ID. An entity parented to another entity stays with its parent.
+class EntityTreeShard {
+public:
+    static const int MAX_SHARD_COUNT = NUMBER_OF_CHILDREN;
+
+    EntityTreeShard() {}
+    EntityTreeShard(int shardIndex, int shardCount);
+
+    bool isSharded() const { return _shardCount > 1; }
+    int getShardIndex() const { return _shardIndex; }
+    int getShardCount() const { return _shardCount; }
+
+    int shardForPosition(const glm::vec3& position) const;
+    int shardForAvatarID(const QUuid& avatarID) const;
+
+    bool ownsPosition(const glm::vec3& position) const { return shardForPosition(position) == _shardIndex; }
+    bool ownsAvatarChild(const QUuid& avatarID) const { return shardForAvatarID(avatarID) == _shardIndex; }
+
+    // returns the persist file path this shard should use given the path configured for the whole domain,
+    // so that models.json.gz becomes models.shard-1-of-4.json.gz
+    QString shardPersistFilePath(const QString& persistFilePath) const;
+
+private:
+    int _shardIndex { 0 };
+    int _shardCount { 1 };
+};
+
+#endif // hifi_EntityTreeShard_h
@@ -30,6 +30,7 @@
 #include <OctalCode.h>
 #include <gpu/Format.h>
 #include <LogHandler.h>
+#include <TBBHelpers.h>
 
 #include "FBXReader.h"
 #include "ModelFormatLogging.h"
@@ -689,6 +690,15 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
     QString hifiGlobalNodeID;
     unsigned int meshIndex = 0;
     haveReportedUnhandledRotationOrder = false;
+
+    // the meshes don't depend on anything else in the file, so they are extracted together after the other objects
+    struct PendingMesh {
+        QString id;
+        const FBXNode* object;
+        unsigned int meshIndex;
+        ExtractedMesh extracted;
+    };
+    std::vector<PendingMesh> pendingMeshes;
     foreach (const FBXNode& child, node.children) {
 
         if (child.name == "FBXHeaderExtension") {
@@ -736,7 +746,8 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
             foreach (const FBXNode& object, child.children) {
                 if (object.name == "Geometry") {
                     if (object.properties.at(2) == "Mesh") {
-                        meshes.insert(getID(object.properties), extractMesh(object, meshIndex));
+                        // number it now so the meshes keep the order they appear in the file
+                        pendingMeshes.push_back({ getID(object.properties), &object, meshIndex++, ExtractedMesh() });
                     } else { // object.properties.at(2) == "Shape"
                         ExtractedBlendshape extracted = { getID(object.properties), extractBlendshape(object) };
                         blendshapes.append(extracted);
@@ -1426,6 +1437,17 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
 #endif
     }
 
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pendingMeshes.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+        for (auto i = range.begin(); i != range.end(); ++i) {
+            auto& pending = pendingMeshes[i];
+            pending.extracted = extractMesh(*pending.object, pending.meshIndex);
+        }
+    });
+    for (auto& pending : pendingMeshes) {
+        meshes.insert(pending.id, pending.extracted);
+    }
+    pendingMeshes.clear();
+
     // TODO: check if is code is needed
     if (!lights.empty()) {
         if (hifiGlobalNodeID.isEmpty()) {
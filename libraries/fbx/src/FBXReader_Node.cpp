@@ -11,9 +11,9 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
 #include <iostream>
 #include <QtCore/QBuffer>
-#include <QtCore/QDataStream>
 #include <QtCore/QIODevice>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
@@ -21,183 +21,159 @@
 #include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
+#include <zlib.h>
+
 #include <shared/NsightHelpers.h>
 #include "ModelFormatLogging.h"
 
-template<class T>
-int streamSize() {
-    return sizeof(T);
-}
+// Reads a binary FBX out of memory, in order: the values are taken from the data as they are reached and the arrays
+// are copied (or inflated) straight into the vectors that hold them, with nothing read through a stream in between.
+class BinaryFBXReader {
+public:
+    BinaryFBXReader(const char* begin, const char* end) : _begin(begin), _next(begin), _end(end) { }
 
-template<bool>
-int streamSize() {
-    return 1;
-}
+    void setHas64BitPositions(bool has64BitPositions) { _has64BitPositions = has64BitPositions; }
 
-template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
+    bool atEnd() const { return _next >= _end; }
+    qint64 getPosition() const { return _next - _begin; }
 
-    in >> arrayLength;
-    in >> encoding;
-    in >> compressedLength;
-    position += sizeof(quint32) * 3;
+    void skip(size_t size) { take(size); }
 
-    QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        QByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
+    template<class T>
+    T read() {
+        T value;
+        memcpy(&value, take(sizeof(T)), sizeof(T));
+        fromLittleEndian(&value, 1);
+        return value;
+    }
+
+    FBXNode parseNode();
+    QVariant parseProperty();
+
+private:
+    // answers where the next size bytes are and moves past them
+    const char* take(size_t size) {
+        if ((size_t)(_end - _next) < size) {
+            throw QString("corrupt fbx file");
         }
+        const char* data = _next;
+        _next += size;
+        return data;
+    }
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
+    template<class T>
+    static void fromLittleEndian(T* values, size_t count) {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        for (size_t i = 0; i < count; i++) {
+            char* bytes = reinterpret_cast<char*>(values + i);
+            std::reverse(bytes, bytes + sizeof(T));
         }
-    } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            QByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
+#else
+        Q_UNUSED(values);
+        Q_UNUSED(count);
+#endif
+    }
+
+    template<class T>
+    QVariant readArray();
+
+    const char* _begin;
+    const char* _next;
+    const char* _end;
+    bool _has64BitPositions { false };
+};
+
+template<class T>
+QVariant BinaryFBXReader::readArray() {
+    quint32 arrayLength = read<quint32>();
+    quint32 encoding = read<quint32>();
+    quint32 compressedLength = read<quint32>();
+
+    QVector<T> values;
+    uLongf size = (uLongf)sizeof(T) * arrayLength;
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        const char* compressed = take(compressedLength);
+
+        // deflate can't do better than about 1:1032, anything more is a corrupt length we shouldn't allocate for
+        const quint64 MAX_DEFLATE_RATIO = 1032;
+        if ((quint64)size > (quint64)compressedLength * MAX_DEFLATE_RATIO) {
+            throw QString("corrupt fbx file");
+        }
+        if (arrayLength > 0) {
+            values.resize(arrayLength);
+            uLongf uncompressedSize = size;
+            if (uncompress(reinterpret_cast<Bytef*>(values.data()), &uncompressedSize,
+                           reinterpret_cast<const Bytef*>(compressed), compressedLength) != Z_OK ||
+                uncompressedSize != size) {
                 throw QString("corrupt fbx file");
             }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
+        }
+    } else {
+        const char* data = take(size);
+        if (arrayLength > 0) {
+            values.resize(arrayLength);
+            memcpy(values.data(), data, size);
         }
     }
+    fromLittleEndian(values.data(), values.size());
+
     return QVariant::fromValue(values);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+QVariant BinaryFBXReader::parseProperty() {
+    char ch = read<char>();
     switch (ch) {
-        case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
-        }
-        case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
-        }
-        case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
-        }
-        case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
-        }
-        case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
-        }
-        case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
-        }
-        case 'f': {
-            return readBinaryArray<float>(in, position);
-        }
-        case 'd': {
-            return readBinaryArray<double>(in, position);
-        }
-        case 'l': {
-            return readBinaryArray<qint64>(in, position);
-        }
-        case 'i': {
-            return readBinaryArray<qint32>(in, position);
-        }
-        case 'b': {
-            return readBinaryArray<bool>(in, position);
-        }
+        case 'Y':
+            return QVariant::fromValue(read<qint16>());
+        case 'C':
+            return QVariant::fromValue(read<quint8>() != 0);
+        case 'I':
+            return QVariant::fromValue(read<qint32>());
+        case 'F':
+            return QVariant::fromValue(read<float>());
+        case 'D':
+            return QVariant::fromValue(read<double>());
+        case 'L':
+            return QVariant::fromValue(read<qint64>());
+        case 'f':
+            return readArray<float>();
+        case 'd':
+            return readArray<double>();
+        case 'l':
+            return readArray<qint64>();
+        case 'i':
+            return readArray<qint32>();
+        case 'b':
+            return readArray<bool>();
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            quint32 length = read<quint32>();
+            return QVariant::fromValue(QByteArray(take(length), length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode BinaryFBXReader::parseNode() {
     qint64 endOffset;
     quint64 propertyCount;
     quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
     // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
-    if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+    // from here on out, but if the file is an older format we read the 32bit values and widen them.
+    if (_has64BitPositions) {
+        endOffset = read<qint64>();
+        propertyCount = read<quint64>();
+        propertyListLength = read<quint64>();
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = read<qint32>();
+        propertyCount = read<quint32>();
+        propertyListLength = read<quint32>();
+    }
+    Q_UNUSED(propertyListLength);
+    quint8 nameLength = read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -205,15 +181,16 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = QByteArray(take(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    // every property takes at least a byte, so a count beyond what is left is corrupt and not worth reserving for
+    node.properties.reserve((int)std::min<quint64>(propertyCount, _end - _next));
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseProperty());
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (endOffset > getPosition()) {
+        FBXNode child = parseNode();
         if (child.name.isNull()) {
             return node;
 
@@ -366,9 +343,16 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
+    // read the whole file in one go, or use the data of a buffer where it is
+    QByteArray data;
+    qint64 offset = 0;
+    if (auto buffer = qobject_cast<QBuffer*>(device)) {
+        data = buffer->data();
+        offset = buffer->pos();
+    } else {
+        data = device->readAll();
+    }
+    BinaryFBXReader reader(data.constData() + offset, data.constData() + data.size());
 
     // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
     // of the FBX binary format
@@ -377,18 +361,15 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
     //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
     //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
     //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
+    reader.skip(FBX_HEADER_BYTES_BEFORE_VERSION);
+    quint32 fileVersion = reader.read<quint32>();
     qCDebug(modelformat) << "fileVersion:" << fileVersion;
-    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+    reader.setHas64BitPositions(fileVersion >= FBX_VERSION_2016);
 
     // parse the top-level node
     FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (!reader.atEnd()) {
+        FBXNode next = reader.parseNode();
         if (next.name.isNull()) {
             return top;
 
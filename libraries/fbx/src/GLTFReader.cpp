@@ -9,6 +9,11 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
 #include <QtCore/QBuffer>
 #include <QtCore/QIODevice>
 #include <QtCore/QEventLoop>
@@ -18,6 +23,7 @@
 #include <QtCore/qjsonvalue.h>
 #include <QtCore/qpair.h>
 #include <QtCore/qlist.h>
+#include <QtCore/QtEndian>
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkRequest>
@@ -27,6 +33,7 @@
 #include <shared/NsightHelpers.h>
 #include <NetworkAccessManager.h>
 #include <ResourceManager.h>
+#include <TBBHelpers.h>
 
 #include "GLTFReader.h"
 #include "FBXReader.h"
@@ -250,6 +257,23 @@ bool GLTFReader::addAccessor(const QJsonObject& object) {
     getDoubleArrayVal(object, "max", accessor.max, accessor.defined);
     getDoubleArrayVal(object, "min", accessor.min, accessor.defined);
 
+    QJsonObject jsSparse;
+    if (getObjectVal(object, "sparse", jsSparse, accessor.defined)) {
+        GLTFAccessorSparse& sparse = accessor.sparse;
+        getIntVal(jsSparse, "count", sparse.count, sparse.defined);
+        QJsonObject jsIndices;
+        if (getObjectVal(jsSparse, "indices", jsIndices, sparse.defined)) {
+            getIntVal(jsIndices, "bufferView", sparse.indices.bufferView, sparse.indices.defined);
+            getIntVal(jsIndices, "byteOffset", sparse.indices.byteOffset, sparse.indices.defined);
+            getIntVal(jsIndices, "componentType", sparse.indices.componentType, sparse.indices.defined);
+        }
+        QJsonObject jsValues;
+        if (getObjectVal(jsSparse, "values", jsValues, sparse.defined)) {
+            getIntVal(jsValues, "bufferView", sparse.values.bufferView, sparse.values.defined);
+            getIntVal(jsValues, "byteOffset", sparse.values.byteOffset, sparse.values.defined);
+        }
+    }
+
     _file.accessors.push_back(accessor);
 
     return true;
@@ -299,6 +323,7 @@ bool GLTFReader::addBufferView(const QJsonObject& object) {
     getIntVal(object, "buffer", bufferview.buffer, bufferview.defined);
     getIntVal(object, "byteLength", bufferview.byteLength, bufferview.defined);
     getIntVal(object, "byteOffset", bufferview.byteOffset, bufferview.defined);
+    getIntVal(object, "byteStride", bufferview.byteStride, bufferview.defined);
     getIntVal(object, "target", bufferview.target, bufferview.defined);
     
     _file.bufferviews.push_back(bufferview);
@@ -314,6 +339,10 @@ bool GLTFReader::addBuffer(const QJsonObject& object) {
         if (!readBinary(buffer.uri, buffer.blob)) {
             return false;
         }
+    } else if (_file.buffers.isEmpty() && !_glbBinaryChunk.isNull()) {
+        // the first buffer of a binary glTF has no uri, it is the binary chunk and is read where it is
+        buffer.blob = _glbBinaryChunk;
+        buffer.defined["blob"] = true;
     }
     _file.buffers.push_back(buffer);
     
@@ -529,10 +558,62 @@ bool GLTFReader::addTexture(const QJsonObject& object) {
     return true;
 }
 
+bool GLTFReader::readGLB(const QByteArray& model, QByteArray& json, QByteArray& binary) {
+    // A binary glTF is a header (the magic, the version and the length of the file) and chunks, each a length, a type
+    // and the data: the JSON of the file comes first, then the buffer, if there is one.
+    static const int GLB_HEADER_SIZE = 12;
+    static const int GLB_CHUNK_HEADER_SIZE = 8;
+    static const quint32 GLB_VERSION = 2;
+    static const quint32 GLB_CHUNK_JSON = 0x4E4F534A;
+    static const quint32 GLB_CHUNK_BIN = 0x004E4942;
+
+    auto readUInt32 = [&](int offset) {
+        return qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(model.constData() + offset));
+    };
+
+    if (model.size() < GLB_HEADER_SIZE || readUInt32(4) != GLB_VERSION) {
+        qCWarning(modelformat) << "Unsupported binary GLTF version";
+        return false;
+    }
+    qint64 length = std::min<qint64>(readUInt32(8), model.size());
+
+    qint64 offset = GLB_HEADER_SIZE;
+    while (offset + GLB_CHUNK_HEADER_SIZE <= length) {
+        qint64 chunkLength = readUInt32(offset);
+        quint32 chunkType = readUInt32(offset + 4);
+        offset += GLB_CHUNK_HEADER_SIZE;
+        if (offset + chunkLength > length) {
+            qCWarning(modelformat) << "Binary GLTF chunk runs past the end of the file";
+            return false;
+        }
+
+        // the chunks are used where they are, model is kept for as long as they are needed
+        if (chunkType == GLB_CHUNK_JSON && json.isNull()) {
+            json = QByteArray::fromRawData(model.constData() + offset, (int)chunkLength);
+        } else if (chunkType == GLB_CHUNK_BIN && binary.isNull()) {
+            binary = QByteArray::fromRawData(model.constData() + offset, (int)chunkLength);
+        }
+        offset += chunkLength;
+    }
+
+    return !json.isNull();
+}
+
 bool GLTFReader::parseGLTF(const QByteArray& model) {
     PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xffff0000, nullptr);
-    
-    QJsonDocument d = QJsonDocument::fromJson(model);
+
+    static const QByteArray GLB_MAGIC = "glTF";
+    QByteArray json = model;
+    if (model.startsWith(GLB_MAGIC)) {
+        _glbData = model;
+        json = QByteArray();
+        if (!readGLB(_glbData, json, _glbBinaryChunk)) {
+            qCDebug(modelformat) << "Error parsing binary GLTF file.";
+            return false;
+        }
+    }
+
+    QJsonDocument d = QJsonDocument::fromJson(json);
     QJsonObject jsFile = d.object();
 
     bool isvalid = setAsset(jsFile);
@@ -773,80 +854,35 @@ bool GLTFReader::buildGeometry(FBXGeometry& geometry, const QUrl& url) {
 
                 FBXMeshPart part = FBXMeshPart();
 
-                int indicesAccessorIdx = primitive.indices;
-
-                GLTFAccessor& indicesAccessor = _file.accessors[indicesAccessorIdx];
-                GLTFBufferView& indicesBufferview = _file.bufferviews[indicesAccessor.bufferView];
-                GLTFBuffer& indicesBuffer = _file.buffers[indicesBufferview.buffer];
-
-                int indicesAccBoffset = indicesAccessor.defined["byteOffset"] ? indicesAccessor.byteOffset : 0;
-
-                QVector<int> raw_indices;
-                QVector<glm::vec3> raw_vertices;
-                QVector<glm::vec3> raw_normals;
-
-                addArrayOfType(indicesBuffer.blob, 
-                    indicesBufferview.byteOffset + indicesAccBoffset, 
-                    indicesBufferview.byteLength, 
-                    part.triangleIndices, 
-                    indicesAccessor.type, 
-                    indicesAccessor.componentType);
-
                 QList<QString> keys = primitive.attributes.values.keys();
+                bool isReadable = true;
 
                 foreach(auto &key, keys) {
                     int accessorIdx = primitive.attributes.values[key];
 
-                    GLTFAccessor& accessor = _file.accessors[accessorIdx];
-                    GLTFBufferView& bufferview = _file.bufferviews[accessor.bufferView];
-                    GLTFBuffer& buffer = _file.buffers[bufferview.buffer];
-
-                    int accBoffset = accessor.defined["byteOffset"] ? accessor.byteOffset : 0;
                     if (key == "POSITION") {
-                        QVector<float> vertices;
-                        addArrayOfType(buffer.blob, 
-                            bufferview.byteOffset + accBoffset, 
-                            bufferview.byteLength, vertices, 
-                            accessor.type, 
-                            accessor.componentType);
-                        for (int n = 0; n < vertices.size(); n = n + 3) {
-                            mesh.vertices.push_back(glm::vec3(vertices[n], vertices[n + 1], vertices[n + 2]));
-                        }
+                        isReadable = readAccessor<float>(accessorIdx, mesh.vertices) && isReadable;
                     } else if (key == "NORMAL") {
-                        QVector<float> normals;
-                        addArrayOfType(buffer.blob, 
-                            bufferview.byteOffset + accBoffset, 
-                            bufferview.byteLength, 
-                            normals, 
-                            accessor.type, 
-                            accessor.componentType);
-                        for (int n = 0; n < normals.size(); n = n + 3) {
-                            mesh.normals.push_back(glm::vec3(normals[n], normals[n + 1], normals[n + 2]));
-                        }
+                        isReadable = readAccessor<float>(accessorIdx, mesh.normals) && isReadable;
                     } else if (key == "TEXCOORD_0") {
-                        QVector<float> texcoords;
-                        addArrayOfType(buffer.blob, 
-                            bufferview.byteOffset + accBoffset, 
-                            bufferview.byteLength, 
-                            texcoords, 
-                            accessor.type, 
-                            accessor.componentType);
-                        for (int n = 0; n < texcoords.size(); n = n + 2) {
-                            mesh.texCoords.push_back(glm::vec2(texcoords[n], texcoords[n + 1]));
-                        }
+                        isReadable = readAccessor<float>(accessorIdx, mesh.texCoords) && isReadable;
                     } else if (key == "TEXCOORD_1") {
-                        QVector<float> texcoords;
-                        addArrayOfType(buffer.blob, 
-                            bufferview.byteOffset + accBoffset, 
-                            bufferview.byteLength, 
-                            texcoords, 
-                            accessor.type, 
-                            accessor.componentType);
-                        for (int n = 0; n < texcoords.size(); n = n + 2) {
-                            mesh.texCoords1.push_back(glm::vec2(texcoords[n], texcoords[n + 1]));
-                        }
+                        isReadable = readAccessor<float>(accessorIdx, mesh.texCoords1) && isReadable;
                     }
+                }
 
+                if (primitive.defined["indices"]) {
+                    isReadable = readAccessor<int>(primitive.indices, part.triangleIndices) && isReadable;
+                } else {
+                    // the vertices are drawn in order
+                    part.triangleIndices.resize(mesh.vertices.size());
+                    std::iota(part.triangleIndices.begin(), part.triangleIndices.end(), 0);
+                }
+
+                if (!isReadable) {
+                    qCWarning(modelformat) << "Skipping a primitive of GLTF mesh" << node.mesh << "that can't be read";
+                    geometry.meshes.removeLast();
+                    continue;
                 }
 
                 if (primitive.defined["material"]) {
@@ -1041,150 +1077,210 @@ void GLTFReader::setFBXMaterial(FBXMaterial& fbxmat, const GLTFMaterial& materia
 
 }
 
-template<typename T, typename L>
-bool GLTFReader::readArray(const QByteArray& bin, int byteOffset, int byteLength, 
-                           QVector<L>& outarray, int accessorType) {
-    
-    QDataStream blobstream(bin);
-    blobstream.setByteOrder(QDataStream::LittleEndian);
-    blobstream.setVersion(QDataStream::Qt_5_9);
-    blobstream.setFloatingPointPrecision(QDataStream::FloatingPointPrecision::SinglePrecision);
+static int getAccessorComponentCount(int accessorType) {
+    switch (accessorType) {
+        case GLTFAccessorType::SCALAR:
+            return 1;
+        case GLTFAccessorType::VEC2:
+            return 2;
+        case GLTFAccessorType::VEC3:
+            return 3;
+        case GLTFAccessorType::VEC4:
+        case GLTFAccessorType::MAT2:
+            return 4;
+        case GLTFAccessorType::MAT3:
+            return 9;
+        case GLTFAccessorType::MAT4:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+static int getAccessorComponentSize(int componentType) {
+    switch (componentType) {
+        case GLTFAccessorComponentType::BYTE:
+        case GLTFAccessorComponentType::UNSIGNED_BYTE:
+            return 1;
+        case GLTFAccessorComponentType::SHORT:
+        case GLTFAccessorComponentType::UNSIGNED_SHORT:
+            return 2;
+        case GLTFAccessorComponentType::UNSIGNED_INT:
+        case GLTFAccessorComponentType::FLOAT:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+// below this many elements an accessor is converted on the thread that reads it
+static const int MIN_ACCESSOR_ELEMENTS_PER_TASK = 4096;
+
+// converts count elements of S components, stride bytes apart, to T - normalized integers map to [0, 1] or [-1, 1]
+template<typename S, typename T>
+static void convertComponents(const char* data, int stride, int count, int components, bool normalized, T* values) {
+    normalized = normalized && std::is_integral<S>::value;
+    const size_t elementSize = sizeof(S) * components;
+
+    // where the data is already laid out as we want it, it is copied as is
+    if (sizeof(S) == sizeof(T) && std::is_integral<S>::value == std::is_integral<T>::value && !normalized &&
+        (size_t)stride == elementSize) {
+        memcpy(values, data, elementSize * count);
+        return;
+    }
+
+    const float scale = normalized ? 1.0f / (float)std::numeric_limits<S>::max() : 1.0f;
+    tbb::parallel_for(tbb::blocked_range<int>(0, count, MIN_ACCESSOR_ELEMENTS_PER_TASK), [&](const tbb::blocked_range<int>& range) {
+        for (int i = range.begin(); i != range.end(); ++i) {
+            const char* element = data + (size_t)i * stride;
+            T* value = values + (size_t)i * components;
+            for (int j = 0; j < components; ++j) {
+                S component;
+                memcpy(&component, element + j * sizeof(S), sizeof(S));
+                value[j] = normalized ? (T)std::max((float)component * scale, -1.0f) : (T)component;
+            }
+        }
+    });
+}
 
-    int vsize = byteLength / sizeof(T);
+template<typename T>
+static bool convertAccessorComponents(int componentType, const char* data, int stride, int count, int components,
+                                      bool normalized, T* values) {
+    switch (componentType) {
+        case GLTFAccessorComponentType::BYTE:
+            convertComponents<qint8>(data, stride, count, components, normalized, values);
+            return true;
+        case GLTFAccessorComponentType::UNSIGNED_BYTE:
+            convertComponents<quint8>(data, stride, count, components, normalized, values);
+            return true;
+        case GLTFAccessorComponentType::SHORT:
+            convertComponents<qint16>(data, stride, count, components, normalized, values);
+            return true;
+        case GLTFAccessorComponentType::UNSIGNED_SHORT:
+            convertComponents<quint16>(data, stride, count, components, normalized, values);
+            return true;
+        case GLTFAccessorComponentType::UNSIGNED_INT:
+            convertComponents<quint32>(data, stride, count, components, normalized, values);
+            return true;
+        case GLTFAccessorComponentType::FLOAT:
+            convertComponents<float>(data, stride, count, components, normalized, values);
+            return true;
+        default:
+            return false;
+    }
+}
 
-    qCDebug(modelformat) << "size1: " << vsize;
-    int dataskipped = blobstream.skipRawData(byteOffset);
-    qCDebug(modelformat) << "dataskipped: " << dataskipped;
+bool GLTFReader::getBufferViewData(int bufferViewIndex, int byteOffset, int count, int elementSize,
+                                   const char*& data, int& stride) {
+    if (bufferViewIndex < 0 || bufferViewIndex >= _file.bufferviews.size()) {
+        qCWarning(modelformat) << "GLTF buffer view" << bufferViewIndex << "does not exist";
+        return false;
+    }
+    const GLTFBufferView& bufferview = _file.bufferviews[bufferViewIndex];
+    if (bufferview.buffer < 0 || bufferview.buffer >= _file.buffers.size()) {
+        qCWarning(modelformat) << "GLTF buffer view" << bufferViewIndex << "has no buffer";
+        return false;
+    }
+    const QByteArray& blob = _file.buffers[bufferview.buffer].blob;
 
+    // the elements are packed together unless the view says how far apart they are
+    stride = bufferview.defined["byteStride"] && bufferview.byteStride > 0 ? bufferview.byteStride : elementSize;
 
-    while (outarray.size() < vsize) {
-        
-        T value1, value2, value3, value4, 
-          value5, value6, value7, value8, 
-          value9, value10, value11, value12, 
-          value13, value14, value15, value16;
-
-        if (accessorType == GLTFAccessorType::SCALAR) {
-
-            blobstream >> value1;
-
-            outarray.push_back(value1);
-        } else if (accessorType == GLTFAccessorType::VEC2) {
-
-            blobstream >> value1; 
-            blobstream >> value2;
-
-            outarray.push_back(value1);
-            outarray.push_back(value2);
-        } else if (accessorType == GLTFAccessorType::VEC3) {
-
-            blobstream >> value1;
-            blobstream >> value2;
-            blobstream >> value3;
-
-            outarray.push_back(value1);
-            outarray.push_back(value2);
-            outarray.push_back(value3);
-        } else if (accessorType == GLTFAccessorType::VEC4 || accessorType == GLTFAccessorType::MAT2) {
-
-            blobstream >> value1;
-            blobstream >> value2;
-            blobstream >> value3;
-            blobstream >> value4;
-
-            outarray.push_back(value1);
-            outarray.push_back(value2);
-            outarray.push_back(value3);
-            outarray.push_back(value4);
-        } else if (accessorType == GLTFAccessorType::MAT3) {
-
-            blobstream >> value1;
-            blobstream >> value2;
-            blobstream >> value3;
-            blobstream >> value4;
-            blobstream >> value5;
-            blobstream >> value6;
-            blobstream >> value7;
-            blobstream >> value8;
-            blobstream >> value9;
-
-            outarray.push_back(value1);
-            outarray.push_back(value2);
-            outarray.push_back(value3);
-            outarray.push_back(value4);
-            outarray.push_back(value5);
-            outarray.push_back(value6);
-            outarray.push_back(value7);
-            outarray.push_back(value8);
-            outarray.push_back(value9);
-        } else if (accessorType == GLTFAccessorType::MAT4) {
-
-            blobstream >> value1;
-            blobstream >> value2;
-            blobstream >> value3;
-            blobstream >> value4;
-            blobstream >> value5;
-            blobstream >> value6;
-            blobstream >> value7;
-            blobstream >> value8;
-            blobstream >> value9;
-            blobstream >> value10;
-            blobstream >> value11;
-            blobstream >> value12;
-            blobstream >> value13; 
-            blobstream >> value14; 
-            blobstream >> value15;
-            blobstream >> value16;
-
-            outarray.push_back(value1);
-            outarray.push_back(value2);
-            outarray.push_back(value3);
-            outarray.push_back(value4);
-            outarray.push_back(value5);
-            outarray.push_back(value6);
-            outarray.push_back(value7);
-            outarray.push_back(value8);
-            outarray.push_back(value9);
-            outarray.push_back(value10);
-            outarray.push_back(value11);
-            outarray.push_back(value12);
-            outarray.push_back(value13);
-            outarray.push_back(value14);
-            outarray.push_back(value15);
-            outarray.push_back(value16);
-        
-        }
+    qint64 viewOffset = bufferview.defined["byteOffset"] ? bufferview.byteOffset : 0;
+    qint64 viewEnd = viewOffset + bufferview.byteLength;
+    qint64 begin = viewOffset + byteOffset;
+    qint64 end = count > 0 ? begin + (qint64)(count - 1) * stride + elementSize : begin;
+    if (byteOffset < 0 || end > viewEnd || end > blob.size()) {
+        qCWarning(modelformat) << "GLTF buffer view" << bufferViewIndex << "is too small for what is read from it";
+        return false;
     }
-    blobstream.unsetDevice();
+
+    data = blob.constData() + begin;
     return true;
 }
-template<typename T>
-bool GLTFReader::addArrayOfType(const QByteArray& bin, int byteOffset, int byteLength, 
-                                QVector<T>& outarray, int accessorType, int componentType) {
-    
-    switch (componentType) {
-    case GLTFAccessorComponentType::BYTE: {}
-    case GLTFAccessorComponentType::UNSIGNED_BYTE: {
-        readArray<uchar>(bin, byteOffset, byteLength, outarray, accessorType);
-        break;
+
+template<typename T, typename V>
+bool GLTFReader::readAccessor(int accessorIndex, QVector<V>& values) {
+    static_assert(sizeof(V) % sizeof(T) == 0, "the elements must be made of whole components");
+    const int components = sizeof(V) / sizeof(T);
+
+    // everything is checked before the values are written, and they are left empty if the accessor can't be read
+    values.clear();
+
+    if (accessorIndex < 0 || accessorIndex >= _file.accessors.size()) {
+        qCWarning(modelformat) << "GLTF accessor" << accessorIndex << "does not exist";
+        return false;
     }
-    case GLTFAccessorComponentType::SHORT: {
-        readArray<short>(bin, byteOffset, byteLength, outarray, accessorType);
-        break;
+    const GLTFAccessor& accessor = _file.accessors[accessorIndex];
+    if (getAccessorComponentCount(accessor.type) != components || accessor.count < 0) {
+        qCWarning(modelformat) << "GLTF accessor" << accessorIndex << "is not of the expected type";
+        return false;
     }
-    case GLTFAccessorComponentType::UNSIGNED_INT: {
-        readArray<quint8>(bin, byteOffset, byteLength, outarray, accessorType);
-        break;
+
+    int componentSize = getAccessorComponentSize(accessor.componentType);
+    if (componentSize == 0) {
+        qCWarning(modelformat) << "GLTF accessor" << accessorIndex << "has unknown component type" << accessor.componentType;
+        return false;
     }
-    case GLTFAccessorComponentType::UNSIGNED_SHORT: {
-        readArray<ushort>(bin, byteOffset, byteLength, outarray, accessorType);
-        break;
+
+    const char* data = nullptr;
+    int stride = 0;
+    if (accessor.defined["bufferView"]) {
+        int byteOffset = accessor.defined["byteOffset"] ? accessor.byteOffset : 0;
+        if (!getBufferViewData(accessor.bufferView, byteOffset, accessor.count, componentSize * components, data, stride)) {
+            return false;
+        }
     }
-    case GLTFAccessorComponentType::FLOAT: {
-        readArray<float>(bin, byteOffset, byteLength, outarray, accessorType);
-        break;
+
+    bool isSparse = accessor.defined["sparse"];
+    const GLTFAccessorSparse& sparse = accessor.sparse;
+    const char* indicesData = nullptr;
+    const char* valuesData = nullptr;
+    int indicesStride = 0;
+    int valuesStride = 0;
+    if (isSparse) {
+        int indexSize = getAccessorComponentSize(sparse.indices.componentType);
+        if (sparse.count < 0 || indexSize == 0 || sparse.indices.componentType == GLTFAccessorComponentType::FLOAT) {
+            qCWarning(modelformat) << "GLTF accessor" << accessorIndex << "has invalid sparse values";
+            return false;
+        }
+
+        if (!getBufferViewData(sparse.indices.bufferView, sparse.indices.byteOffset, sparse.count, indexSize,
+                               indicesData, indicesStride) ||
+            !getBufferViewData(sparse.values.bufferView, sparse.values.byteOffset, sparse.count, componentSize * components,
+                               valuesData, valuesStride)) {
+            return false;
+        }
     }
+
+    values.resize(accessor.count);
+    T* output = reinterpret_cast<T*>(values.data());
+
+    if (data) {
+        convertAccessorComponents(accessor.componentType, data, stride, accessor.count, components, accessor.normalized, output);
+    } else {
+        // without a buffer view all the elements are zero, but for those the sparse values set
+        std::fill(output, output + (size_t)accessor.count * components, (T)0);
+    }
+
+    if (isSparse) {
+        QVector<int> indices(sparse.count);
+        QVector<T> sparseValues(sparse.count * components);
+        convertAccessorComponents(sparse.indices.componentType, indicesData, indicesStride, sparse.count, 1, false, indices.data());
+        convertAccessorComponents(accessor.componentType, valuesData, valuesStride, sparse.count, components,
+                                  accessor.normalized, sparseValues.data());
+
+        // the indices are all different, so the values can be put in place in any order
+        tbb::parallel_for(tbb::blocked_range<int>(0, sparse.count, MIN_ACCESSOR_ELEMENTS_PER_TASK), [&](const tbb::blocked_range<int>& range) {
+            for (int i = range.begin(); i != range.end(); ++i) {
+                int index = indices[i];
+                if (index >= 0 && index < accessor.count) {
+                    std::copy_n(sparseValues.constData() + (size_t)i * components, components, output + (size_t)index * components);
+                }
+            }
+        });
     }
+
     return true;
 }
 
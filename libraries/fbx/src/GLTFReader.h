@@ -191,6 +191,7 @@ struct GLTFBufferView {
     int buffer; //required
     int byteLength; //required
     int byteOffset;
+    int byteStride;
     int target;
     QMap<QString, bool> defined;
     void dump() {
@@ -203,6 +204,9 @@ struct GLTFBufferView {
         if (defined["byteOffset"]) {
             qCDebug(modelformat) << "byteOffset: " << byteOffset;
         }
+        if (defined["byteStride"]) {
+            qCDebug(modelformat) << "byteStride: " << byteStride;
+        }
         if (defined["target"]) {
             qCDebug(modelformat) << "target: " << target;
         }
@@ -468,6 +472,56 @@ namespace GLTFAccessorComponentType {
         FLOAT = 5126
     };
 }
+struct GLTFAccessorSparseIndices {
+    int bufferView{ -1 }; //required
+    int byteOffset{ 0 };
+    int componentType{ 0 }; //required
+    QMap<QString, bool> defined;
+    void dump() {
+        if (defined["bufferView"]) {
+            qCDebug(modelformat) << "bufferView: " << bufferView;
+        }
+        if (defined["byteOffset"]) {
+            qCDebug(modelformat) << "byteOffset: " << byteOffset;
+        }
+        if (defined["componentType"]) {
+            qCDebug(modelformat) << "componentType: " << componentType;
+        }
+    }
+};
+
+struct GLTFAccessorSparseValues {
+    int bufferView{ -1 }; //required
+    int byteOffset{ 0 };
+    QMap<QString, bool> defined;
+    void dump() {
+        if (defined["bufferView"]) {
+            qCDebug(modelformat) << "bufferView: " << bufferView;
+        }
+        if (defined["byteOffset"]) {
+            qCDebug(modelformat) << "byteOffset: " << byteOffset;
+        }
+    }
+};
+
+struct GLTFAccessorSparse {
+    int count{ 0 }; //required
+    GLTFAccessorSparseIndices indices; //required
+    GLTFAccessorSparseValues values; //required
+    QMap<QString, bool> defined;
+    void dump() {
+        if (defined["count"]) {
+            qCDebug(modelformat) << "count: " << count;
+        }
+        if (defined["indices"]) {
+            indices.dump();
+        }
+        if (defined["values"]) {
+            values.dump();
+        }
+    }
+};
+
 struct GLTFAccessor {
     int bufferView;
     int byteOffset;
@@ -477,6 +531,7 @@ struct GLTFAccessor {
     bool normalized{ false };
     QVector<double> max;
     QVector<double> min;
+    GLTFAccessorSparse sparse;
     QMap<QString, bool> defined;
     void dump() {
         if (defined["bufferView"]) {
@@ -509,6 +564,10 @@ struct GLTFAccessor {
                 qCDebug(modelformat) << m;
             }
         }
+        if (defined["sparse"]) {
+            qCDebug(modelformat) << "sparse: ";
+            sparse.dump();
+        }
     }
 };
 
@@ -712,10 +771,15 @@ private:
     GLTFFile _file;
     QUrl _url;
 
+    // the whole of a binary glTF, kept so its binary chunk can be read where it is
+    QByteArray _glbData;
+    QByteArray _glbBinaryChunk;
+
     glm::mat4 getModelTransform(const GLTFNode& node);
 
     bool buildGeometry(FBXGeometry& geometry, const QUrl& url);
     bool parseGLTF(const QByteArray& model);
+    bool readGLB(const QByteArray& model, QByteArray& json, QByteArray& binary);
     
     bool getStringVal(const QJsonObject& object, const QString& fieldname, 
                       QString& value, QMap<QString, bool>&  defined);
@@ -761,13 +825,12 @@ private:
 
     bool readBinary(const QString& url, QByteArray& outdata);
 
-    template<typename T, typename L>
-    bool readArray(const QByteArray& bin, int byteOffset, int byteLength, 
-                   QVector<L>& outarray, int accessorType);
-    
-    template<typename T>
-    bool addArrayOfType(const QByteArray& bin, int byteOffset, int byteLength, 
-                        QVector<T>& outarray, int accessorType, int componentType);
+    bool getBufferViewData(int bufferViewIndex, int byteOffset, int count, int elementSize,
+                           const char*& data, int& stride);
+
+    // decodes an accessor into elements of V made of T components (as int indices or glm::vec3 positions of floats)
+    template<typename T, typename V>
+    bool readAccessor(int accessorIndex, QVector<V>& values);
 
     void retriangulate(const QVector<int>& in_indices, const QVector<glm::vec3>& in_vertices, 
                        const QVector<glm::vec3>& in_normals, QVector<int>& out_indices, 
@@ -325,6 +325,7 @@ public:
         static void releaseOpenKtxFiles();
 
     protected:
+        void init(const std::shared_ptr<storage::Storage>& storage);
         std::shared_ptr<storage::FileStorage> maybeOpenFile() const;
 
         mutable std::shared_ptr<std::mutex> _cacheFileMutex { std::make_shared<std::mutex>() };
@@ -157,14 +157,18 @@ struct IrradianceKTXPayload {
 };
 const std::string IrradianceKTXPayload::KEY{ "hifi.irradianceSH" };
 
-KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry) : KtxStorage(cacheEntry->getFilepath())  {
-    _cacheEntry = cacheEntry;
+KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry) : _filename(cacheEntry->getFilepath()), _cacheEntry(cacheEntry) {
+    // share the mapping the cache entry was just read through
+    init(cacheEntry->map());
 }
 
 KtxStorage::KtxStorage(const std::string& filename) : _filename(filename) {
+    init(std::make_shared<storage::FileStorage>(_filename.c_str()));
+}
+
+void KtxStorage::init(const ktx::StoragePointer& storage) {
     {
         // We are doing a lot of work here just to get descriptor data
-        ktx::StoragePointer storage{ new storage::FileStorage(_filename.c_str()) };
         auto ktxPointer = ktx::KTX::create(storage);
         _ktxDescriptor.reset(new ktx::KTXDescriptor(ktxPointer->toDescriptor()));
         if (_ktxDescriptor->images.size() < _ktxDescriptor->header.numberOfMipmapLevels) {
@@ -198,8 +202,8 @@ std::shared_ptr<storage::FileStorage> KtxStorage::maybeOpenFile() const {
         return file;
     }
 
-    // If the file isn't open, create it and save a weak_ptr to it
-    file = std::make_shared<storage::FileStorage>(_filename.c_str());
+    // If the file isn't open, create it and save a weak_ptr to it - a cached file is mapped once for all its readers
+    file = _cacheEntry ? _cacheEntry->map() : std::make_shared<storage::FileStorage>(_filename.c_str());
     _cacheFile = file;
 
     {
@@ -232,6 +236,12 @@ PixelsPointer KtxStorage::getMipFace(uint16 level, uint8 face) const {
         if (file) {
             auto storageView = file->createView(faceSize, faceOffset);
             if (storageView) {
+                // mips are requested from the smallest up, so have the OS read the next one in while this one uploads
+                if (_cacheEntry && level > _minMipLevelAvailable) {
+                    auto nextLevel = level - 1;
+                    _cacheEntry->prefetch(_ktxDescriptor->getMipFaceTexelsOffset(nextLevel, face),
+                                          _ktxDescriptor->getMipFaceTexelsSize(nextLevel, face));
+                }
                 return storageView->toMemoryStorage();
             } else {
                 qWarning() << "Failed to get a valid storageView for faceSize=" << faceSize << "  faceOffset=" << faceOffset << "out of valid file " << QString::fromStdString(_filename);
@@ -309,8 +319,7 @@ void KtxStorage::assignMipFaceData(uint16 level, uint8 face, const storage::Stor
     throw std::runtime_error("Invalid call");
 }
 
-bool validKtx(const std::string& filename) {
-    ktx::StoragePointer storage { new storage::FileStorage(filename.c_str()) };
+bool validKtx(const ktx::StoragePointer& storage) {
     auto ktxPointer = ktx::KTX::create(storage);
     if (!ktxPointer) {
         return false;
@@ -320,7 +329,7 @@ bool validKtx(const std::string& filename) {
 
 void Texture::setKtxBacking(const std::string& filename) {
     // Check the KTX file for validity before using it as backing storage
-    if (!validKtx(filename)) {
+    if (!validKtx(std::make_shared<storage::FileStorage>(filename.c_str()))) {
         return;
     }
 
@@ -330,7 +339,7 @@ void Texture::setKtxBacking(const std::string& filename) {
 
 void Texture::setKtxBacking(const cache::FilePointer& cacheEntry) {
     // Check the KTX file for validity before using it as backing storage
-    if (!validKtx(cacheEntry->getFilepath())) {
+    if (!validKtx(cacheEntry->map())) {
         return;
     }
 
@@ -528,7 +537,7 @@ TexturePointer Texture::build(const ktx::KTXDescriptor& descriptor) {
 }
 
 TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const std::string& source) {
-    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(cacheEntry->getFilepath().c_str()));
+    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(cacheEntry->map());
     if (!ktxPointer) {
         return nullptr;
     }
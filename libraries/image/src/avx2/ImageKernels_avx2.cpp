@@ -0,0 +1,144 @@
+//
+//  ImageKernels_avx2.cpp
+//  libraries/image/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+#include "../image/ImageKernels.h"
+
+namespace image {
+namespace kernels {
+
+// These only convert whole blocks of pixels and answer how many they did, the reference code does the rest.
+
+// the same range as the reference packR11G11B10F
+static const float R11G11B10F_MIN_VALUE = 6.10e-5f;
+static const float R11G11B10F_MAX_VALUE = 6.50e4f;
+
+static inline __m256i packSmallFloat_AVX2(__m256 x, int shift, int exponentMask, int mantissaMask, int nanBits) {
+    // denormalize, and clamp as std::min does, keeping NaNs
+    x = _mm256_andnot_ps(_mm256_cmp_ps(x, _mm256_set1_ps(R11G11B10F_MIN_VALUE), _CMP_LT_OQ), x);
+    x = _mm256_min_ps(_mm256_set1_ps(R11G11B10F_MAX_VALUE), x);
+
+    __m256i f = _mm256_castps_si256(x);
+    __m256i exponent = _mm256_sub_epi32(_mm256_and_si256(f, _mm256_set1_epi32(0x7f800000)),
+                                        _mm256_set1_epi32(0x38000000));
+    exponent = _mm256_and_si256(_mm256_srli_epi32(exponent, shift), _mm256_set1_epi32(exponentMask));
+    __m256i mantissa = _mm256_and_si256(_mm256_srli_epi32(f, shift), _mm256_set1_epi32(mantissaMask));
+    __m256i bits = _mm256_or_si256(exponent, mantissa);
+
+    bits = _mm256_andnot_si256(_mm256_castps_si256(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ)), bits);
+    __m256i isNaN = _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+    return _mm256_blendv_epi8(bits, _mm256_set1_epi32(nanBits), isNaN);
+}
+
+size_t packR11G11B10F_AVX2(const float* rgb, uint32_t* packed, size_t count) {
+    // every third float is the same channel of the next pixel
+    const __m256i channelOffsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float* pixels = &rgb[3 * i];
+        __m256 r = _mm256_i32gather_ps(pixels, channelOffsets, 4);
+        __m256 g = _mm256_i32gather_ps(pixels + 1, channelOffsets, 4);
+        __m256 b = _mm256_i32gather_ps(pixels + 2, channelOffsets, 4);
+
+        __m256i bits = packSmallFloat_AVX2(r, 17, 0x07c0, 0x003f, 0x07ff);
+        bits = _mm256_or_si256(bits, _mm256_slli_epi32(packSmallFloat_AVX2(g, 17, 0x07c0, 0x003f, 0x07ff), 11));
+        bits = _mm256_or_si256(bits, _mm256_slli_epi32(packSmallFloat_AVX2(b, 18, 0x03e0, 0x001f, 0x03ff), 22));
+        _mm256_storeu_si256((__m256i*)&packed[i], bits);
+    }
+    return i;
+}
+
+size_t convertSRGBToR11G11B10F_AVX2(const uint32_t* argb, uint32_t* packed, size_t count, const uint32_t (*table)[256]) {
+    const __m256i channelMask = _mm256_set1_epi32(0xff);
+    const int* redTable = (const int*)table[0];
+    const int* greenTable = (const int*)table[1];
+    const int* blueTable = (const int*)table[2];
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*)&argb[i]);
+        __m256i red = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), channelMask);
+        __m256i green = _mm256_and_si256(_mm256_srli_epi32(pixels, 8), channelMask);
+        __m256i blue = _mm256_and_si256(pixels, channelMask);
+
+        __m256i bits = _mm256_i32gather_epi32(redTable, red, 4);
+        bits = _mm256_or_si256(bits, _mm256_i32gather_epi32(greenTable, green, 4));
+        bits = _mm256_or_si256(bits, _mm256_i32gather_epi32(blueTable, blue, 4));
+        _mm256_storeu_si256((__m256i*)&packed[i], bits);
+    }
+    return i;
+}
+
+// trunc((d + 1) * 127.5) & 0xff for sixteen 16 bit values: the product wraps, but its low bits are still right
+static inline __m256i mapNormalComponents_AVX2(__m256i d) {
+    __m256i m = _mm256_add_epi16(d, _mm256_set1_epi16(1));
+    __m256i n = _mm256_mullo_epi16(m, _mm256_set1_epi16(255));
+    // halving rounds towards zero, so the negative ones need one more first
+    n = _mm256_add_epi16(n, _mm256_srli_epi16(m, 15));
+    return _mm256_and_si256(_mm256_srli_epi16(n, 1), _mm256_set1_epi16(0xff));
+}
+
+static inline __m256i loadPixels_AVX2(const uint8_t* pixels) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)pixels));
+}
+
+size_t convertBumpToNormals_AVX2(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals,
+                                 int width) {
+    const __m256i redAndAlpha = _mm256_set1_epi16(0x01ff);
+
+    // the loads reach one pixel past the sixteen, which is the repeated edge at the end of the row
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i aboveLeft = loadPixels_AVX2(&above[x - 1]);
+        __m256i aboveCenter = loadPixels_AVX2(&above[x]);
+        __m256i aboveRight = loadPixels_AVX2(&above[x + 1]);
+        __m256i rowLeft = loadPixels_AVX2(&row[x - 1]);
+        __m256i rowRight = loadPixels_AVX2(&row[x + 1]);
+        __m256i belowLeft = loadPixels_AVX2(&below[x - 1]);
+        __m256i belowCenter = loadPixels_AVX2(&below[x]);
+        __m256i belowRight = loadPixels_AVX2(&below[x + 1]);
+
+        __m256i dX = _mm256_sub_epi16(
+            _mm256_add_epi16(_mm256_add_epi16(belowLeft, belowRight), _mm256_slli_epi16(belowCenter, 1)),
+            _mm256_add_epi16(_mm256_add_epi16(aboveLeft, aboveRight), _mm256_slli_epi16(aboveCenter, 1)));
+        __m256i dY = _mm256_sub_epi16(
+            _mm256_add_epi16(_mm256_add_epi16(aboveRight, belowRight), _mm256_slli_epi16(rowRight, 1)),
+            _mm256_add_epi16(_mm256_add_epi16(aboveLeft, belowLeft), _mm256_slli_epi16(rowLeft, 1)));
+
+        __m256i greenAndBlue = _mm256_or_si256(_mm256_slli_epi16(mapNormalComponents_AVX2(dY), 8),
+                                               mapNormalComponents_AVX2(dX));
+
+        // the unpacks work within each half, so the halves are put back in order
+        __m256i low = _mm256_unpacklo_epi16(greenAndBlue, redAndAlpha);     // 0-3 | 8-11
+        __m256i high = _mm256_unpackhi_epi16(greenAndBlue, redAndAlpha);    // 4-7 | 12-15
+        _mm256_storeu_si256((__m256i*)&normals[x], _mm256_permute2x128_si256(low, high, 0x20));
+        _mm256_storeu_si256((__m256i*)&normals[x + 8], _mm256_permute2x128_si256(low, high, 0x31));
+    }
+    return x;
+}
+
+size_t invertPixels_AVX2(uint32_t* pixels, size_t count) {
+    const __m256i ones = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i* p = (__m256i*)&pixels[i];
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), ones));
+    }
+    return i;
+}
+
+} // namespace kernels
+} // namespace image
+
+#endif
@@ -11,6 +11,8 @@
 
 #include "Image.h"
 
+#include <mutex>
+
 #include <glm/gtc/packing.hpp>
 
 #include <QtCore/QtGlobal>
@@ -23,7 +25,11 @@
 #include <Profile.h>
 #include <StatTracker.h>
 #include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <TBBHelpers.h>
 
+#include "ImageKernels.h"
 #include "ImageLogging.h"
 
 using namespace gpu;
@@ -223,25 +229,6 @@ void setCubeTexturesCompressionEnabled(bool enabled) {
     compressCubeTextures.store(enabled);
 }
 
-static float denormalize(float value, const float minValue) {
-    return value < minValue ? 0.0f : value;
-}
-
-uint32 packR11G11B10F(const glm::vec3& color) {
-    // Denormalize else unpacking gives high and incorrect values
-    // See https://www.khronos.org/opengl/wiki/Small_Float_Formats for this min value
-    static const auto minValue = 6.10e-5f;
-    static const auto maxValue = 6.50e4f;
-    glm::vec3 ucolor;
-    ucolor.r = denormalize(color.r, minValue);
-    ucolor.g = denormalize(color.g, minValue);
-    ucolor.b = denormalize(color.b, minValue);
-    ucolor.r = std::min(ucolor.r, maxValue);
-    ucolor.g = std::min(ucolor.g, maxValue);
-    ucolor.b = std::min(ucolor.b, maxValue);
-    return glm::packF2x11_1x10(ucolor);
-}
-
 QImage processRawImageData(QByteArray&& content, const std::string& filename) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
@@ -275,9 +262,14 @@ QImage processRawImageData(QByteArray&& content, const std::string& filename) {
 
 gpu::TexturePointer processImage(QByteArray&& content, const std::string& filename,
                                  int maxNumPixels, TextureUsage::Type textureType,
-                                 const std::atomic<bool>& abortProcessing) {
+                                 const std::atomic<bool>& abortProcessing, ProcessingTimings* timings) {
 
+    auto start = usecTimestampNow();
     QImage image = processRawImageData(std::move(content), filename);
+    auto decoded = usecTimestampNow();
+    if (timings) {
+        timings->decodeUsecs = decoded - start;
+    }
 
     int imageWidth = image.width();
     int imageHeight = image.height();
@@ -305,6 +297,10 @@ gpu::TexturePointer processImage(QByteArray&& content, const std::string& filena
     auto loader = TextureUsage::getTextureLoaderForType(textureType);
     auto texture = loader(std::move(image), filename, abortProcessing);
 
+    if (timings) {
+        timings->processUsecs = usecTimestampNow() - decoded;
+    }
+
     return texture;
 }
 
@@ -347,8 +343,11 @@ QImage processSourceImage(QImage&& srcImage, bool cubemap) {
 }
 
 #if defined(NVTT_API)
+// The mips and faces of a texture are compressed concurrently, but its storage can only take them one at a time,
+// so every handler of a texture shares the mutex that texture was given
 struct OutputHandler : public nvtt::OutputHandler {
-    OutputHandler(gpu::Texture* texture, int face) : _texture(texture), _face(face) {}
+    OutputHandler(gpu::Texture* texture, int face, std::mutex& mipAssignMutex) :
+        _texture(texture), _face(face), _mipAssignMutex(mipAssignMutex) {}
 
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
         _size = size;
@@ -366,13 +365,16 @@ struct OutputHandler : public nvtt::OutputHandler {
     }
 
     virtual void endImage() override {
+        storage::StoragePointer storage = std::make_shared<storage::MemoryStorage>(_size, static_cast<const gpu::Byte*>(_data));
+        free(_data);
+        _data = nullptr;
+
+        std::lock_guard<std::mutex> lock(_mipAssignMutex);
         if (_face >= 0) {
-            _texture->assignStoredMipFace(_miplevel, _face, _size, static_cast<const gpu::Byte*>(_data));
+            _texture->assignStoredMipFace(_miplevel, _face, storage);
         } else {
-            _texture->assignStoredMip(_miplevel, _size, static_cast<const gpu::Byte*>(_data));
+            _texture->assignStoredMip(_miplevel, storage);
         }
-        free(_data);
-        _data = nullptr;
     }
 
     gpu::Byte* _data{ nullptr };
@@ -381,15 +383,13 @@ struct OutputHandler : public nvtt::OutputHandler {
     int _miplevel = 0;
     int _size = 0;
     int _face = -1;
+    std::mutex& _mipAssignMutex;
 };
 
 struct PackedFloatOutputHandler : public OutputHandler {
-    PackedFloatOutputHandler(gpu::Texture* texture, int face, gpu::Element format) : OutputHandler(texture, face) {
-        if (format == gpu::Element::COLOR_RGB9E5) {
-            _packFunc = glm::packF3x9_E1x5;
-        } else if (format == gpu::Element::COLOR_R11G11B10) {
-            _packFunc = packR11G11B10F;
-        } else {
+    PackedFloatOutputHandler(gpu::Texture* texture, int face, std::mutex& mipAssignMutex, gpu::Element format) :
+        OutputHandler(texture, face, mipAssignMutex), _format(format) {
+        if (format != gpu::Element::COLOR_RGB9E5 && format != gpu::Element::COLOR_R11G11B10) {
             qCWarning(imagelogging) << "Unknown handler format";
             Q_UNREACHABLE();
         }
@@ -398,33 +398,33 @@ struct PackedFloatOutputHandler : public OutputHandler {
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
         // Divide by 3 because we will compress from 3*floats to 1 uint32
         OutputHandler::beginImage(size / 3, width, height, depth, face, miplevel);
+        _floats.clear();
+        _floats.reserve(size / sizeof(float));
     }
     virtual bool writeData(const void* data, int size) override {
-        // Expecting to write multiple of floats
-        if (_packFunc) {
-            assert((size % sizeof(float)) == 0);
-            auto floatCount = size / sizeof(float);
-            const float* floatBegin = (const float*)data;
-            const float* floatEnd = floatBegin + floatCount;
-
-            while (floatBegin < floatEnd) {
-                _pixel[_coordIndex] = *floatBegin;
-                floatBegin++;
-                _coordIndex++;
-                if (_coordIndex == 3) {
-                    uint32 packedRGB = _packFunc(_pixel);
-                    _coordIndex = 0;
-                    OutputHandler::writeData(&packedRGB, sizeof(packedRGB));
-                }
+        // Expecting to write multiple of floats, which are packed all at once when the image is done
+        assert((size % sizeof(float)) == 0);
+        const float* floatBegin = (const float*)data;
+        _floats.insert(_floats.end(), floatBegin, floatBegin + size / sizeof(float));
+        return true;
+    }
+    virtual void endImage() override {
+        size_t pixelCount = _floats.size() / 3;
+        assert(pixelCount * sizeof(uint32) <= (size_t)_size);
+        uint32* packed = reinterpret_cast<uint32*>(_data);
+        if (_format == gpu::Element::COLOR_R11G11B10) {
+            kernels::packR11G11B10F(_floats.data(), packed, pixelCount);
+        } else {
+            for (size_t i = 0; i < pixelCount; ++i) {
+                packed[i] = glm::packF3x9_E1x5(glm::vec3(_floats[3 * i], _floats[3 * i + 1], _floats[3 * i + 2]));
             }
-            return true;
         }
-        return false;
+        _floats.clear();
+        OutputHandler::endImage();
     }
 
-    std::function<uint32(const glm::vec3&)> _packFunc;
-    glm::vec3 _pixel;
-    int _coordIndex{ 0 };
+    gpu::Element _format;
+    std::vector<float> _floats;
 };
 
 struct MyErrorHandler : public nvtt::ErrorHandler {
@@ -433,24 +433,25 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+// Runs the tasks nvtt splits its work into (the blocks of a mip to compress) on TBB's work-stealing pool, which is
+// shared by all the threads processing textures, rather than one after the other on the calling thread
+class ParallelTaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
+    ParallelTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
 
     const std::atomic<bool>& _abortProcessing;
 
     virtual void dispatch(nvtt::Task* task, void* context, int count) override {
-        for (int i = 0; i < count; i++) {
+        tbb::parallel_for(0, count, [&](int i) {
             if (!_abortProcessing.load()) {
                 task(context, i);
-            } else {
-                break;
             }
-        }
+        });
     }
 };
 
-void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateHDRMips(gpu::Texture* texture, QImage&& image, std::mutex& mipAssignMutex,
+                     const std::atomic<bool>& abortProcessing, int face) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -513,40 +514,47 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
     // We're done with the localCopy, free up the memory to avoid bloating the heap
     localCopy = QImage(); // QImage doesn't have a clear function, so override it with an empty one.
 
-    nvtt::OutputOptions outputOptions;
-    outputOptions.setOutputHeader(false);
-    std::unique_ptr<nvtt::OutputHandler> outputHandler;
     MyErrorHandler errorHandler;
-    outputOptions.setErrorHandler(&errorHandler);
-    nvtt::Context context;
-    int mipLevel = 0;
-
-    if (mipFormat == gpu::Element::COLOR_RGB9E5 || mipFormat == gpu::Element::COLOR_R11G11B10) {
-        // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
-        outputHandler.reset(new PackedFloatOutputHandler(texture, face, mipFormat));
-    } else {
-        outputHandler.reset(new OutputHandler(texture, face));
-    }
-
-    outputOptions.setOutputHandler(outputHandler.get());
+    ParallelTaskDispatcher dispatcher(abortProcessing);
 
+    // Each mip is built from the one above it, but they can then all be compressed at once. The surfaces share their
+    // pixels until they are changed, so keeping each level costs only the memory of the mips themselves.
+    std::vector<nvtt::Surface> mips;
     nvtt::Surface surface;
     surface.setImage(inputFormat, width, height, 1, &(*data.begin()));
     surface.setAlphaMode(alphaMode);
     surface.setWrapMode(wrapMode);
-
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
-    context.setTaskDispatcher(&dispatcher);
-
-    context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
+    mips.push_back(surface);
     while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
         surface.buildNextMipmap(nvtt::MipmapFilter_Box);
-        context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
+        mips.push_back(surface);
     }
+
+    tbb::parallel_for(0, (int)mips.size(), [&](int mipLevel) {
+        if (abortProcessing.load()) {
+            return;
+        }
+
+        nvtt::OutputOptions outputOptions;
+        outputOptions.setOutputHeader(false);
+        outputOptions.setErrorHandler(&errorHandler);
+        std::unique_ptr<nvtt::OutputHandler> outputHandler;
+        if (mipFormat == gpu::Element::COLOR_RGB9E5 || mipFormat == gpu::Element::COLOR_R11G11B10) {
+            // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
+            outputHandler.reset(new PackedFloatOutputHandler(texture, face, mipAssignMutex, mipFormat));
+        } else {
+            outputHandler.reset(new OutputHandler(texture, face, mipAssignMutex));
+        }
+        outputOptions.setOutputHandler(outputHandler.get());
+
+        nvtt::Context context;
+        context.setTaskDispatcher(&dispatcher);
+        context.compress(mips[mipLevel], face, mipLevel, compressionOptions, outputOptions);
+    });
 }
 
-void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateLDRMips(gpu::Texture* texture, QImage&& image, std::mutex& mipAssignMutex,
+                     const std::atomic<bool>& abortProcessing, int face) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -662,12 +670,13 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
     nvtt::OutputOptions outputOptions;
     outputOptions.setOutputHeader(false);
-    OutputHandler outputHandler(texture, face);
+    OutputHandler outputHandler(texture, face, mipAssignMutex);
     outputOptions.setOutputHandler(&outputHandler);
     MyErrorHandler errorHandler;
     outputOptions.setErrorHandler(&errorHandler);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
+    // nvtt builds the mips one after the other here, but the blocks of each are compressed in parallel
+    ParallelTaskDispatcher dispatcher(abortProcessing);
     nvtt::Compressor compressor;
     compressor.setTaskDispatcher(&dispatcher);
     compressor.process(inputOptions, compressionOptions, outputOptions);
@@ -677,15 +686,16 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
 
 
-void generateMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing = false, int face = -1) {
+void generateMips(gpu::Texture* texture, QImage&& image, std::mutex& mipAssignMutex,
+                  const std::atomic<bool>& abortProcessing = false, int face = -1) {
 #if CPU_MIPMAPS
 #if !defined(Q_OS_ANDROID)
     PROFILE_RANGE(resource_parse, "generateMips");
 
     if (image.format() == QIMAGE_HDR_FORMAT) {
-        generateHDRMips(texture, std::move(image), abortProcessing, face);
+        generateHDRMips(texture, std::move(image), mipAssignMutex, abortProcessing, face);
     } else  {
-        generateLDRMips(texture, std::move(image), abortProcessing, face);
+        generateLDRMips(texture, std::move(image), mipAssignMutex, abortProcessing, face);
     }
 
 #else
@@ -786,7 +796,8 @@ gpu::TexturePointer TextureUsage::process2DTextureColorFromImage(QImage&& srcIma
         theTexture->setUsage(usage.build());
         theTexture->setStoredMipFormat(formatMip);
         theTexture->assignStoredMip(0, image.byteCount(), image.constBits());
-        generateMips(theTexture.get(), std::move(image), abortProcessing);
+        std::mutex mipAssignMutex;
+        generateMips(theTexture.get(), std::move(image), mipAssignMutex, abortProcessing);
     }
 
     return theTexture;
@@ -796,14 +807,6 @@ int clampPixelCoordinate(int coordinate, int maxCoordinate) {
     return coordinate - ((int)(coordinate < 0) * coordinate) + ((int)(coordinate > maxCoordinate) * (maxCoordinate - coordinate));
 }
 
-const int RGBA_MAX = 255;
-
-// transform -1 - 1 to 0 - 255 (from sobel value to rgb)
-double mapComponent(double sobelValue) {
-    const double factor = RGBA_MAX / 2.0;
-    return (sobelValue + 1.0) * factor;
-}
-
 QImage processBumpMap(QImage&& image) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
@@ -815,53 +818,30 @@ QImage processBumpMap(QImage&& image) {
 
     // PR 5540 by AlessandroSigna integrated here as a specialized TextureLoader for bumpmaps
     // The conversion is done using the Sobel Filter to calculate the derivatives from the grayscale image
-    const double pStrength = 2.0;
     int width = localCopy.width();
     int height = localCopy.height();
 
     QImage result(width, height, QImage::Format_ARGB32);
 
-    for (int i = 0; i < width; i++) {
-        const int iNextClamped = clampPixelCoordinate(i + 1, width - 1);
-        const int iPrevClamped = clampPixelCoordinate(i - 1, width - 1);
-
-        for (int j = 0; j < height; j++) {
-            const int jNextClamped = clampPixelCoordinate(j + 1, height - 1);
-            const int jPrevClamped = clampPixelCoordinate(j - 1, height - 1);
-
-            // surrounding pixels
-            const QRgb topLeft = localCopy.pixel(iPrevClamped, jPrevClamped);
-            const QRgb top = localCopy.pixel(iPrevClamped, j);
-            const QRgb topRight = localCopy.pixel(iPrevClamped, jNextClamped);
-            const QRgb right = localCopy.pixel(i, jNextClamped);
-            const QRgb bottomRight = localCopy.pixel(iNextClamped, jNextClamped);
-            const QRgb bottom = localCopy.pixel(iNextClamped, j);
-            const QRgb bottomLeft = localCopy.pixel(iNextClamped, jPrevClamped);
-            const QRgb left = localCopy.pixel(i, jPrevClamped);
-
-            // take their gray intensities
-            // since it's a grayscale image, the value of each component RGB is the same
-            const double tl = qRed(topLeft);
-            const double t = qRed(top);
-            const double tr = qRed(topRight);
-            const double r = qRed(right);
-            const double br = qRed(bottomRight);
-            const double b = qRed(bottom);
-            const double bl = qRed(bottomLeft);
-            const double l = qRed(left);
-
-            // apply the sobel filter
-            const double dX = (tr + pStrength * r + br) - (tl + pStrength * l + bl);
-            const double dY = (bl + pStrength * b + br) - (tl + pStrength * t + tr);
-            const double dZ = RGBA_MAX / pStrength;
-
-            glm::vec3 v(dX, dY, dZ);
-            glm::normalize(v);
-
-            // convert to rgb from the value obtained computing the filter
-            QRgb qRgbValue = qRgba(mapComponent(v.z), mapComponent(v.y), mapComponent(v.x), 1.0);
-            result.setPixel(i, j, qRgbValue);
-        }
+    // the rows are copied with their edge pixels repeated on both sides, which the filter reads past the edges
+    std::vector<uint8_t> paddedRows[3];
+    auto padRow = [&](int y, std::vector<uint8_t>& padded) {
+        const uint8_t* row = localCopy.constScanLine(clampPixelCoordinate(y, height - 1));
+        padded.resize(width + 2);
+        padded[0] = row[0];
+        memcpy(&padded[1], row, width);
+        padded[width + 1] = row[width - 1];
+    };
+    padRow(-1, paddedRows[0]);
+    padRow(0, paddedRows[1]);
+
+    for (int y = 0; y < height; y++) {
+        auto& above = paddedRows[y % 3];
+        auto& row = paddedRows[(y + 1) % 3];
+        auto& below = paddedRows[(y + 2) % 3];
+        padRow(y + 1, below);
+
+        kernels::convertBumpToNormals(&above[1], &row[1], &below[1], reinterpret_cast<uint32_t*>(result.scanLine(y)), width);
     }
 
     return result;
@@ -893,7 +873,8 @@ gpu::TexturePointer TextureUsage::process2DTextureNormalMapFromImage(QImage&& sr
         theTexture->setSource(srcImageName);
         theTexture->setStoredMipFormat(formatMip);
         theTexture->assignStoredMip(0, image.byteCount(), image.constBits());
-        generateMips(theTexture.get(), std::move(image), abortProcessing);
+        std::mutex mipAssignMutex;
+        generateMips(theTexture.get(), std::move(image), mipAssignMutex, abortProcessing);
     }
 
     return theTexture;
@@ -911,7 +892,9 @@ gpu::TexturePointer TextureUsage::process2DTextureGrayscaleFromImage(QImage&& sr
 
     if (isInvertedPixels) {
         // Gloss turned into Rough
-        image.invertPixels(QImage::InvertRgba);
+        for (int y = 0; y < image.height(); y++) {
+            kernels::invertPixels(reinterpret_cast<uint32_t*>(image.scanLine(y)), image.width());
+        }
     }
 
     gpu::TexturePointer theTexture = nullptr;
@@ -930,7 +913,8 @@ gpu::TexturePointer TextureUsage::process2DTextureGrayscaleFromImage(QImage&& sr
         theTexture->setSource(srcImageName);
         theTexture->setStoredMipFormat(formatMip);
         theTexture->assignStoredMip(0, image.byteCount(), image.constBits());
-        generateMips(theTexture.get(), std::move(image), abortProcessing);
+        std::mutex mipAssignMutex;
+        generateMips(theTexture.get(), std::move(image), mipAssignMutex, abortProcessing);
     }
 
     return theTexture;  
@@ -1216,7 +1200,7 @@ QImage convertToHDRFormat(QImage&& srcImage, gpu::Element format) {
 
     switch (format.getSemantic()) {
         case gpu::R11G11B10:
-            packFunc = packR11G11B10F;
+            // converted a line at a time by kernels::convertSRGBToR11G11B10F
 #ifdef DEBUG_COLOR_PACKING
             unpackFunc = glm::unpackF2x11_1x10;
 #endif
@@ -1240,6 +1224,19 @@ QImage convertToHDRFormat(QImage&& srcImage, gpu::Element format) {
         uint32* hdrLineIt = reinterpret_cast<uint32*>( hdrImage.scanLine(y) );
         glm::vec3 color;
 
+        if (!packFunc) {
+            kernels::convertSRGBToR11G11B10F(srcLineIt, hdrLineIt, localCopy.width());
+#ifdef DEBUG_COLOR_PACKING
+            for (; srcLineIt < srcLineEnd; ++srcLineIt, ++hdrLineIt) {
+                color = glm::vec3(qRed(*srcLineIt), qGreen(*srcLineIt), qBlue(*srcLineIt)) / 255.0f;
+                color = glm::vec3(powf(color.r, 2.2f), powf(color.g, 2.2f), powf(color.b, 2.2f));
+                glm::vec3 ucolor = unpackFunc(*hdrLineIt);
+                assert(glm::distance(color, ucolor) <= 5e-2);
+            }
+#endif
+            continue;
+        }
+
         while (srcLineIt < srcLineEnd) {
             color.r = qRed(*srcLineIt);
             color.g = qGreen(*srcLineIt);
@@ -1352,9 +1349,10 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(QImage&& srcI
             theTexture->overrideIrradiance(irradiance);
         }
 
-        for (uint8 face = 0; face < faces.size(); ++face) {
-            generateMips(theTexture.get(), std::move(faces[face]), abortProcessing, face);
-        }
+        std::mutex mipAssignMutex;
+        tbb::parallel_for(0, (int)faces.size(), [&](int face) {
+            generateMips(theTexture.get(), std::move(faces[face]), mipAssignMutex, abortProcessing, face);
+        });
     }
 
     return theTexture;
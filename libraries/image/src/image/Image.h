@@ -92,9 +92,16 @@ void setNormalTexturesCompressionEnabled(bool enabled);
 void setGrayscaleTexturesCompressionEnabled(bool enabled);
 void setCubeTexturesCompressionEnabled(bool enabled);
 
+// How long processImage took with a texture, in microseconds
+struct ProcessingTimings {
+    quint64 decodeUsecs { 0 }; // reading the image out of its file
+    quint64 processUsecs { 0 }; // converting it and generating (and compressing) its mips
+};
+
 gpu::TexturePointer processImage(QByteArray&& content, const std::string& url,
                                  int maxNumPixels, TextureUsage::Type textureType,
-                                 const std::atomic<bool>& abortProcessing = false);
+                                 const std::atomic<bool>& abortProcessing = false,
+                                 ProcessingTimings* timings = nullptr);
 
 } // namespace image
 
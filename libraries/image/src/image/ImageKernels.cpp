@@ -0,0 +1,295 @@
+//
+//  ImageKernels.cpp
+//  image/src/image
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ImageKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>  // SSE2
+
+#include "CPUDetect.h"
+#endif
+
+namespace image {
+namespace kernels {
+
+//
+// portable reference code
+//
+
+// See https://www.khronos.org/opengl/wiki/Small_Float_Formats for these
+static const float R11G11B10F_MIN_VALUE = 6.10e-5f;
+static const float R11G11B10F_MAX_VALUE = 6.50e4f;
+
+static uint32_t packR11G11B10F(const glm::vec3& color) {
+    // Denormalize else unpacking gives high and incorrect values
+    glm::vec3 ucolor;
+    ucolor.r = color.r < R11G11B10F_MIN_VALUE ? 0.0f : color.r;
+    ucolor.g = color.g < R11G11B10F_MIN_VALUE ? 0.0f : color.g;
+    ucolor.b = color.b < R11G11B10F_MIN_VALUE ? 0.0f : color.b;
+    ucolor.r = std::min(ucolor.r, R11G11B10F_MAX_VALUE);
+    ucolor.g = std::min(ucolor.g, R11G11B10F_MAX_VALUE);
+    ucolor.b = std::min(ucolor.b, R11G11B10F_MAX_VALUE);
+    return glm::packF2x11_1x10(ucolor);
+}
+
+static void packR11G11B10F_ref(const float* rgb, uint32_t* packed, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        packed[i] = packR11G11B10F(glm::vec3(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]));
+    }
+}
+
+// Each channel of an sRGB pixel only has 256 values, so its bits of R11G11B10F are looked up rather than computed:
+// the red bits of the packed pixel are table[0][red], the green ones table[1][green] and the blue ones table[2][blue].
+static const uint32_t (*getSRGBToR11G11B10FTable())[256] {
+    struct Table {
+        uint32_t bits[3][256];
+
+        Table() {
+            const uint32_t RED_MASK = (1 << 11) - 1;
+            const uint32_t GREEN_MASK = RED_MASK << 11;
+            const uint32_t BLUE_MASK = ~(RED_MASK | GREEN_MASK);
+            for (int value = 0; value < 256; ++value) {
+                // Normalize and apply gamma
+                float linear = powf(value / 255.0f, 2.2f);
+                uint32_t packed = packR11G11B10F(glm::vec3(linear));
+                bits[0][value] = packed & RED_MASK;
+                bits[1][value] = packed & GREEN_MASK;
+                bits[2][value] = packed & BLUE_MASK;
+            }
+        }
+    };
+    static const Table table;
+    return table.bits;
+}
+
+static void convertSRGBToR11G11B10F_ref(const uint32_t* argb, uint32_t* packed, size_t count) {
+    auto table = getSRGBToR11G11B10FTable();
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pixel = argb[i];
+        packed[i] = table[0][(pixel >> 16) & 0xff] | table[1][(pixel >> 8) & 0xff] | table[2][pixel & 0xff];
+    }
+}
+
+// The normal maps are what they always were: the red channel is the filter's z of 127.5 and the green and blue are its
+// y and x, none of them normalized, mapped from [-1, 1] to [0, 255] and truncated to a byte. The alpha is 1.
+static const uint32_t NORMAL_RED_AND_ALPHA = 0x01ff0000;
+
+static inline uint32_t mapNormalComponent(int value) {
+    return (uint32_t)(((value + 1) * 255) / 2) & 0xff;
+}
+
+static void convertBumpToNormals_ref(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals,
+                                     int width) {
+    for (int x = 0; x < width; ++x) {
+        int dX = (below[x - 1] + 2 * below[x] + below[x + 1]) - (above[x - 1] + 2 * above[x] + above[x + 1]);
+        int dY = (above[x + 1] + 2 * row[x + 1] + below[x + 1]) - (above[x - 1] + 2 * row[x - 1] + below[x - 1]);
+        normals[x] = NORMAL_RED_AND_ALPHA | (mapNormalComponent(dY) << 8) | mapNormalComponent(dX);
+    }
+}
+
+static void invertPixels_ref(uint32_t* pixels, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        pixels[i] = ~pixels[i];
+    }
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+// the bits of R11G11B10F for four floats, the same as glm's floatTo11bit (shift 17) and floatTo10bit (shift 18)
+static inline __m128i packSmallFloat_SSE(__m128 x, int shift, int exponentMask, int mantissaMask, int nanBits) {
+    // denormalize, and clamp as std::min does, keeping NaNs
+    x = _mm_andnot_ps(_mm_cmplt_ps(x, _mm_set1_ps(R11G11B10F_MIN_VALUE)), x);
+    x = _mm_min_ps(_mm_set1_ps(R11G11B10F_MAX_VALUE), x);
+
+    __m128i f = _mm_castps_si128(x);
+    __m128i exponent = _mm_sub_epi32(_mm_and_si128(f, _mm_set1_epi32(0x7f800000)), _mm_set1_epi32(0x38000000));
+    exponent = _mm_and_si128(_mm_srli_epi32(exponent, shift), _mm_set1_epi32(exponentMask));
+    __m128i mantissa = _mm_and_si128(_mm_srli_epi32(f, shift), _mm_set1_epi32(mantissaMask));
+    __m128i bits = _mm_or_si128(exponent, mantissa);
+
+    bits = _mm_andnot_si128(_mm_castps_si128(_mm_cmpeq_ps(x, _mm_setzero_ps())), bits);
+    __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(x, x));
+    return _mm_or_si128(_mm_andnot_si128(isNaN, bits), _mm_and_si128(isNaN, _mm_set1_epi32(nanBits)));
+}
+
+static void packR11G11B10F_SSE(const float* rgb, uint32_t* packed, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3
+        __m128 a0 = _mm_loadu_ps(&rgb[3 * i]);
+        __m128 a1 = _mm_loadu_ps(&rgb[3 * i + 4]);
+        __m128 a2 = _mm_loadu_ps(&rgb[3 * i + 8]);
+
+        __m128 t0 = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(0, 1, 0, 2));    // r2 _ r3 _
+        __m128 r = _mm_shuffle_ps(a0, t0, _MM_SHUFFLE(2, 0, 3, 0));     // r0 r1 r2 r3
+        __m128 t1 = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(0, 0, 0, 1));    // g0 _ g1 _
+        __m128 t2 = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(0, 2, 0, 3));    // g2 _ g3 _
+        __m128 g = _mm_shuffle_ps(t1, t2, _MM_SHUFFLE(2, 0, 2, 0));     // g0 g1 g2 g3
+        __m128 t3 = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(0, 1, 0, 2));    // b0 _ b1 _
+        __m128 b = _mm_shuffle_ps(t3, a2, _MM_SHUFFLE(3, 0, 2, 0));     // b0 b1 b2 b3
+
+        __m128i bits = packSmallFloat_SSE(r, 17, 0x07c0, 0x003f, 0x07ff);
+        bits = _mm_or_si128(bits, _mm_slli_epi32(packSmallFloat_SSE(g, 17, 0x07c0, 0x003f, 0x07ff), 11));
+        bits = _mm_or_si128(bits, _mm_slli_epi32(packSmallFloat_SSE(b, 18, 0x03e0, 0x001f, 0x03ff), 22));
+        _mm_storeu_si128((__m128i*)&packed[i], bits);
+    }
+    packR11G11B10F_ref(&rgb[3 * i], &packed[i], count - i);
+}
+
+// trunc((d + 1) * 127.5) & 0xff for eight 16 bit values: the product wraps, but its low bits are still right
+static inline __m128i mapNormalComponents_SSE(__m128i d) {
+    __m128i m = _mm_add_epi16(d, _mm_set1_epi16(1));
+    __m128i n = _mm_mullo_epi16(m, _mm_set1_epi16(255));
+    // halving rounds towards zero, so the negative ones need one more first
+    n = _mm_add_epi16(n, _mm_srli_epi16(m, 15));
+    return _mm_and_si128(_mm_srli_epi16(n, 1), _mm_set1_epi16(0xff));
+}
+
+static void convertBumpToNormals_SSE(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals,
+                                     int width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i redAndAlpha = _mm_set1_epi16((short)(NORMAL_RED_AND_ALPHA >> 16));
+
+    // the loads reach one pixel past the eight, which is the repeated edge at the end of the row
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i aboveLeft = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&above[x - 1]), zero);
+        __m128i aboveCenter = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&above[x]), zero);
+        __m128i aboveRight = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&above[x + 1]), zero);
+        __m128i rowLeft = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&row[x - 1]), zero);
+        __m128i rowRight = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&row[x + 1]), zero);
+        __m128i belowLeft = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&below[x - 1]), zero);
+        __m128i belowCenter = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&below[x]), zero);
+        __m128i belowRight = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&below[x + 1]), zero);
+
+        __m128i dX = _mm_sub_epi16(
+            _mm_add_epi16(_mm_add_epi16(belowLeft, belowRight), _mm_slli_epi16(belowCenter, 1)),
+            _mm_add_epi16(_mm_add_epi16(aboveLeft, aboveRight), _mm_slli_epi16(aboveCenter, 1)));
+        __m128i dY = _mm_sub_epi16(
+            _mm_add_epi16(_mm_add_epi16(aboveRight, belowRight), _mm_slli_epi16(rowRight, 1)),
+            _mm_add_epi16(_mm_add_epi16(aboveLeft, belowLeft), _mm_slli_epi16(rowLeft, 1)));
+
+        __m128i greenAndBlue = _mm_or_si128(_mm_slli_epi16(mapNormalComponents_SSE(dY), 8), mapNormalComponents_SSE(dX));
+        _mm_storeu_si128((__m128i*)&normals[x], _mm_unpacklo_epi16(greenAndBlue, redAndAlpha));
+        _mm_storeu_si128((__m128i*)&normals[x + 4], _mm_unpackhi_epi16(greenAndBlue, redAndAlpha));
+    }
+    convertBumpToNormals_ref(&above[x], &row[x], &below[x], &normals[x], width - x);
+}
+
+static void invertPixels_SSE(uint32_t* pixels, size_t count) {
+    const __m128i ones = _mm_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i* p = (__m128i*)&pixels[i];
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), ones));
+    }
+    invertPixels_ref(&pixels[i], count - i);
+}
+
+//
+// Runtime CPU dispatch
+//
+
+size_t packR11G11B10F_AVX2(const float* rgb, uint32_t* packed, size_t count);
+size_t convertSRGBToR11G11B10F_AVX2(const uint32_t* argb, uint32_t* packed, size_t count, const uint32_t (*table)[256]);
+size_t convertBumpToNormals_AVX2(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals,
+                                 int width);
+size_t invertPixels_AVX2(uint32_t* pixels, size_t count);
+
+// the AVX2 kernels do whole blocks of pixels, and the reference code finishes the rows
+static void packR11G11B10F_withAVX2(const float* rgb, uint32_t* packed, size_t count) {
+    size_t done = packR11G11B10F_AVX2(rgb, packed, count);
+    packR11G11B10F_ref(&rgb[3 * done], &packed[done], count - done);
+}
+
+static void convertSRGBToR11G11B10F_withAVX2(const uint32_t* argb, uint32_t* packed, size_t count) {
+    size_t done = convertSRGBToR11G11B10F_AVX2(argb, packed, count, getSRGBToR11G11B10FTable());
+    convertSRGBToR11G11B10F_ref(&argb[done], &packed[done], count - done);
+}
+
+static void convertBumpToNormals_withAVX2(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+                                          uint32_t* normals, int width) {
+    int done = (int)convertBumpToNormals_AVX2(above, row, below, normals, width);
+    convertBumpToNormals_ref(&above[done], &row[done], &below[done], &normals[done], width - done);
+}
+
+static void invertPixels_withAVX2(uint32_t* pixels, size_t count) {
+    size_t done = invertPixels_AVX2(pixels, count);
+    invertPixels_ref(&pixels[done], count - done);
+}
+
+void packR11G11B10F(const float* rgb, uint32_t* packed, size_t count) {
+    static auto f = cpuSupportsAVX2() ? packR11G11B10F_withAVX2 : packR11G11B10F_SSE;
+    (*f)(rgb, packed, count);   // dispatch
+}
+
+// SSE2 has no gather, the lookups are as fast one at a time
+void convertSRGBToR11G11B10F(const uint32_t* argb, uint32_t* packed, size_t count) {
+    static auto f = cpuSupportsAVX2() ? convertSRGBToR11G11B10F_withAVX2 : convertSRGBToR11G11B10F_ref;
+    (*f)(argb, packed, count);  // dispatch
+}
+
+void convertBumpToNormals(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals, int width) {
+    static auto f = cpuSupportsAVX2() ? convertBumpToNormals_withAVX2 : convertBumpToNormals_SSE;
+    (*f)(above, row, below, normals, width);    // dispatch
+}
+
+void invertPixels(uint32_t* pixels, size_t count) {
+    static auto f = cpuSupportsAVX2() ? invertPixels_withAVX2 : invertPixels_SSE;
+    (*f)(pixels, count);    // dispatch
+}
+
+std::vector<Implementation> getImplementations() {
+    std::vector<Implementation> implementations {
+        { "reference", packR11G11B10F_ref, convertSRGBToR11G11B10F_ref, convertBumpToNormals_ref, invertPixels_ref },
+        { "SSE2", packR11G11B10F_SSE, convertSRGBToR11G11B10F_ref, convertBumpToNormals_SSE, invertPixels_SSE }
+    };
+    if (cpuSupportsAVX2()) {
+        implementations.push_back({ "AVX2", packR11G11B10F_withAVX2, convertSRGBToR11G11B10F_withAVX2,
+                                    convertBumpToNormals_withAVX2, invertPixels_withAVX2 });
+    }
+    return implementations;
+}
+
+#else   // portable reference code
+
+void packR11G11B10F(const float* rgb, uint32_t* packed, size_t count) {
+    packR11G11B10F_ref(rgb, packed, count);
+}
+
+void convertSRGBToR11G11B10F(const uint32_t* argb, uint32_t* packed, size_t count) {
+    convertSRGBToR11G11B10F_ref(argb, packed, count);
+}
+
+void convertBumpToNormals(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals, int width) {
+    convertBumpToNormals_ref(above, row, below, normals, width);
+}
+
+void invertPixels(uint32_t* pixels, size_t count) {
+    invertPixels_ref(pixels, count);
+}
+
+std::vector<Implementation> getImplementations() {
+    return { { "reference", packR11G11B10F_ref, convertSRGBToR11G11B10F_ref, convertBumpToNormals_ref, invertPixels_ref } };
+}
+
+#endif
+
+} // namespace kernels
+} // namespace image
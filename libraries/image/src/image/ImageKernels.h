@@ -0,0 +1,55 @@
+//
+//  ImageKernels.h
+//  image/src/image
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_image_ImageKernels_h
+#define hifi_image_ImageKernels_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+namespace image {
+
+// The pixel conversions that processing a texture spends its time in. Each has a portable reference version and SIMD
+// versions for the CPUs that have them, picked at runtime, and they all give the same results bit for bit.
+namespace kernels {
+
+// linear RGB colors, three floats a pixel, to R11G11B10F (as packR11G11B10F does)
+void packR11G11B10F(const float* rgb, uint32_t* packed, size_t count);
+
+// ARGB32 pixels in sRGB to R11G11B10F in linear RGB (the alpha is dropped)
+void convertSRGBToR11G11B10F(const uint32_t* argb, uint32_t* packed, size_t count);
+
+// A row of a normal map from the rows of a grayscale bump map above, at and below it, with a Sobel filter. Each row
+// has its edge pixels repeated once on both sides, so row[-1] and row[width] are there to be read.
+void convertBumpToNormals(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals, int width);
+
+// inverts all four channels of ARGB32 pixels
+void invertPixels(uint32_t* pixels, size_t count);
+
+// one version of each of the kernels, for tests and benchmarks to compare
+struct Implementation {
+    const char* name;
+    void (*packR11G11B10F)(const float* rgb, uint32_t* packed, size_t count);
+    void (*convertSRGBToR11G11B10F)(const uint32_t* argb, uint32_t* packed, size_t count);
+    void (*convertBumpToNormals)(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t* normals,
+                                 int width);
+    void (*invertPixels)(uint32_t* pixels, size_t count);
+};
+
+// the reference implementation first, then those this CPU can run
+std::vector<Implementation> getImplementations();
+
+} // namespace kernels
+
+} // namespace image
+
+#endif // hifi_image_ImageKernels_h
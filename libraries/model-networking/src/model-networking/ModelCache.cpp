@@ -180,7 +180,8 @@ void GeometryReader::run() {
             (_url.path().toLower().endsWith(".fbx") ||
                 _url.path().toLower().endsWith(".obj") ||
                 _url.path().toLower().endsWith(".obj.gz") ||
-                _url.path().toLower().endsWith(".gltf"))) {
+                _url.path().toLower().endsWith(".gltf") ||
+                _url.path().toLower().endsWith(".glb"))) {
 
             FBXGeometry::Pointer fbxGeometry;
 
@@ -199,7 +200,7 @@ void GeometryReader::run() {
                     throw QString("failed to decompress .obj.gz");
                 }
 
-            } else if (_url.path().toLower().endsWith(".gltf")) {
+            } else if (_url.path().toLower().endsWith(".gltf") || _url.path().toLower().endsWith(".glb")) {
                 std::shared_ptr<GLTFReader> glreader = std::make_shared<GLTFReader>();
                 fbxGeometry.reset(glreader->readGLTF(_data, _mapping, _url));
                 if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
@@ -114,6 +114,7 @@ public:
     QUrl getURL() const { return (bool)_resource ? _resource->getURL() : QUrl(); }
     int getResourceDownloadAttempts() { return _resource ? _resource->getDownloadAttempts() : 0; }
     int getResourceDownloadAttemptsRemaining() { return _resource ? _resource->getDownloadAttemptsRemaining() : 0; }
+    void setLoadPriority(const QPointer<QObject>& owner, float priority) { if (_resource) { _resource->setLoadPriority(owner, priority); } }
 
 private:
     void startWatching();
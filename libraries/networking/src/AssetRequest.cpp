@@ -25,6 +25,9 @@
 
 static int requestID = 0;
 
+const qint64 AssetRequest::STREAM_RANGE_SIZE = 1024 * 1024;
+const int AssetRequest::MAX_PIPELINED_RANGES = 4;
+
 AssetRequest::AssetRequest(const QString& hash, const ByteRange& byteRange) :
     _requestID(++requestID),
     _hash(hash),
@@ -38,6 +41,27 @@ AssetRequest::~AssetRequest() {
     if (_assetRequestID) {
         assetClient->cancelGetAssetRequest(_assetRequestID);
     }
+    if (_assetInfoRequestID) {
+        assetClient->cancelGetAssetInfoRequest(_assetInfoRequestID);
+    }
+    for (const auto& range : _pendingRanges) {
+        if (range.second != INVALID_MESSAGE_ID) {
+            assetClient->cancelGetAssetRequest(range.second);
+        }
+    }
+}
+
+AssetRequest::Error AssetRequest::errorFromServerError(AssetUtils::AssetServerError serverError) {
+    switch (serverError) {
+        case AssetUtils::AssetServerError::NoError:
+            return NoError;
+        case AssetUtils::AssetServerError::AssetNotFound:
+            return NotFound;
+        case AssetUtils::AssetServerError::InvalidByteRange:
+            return InvalidByteRange;
+        default:
+            return UnknownError;
+    }
 }
 
 void AssetRequest::start() {
@@ -67,6 +91,10 @@ void AssetRequest::start() {
 
         _loadedFromCache = true;
 
+        if (_streaming) {
+            emit dataReceived(_data);
+        }
+
         _state = Finished;
         emit finished(this);
 
@@ -75,6 +103,44 @@ void AssetRequest::start() {
 
     _state = WaitingForData;
 
+    if (!_streaming || _byteRange.isSet()) {
+        requestAsset();
+        return;
+    }
+
+    // find out how big the asset is first, so it can be split into ranges
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this);
+
+    _assetInfoRequestID = assetClient->getAssetInfo(_hash,
+        [this, that](bool responseReceived, AssetUtils::AssetServerError serverError, AssetInfo info) {
+
+        if (!that) {
+            return;
+        }
+        _assetInfoRequestID = INVALID_MESSAGE_ID;
+
+        if (!responseReceived) {
+            _error = NetworkError;
+        } else {
+            _error = errorFromServerError(serverError);
+        }
+
+        if (_error != NoError) {
+            qCWarning(asset_client) << "Got error retrieving size of asset" << _hash << "- error code" << _error;
+            _state = Finished;
+            emit finished(this);
+        } else if (info.size <= STREAM_RANGE_SIZE) {
+            // small enough that splitting it up gains nothing
+            _streaming = false;
+            requestAsset();
+        } else {
+            requestStreamedAsset(info.size);
+        }
+    });
+}
+
+void AssetRequest::requestAsset() {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
@@ -92,17 +158,7 @@ void AssetRequest::start() {
         if (!responseReceived) {
             _error = NetworkError;
         } else if (serverError != AssetUtils::AssetServerError::NoError) {
-            switch (serverError) {
-                case AssetUtils::AssetServerError::AssetNotFound:
-                    _error = NotFound;
-                    break;
-                case AssetUtils::AssetServerError::InvalidByteRange:
-                    _error = InvalidByteRange;
-                    break;
-                default:
-                    _error = UnknownError;
-                    break;
-            }
+            _error = errorFromServerError(serverError);
         } else {
             if (!_byteRange.isSet() && AssetUtils::hashData(data).toHex() != _hash) {
                 // the hash of the received data does not match what we expect, so we return an error
@@ -114,6 +170,10 @@ void AssetRequest::start() {
                 _totalReceived += data.size();
                 emit progress(_totalReceived, data.size());
 
+                if (_streaming) {
+                    emit dataReceived(_data);
+                }
+
                 if (!_byteRange.isSet()) {
                     AssetUtils::saveToCache(getUrl(), data);
                 }
@@ -135,6 +195,133 @@ void AssetRequest::start() {
     });
 }
 
+void AssetRequest::requestStreamedAsset(qint64 size) {
+    _streamSize = size;
+    _numRanges = (int)((size + STREAM_RANGE_SIZE - 1) / STREAM_RANGE_SIZE);
+    _data.reserve(size);
+
+    qCDebug(asset_client) << "Streaming" << _hash << "(" << size << "bytes) in" << _numRanges << "ranges";
+
+    requestNextRanges();
+}
+
+void AssetRequest::requestNextRanges() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this);
+
+    // only keep a few ranges ahead of the one being waited on, so a slow range doesn't pile up the ones after it
+    while (_state == WaitingForData && _nextRangeToRequest < _numRanges &&
+           _nextRangeToRequest < _nextRangeToDeliver + MAX_PIPELINED_RANGES) {
+        int rangeIndex = _nextRangeToRequest++;
+        auto start = rangeIndex * STREAM_RANGE_SIZE;
+        auto end = std::min(start + STREAM_RANGE_SIZE, _streamSize);
+
+        // the reply can come back before getAsset returns if the request could not be sent
+        _pendingRanges[rangeIndex] = INVALID_MESSAGE_ID;
+        auto messageID = assetClient->getAsset(_hash, start, end,
+            [this, that, rangeIndex](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data) {
+            if (that) {
+                handleRangeReceived(rangeIndex, responseReceived, serverError, data);
+            }
+        }, [this, that, rangeIndex](qint64 totalReceived, qint64 total) {
+            if (that) {
+                handleRangeProgress(rangeIndex, totalReceived);
+            }
+        });
+
+        auto it = _pendingRanges.find(rangeIndex);
+        if (it != _pendingRanges.end()) {
+            it->second = messageID;
+        }
+    }
+}
+
+void AssetRequest::handleRangeProgress(int rangeIndex, qint64 rangeReceived) {
+    if (_state != WaitingForData) {
+        return;
+    }
+
+    _rangesReceived[rangeIndex] = rangeReceived;
+    emit progress(getStreamReceived(), _streamSize);
+}
+
+qint64 AssetRequest::getStreamReceived() const {
+    // the ranges in flight make progress side by side, so add up what each has so far to what is finished
+    qint64 received = (qint64)_totalReceived;
+    for (const auto& range : _rangesReceived) {
+        received += range.second;
+    }
+    return received;
+}
+
+void AssetRequest::handleRangeReceived(int rangeIndex, bool responseReceived, AssetUtils::AssetServerError serverError,
+                                       const QByteArray& data) {
+    _pendingRanges.erase(rangeIndex);
+    _rangesReceived.erase(rangeIndex);
+
+    if (_state != WaitingForData) {
+        return;
+    }
+
+    auto expectedSize = std::min(STREAM_RANGE_SIZE, _streamSize - rangeIndex * STREAM_RANGE_SIZE);
+
+    if (!responseReceived) {
+        _error = NetworkError;
+    } else if (serverError != AssetUtils::AssetServerError::NoError) {
+        _error = errorFromServerError(serverError);
+    } else if (data.size() != expectedSize) {
+        _error = SizeVerificationFailed;
+    }
+
+    if (_error != NoError) {
+        qCWarning(asset_client) << "Got error retrieving range" << rangeIndex << "of asset" << _hash << "- error code" << _error;
+        finishStream();
+        return;
+    }
+
+    _totalReceived += data.size();
+    emit progress(getStreamReceived(), _streamSize);
+
+    _receivedRanges[rangeIndex] = data;
+
+    // hand on everything that is now in order
+    auto it = _receivedRanges.begin();
+    while (it != _receivedRanges.end() && it->first == _nextRangeToDeliver) {
+        _streamHash.addData(it->second);
+        _data.append(it->second);
+        emit dataReceived(it->second);
+
+        it = _receivedRanges.erase(it);
+        ++_nextRangeToDeliver;
+    }
+
+    if (_nextRangeToDeliver == _numRanges) {
+        if (_streamHash.result().toHex() != _hash) {
+            _error = HashVerificationFailed;
+            qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+        } else {
+            AssetUtils::saveToCache(getUrl(), _data);
+        }
+        finishStream();
+    } else {
+        requestNextRanges();
+    }
+}
+
+void AssetRequest::finishStream() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    for (const auto& range : _pendingRanges) {
+        if (range.second != INVALID_MESSAGE_ID) {
+            assetClient->cancelGetAssetRequest(range.second);
+        }
+    }
+    _pendingRanges.clear();
+    _rangesReceived.clear();
+    _receivedRanges.clear();
+
+    _state = Finished;
+    emit finished(this);
+}
 
 const QString AssetRequest::getErrorString() const {
     QString result;
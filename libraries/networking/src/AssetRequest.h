@@ -12,7 +12,10 @@
 #ifndef hifi_AssetRequest_h
 #define hifi_AssetRequest_h
 
+#include <map>
+
 #include <QByteArray>
+#include <QCryptographicHash>
 #include <QObject>
 #include <QString>
 
@@ -43,9 +46,20 @@ public:
         UnknownError
     };
     Q_ENUM(Error)
+
+    // Streamed assets are fetched as consecutive ranges of this size, a few of them in flight at once
+    static const qint64 STREAM_RANGE_SIZE;
+    static const int MAX_PIPELINED_RANGES;
+
     AssetRequest(const QString& hash, const ByteRange& byteRange = ByteRange());
     virtual ~AssetRequest() override;
 
+    // When streaming, an asset larger than a range is requested as several pipelined ranges and dataReceived is
+    // emitted with each piece, in order, as soon as everything before it has arrived. Uncached assets cost a round trip
+    // for their size first, so only stream when something uses the pieces. Must be set before start.
+    void setStreaming(bool streaming) { _streaming = streaming; }
+    bool isStreaming() const { return _streaming; }
+
     Q_INVOKABLE void start();
 
     const QByteArray& getData() const { return _data; }
@@ -60,8 +74,20 @@ public:
 signals:
     void finished(AssetRequest* thisRequest);
     void progress(qint64 totalReceived, qint64 total);
+    void dataReceived(QByteArray data);
 
 private:
+    void requestAsset();
+    void requestStreamedAsset(qint64 size);
+    void requestNextRanges();
+    void handleRangeProgress(int rangeIndex, qint64 rangeReceived);
+    qint64 getStreamReceived() const;
+    void handleRangeReceived(int rangeIndex, bool responseReceived, AssetUtils::AssetServerError serverError,
+                             const QByteArray& data);
+    void finishStream();
+
+    static Error errorFromServerError(AssetUtils::AssetServerError serverError);
+
     int _requestID;
     State _state = NotStarted;
     Error _error = NoError;
@@ -70,8 +96,19 @@ private:
     QByteArray _data;
     int _numPendingRequests { 0 };
     MessageID _assetRequestID { INVALID_MESSAGE_ID };
+    MessageID _assetInfoRequestID { INVALID_MESSAGE_ID };
     const ByteRange _byteRange;
     bool _loadedFromCache { false };
+
+    bool _streaming { false };
+    qint64 _streamSize { 0 };
+    int _numRanges { 0 };
+    int _nextRangeToRequest { 0 };
+    int _nextRangeToDeliver { 0 };
+    std::map<int, MessageID> _pendingRanges; // range index => request
+    std::map<int, qint64> _rangesReceived; // range index => bytes of it received so far, while in flight
+    std::map<int, QByteArray> _receivedRanges; // ranges that arrived before the ones ahead of them
+    QCryptographicHash _streamHash { QCryptographicHash::Sha256 };
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QTcpSocket>
@@ -35,10 +36,34 @@
 #include "Assignment.h"
 #include "HifiSockAddr.h"
 #include "NetworkLogging.h"
+#include "NodeCongestionControlFactory.h"
 #include "udt/Packet.h"
 
 static Setting::Handle<quint16> LIMITED_NODELIST_LOCAL_PORT("LimitedNodeList.LocalPort", 0);
 
+// node type name (or "Default") to congestion control name, see NodeCongestionControlFactory
+static Setting::Handle<QVariantMap> LIMITED_NODELIST_CONGESTION_CONTROL("LimitedNodeList.CongestionControl", QVariantMap());
+
+// assignment clients have no settings file, so HIFI_UDT_CONGESTION_CONTROL can override the setting,
+// e.g. "bbr" for every connection or "Agent=bbr;Default=vegas"
+static QVariantMap congestionControlSettings() {
+    auto settings = LIMITED_NODELIST_CONGESTION_CONTROL.get();
+
+    static const QString CONGESTION_CONTROL_ENV = "HIFI_UDT_CONGESTION_CONTROL";
+    auto environmentValue = QProcessEnvironment::systemEnvironment().value(CONGESTION_CONTROL_ENV);
+
+    for (const auto& entry : environmentValue.split(';', QString::SkipEmptyParts)) {
+        auto separator = entry.indexOf('=');
+        if (separator < 0) {
+            settings["Default"] = entry.trimmed();
+        } else {
+            settings[entry.left(separator).trimmed()] = entry.mid(separator + 1).trimmed();
+        }
+    }
+
+    return settings;
+}
+
 const std::set<NodeType_t> SOLO_NODE_TYPES = {
     NodeType::AvatarMixer,
     NodeType::AudioMixer,
@@ -113,6 +138,14 @@ LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     // set our socketBelongsToNode method as the connection creation filter operator for the udt::Socket
     _nodeSocket.setConnectionCreationFilterOperator(std::bind(&LimitedNodeList::sockAddrBelongsToNode, this, _1));
 
+    // choose the congestion control for each new connection from the type of node it is to
+    auto congestionControlFactory = new NodeCongestionControlFactory([this](const HifiSockAddr& sockAddr) {
+        auto node = findNodeWithAddr(sockAddr);
+        return node ? node->getType() : NodeType::Unassigned;
+    });
+    congestionControlFactory->configure(congestionControlSettings());
+    _nodeSocket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(congestionControlFactory));
+
     // handle when a socket connection has its receiver side reset - might need to emit clientConnectionToNodeReset
     connect(&_nodeSocket, &udt::Socket::clientHandshakeRequestComplete, this, &LimitedNodeList::clientConnectionToSockAddrReset);
 
@@ -312,11 +345,8 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
         if (sourceNode) {
             if (!PacketTypeEnum::getNonVerifiedPackets().contains(headerType)) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, sourceNode->getConnectionSecret());
-
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!NLPacket::verificationHashMatches(packet, sourceNode->getConnectionSecret())) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
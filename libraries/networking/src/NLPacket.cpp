@@ -11,6 +11,25 @@
 
 #include "NLPacket.h"
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QtEndian>
+
+#include <SipHash.h>
+
+static_assert(SIPHASH_128_SIZE == NUM_BYTES_MD5_HASH, "SipHash verification must fit the header's hash field");
+
+// the connection secret in RFC 4122 byte order, like QUuid::toRfc4122 but without the QByteArray
+static void connectionSecretBytes(const QUuid& connectionSecret, uint8_t bytes[NUM_BYTES_RFC4122_UUID]) {
+    quint32 data1 = qToBigEndian<quint32>(connectionSecret.data1);
+    quint16 data2 = qToBigEndian<quint16>(connectionSecret.data2);
+    quint16 data3 = qToBigEndian<quint16>(connectionSecret.data3);
+
+    memcpy(bytes, &data1, sizeof(data1));
+    memcpy(bytes + 4, &data2, sizeof(data2));
+    memcpy(bytes + 6, &data3, sizeof(data3));
+    memcpy(bytes + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+}
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = PacketTypeEnum::getNonSourcedPackets().contains(type);
     bool nonVerified = PacketTypeEnum::getNonVerifiedPackets().contains(type);
@@ -32,7 +51,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -69,6 +88,8 @@ NLPacket::NLPacket(PacketType type, qint64 size, bool isReliable, bool isPartOfM
     adjustPayloadStartAndCapacity(NLPacket::localHeaderSize(_type));
 
     writeTypeAndVersion();
+
+    setStream(streamForPacketType(_type));
 }
 
 NLPacket::NLPacket(Packet&& packet) :
@@ -87,7 +108,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -150,17 +171,51 @@ QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
 }
 
 QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
+    QByteArray hash(NUM_BYTES_MD5_HASH, 0);
+    computeVerificationHash(packet, connectionSecret, hash.data());
+    return hash;
+}
+
+void NLPacket::computeVerificationHash(const udt::Packet& packet, const QUuid& connectionSecret,
+                                       char hash[NUM_BYTES_MD5_HASH]) {
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
         + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
-    
-    // add the packet payload and the connection UUID
-    hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
-    hash.addData(connectionSecret.toRfc4122());
-    
-    // return the hash
-    return hash.result();
+
+    const char* payload = packet.getData() + offset;
+    int payloadSize = packet.getDataSize() - offset;
+
+    uint8_t secret[NUM_BYTES_RFC4122_UUID];
+    connectionSecretBytes(connectionSecret, secret);
+
+    if (verificationMethodForPacket(typeInHeader(packet), versionInHeader(packet)) == PacketVerificationMethod::SipHash) {
+        sipHash128(secret, payload, payloadSize, reinterpret_cast<uint8_t*>(hash));
+    } else {
+        QCryptographicHash md5(QCryptographicHash::Md5);
+
+        // add the packet payload and the connection UUID
+        md5.addData(payload, payloadSize);
+        md5.addData(reinterpret_cast<const char*>(secret), NUM_BYTES_RFC4122_UUID);
+
+        QByteArray result = md5.result();
+        memcpy(hash, result.constData(), NUM_BYTES_MD5_HASH);
+    }
+}
+
+bool NLPacket::verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret) {
+    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_RFC4122_UUID;
+
+    char expectedHash[NUM_BYTES_MD5_HASH];
+    computeVerificationHash(packet, connectionSecret, expectedHash);
+
+    // look at every byte so the time taken doesn't say how much of a forged hash was right
+    const char* headerHash = packet.getData() + offset;
+    char difference = 0;
+    for (int i = 0; i < NUM_BYTES_MD5_HASH; ++i) {
+        difference |= headerHash[i] ^ expectedHash[i];
+    }
+
+    return difference == 0;
 }
 
 void NLPacket::writeTypeAndVersion() {
@@ -218,7 +273,5 @@ void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) c
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    computeVerificationHash(*this, connectionSecret, _packet.get() + offset);
 }
@@ -0,0 +1,89 @@
+//
+//  NodeCongestionControlFactory.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeCongestionControlFactory.h"
+
+#include "HifiSockAddr.h"
+#include "NetworkLogging.h"
+#include "udt/BBRCC.h"
+#include "udt/TCPVegasCC.h"
+
+static const QString DEFAULT_NODE_TYPE_KEY = "Default";
+
+NodeCongestionControlFactory::NodeCongestionControlFactory(NodeTypeOperator nodeTypeOperator) :
+    _nodeTypeOperator(nodeTypeOperator)
+{
+
+}
+
+void NodeCongestionControlFactory::configure(const QVariantMap& algorithmsByNodeType) {
+    for (auto it = algorithmsByNodeType.begin(); it != algorithmsByNodeType.end(); ++it) {
+        Algorithm algorithm;
+        if (!algorithmFromString(it.value().toString(), algorithm)) {
+            qCWarning(networking) << "Ignoring unknown congestion control" << it.value().toString() << "for" << it.key();
+            continue;
+        }
+
+        if (it.key().compare(DEFAULT_NODE_TYPE_KEY, Qt::CaseInsensitive) == 0) {
+            _defaultAlgorithm = algorithm;
+            continue;
+        }
+
+        NodeType_t nodeType = NodeType::fromString(it.key());
+        if (nodeType == NodeType::Unassigned) {
+            qCWarning(networking) << "Ignoring congestion control for unknown node type" << it.key();
+            continue;
+        }
+
+        _algorithms[nodeType] = algorithm;
+    }
+}
+
+NodeCongestionControlFactory::Algorithm NodeCongestionControlFactory::algorithmForNodeType(NodeType_t nodeType) const {
+    return _algorithms.value(nodeType, _defaultAlgorithm);
+}
+
+bool NodeCongestionControlFactory::algorithmFromString(const QString& name, Algorithm& algorithm) {
+    auto lowerName = name.trimmed().toLower();
+
+    if (lowerName == "udt") {
+        algorithm = Algorithm::UDT;
+    } else if (lowerName == "vegas") {
+        algorithm = Algorithm::TCPVegas;
+    } else if (lowerName == "bbr") {
+        algorithm = Algorithm::BBR;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+std::unique_ptr<udt::CongestionControl> NodeCongestionControlFactory::create() {
+    return createForAlgorithm(_defaultAlgorithm);
+}
+
+std::unique_ptr<udt::CongestionControl> NodeCongestionControlFactory::createForDestination(const HifiSockAddr& destination) {
+    // anything that isn't a node we know about (the domain server, an ICE peer) gets the default
+    NodeType_t nodeType = _nodeTypeOperator ? _nodeTypeOperator(destination) : NodeType::Unassigned;
+    return createForAlgorithm(algorithmForNodeType(nodeType));
+}
+
+std::unique_ptr<udt::CongestionControl> NodeCongestionControlFactory::createForAlgorithm(Algorithm algorithm) {
+    switch (algorithm) {
+        case Algorithm::UDT:
+            return std::unique_ptr<udt::CongestionControl>(new udt::DefaultCC());
+        case Algorithm::BBR:
+            return std::unique_ptr<udt::CongestionControl>(new udt::BBRCC());
+        case Algorithm::TCPVegas:
+        default:
+            return std::unique_ptr<udt::CongestionControl>(new udt::TCPVegasCC());
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  NodeCongestionControlFactory.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NodeCongestionControlFactory_h
+#define hifi_NodeCongestionControlFactory_h
+
+#include <functional>
+
+#include <QtCore/QHash>
+#include <QtCore/QVariantMap>
+
+#include "NodeType.h"
+#include "udt/CongestionControl.h"
+
+// Picks the congestion control for each new udt connection from the type of node at the other end, so that for
+// example connections to the asset server can use BBRCC while everything else stays on TCPVegasCC.
+//
+// The choice is read from a map of node type name (as in NodeType::getNodeTypeName, or "Default") to algorithm name
+// ("udt", "vegas" or "bbr"). Both ends of a connection should normally use the same algorithm.
+class NodeCongestionControlFactory : public udt::CongestionControlVirtualFactory {
+public:
+    enum class Algorithm {
+        UDT, // DefaultCC
+        TCPVegas, // TCPVegasCC
+        BBR // BBRCC
+    };
+
+    using NodeTypeOperator = std::function<NodeType_t(const HifiSockAddr&)>;
+
+    NodeCongestionControlFactory(NodeTypeOperator nodeTypeOperator);
+
+    // must be called before the factory is given to the socket, it isn't protected against concurrent connections
+    void configure(const QVariantMap& algorithmsByNodeType);
+
+    Algorithm algorithmForNodeType(NodeType_t nodeType) const;
+
+    static bool algorithmFromString(const QString& name, Algorithm& algorithm);
+
+    virtual std::unique_ptr<udt::CongestionControl> create() override;
+    virtual std::unique_ptr<udt::CongestionControl> createForDestination(const HifiSockAddr& destination) override;
+
+private:
+    static std::unique_ptr<udt::CongestionControl> createForAlgorithm(Algorithm algorithm);
+
+    NodeTypeOperator _nodeTypeOperator;
+
+    Algorithm _defaultAlgorithm { Algorithm::TCPVegas };
+    QHash<NodeType_t, Algorithm> _algorithms;
+};
+
+#endif // hifi_NodeCongestionControlFactory_h
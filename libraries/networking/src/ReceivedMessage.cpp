@@ -12,6 +12,8 @@
 
 #include "ReceivedMessage.h"
 
+#include <algorithm>
+
 #include "QSharedPointer"
 
 int receivedMessageMetaTypeId = qRegisterMetaType<ReceivedMessage*>("ReceivedMessage*");
@@ -20,32 +22,48 @@ int sharedPtrReceivedMessageMetaTypeId = qRegisterMetaType<QSharedPointer<Receiv
 static const int HEAD_DATA_SIZE = 512;
 
 ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
-    : _data(packetList.getMessage()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(packetList.getNumPackets()),
+    : _numPackets(packetList.getNumPackets()),
       _sourceID(packetList.getSourceID()),
       _packetType(packetList.getType()),
       _packetVersion(packetList.getVersion()),
       _senderSockAddr(packetList.getSenderSockAddr())
 {
+    Chunk chunk;
+    chunk.ownedData = packetList.getMessage();
+    appendChunk(std::move(chunk));
 }
 
 ReceivedMessage::ReceivedMessage(NLPacket& packet)
-    : _data(packet.readAll()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(1),
+    : _numPackets(1),
       _sourceID(packet.getSourceID()),
       _packetType(packet.getType()),
       _packetVersion(packet.getVersion()),
       _senderSockAddr(packet.getSenderSockAddr()),
       _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
 {
+    Chunk chunk;
+    chunk.ownedData = packet.readAll();
+    appendChunk(std::move(chunk));
+}
+
+ReceivedMessage::ReceivedMessage(std::unique_ptr<NLPacket> packet)
+    : _numPackets(1),
+      _sourceID(packet->getSourceID()),
+      _packetType(packet->getType()),
+      _packetVersion(packet->getVersion()),
+      _senderSockAddr(packet->getSenderSockAddr()),
+      _isComplete(packet->getPacketPosition() == NLPacket::ONLY)
+{
+    // like the copying constructor, the message starts at the packet's current position
+    Chunk chunk;
+    chunk.data = packet->getPayload() + packet->pos();
+    chunk.size = packet->bytesLeftToRead();
+    chunk.buffer = packet->releaseBuffer();
+    appendChunk(std::move(chunk));
 }
 
 ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                 const HifiSockAddr& senderSockAddr, QUuid sourceID) :
-    _data(byteArray),
-    _headData(_data.mid(0, HEAD_DATA_SIZE)),
     _numPackets(1),
     _sourceID(sourceID),
     _packetType(packetType),
@@ -53,6 +71,122 @@ ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, Pa
     _senderSockAddr(senderSockAddr),
     _isComplete(true)
 {
+    Chunk chunk;
+    chunk.ownedData = byteArray;
+    appendChunk(std::move(chunk));
+}
+
+void ReceivedMessage::appendChunk(Chunk&& chunk) {
+    if (!chunk.buffer) {
+        chunk.data = chunk.ownedData.constData();
+        chunk.size = chunk.ownedData.size();
+    }
+
+    std::lock_guard<std::mutex> lock(_dataMutex);
+
+    if (chunk.size <= 0 && !_chunks.empty()) {
+        return;
+    }
+
+    chunk.start = _size;
+
+    // the head comes from the first chunk only, since readHead can run while later chunks are being appended
+    if (_chunks.empty()) {
+        _headData = QByteArray(chunk.data, std::min(chunk.size, (qint64)HEAD_DATA_SIZE));
+    }
+
+    auto size = chunk.size;
+    _chunks.push_back(std::move(chunk));
+    _size += size;
+}
+
+QByteArray ReceivedMessage::getMessage() const {
+    ensureContiguous();
+
+    std::lock_guard<std::mutex> lock(_dataMutex);
+    if (_data.isNull()) {
+        // a message held in a single chunk it owns doesn't need a copy
+        return _chunks.front().ownedData;
+    }
+    return _data;
+}
+
+const char* ReceivedMessage::getRawMessage() const {
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        if (_chunks.size() == 1) {
+            return _chunks.front().data;
+        }
+    }
+    ensureContiguous();
+    return _data.constData();
+}
+
+int ReceivedMessage::getNumChunks() const {
+    std::lock_guard<std::mutex> lock(_dataMutex);
+    return (int)_chunks.size();
+}
+
+void ReceivedMessage::ensureContiguous() const {
+    std::lock_guard<std::mutex> lock(_dataMutex);
+
+    if (!_data.isNull() || (_chunks.size() == 1 && !_chunks.front().buffer)) {
+        return;
+    }
+
+    Q_ASSERT_X(_isComplete, "ReceivedMessage::ensureContiguous",
+               "The whole message should only be asked for once it is complete");
+
+    QByteArray data;
+    data.resize(_size);
+    for (const auto& chunk : _chunks) {
+        memcpy(data.data() + chunk.start, chunk.data, chunk.size);
+    }
+    _data = data;
+}
+
+size_t ReceivedMessage::findChunk(qint64 position) const {
+    size_t index = _lastChunk;
+    if (index < _chunks.size()) {
+        const auto& chunk = _chunks[index];
+        if (position >= chunk.start && position < chunk.start + chunk.size) {
+            return index;
+        }
+        // the next read most often starts at the next chunk
+        if (index + 1 < _chunks.size() && position >= _chunks[index + 1].start &&
+            position < _chunks[index + 1].start + _chunks[index + 1].size) {
+            _lastChunk = index + 1;
+            return index + 1;
+        }
+    }
+
+    if (position < 0 || position >= _size) {
+        return _chunks.size();
+    }
+
+    auto it = std::upper_bound(_chunks.begin(), _chunks.end(), position, [](qint64 position, const Chunk& chunk) {
+        return position < chunk.start;
+    });
+    index = (it - _chunks.begin()) - 1;
+    _lastChunk = index;
+    return index;
+}
+
+qint64 ReceivedMessage::copyOut(qint64 position, char* data, qint64 size) const {
+    std::lock_guard<std::mutex> lock(_dataMutex);
+
+    size = std::max(std::min(size, _size - position), (qint64)0);
+
+    qint64 copied = 0;
+    for (auto index = findChunk(position); copied < size && index < _chunks.size(); ++index) {
+        const auto& chunk = _chunks[index];
+        auto offset = position + copied - chunk.start;
+        auto toCopy = std::min(chunk.size - offset, size - copied);
+        memcpy(data + copied, chunk.data + offset, toCopy);
+        copied += toCopy;
+    }
+
+    return copied;
 }
 
 void ReceivedMessage::setFailed() {
@@ -61,7 +195,7 @@ void ReceivedMessage::setFailed() {
     emit completed();
 }
 
-void ReceivedMessage::appendPacket(NLPacket& packet) {
+void ReceivedMessage::appendPacket(std::unique_ptr<NLPacket> packet) {
     Q_ASSERT_X(!_isComplete, "ReceivedMessage::appendPacket", 
                "We should not be appending to a complete message");
 
@@ -70,27 +204,33 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
+    bool isLast = packet->getPacketPosition() == NLPacket::PacketPosition::LAST;
+
+    // keep the packet's buffer as the next chunk rather than copying its payload out
+    Chunk chunk;
+    chunk.data = packet->getPayload();
+    chunk.size = packet->getPayloadSize();
+    chunk.buffer = packet->releaseBuffer();
+    appendChunk(std::move(chunk));
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress(getSize());
     }
 
-    if (packet.getPacketPosition() == NLPacket::PacketPosition::LAST) {
+    if (isLast) {
         _isComplete = true;
         emit completed();
     }
 }
 
 qint64 ReceivedMessage::peek(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    return size;
+    return copyOut(_position, data, size);
 }
 
 qint64 ReceivedMessage::read(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    _position += size;
-    return size;
+    auto read = copyOut(_position, data, size);
+    _position += read;
+    return read;
 }
 
 qint64 ReceivedMessage::readHead(char* data, qint64 size) {
@@ -100,12 +240,15 @@ qint64 ReceivedMessage::readHead(char* data, qint64 size) {
 }
 
 QByteArray ReceivedMessage::peek(qint64 size) {
-    return _data.mid(_position, size);
+    QByteArray data;
+    data.resize(std::max(std::min(size, getBytesLeftToRead()), (qint64)0));
+    copyOut(_position, data.data(), data.size());
+    return data;
 }
 
 QByteArray ReceivedMessage::read(qint64 size) {
-    auto data = _data.mid(_position, size);
-    _position += size;
+    auto data = peek(size);
+    _position += data.size();
     return data;
 }
 
@@ -119,19 +262,57 @@ QByteArray ReceivedMessage::readAll() {
     return read(getBytesLeftToRead());
 }
 
+qint64 ReceivedMessage::readAll(QIODevice& device) {
+    qint64 written = 0;
+    for (auto chunk = readChunkWithoutCopy(); !chunk.isEmpty(); chunk = readChunkWithoutCopy()) {
+        if (device.write(chunk) != chunk.size()) {
+            return -1;
+        }
+        written += chunk.size();
+    }
+    return written;
+}
+
 QString ReceivedMessage::readString() {
     uint32_t size;
     readPrimitive(&size);
     //Q_ASSERT(size <= _size - _position);
-    auto string = QString::fromUtf8(_data.constData() + _position, size);
-    _position += size;
-    return string;
+    return QString::fromUtf8(readWithoutCopy(size));
 }
 
 QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
-    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
+    size = std::max(std::min(size, getBytesLeftToRead()), (qint64)0);
+
+    qint64 position = _position;
+    const char* data = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        auto index = findChunk(position);
+        if (index < _chunks.size() && position + size <= _chunks[index].start + _chunks[index].size) {
+            data = _chunks[index].data + (position - _chunks[index].start);
+        }
+    }
+    if (!data && size > 0) {
+        ensureContiguous();
+        data = _data.constData() + position;
+    }
+
     _position += size;
-    return data;
+    return QByteArray::fromRawData(data, size);
+}
+
+QByteArray ReceivedMessage::readChunkWithoutCopy() {
+    qint64 chunkEnd;
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        auto index = findChunk(_position);
+        if (index >= _chunks.size()) {
+            return QByteArray();
+        }
+        chunkEnd = _chunks[index].start + _chunks[index].size;
+    }
+    return readWithoutCopy(chunkEnd - _position);
 }
 
 void ReceivedMessage::onComplete() {
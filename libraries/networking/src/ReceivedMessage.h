@@ -16,26 +16,35 @@
 #include <QObject>
 
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "NLPacketList.h"
 
+// A message is kept as the list of chunks it arrived in - for a message received in packets each chunk is the payload
+// of one packet, still in that packet's buffer - so reassembling a large message doesn't copy it into an ever growing
+// array. Reads copy straight out of the chunks, a contiguous copy is only made if a handler asks for the whole message
+// with getMessage() or getRawMessage(). Handlers that can consume the message piece by piece should prefer
+// readChunkWithoutCopy() or readAll(QIODevice&), which never need one.
 class ReceivedMessage : public QObject {
     Q_OBJECT
 public:
     ReceivedMessage(const NLPacketList& packetList);
-    ReceivedMessage(NLPacket& packet);
+    ReceivedMessage(NLPacket& packet); // copies the rest of the packet, prefer taking ownership of it when possible
+    ReceivedMessage(std::unique_ptr<NLPacket> packet);
     ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                     const HifiSockAddr& senderSockAddr, QUuid sourceID = QUuid());
 
-    QByteArray getMessage() const { return _data; }
-    const char* getRawMessage() const { return _data.constData(); }
+    // These need the message in one piece, which costs a copy of it the first time for a multi-packet message
+    QByteArray getMessage() const;
+    const char* getRawMessage() const;
 
     PacketType getType() const { return _packetType; }
     PacketVersion getVersion() const { return _packetVersion; }
 
     void setFailed();
 
-    void appendPacket(NLPacket& packet);
+    void appendPacket(std::unique_ptr<NLPacket> packet);
 
     bool failed() const { return _failed; }
     bool isComplete() const { return _isComplete; }
@@ -48,9 +57,12 @@ public:
     // Get the number of packets that were used to send this message
     qint64 getNumPackets() const { return _numPackets; }
 
-    qint64 getSize() const { return _data.size(); }
+    qint64 getSize() const { return _size; }
 
-    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+    qint64 getBytesLeftToRead() const { return _size -  _position; }
+
+    // Get the number of pieces the message is held in, one per packet unless a contiguous copy was asked for first
+    int getNumChunks() const;
 
     void seek(qint64 position) { _position = position; }
 
@@ -72,8 +84,17 @@ public:
     // This will return a QByteArray referencing the underlying data _without_ refcounting that data.
     // Be careful when using this method, only use it when the lifetime of the returned QByteArray will not
     // exceed that of the ReceivedMessage.
+    // If the data spans more than one chunk this falls back to the contiguous copy of the message.
     QByteArray readWithoutCopy(qint64 size);
 
+    // Reads the rest of the chunk the position is in, without copying it - the same lifetime rules as
+    // readWithoutCopy apply. Returns an empty QByteArray once the whole message has been read.
+    QByteArray readChunkWithoutCopy();
+
+    // Writes the rest of the message to the device a chunk at a time and returns the number of bytes written,
+    // or -1 if the device failed
+    qint64 readAll(QIODevice& device);
+
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
 
@@ -87,7 +108,32 @@ private slots:
     void onComplete();
 
 private:
-    QByteArray _data;
+    struct Chunk {
+        udt::PacketBuffer buffer; // the packet buffer the chunk is in, if it is not in ownedData
+        QByteArray ownedData;
+        const char* data { nullptr };
+        qint64 size { 0 };
+        qint64 start { 0 }; // where the chunk starts in the message
+    };
+
+    void appendChunk(Chunk&& chunk);
+
+    // finds the chunk the position is in, returns the number of chunks past the end of the message - the caller holds
+    // _dataMutex, since packets can still be appended while the message is read
+    size_t findChunk(qint64 position) const;
+
+    qint64 copyOut(qint64 position, char* data, qint64 size) const;
+
+    void ensureContiguous() const;
+
+    std::vector<Chunk> _chunks;
+    std::atomic<qint64> _size { 0 };
+    mutable std::atomic<size_t> _lastChunk { 0 }; // reads are mostly sequential, so start looking where the last one was
+
+    // built on demand and kept alongside the chunks, so data handed out by readWithoutCopy stays valid
+    mutable QByteArray _data;
+    mutable std::mutex _dataMutex; // guards _chunks and _data - a chunk's data doesn't move once it is appended
+
     QByteArray _headData;
 
     std::atomic<qint64> _position { 0 };
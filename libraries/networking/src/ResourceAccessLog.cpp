@@ -0,0 +1,108 @@
+//
+//  ResourceAccessLog.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceAccessLog.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QFile>
+
+#include <SharedUtil.h>
+
+#include "NetworkLogging.h"
+
+static const char FIELD_SEPARATOR = '\t';
+static const int NUM_FIELDS = 6;
+
+static const QByteArray GET_EVENT = "get";
+static const QByteArray RELEASE_EVENT = "release";
+
+static std::mutex logMutex;
+static std::unique_ptr<QFile> logFile;
+static std::atomic<bool> recording { false };
+
+bool ResourceAccessLog::start(const QString& filePath) {
+    std::lock_guard<std::mutex> lock(logMutex);
+
+    std::unique_ptr<QFile> file { new QFile(filePath) };
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(resourceLog) << "Could not open resource access log" << filePath;
+        return false;
+    }
+
+    qCInfo(resourceLog) << "Recording resource accesses to" << filePath;
+    logFile = std::move(file);
+    recording = true;
+    return true;
+}
+
+void ResourceAccessLog::stop() {
+    std::lock_guard<std::mutex> lock(logMutex);
+    recording = false;
+    logFile.reset();
+}
+
+bool ResourceAccessLog::isRecording() {
+    return recording;
+}
+
+void ResourceAccessLog::record(Event event, const QString& cache, const QUrl& url, qint64 size, quint64 costUsecs) {
+    if (!recording) {
+        return;
+    }
+
+    QByteArray line;
+    line += QByteArray::number(usecTimestampNow()) + FIELD_SEPARATOR;
+    line += (event == GET ? GET_EVENT : RELEASE_EVENT) + FIELD_SEPARATOR;
+    line += cache.toUtf8() + FIELD_SEPARATOR;
+    line += QByteArray::number(size) + FIELD_SEPARATOR;
+    line += QByteArray::number(costUsecs) + FIELD_SEPARATOR;
+    line += url.toEncoded() + '\n';
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (logFile) {
+        logFile->write(line);
+    }
+}
+
+bool ResourceAccessLog::parse(const QByteArray& line, Record& record) {
+    auto fields = line.trimmed().split(FIELD_SEPARATOR);
+    if (fields.size() != NUM_FIELDS) {
+        return false;
+    }
+
+    bool ok = true;
+    record.usecs = fields[0].toULongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+
+    if (fields[1] == GET_EVENT) {
+        record.event = GET;
+    } else if (fields[1] == RELEASE_EVENT) {
+        record.event = RELEASE;
+    } else {
+        return false;
+    }
+
+    record.cache = QString::fromUtf8(fields[2]);
+    record.size = fields[3].toLongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+    record.costUsecs = fields[4].toULongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+    record.url = QString::fromUtf8(fields[5]);
+    return true;
+}
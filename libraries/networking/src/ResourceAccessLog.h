@@ -0,0 +1,49 @@
+//
+//  ResourceAccessLog.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceAccessLog_h
+#define hifi_ResourceAccessLog_h
+
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+/// Records when the resource caches are asked for resources and when the resources are let go of, so a session can
+/// be replayed against different eviction policies (see tests/resource-cache-replay).
+///
+/// Each line of the log is one event: the time in microseconds, "get" or "release", the class of the cache, the size
+/// and load cost in microseconds the resource is known to have (0 before it is loaded) and the url, separated by tabs.
+class ResourceAccessLog {
+public:
+    enum Event {
+        GET,
+        RELEASE
+    };
+
+    struct Record {
+        quint64 usecs { 0 };
+        Event event { GET };
+        QString cache;
+        qint64 size { 0 };
+        quint64 costUsecs { 0 };
+        QString url;
+    };
+
+    /// Starts writing the log to a file, replacing it.
+    static bool start(const QString& filePath);
+    static void stop();
+    static bool isRecording();
+
+    static void record(Event event, const QString& cache, const QUrl& url, qint64 size, quint64 costUsecs);
+
+    /// Reads back a line of a log.
+    static bool parse(const QByteArray& line, Record& record);
+};
+
+#endif // hifi_ResourceAccessLog_h
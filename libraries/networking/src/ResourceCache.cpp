@@ -11,6 +11,7 @@
 
 #include "ResourceCache.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <assert.h>
@@ -18,12 +19,14 @@
 #include <QThread>
 #include <QTimer>
 
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <shared/QtHelpers.h>
 #include <Trace.h>
 #include <Profile.h>
 
 #include "NetworkAccessManager.h"
+#include "ResourceAccessLog.h"
 #include "NetworkLogging.h"
 #include "NodeList.h"
 
@@ -32,23 +35,63 @@
                            (((x) > (max)) ? (max) :\
                                             (x)))
 
+// a transfer's rate is only a measure of the bandwidth once it is large enough for the latency not to dominate
+static const qint64 MIN_TRANSFER_RATE_SAMPLE_BYTES = 256 * 1024;
+static const double TRANSFER_RATE_SMOOTHING = 0.25;
+// transfers that get much slower than they were are sharing a saturated link, so fewer run at once
+static const double SATURATED_TRANSFER_RATE_RATIO = 0.5;
+static const int MIN_PROTOCOL_REQUEST_LIMIT = 2;
+
+static const double WAIT_TIME_SMOOTHING = 0.1;
+
+// loading requests are only preempted for pending ones that are clearly more important
+static const float MIN_PREEMPTING_PRIORITY_GAIN = 0.1f;
+
+ResourceCacheSharedItems::Protocol ResourceCacheSharedItems::getProtocol(const QUrl& url) {
+    auto scheme = url.scheme();
+    if (scheme == URL_SCHEME_FILE || scheme == URL_SCHEME_QRC) {
+        return FILE_PROTOCOL;
+    } else if (scheme == URL_SCHEME_ATP) {
+        return ATP_PROTOCOL;
+    }
+    return HTTP_PROTOCOL;
+}
+
 void ResourceCacheSharedItems::appendActiveRequest(QWeakPointer<Resource> resource) {
+    auto strongResource = resource.lock();
+    if (!strongResource) {
+        return;
+    }
+
     Lock lock(_mutex);
-    _loadingRequests.append(resource);
+    _lanes[getProtocol(strongResource->getURL())].loading.append({ resource, usecTimestampNow() });
+    ++_numLoading;
 }
 
 void ResourceCacheSharedItems::appendPendingRequest(QWeakPointer<Resource> resource) {
+    auto strongResource = resource.lock();
+    if (!strongResource) {
+        return;
+    }
+
+    float priority = strongResource->getLoadPriority();
+
     Lock lock(_mutex);
-    _pendingRequests.append(resource);
+    auto& pending = _lanes[getProtocol(strongResource->getURL())].pending;
+    pending.push_back({ resource, priority, _nextSequence++, usecTimestampNow() });
+    std::push_heap(pending.begin(), pending.end());
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _pendingRequests) {
-        if (resource) {
-            result.append(resource);
+    for (const auto& lane : _lanes) {
+        for (const auto& request : lane.pending) {
+            auto resource = request.resource.lock();
+            if (resource) {
+                result.append(resource);
+            }
         }
     }
 
@@ -57,16 +100,23 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
 
 uint32_t ResourceCacheSharedItems::getPendingRequestsCount() const {
     Lock lock(_mutex);
-    return _pendingRequests.size();
+    uint32_t count = 0;
+    for (const auto& lane : _lanes) {
+        count += (uint32_t)lane.pending.size();
+    }
+    return count;
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _loadingRequests) {
-        if (resource) {
-            result.append(resource);
+    for (const auto& lane : _lanes) {
+        for (const auto& request : lane.loading) {
+            auto resource = request.resource.lock();
+            if (resource) {
+                result.append(resource);
+            }
         }
     }
 
@@ -75,60 +125,196 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() {
 
 uint32_t ResourceCacheSharedItems::getLoadingRequestsCount() const {
     Lock lock(_mutex);
-    return _loadingRequests.size();
+    return _numLoading;
 }
 
-void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
+void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource, bool wasPreempted) {
+    auto strongResource = resource.lock();
+    quint64 now = usecTimestampNow();
     Lock lock(_mutex);
 
     // resource can only be removed if it still has a ref-count, as
     // QWeakPointer has no operator== implementation for two weak ptrs, so
     // manually loop in case resource has been freed.
-    for (int i = 0; i < _loadingRequests.size();) {
-        auto request = _loadingRequests.at(i);
-        // Clear our resource and any freed resources
-        if (!request || request.data() == resource.data()) {
-            _loadingRequests.removeAt(i);
-            continue;
+    for (auto& lane : _lanes) {
+        for (int i = 0; i < lane.loading.size();) {
+            const auto& request = lane.loading.at(i);
+            // Clear our resource and any freed resources
+            if (!request.resource || request.resource.data() == resource.data()) {
+                if (strongResource && request.resource.data() == resource.data() && !wasPreempted) {
+                    updateTransferRate(lane, strongResource->getBytesReceived(), now - request.startedUsecs);
+                }
+                lane.loading.removeAt(i);
+                --_numLoading;
+                continue;
+            }
+            i++;
         }
-        i++;
+    }
+
+    if (wasPreempted) {
+        ++_numPreempted;
     }
 }
 
 QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    QSharedPointer<Resource> highestResource;
     Lock lock(_mutex);
 
-    bool currentHighestIsFile = false;
+    if (_numLoading >= (uint32_t)ResourceCache::getRequestLimit()) {
+        return QSharedPointer<Resource>();
+    }
+
+    // local files don't compete for bandwidth, so they go first
+    Lane* lane = nullptr;
+    if (!_lanes[FILE_PROTOCOL].pending.empty() && hasCapacity(_lanes[FILE_PROTOCOL])) {
+        lane = &_lanes[FILE_PROTOCOL];
+    } else {
+        for (int protocol = FILE_PROTOCOL + 1; protocol < NUM_PROTOCOLS; ++protocol) {
+            auto& candidate = _lanes[protocol];
+            if (!candidate.pending.empty() && hasCapacity(candidate) &&
+                (!lane || lane->pending.front() < candidate.pending.front())) {
+                lane = &candidate;
+            }
+        }
+    }
+
+    if (!lane) {
+        return QSharedPointer<Resource>();
+    }
+
+    auto& pending = lane->pending;
+    while (!pending.empty()) {
+        std::pop_heap(pending.begin(), pending.end());
+        auto request = pending.back();
+        pending.pop_back();
 
-    for (int i = 0; i < _pendingRequests.size();) {
         // Clear any freed resources
-        auto resource = _pendingRequests.at(i).lock();
+        auto resource = request.resource.lock();
         if (!resource) {
-            _pendingRequests.removeAt(i);
             continue;
         }
 
-        // Check load priority
+        // the priority may have dropped since the request was queued, if so it goes back where it now belongs
         float priority = resource->getLoadPriority();
-        bool isFile = resource->getURL().scheme() == URL_SCHEME_FILE;
-        if (priority >= highestPriority && (isFile || !currentHighestIsFile)) {
-            highestPriority = priority;
-            highestIndex = i;
-            highestResource = resource;
-            currentHighestIsFile = isFile;
+        if (priority < request.priority && !pending.empty() && priority < pending.front().priority) {
+            request.priority = priority;
+            pending.push_back(request);
+            std::push_heap(pending.begin(), pending.end());
+            continue;
+        }
+
+        auto waitUsecs = (double)(usecTimestampNow() - request.queuedUsecs);
+        _averageWaitUsecs += (waitUsecs - _averageWaitUsecs) * WAIT_TIME_SMOOTHING;
+        return resource;
+    }
+
+    return QSharedPointer<Resource>();
+}
+
+bool ResourceCacheSharedItems::hasCapacityFor(const QSharedPointer<Resource>& resource) const {
+    Lock lock(_mutex);
+    return hasCapacity(_lanes[getProtocol(resource->getURL())]);
+}
+
+void ResourceCacheSharedItems::reprioritize() {
+    Lock lock(_mutex);
+    for (auto& lane : _lanes) {
+        auto& pending = lane.pending;
+        pending.erase(std::remove_if(pending.begin(), pending.end(), [](const PendingRequest& request) {
+            return request.resource.isNull();
+        }), pending.end());
+
+        for (auto& request : pending) {
+            auto resource = request.resource.lock();
+            if (resource) {
+                request.priority = resource->getLoadPriority();
+            }
+        }
+        std::make_heap(pending.begin(), pending.end());
+    }
+}
+
+QSharedPointer<Resource> ResourceCacheSharedItems::getRequestToPreempt() {
+    Lock lock(_mutex);
+
+    for (int protocol = FILE_PROTOCOL + 1; protocol < NUM_PROTOCOLS; ++protocol) {
+        auto& lane = _lanes[protocol];
+        bool isFull = !hasCapacity(lane) || _numLoading >= (uint32_t)ResourceCache::getRequestLimit();
+        if (lane.pending.empty() || !isFull) {
+            continue;
+        }
+
+        QSharedPointer<Resource> lowestResource;
+        float lowestPriority = FLT_MAX;
+        for (const auto& request : lane.loading) {
+            auto resource = request.resource.lock();
+            if (!resource || !resource->isPreemptible()) {
+                continue;
+            }
+
+            float priority = resource->getLoadPriority();
+            if (priority < lowestPriority) {
+                lowestPriority = priority;
+                lowestResource = resource;
+            }
+        }
+
+        if (lowestResource && lane.pending.front().priority > lowestPriority + MIN_PREEMPTING_PRIORITY_GAIN) {
+            return lowestResource;
+        }
+    }
+
+    return QSharedPointer<Resource>();
+}
+
+ResourceCacheSharedItems::Stats ResourceCacheSharedItems::getStats() const {
+    Stats stats;
+    quint64 now = usecTimestampNow();
+    Lock lock(_mutex);
+
+    for (int protocol = 0; protocol < NUM_PROTOCOLS; ++protocol) {
+        const auto& lane = _lanes[protocol];
+        stats.pendingPerProtocol[protocol] = (uint32_t)lane.pending.size();
+        stats.limitPerProtocol[protocol] = getLimit(lane);
+        stats.pending += (uint32_t)lane.pending.size();
+
+        for (const auto& request : lane.pending) {
+            stats.longestWaitUsecs = std::max(stats.longestWaitUsecs, now - request.queuedUsecs);
         }
-        i++;
     }
 
-    if (highestIndex >= 0) {
-        _pendingRequests.takeAt(highestIndex);
+    stats.loading = _numLoading;
+    stats.averageWaitUsecs = (quint64)_averageWaitUsecs;
+    stats.preempted = _numPreempted;
+    return stats;
+}
+
+int ResourceCacheSharedItems::getLimit(const Lane& lane) const {
+    int requestLimit = ResourceCache::getRequestLimit();
+    return lane.limit < 0 ? requestLimit : std::min(lane.limit, requestLimit);
+}
+
+bool ResourceCacheSharedItems::hasCapacity(const Lane& lane) const {
+    return lane.loading.size() < getLimit(lane);
+}
+
+void ResourceCacheSharedItems::updateTransferRate(Lane& lane, qint64 bytes, quint64 elapsedUsecs) {
+    if (&lane == &_lanes[FILE_PROTOCOL] || bytes < MIN_TRANSFER_RATE_SAMPLE_BYTES || elapsedUsecs == 0) {
+        return;
+    }
+
+    double rate = (double)bytes * USECS_PER_SECOND / elapsedUsecs;
+    int limit = getLimit(lane);
+
+    if (lane.transferRate > 0.0 && rate < lane.transferRate * SATURATED_TRANSFER_RATE_RATIO) {
+        // adding transfers only split the bandwidth further, back off
+        lane.limit = std::max(limit / 2, MIN_PROTOCOL_REQUEST_LIMIT);
+    } else {
+        lane.limit = std::min(limit + 1, ResourceCache::getRequestLimit());
     }
 
-    return highestResource;
+    lane.transferRate = lane.transferRate > 0.0 ?
+        lane.transferRate + (rate - lane.transferRate) * TRANSFER_RATE_SMOOTHING : rate;
 }
 
 ScriptableResource::ScriptableResource(const QUrl& url) :
@@ -217,7 +403,9 @@ ScriptableResource* ResourceCache::prefetch(const QUrl& url, void* extra) {
     return result;
 }
 
-ResourceCache::ResourceCache(QObject* parent) : QObject(parent) {
+ResourceCache::ResourceCache(QObject* parent) :
+    QObject(parent),
+    _evictionPolicy(ResourceEvictionPolicy::create(_defaultEvictionPolicy)) {
     auto nodeList = DependencyManager::get<NodeList>();
     if (nodeList) {
         auto& domainHandler = nodeList->getDomainHandler();
@@ -250,7 +438,7 @@ void ResourceCache::clearATPAssets() {
         QWriteLocker locker(&_unusedResourcesLock);
         for (auto& resource : _unusedResources.values()) {
             if (resource->getURL().scheme() == URL_SCHEME_ATP) {
-                _unusedResources.remove(resource->getLRUKey());
+                _unusedResources.remove(getUnusedResourceKey(resource));
             }
         }
     }
@@ -336,6 +524,9 @@ QSharedPointer<Resource> ResourceCache::getResource(const QUrl& url, const QUrl&
         resource = _resources.value(url).lock();
     }
     if (resource) {
+        ++resource->_useCount;
+        ResourceAccessLog::record(ResourceAccessLog::GET, metaObject()->className(), url,
+                                  resource->getBytes(), resource->getLoadCostUsecs());
         removeUnusedResource(resource);
         return resource;
     }
@@ -350,6 +541,8 @@ QSharedPointer<Resource> ResourceCache::getResource(const QUrl& url, const QUrl&
         extra);
     resource->setSelf(resource);
     resource->setCache(this);
+    resource->_useCount = 1;
+    ResourceAccessLog::record(ResourceAccessLog::GET, metaObject()->className(), url, 0, 0);
     resource->moveToThread(qApp->thread());
     connect(resource.data(), &Resource::updateSize, this, &ResourceCache::updateTotalSize);
     {
@@ -368,7 +561,54 @@ void ResourceCache::setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize) {
     resetResourceCounters();
 }
 
+bool ResourceCache::setDefaultEvictionPolicy(const QString& name) {
+    if (!ResourceEvictionPolicy::create(name)) {
+        qCWarning(networking) << "Unknown resource eviction policy" << name << "- the policies are"
+            << ResourceEvictionPolicy::getNames();
+        return false;
+    }
+    _defaultEvictionPolicy = name;
+    return true;
+}
+
+bool ResourceCache::setEvictionPolicy(const QString& name) {
+    auto policy = ResourceEvictionPolicy::create(name);
+    if (!policy) {
+        qCWarning(networking) << "Unknown resource eviction policy" << name;
+        return false;
+    }
+
+    QWriteLocker locker(&_unusedResourcesLock);
+    _evictionPolicy = std::move(policy);
+
+    // give the unused resources their priorities under the new policy, in the order they became unused
+    auto unusedResources = _unusedResources.values();
+    std::sort(unusedResources.begin(), unusedResources.end(), [](const QSharedPointer<Resource>& a,
+                                                                 const QSharedPointer<Resource>& b) {
+        return a->getLRUKey() < b->getLRUKey();
+    });
+
+    _unusedResources.clear();
+    for (const auto& resource : unusedResources) {
+        resource->_evictionPriority = _evictionPolicy->getPriority({ resource->getBytes(), resource->getLoadCostUsecs(),
+                                                                     resource->getUseCount() });
+        _unusedResources.insert(getUnusedResourceKey(resource), resource);
+    }
+    return true;
+}
+
+QString ResourceCache::getEvictionPolicy() const {
+    return _evictionPolicy->getName();
+}
+
+ResourceCache::UnusedResourceKey ResourceCache::getUnusedResourceKey(const QSharedPointer<Resource>& resource) {
+    return UnusedResourceKey(resource->_evictionPriority, resource->getLRUKey());
+}
+
 void ResourceCache::addUnusedResource(const QSharedPointer<Resource>& resource) {
+    ResourceAccessLog::record(ResourceAccessLog::RELEASE, metaObject()->className(), resource->getURL(),
+                              resource->getBytes(), resource->getLoadCostUsecs());
+
     // If it doesn't fit or its size is unknown, remove it from the cache.
     if (resource->getBytes() == 0 || resource->getBytes() > _unusedResourcesMaxSize) {
         resource->setCache(nullptr);
@@ -384,13 +624,16 @@ void ResourceCache::addUnusedResource(const QSharedPointer<Resource>& resource)
     resetResourceCounters();
 
     QWriteLocker locker(&_unusedResourcesLock);
-    _unusedResources.insert(resource->getLRUKey(), resource);
+    resource->_evictionPriority = _evictionPolicy->getPriority({ resource->getBytes(), resource->getLoadCostUsecs(),
+                                                                 resource->getUseCount() });
+    _unusedResources.insert(getUnusedResourceKey(resource), resource);
 }
 
 void ResourceCache::removeUnusedResource(const QSharedPointer<Resource>& resource) {
     QWriteLocker locker(&_unusedResourcesLock);
-    if (_unusedResources.contains(resource->getLRUKey())) {
-        _unusedResources.remove(resource->getLRUKey());
+    auto key = getUnusedResourceKey(resource);
+    if (_unusedResources.contains(key)) {
+        _unusedResources.remove(key);
         _unusedResourcesSize -= resource->getBytes();
 
         locker.unlock();
@@ -402,8 +645,9 @@ void ResourceCache::reserveUnusedResource(qint64 resourceSize) {
     QWriteLocker locker(&_unusedResourcesLock);
     while (!_unusedResources.empty() &&
            _unusedResourcesSize + resourceSize > _unusedResourcesMaxSize) {
-        // unload the oldest resource
-        QMap<int, QSharedPointer<Resource> >::iterator it = _unusedResources.begin();
+        // unload the resource the eviction policy values least
+        QMap<UnusedResourceKey, QSharedPointer<Resource> >::iterator it = _unusedResources.begin();
+        _evictionPolicy->evicted(it.key().first);
         
         it.value()->setCache(nullptr);
         auto size = it.value()->getBytes();
@@ -471,12 +715,39 @@ int ResourceCache::getLoadingRequestCount() {
     return DependencyManager::get<ResourceCacheSharedItems>()->getLoadingRequestsCount();
 }
 
+ResourceCacheSharedItems::Stats ResourceCache::getRequestStats() {
+    return DependencyManager::get<ResourceCacheSharedItems>()->getStats();
+}
+
+void ResourceCache::reprioritizeRequests() {
+    // a few at a time, so a view that keeps moving doesn't keep restarting downloads
+    const int MAX_PREEMPTIONS = 2;
+
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->reprioritize();
+
+    for (int i = 0; i < MAX_PREEMPTIONS; ++i) {
+        auto resource = sharedItems->getRequestToPreempt();
+        if (!resource) {
+            break;
+        }
+
+        qCDebug(networking).noquote() << "Preempting request for" << resource->getURL().toDisplayString();
+        resource->preempt();
+        sharedItems->removeRequest(resource, true);
+        --_requestsActive;
+        sharedItems->appendPendingRequest(resource);
+
+        attemptHighestPriorityRequest();
+    }
+}
+
 bool ResourceCache::attemptRequest(QSharedPointer<Resource> resource) {
     Q_ASSERT(!resource.isNull());
 
 
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
-    if (_requestsActive >= _requestLimit) {
+    if (_requestsActive >= _requestLimit || !sharedItems->hasCapacityFor(resource)) {
         // wait until a slot becomes available
         sharedItems->appendPendingRequest(resource);
         return false;
@@ -484,17 +755,31 @@ bool ResourceCache::attemptRequest(QSharedPointer<Resource> resource) {
     
     ++_requestsActive;
     sharedItems->appendActiveRequest(resource);
+    resource->_loadStartedUsecs = usecTimestampNow();
     resource->makeRequest();
     return true;
 }
 
 void ResourceCache::requestCompleted(QWeakPointer<Resource> resource) {
+    // what it would take to load the resource again adds up every request it took (each mip of a texture, say),
+    // the clock keeps running for processing the data until finishedLoading
+    if (auto completedResource = resource.lock()) {
+        if (completedResource->_loadStartedUsecs > 0) {
+            auto now = usecTimestampNow();
+            completedResource->_loadCostUsecs += now - completedResource->_loadStartedUsecs;
+            completedResource->_loadStartedUsecs = now;
+        }
+    }
+
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
 
     sharedItems->removeRequest(resource);
     --_requestsActive;
 
-    attemptHighestPriorityRequest();
+    // the limit of the protocol may have grown with the transfer rate, so this can free more than one slot
+    while (attemptHighestPriorityRequest()) {
+        // just keep looping until we reach the limits or no more pending requests
+    }
 }
 
 bool ResourceCache::attemptHighestPriorityRequest() {
@@ -506,6 +791,7 @@ bool ResourceCache::attemptHighestPriorityRequest() {
 const int DEFAULT_REQUEST_LIMIT = 10;
 int ResourceCache::_requestLimit = DEFAULT_REQUEST_LIMIT;
 int ResourceCache::_requestsActive = 0;
+QString ResourceCache::_defaultEvictionPolicy;
 
 static int requestID = 0;
 
@@ -586,6 +872,20 @@ void Resource::refresh() {
     emit onRefresh();
 }
 
+bool Resource::isPreemptible() const {
+    // resources that make their own requests can't be stopped from here, and one that is half way there is
+    // better left to finish
+    return _request && (_bytesTotal <= 0 || _bytesReceived < _bytesTotal / 2);
+}
+
+void Resource::preempt() {
+    PROFILE_ASYNC_END(resource, "Resource:" + getType(), QString::number(_requestID));
+    _request->disconnect(this);
+    _request->deleteLater();
+    _request = nullptr;
+    _bytesReceived = _bytesTotal = 0;
+}
+
 void Resource::allReferencesCleared() {
     if (QThread::currentThread() != thread()) {
         QMetaObject::invokeMethod(this, "allReferencesCleared");
@@ -616,6 +916,7 @@ void Resource::init(bool resetLoaded) {
     _failedToLoad = false;
     if (resetLoaded) {
         _loaded = false;
+        _loadCostUsecs = 0;
     }
     _attempts = 0;
     _activeUrl = _url;
@@ -644,6 +945,11 @@ void Resource::finishedLoading(bool success) {
         qCDebug(networking).noquote() << "Finished loading:" << _url.toDisplayString();
         _loadPriorities.clear();
         _loaded = true;
+
+        if (_loadStartedUsecs > 0) {
+            _loadCostUsecs += usecTimestampNow() - _loadStartedUsecs;
+            _loadStartedUsecs = 0;
+        }
     } else {
         qCDebug(networking).noquote() << "Failed to load:" << _url.toDisplayString();
         _failedToLoad = true;
@@ -683,6 +989,7 @@ void Resource::makeRequest() {
 
     _request->setByteRange(_requestByteRange);
     _request->setFailOnRedirect(_shouldFailOnRedirect);
+    _request->setStreamingEnabled(_shouldStream);
 
     qCDebug(resourceLog).noquote() << "Starting request for:" << _url.toDisplayString();
     emit loading();
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
@@ -32,6 +33,7 @@
 
 #include <DependencyManager.h>
 
+#include "ResourceEvictionPolicy.h"
 #include "ResourceManager.h"
 
 Q_DECLARE_METATYPE(size_t)
@@ -59,6 +61,10 @@ static const qint64 MAX_UNUSED_MAX_SIZE = MAXIMUM_CACHE_SIZE;
 // ResourceCache derived classes. Since we can't count on the ordering of
 // static members destruction, we need to use this Dependency manager implemented
 // object instead
+//
+// The pending requests are kept in a heap per protocol, ordered by the load priority of the resources (which their
+// owners set from how large they are on screen, how far away they are and what kind of resource they are). Each
+// protocol has its own limit on concurrent requests, adapted to the bandwidth its transfers are getting.
 class ResourceCacheSharedItems : public Dependency  {
     SINGLETON_DEPENDENCY
 
@@ -66,21 +72,82 @@ class ResourceCacheSharedItems : public Dependency  {
     using Lock = std::unique_lock<Mutex>;
 
 public:
+    enum Protocol {
+        FILE_PROTOCOL,
+        ATP_PROTOCOL,
+        HTTP_PROTOCOL,
+        NUM_PROTOCOLS
+    };
+
+    struct Stats {
+        uint32_t pending { 0 };
+        uint32_t loading { 0 };
+        uint32_t pendingPerProtocol[NUM_PROTOCOLS] {};
+        int limitPerProtocol[NUM_PROTOCOLS] {};
+        quint64 averageWaitUsecs { 0 }; // how long the recently started requests waited in the queue
+        quint64 longestWaitUsecs { 0 }; // how long the request that has been pending longest has waited so far
+        uint32_t preempted { 0 };
+    };
+
+    static Protocol getProtocol(const QUrl& url);
+
     void appendPendingRequest(QWeakPointer<Resource> newRequest);
     void appendActiveRequest(QWeakPointer<Resource> newRequest);
-    void removeRequest(QWeakPointer<Resource> doneRequest);
+    void removeRequest(QWeakPointer<Resource> doneRequest, bool wasPreempted = false);
     QList<QSharedPointer<Resource>> getPendingRequests();
     uint32_t getPendingRequestsCount() const;
     QList<QSharedPointer<Resource>> getLoadingRequests();
     QSharedPointer<Resource> getHighestPendingRequest();
     uint32_t getLoadingRequestsCount() const;
 
+    /// Checks whether a request for the resource fits in the concurrency limit of its protocol.
+    bool hasCapacityFor(const QSharedPointer<Resource>& resource) const;
+
+    /// Reorders the pending requests by the current priorities of their resources.
+    void reprioritize();
+
+    /// Returns a loading request that should make way for a pending one of much higher priority, if there is one.
+    QSharedPointer<Resource> getRequestToPreempt();
+
+    Stats getStats() const;
+
 private:
+    struct PendingRequest {
+        QWeakPointer<Resource> resource;
+        float priority;
+        quint64 sequence;
+        quint64 queuedUsecs;
+
+        bool operator<(const PendingRequest& other) const {
+            // the heap is a max-heap, requests of the same priority go in the order they were queued
+            return priority != other.priority ? priority < other.priority : sequence > other.sequence;
+        }
+    };
+
+    struct LoadingRequest {
+        QWeakPointer<Resource> resource;
+        quint64 startedUsecs;
+    };
+
+    struct Lane {
+        std::vector<PendingRequest> pending;
+        QList<LoadingRequest> loading;
+        int limit { -1 }; // the request limit until the bandwidth of the transfers has been measured
+        double transferRate { 0.0 }; // smoothed bytes per second of a single transfer
+    };
+
     ResourceCacheSharedItems() = default;
 
+    int getLimit(const Lane& lane) const;
+    bool hasCapacity(const Lane& lane) const;
+    void updateTransferRate(Lane& lane, qint64 bytes, quint64 elapsedUsecs);
+
     mutable Mutex _mutex;
-    QList<QWeakPointer<Resource>> _pendingRequests;
-    QList<QWeakPointer<Resource>> _loadingRequests;
+    Lane _lanes[NUM_PROTOCOLS];
+    quint64 _nextSequence { 0 };
+    uint32_t _numLoading { 0 };
+    double _averageWaitUsecs { 0.0 };
+    uint32_t _numPreempted { 0 };
 };
 
 /// Wrapper to expose resources to JS/QML
@@ -238,12 +305,25 @@ public:
     void setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize);
     qint64 getUnusedResourceCacheSize() const { return _unusedResourcesMaxSize; }
 
+    /// Sets the eviction policy (see ResourceEvictionPolicy::getNames) the caches created from now on use.
+    static bool setDefaultEvictionPolicy(const QString& name);
+
+    /// Sets the policy that decides which unused resources are evicted first, the unused resources are reordered.
+    bool setEvictionPolicy(const QString& name);
+    QString getEvictionPolicy() const;
+
     static QList<QSharedPointer<Resource>> getLoadingRequests();
 
     static int getPendingRequestCount();
 
     static int getLoadingRequestCount();
 
+    static ResourceCacheSharedItems::Stats getRequestStats();
+
+    /// Reorders the pending requests after the priorities of their resources changed (when the view moved, say),
+    /// preempting loading requests that have become much less important than pending ones.
+    static void reprioritizeRequests();
+
     ResourceCache(QObject* parent = nullptr);
     virtual ~ResourceCache();
     
@@ -309,12 +389,17 @@ protected:
 private:
     friend class Resource;
 
+    // unused resources are ordered by the priority their eviction policy gave them, then by when they became unused
+    using UnusedResourceKey = QPair<double, int>;
+    static UnusedResourceKey getUnusedResourceKey(const QSharedPointer<Resource>& resource);
+
     void reserveUnusedResource(qint64 resourceSize);
     void resetResourceCounters();
     void removeResource(const QUrl& url, qint64 size = 0);
 
     static int _requestLimit;
     static int _requestsActive;
+    static QString _defaultEvictionPolicy;
 
     // Resources
     QHash<QUrl, QWeakPointer<Resource>> _resources;
@@ -325,9 +410,10 @@ private:
     std::atomic<qint64> _totalResourcesSize { 0 };
 
     // Cached resources
-    QMap<int, QSharedPointer<Resource>> _unusedResources;
+    QMap<UnusedResourceKey, QSharedPointer<Resource>> _unusedResources;
     QReadWriteLock _unusedResourcesLock { QReadWriteLock::Recursive };
     qint64 _unusedResourcesMaxSize = DEFAULT_UNUSED_MAX_SIZE;
+    std::unique_ptr<ResourceEvictionPolicy> _evictionPolicy;
 
     std::atomic<size_t> _numUnusedResources { 0 };
     std::atomic<qint64> _unusedResourcesSize { 0 };
@@ -381,12 +467,21 @@ public:
     /// For loaded resources, returns the number of actual bytes (defaults to total bytes if not explicitly set).
     qint64 getBytes() const { return _bytes; }
 
+    /// For loaded resources, returns how long the resource took to download and process.
+    quint64 getLoadCostUsecs() const { return _loadCostUsecs; }
+
+    /// Returns how many times the resource was asked for since it was created.
+    quint32 getUseCount() const { return _useCount; }
+
     /// For loading resources, returns the load progress.
     float getProgress() const { return (_bytesTotal <= 0) ? 0.0f : (float)_bytesReceived / _bytesTotal; }
     
     /// Refreshes the resource.
     virtual void refresh();
 
+    /// Checks whether the request loading the resource can be dropped and started again later.
+    bool isPreemptible() const;
+
     void setSelf(const QWeakPointer<Resource>& self) { _self = self; }
 
     void setCache(ResourceCache* cache) { _cache = cache; }
@@ -456,6 +551,9 @@ protected:
     QUrl _activeUrl;
     ByteRange _requestByteRange;
     bool _shouldFailOnRedirect { false };
+    // only for resources that start decoding from ResourceRequest::dataReceived - a streamed asset costs an extra
+    // round trip for its size before the first range, which the whole download pays if nothing uses the early data
+    bool _shouldStream { false };
 
     // _loaded == true means we are in a loaded and usable state. It is possible that there may still be
     // active requests/loading while in this state. Example: Progressive KTX downloads, where higher resolution
@@ -488,10 +586,17 @@ private:
     void retry();
     void reinsert();
 
+    /// Drops the request loading the resource, it goes back in the queue.
+    void preempt();
+
     bool isInScript() const { return _isInScript; }
     void setInScript(bool isInScript) { _isInScript = isInScript; }
     
     int _lruKey{ 0 };
+    double _evictionPriority { 0.0 };
+    quint32 _useCount { 0 };
+    quint64 _loadStartedUsecs { 0 };
+    quint64 _loadCostUsecs { 0 };
     QTimer* _replyTimer{ nullptr };
     unsigned int _attempts{ 0 };
     static const int MAX_ATTEMPTS = 8;
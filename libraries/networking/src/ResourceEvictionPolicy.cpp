@@ -0,0 +1,38 @@
+//
+//  ResourceEvictionPolicy.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceEvictionPolicy.h"
+
+#include <algorithm>
+
+const QString ResourceEvictionPolicy::LRU = "lru";
+const QString ResourceEvictionPolicy::GDSF = "gdsf";
+
+// even a resource that loads instantly costs a round trip to ask for again
+static const quint64 MIN_COST_USECS = 1000;
+
+std::unique_ptr<ResourceEvictionPolicy> ResourceEvictionPolicy::create(const QString& name) {
+    if (name == LRU) {
+        return std::unique_ptr<ResourceEvictionPolicy>(new LRUEvictionPolicy());
+    } else if (name.isEmpty() || name == GDSF) {
+        return std::unique_ptr<ResourceEvictionPolicy>(new GDSFEvictionPolicy());
+    }
+    return nullptr;
+}
+
+double GDSFEvictionPolicy::getPriority(const Entry& entry) {
+    auto cost = (double)std::max(entry.costUsecs, MIN_COST_USECS);
+    auto size = (double)std::max<qint64>(entry.size, 1);
+    return _inflation + std::max<quint32>(entry.uses, 1) * cost / size;
+}
+
+void GDSFEvictionPolicy::evicted(double priority) {
+    _inflation = std::max(_inflation, priority);
+}
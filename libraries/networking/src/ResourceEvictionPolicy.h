@@ -0,0 +1,71 @@
+//
+//  ResourceEvictionPolicy.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceEvictionPolicy_h
+#define hifi_ResourceEvictionPolicy_h
+
+#include <memory>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+/// Decides which of the unused resources of a ResourceCache are evicted first when it is over its size budget.
+/// Each resource is given a priority when it becomes unused, the one with the lowest priority goes first.
+class ResourceEvictionPolicy {
+public:
+    struct Entry {
+        qint64 size { 0 };
+        quint64 costUsecs { 0 }; // how long the resource took to download and process
+        quint32 uses { 0 }; // how many times the resource was asked for since it was loaded
+    };
+
+    static const QString LRU;
+    static const QString GDSF;
+
+    static QStringList getNames() { return { LRU, GDSF }; }
+
+    /// Returns the policy with the given name (GDSF for no name), or nullptr if there is none.
+    static std::unique_ptr<ResourceEvictionPolicy> create(const QString& name);
+
+    virtual ~ResourceEvictionPolicy() = default;
+
+    virtual QString getName() const = 0;
+
+    /// Returns the priority to keep a resource that just became unused at.
+    virtual double getPriority(const Entry& entry) = 0;
+
+    /// Called with the priority of each resource evicted.
+    virtual void evicted(double priority) {}
+};
+
+/// Evicts the least recently used resource first.
+class LRUEvictionPolicy : public ResourceEvictionPolicy {
+public:
+    QString getName() const override { return LRU; }
+    double getPriority(const Entry& entry) override { return (double)++_clock; }
+
+private:
+    quint64 _clock { 0 };
+};
+
+/// Greedy-Dual-Size-Frequency: keeps the resources that save the most reload time per byte of cache, by how often
+/// they are used and how long they take to load. The priority of the last eviction is added to every new priority,
+/// so resources that haven't been used for a while age out whatever they cost.
+class GDSFEvictionPolicy : public ResourceEvictionPolicy {
+public:
+    QString getName() const override { return GDSF; }
+    double getPriority(const Entry& entry) override;
+    void evicted(double priority) override;
+
+private:
+    double _inflation { 0.0 };
+};
+
+#endif // hifi_ResourceEvictionPolicy_h
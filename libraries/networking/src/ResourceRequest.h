@@ -76,11 +76,16 @@ public:
     void setCacheEnabled(bool value) { _cacheEnabled = value; }
     void setByteRange(ByteRange byteRange) { _byteRange = byteRange; }
 
+    // Asks for the resource to be handed over in pieces through dataReceived as it arrives, so a consumer can start
+    // decoding before the whole of it is here. Requests that can't stream still emit finished with all the data.
+    void setStreamingEnabled(bool value) { _streamingEnabled = value; }
+
 public slots:
     void send();
 
 signals:
     void progress(qint64 bytesReceived, qint64 bytesTotal);
+    void dataReceived(QByteArray data); // the next piece of the resource, in order - only when streaming
     void finished();
 
 protected:
@@ -95,6 +100,7 @@ protected:
     bool _failOnRedirect { false };
     bool _cacheEnabled { true };
     bool _loadedFromCache { false };
+    bool _streamingEnabled { false };
     ByteRange _byteRange;
     bool _rangeRequestSuccessful { false };
     uint64_t _totalSizeOfResource { 0 };
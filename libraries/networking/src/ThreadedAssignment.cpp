@@ -103,6 +103,15 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["outbound_bytes_per_s"] = bytesOutPerSecond;
     ioStats["outbound_packets_per_s"] = packetsOutPerSecond;
 
+    // packet buffer allocations since the last stats packet, heap allocations should settle at zero under steady load
+    auto packetBufferStats = udt::PacketBufferPool::getStats();
+    ioStats["packet_buffer_heap_allocations"] =
+        (double)(packetBufferStats.heapAllocations - _lastPacketBufferStats.heapAllocations);
+    ioStats["packet_buffer_pooled_allocations"] =
+        (double)(packetBufferStats.pooledAllocations - _lastPacketBufferStats.pooledAllocations);
+    ioStats["packet_buffers_outstanding"] = (double)packetBufferStats.outstandingBuffers;
+    _lastPacketBufferStats = packetBufferStats;
+
     statsObject["io_stats"] = ioStats;
 
     nodeList->sendStatsToDomainServer(statsObject);
@@ -15,6 +15,7 @@
 #include <QtCore/QSharedPointer>
 
 #include "ReceivedMessage.h"
+#include "udt/PacketBufferPool.h"
 
 #include "Assignment.h"
 
@@ -47,6 +48,7 @@ protected:
     QTimer _domainServerTimer;
     QTimer _statsTimer;
     int _numQueuedCheckIns { 0 };
+    udt::PacketBufferPool::Stats _lastPacketBufferStats;
     
 protected slots:
     void domainSettingsRequestFailed();
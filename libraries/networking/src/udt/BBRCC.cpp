@@ -0,0 +1,351 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double USECS_PER_SECOND = 1000000.0;
+
+// 2/ln(2), the smallest gain that still doubles the delivery rate every round during startup
+static const double STARTUP_GAIN = 2.885;
+
+// one phase probing for more bandwidth, one draining what that queued, then six cruising at the estimate
+static const double PROBE_BANDWIDTH_GAINS[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int PROBE_BANDWIDTH_PHASES = sizeof(PROBE_BANDWIDTH_GAINS) / sizeof(double);
+
+// the bandwidth estimate has to grow by this much in a round for startup to keep going
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const int INITIAL_CONGESTION_WINDOW = 16;
+static const int MIN_CONGESTION_WINDOW = 4;
+
+static const int DEFAULT_RTT_USECS = 100000;
+static const microseconds MIN_RTT_WINDOW = seconds(10);
+static const microseconds PROBE_RTT_DURATION = milliseconds(200);
+
+BBRCC::BBRCC() {
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    _congestionWindowSize = INITIAL_CONGESTION_WINDOW;
+
+    setAckInterval(1); // every ACK gives us an RTT and a delivery rate sample
+
+    enterStartup();
+    updateControlParameters(0);
+}
+
+void BBRCC::setInitialSendSequenceNumber(SequenceNumber seqNum) {
+    _lastACK = seqNum - 1;
+    _lastFastRetransmit = _lastACK;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    int offset = seqoff(_lastACK + 1, seqNum);
+
+    if (offset < 0) {
+        // re-send of a packet that has been ACKed since
+        return;
+    }
+
+    if (offset < (int)_sentPackets.size()) {
+        // a re-send, its ACK can't be matched to a send time any more
+        _sentPackets[offset].wasRetransmitted = true;
+        return;
+    }
+
+    if (_sentPackets.empty()) {
+        // nothing in flight, delivery rate samples start over from here
+        _firstSentTime = timePoint;
+        _deliveredTime = timePoint;
+    }
+
+    SentPacket sentPacket;
+    sentPacket.sendTime = timePoint;
+    sentPacket.firstSentTime = _firstSentTime;
+    sentPacket.deliveredTime = _deliveredTime;
+    sentPacket.delivered = _delivered;
+
+    // we should never skip a sequence number, but if we do the skipped ones must not be sampled
+    while ((int)_sentPackets.size() < offset) {
+        SentPacket skipped = sentPacket;
+        skipped.wasRetransmitted = true;
+        _sentPackets.push_back(skipped);
+    }
+
+    _sentPackets.push_back(sentPacket);
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    int numACKed = seqoff(_lastACK, ack);
+    if (numACKed <= 0) {
+        return false;
+    }
+
+    // the last packet covered by this ACK carries the delivery state from when it was sent
+    bool hasSample = numACKed <= (int)_sentPackets.size();
+    SentPacket ackedPacket;
+    if (hasSample) {
+        ackedPacket = _sentPackets[numACKed - 1];
+    }
+
+    _sentPackets.erase(_sentPackets.begin(), _sentPackets.begin() + std::min(numACKed, (int)_sentPackets.size()));
+
+    _lastACK = ack;
+    _delivered += numACKed;
+    _deliveredTime = receiveTime;
+
+    bool isRoundStart = false;
+    bool isMinRTTExpired = false;
+
+    if (hasSample) {
+        _firstSentTime = ackedPacket.sendTime;
+
+        if (ackedPacket.delivered >= _nextRoundDelivered) {
+            // everything that was in flight at the start of this round has now been ACKed
+            _nextRoundDelivered = _delivered;
+            ++_roundCount;
+            isRoundStart = true;
+        }
+
+        if (!ackedPacket.wasRetransmitted) {
+            int rtt = std::max((int)duration_cast<microseconds>(receiveTime - ackedPacket.sendTime).count(), 1);
+            isMinRTTExpired = updateRTT(rtt, receiveTime);
+
+            // the rate can't be faster than either the rate we sent these packets at or the rate they were ACKed at,
+            // so use the longer of the two intervals - this keeps a burst of ACKs after a hole is filled from
+            // looking like a jump in bandwidth
+            auto sendInterval = duration_cast<microseconds>(ackedPacket.sendTime - ackedPacket.firstSentTime).count();
+            auto ackInterval = duration_cast<microseconds>(receiveTime - ackedPacket.deliveredTime).count();
+            auto interval = std::max(sendInterval, ackInterval);
+
+            if (interval > 0) {
+                double deliveryRate = (_delivered - ackedPacket.delivered) * USECS_PER_SECOND / interval;
+                updateBandwidth(deliveryRate, isRoundStart);
+            }
+        }
+    }
+
+    if (isRoundStart && (!hasSample || ackedPacket.wasRetransmitted)) {
+        // still start a new slot in the bandwidth window
+        updateBandwidth(0.0, isRoundStart);
+    }
+
+    checkFullPipe(isRoundStart);
+    updateMode(receiveTime, isMinRTTExpired);
+    updateControlParameters(numACKed);
+
+    // NAKs re-send most losses, but if the packet after this ACK is overdue and the other side isn't NAKing
+    // (it may be using a congestion control that doesn't) we ask for a fast re-transmit, once per packet
+    if (!_sentPackets.empty() && _ewmaRTT > 0 && _lastFastRetransmit != ack + 1) {
+        auto sinceSend = duration_cast<microseconds>(p_high_resolution_clock::now() - _sentPackets.front().sendTime);
+        if (sinceSend.count() >= _ewmaRTT + 4 * _rttVariance) {
+            _lastFastRetransmit = ack + 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void BBRCC::onTimeout() {
+    // everything in flight is probably gone, start again from the minimum window and let ACKs grow it back
+    _congestionWindowSize = MIN_CONGESTION_WINDOW;
+}
+
+int BBRCC::packetsInFlight() const {
+    return (int)_sentPackets.size();
+}
+
+double BBRCC::bandwidthEstimate() const {
+    double bandwidth = *std::max_element(_maxBandwidthPerRound.begin(), _maxBandwidthPerRound.end());
+
+    // until we have our own samples fall back to the receive rate the other side reports
+    return bandwidth > 0.0 ? bandwidth : (double)_receiveRate;
+}
+
+int BBRCC::minRTTEstimate() const {
+    if (_minRTT > 0) {
+        return _minRTT;
+    } else {
+        return _rtt > 0 ? _rtt : DEFAULT_RTT_USECS;
+    }
+}
+
+int BBRCC::bandwidthDelayProduct(double gain) const {
+    double bandwidth = bandwidthEstimate();
+    if (bandwidth <= 0.0) {
+        return (int)(gain * INITIAL_CONGESTION_WINDOW);
+    }
+
+    return (int)std::ceil(gain * bandwidth * minRTTEstimate() / USECS_PER_SECOND);
+}
+
+bool BBRCC::updateRTT(int rtt, time_point now) {
+    bool isExpired = _minRTT > 0 && (now - _minRTTTime) > MIN_RTT_WINDOW;
+
+    if (_minRTT < 0 || rtt <= _minRTT || isExpired) {
+        _minRTT = rtt;
+        _minRTTTime = now;
+    }
+
+    // same smoothing as TCPVegasCC, only used to decide when a packet is overdue
+    static const int RTT_ESTIMATION_ALPHA = 8;
+    static const int RTT_ESTIMATION_VARIANCE_ALPHA = 4;
+
+    if (_ewmaRTT == -1) {
+        _ewmaRTT = rtt;
+        _rttVariance = rtt / 2;
+    } else {
+        _ewmaRTT = (_ewmaRTT * (RTT_ESTIMATION_ALPHA - 1) + rtt) / RTT_ESTIMATION_ALPHA;
+        _rttVariance = (_rttVariance * (RTT_ESTIMATION_VARIANCE_ALPHA - 1)
+                        + std::abs(rtt - _ewmaRTT)) / RTT_ESTIMATION_VARIANCE_ALPHA;
+    }
+
+    return isExpired;
+}
+
+void BBRCC::updateBandwidth(double packetsPerSecond, bool isRoundStart) {
+    auto& roundMax = _maxBandwidthPerRound[_roundCount % BANDWIDTH_WINDOW_ROUNDS];
+
+    if (isRoundStart) {
+        // this slot last held the round that is now out of the window
+        roundMax = 0.0;
+    }
+
+    roundMax = std::max(roundMax, packetsPerSecond);
+}
+
+void BBRCC::checkFullPipe(bool isRoundStart) {
+    if (_isPipeFilled || !isRoundStart) {
+        return;
+    }
+
+    double bandwidth = bandwidthEstimate();
+
+    if (bandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+        // still growing, keep going
+        _fullBandwidth = bandwidth;
+        _fullBandwidthRounds = 0;
+    } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+        _isPipeFilled = true;
+    }
+}
+
+void BBRCC::updateMode(time_point now, bool isMinRTTExpired) {
+    if (_mode == Mode::Startup && _isPipeFilled) {
+        _mode = Mode::Drain;
+        _pacingGain = 1.0 / STARTUP_GAIN;
+        _congestionWindowGain = STARTUP_GAIN;
+    }
+
+    if (_mode == Mode::Drain && packetsInFlight() <= bandwidthDelayProduct(1.0)) {
+        enterProbeBandwidth(now);
+    }
+
+    if (_mode == Mode::ProbeBandwidth) {
+        bool isPhaseOver = (now - _cycleStartTime) > microseconds(minRTTEstimate());
+
+        if (_pacingGain < 1.0) {
+            // the draining phase can end as soon as the queue we built probing is gone
+            isPhaseOver = isPhaseOver || packetsInFlight() <= bandwidthDelayProduct(1.0);
+        }
+
+        if (isPhaseOver) {
+            _cycleIndex = (_cycleIndex + 1) % PROBE_BANDWIDTH_PHASES;
+            _cycleStartTime = now;
+            _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+        }
+    }
+
+    if (isMinRTTExpired && _mode != Mode::ProbeRTT) {
+        // we haven't seen the propagation delay in a while, drain the pipe to measure it again
+        _mode = Mode::ProbeRTT;
+        _pacingGain = 1.0;
+        _congestionWindowGain = 1.0;
+        _isProbeRTTDoneTimeSet = false;
+        _priorCongestionWindowSize = _congestionWindowSize;
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        if (!_isProbeRTTDoneTimeSet) {
+            if (packetsInFlight() <= MIN_CONGESTION_WINDOW) {
+                // hold the window at the minimum for a while, and at least a round, so the RTT samples see no queue
+                _probeRTTDoneTime = now + PROBE_RTT_DURATION;
+                _probeRTTRoundDoneAt = _roundCount + 1;
+                _isProbeRTTDoneTimeSet = true;
+            }
+        } else if (now >= _probeRTTDoneTime && _roundCount >= _probeRTTRoundDoneAt) {
+            _minRTTTime = now;
+
+            // pick up where we were before probing
+            _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+            _priorCongestionWindowSize = 0;
+
+            if (_isPipeFilled) {
+                enterProbeBandwidth(now);
+            } else {
+                enterStartup();
+            }
+        }
+    }
+}
+
+void BBRCC::updateControlParameters(int numACKed) {
+    double bandwidth = bandwidthEstimate();
+
+    if (bandwidth > 0.0) {
+        setPacketSendPeriod(USECS_PER_SECOND / (_pacingGain * bandwidth));
+    } else {
+        // no idea of the bandwidth yet, pace the initial window out over one RTT
+        setPacketSendPeriod(minRTTEstimate() / (_pacingGain * INITIAL_CONGESTION_WINDOW));
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = MIN_CONGESTION_WINDOW;
+        return;
+    }
+
+    int targetWindow = bandwidthDelayProduct(_congestionWindowGain);
+
+    if (_isPipeFilled) {
+        _congestionWindowSize = std::min(_congestionWindowSize + numACKed, targetWindow);
+    } else if (_congestionWindowSize < targetWindow || _delivered < INITIAL_CONGESTION_WINDOW) {
+        // during startup the window only ever grows
+        _congestionWindowSize += numACKed;
+    }
+
+    _congestionWindowSize = std::max(std::min(_congestionWindowSize, udt::MAX_PACKETS_IN_FLIGHT), MIN_CONGESTION_WINDOW);
+}
+
+void BBRCC::enterStartup() {
+    _mode = Mode::Startup;
+    _pacingGain = STARTUP_GAIN;
+    _congestionWindowGain = STARTUP_GAIN;
+}
+
+void BBRCC::enterProbeBandwidth(time_point now) {
+    _mode = Mode::ProbeBandwidth;
+    _congestionWindowGain = 2.0;
+
+    // start in a random phase, other than the draining one, so that flows starting together don't probe in lockstep
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<> distribution(2, PROBE_BANDWIDTH_PHASES);
+    _cycleIndex = distribution(generator) % PROBE_BANDWIDTH_PHASES;
+
+    _cycleStartTime = now;
+    _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+}
@@ -0,0 +1,118 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <array>
+#include <deque>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// A model based congestion control in the style of BBR (https://queue.acm.org/detail.cfm?id=3022184).
+//
+// Rather than treating loss or rising delay as congestion, it keeps a running estimate of the bottleneck bandwidth
+// (the max of recent delivery rate samples) and of the path's propagation delay (the min of recent RTT samples), then
+// paces packets out at that bandwidth and caps what is in flight at a small multiple of their product. Random loss on
+// a long lossy path therefore doesn't collapse the send rate the way it does for DefaultCC and TCPVegasCC.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) override {}
+    virtual void onTimeout() override;
+
+    virtual bool shouldACK2() override { return false; }
+    virtual bool shouldProbe() override { return false; }
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override;
+
+private:
+    using time_point = p_high_resolution_clock::time_point;
+
+    enum class Mode {
+        Startup, // doubling the send rate every round until the bandwidth estimate stops growing
+        Drain, // draining the queue startup built at the bottleneck
+        ProbeBandwidth, // cycling the pacing gain around 1 to find more bandwidth
+        ProbeRTT // briefly emptying the pipe to re-measure the propagation delay
+    };
+
+    struct SentPacket {
+        time_point sendTime;
+        time_point firstSentTime; // send time of the last delivered packet when this one was sent
+        time_point deliveredTime; // time of the last delivery when this one was sent
+        int64_t delivered { 0 }; // number of packets delivered when this one was sent
+        bool wasRetransmitted { false };
+    };
+
+    int packetsInFlight() const;
+    int bandwidthDelayProduct(double gain) const; // in packets
+    double bandwidthEstimate() const; // in packets per second
+    int minRTTEstimate() const; // in microseconds
+
+    bool updateRTT(int rtt, time_point now); // returns true if the min RTT estimate had expired
+    void updateBandwidth(double packetsPerSecond, bool isRoundStart);
+    void checkFullPipe(bool isRoundStart);
+    void updateMode(time_point now, bool isMinRTTExpired);
+    void updateControlParameters(int numACKed);
+
+    void enterStartup();
+    void enterProbeBandwidth(time_point now);
+
+    std::deque<SentPacket> _sentPackets; // packets sent and not yet ACKed, starting at _lastACK + 1
+    SequenceNumber _lastACK;
+
+    int64_t _delivered { 0 }; // total packets ACKed
+    time_point _deliveredTime;
+    time_point _firstSentTime;
+
+    int64_t _roundCount { 0 }; // number of round trips so far
+    int64_t _nextRoundDelivered { 0 }; // _delivered at which the current round ends
+
+    static const int BANDWIDTH_WINDOW_ROUNDS = 10;
+    std::array<double, BANDWIDTH_WINDOW_ROUNDS> _maxBandwidthPerRound {}; // in packets per second
+
+    int _minRTT { -1 }; // in microseconds, -1 until the first sample
+    time_point _minRTTTime;
+    int _ewmaRTT { -1 }; // smoothed RTT and variance, for deciding when to fast re-transmit
+    int _rttVariance { 0 };
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain { 1.0 };
+    double _congestionWindowGain { 1.0 };
+
+    int _cycleIndex { 0 }; // phase of the ProbeBandwidth gain cycle
+    time_point _cycleStartTime;
+
+    double _fullBandwidth { 0.0 };
+    int _fullBandwidthRounds { 0 };
+    bool _isPipeFilled { false };
+
+    int _priorCongestionWindowSize { 0 }; // window to go back to after ProbeRTT or a timeout
+
+    time_point _probeRTTDoneTime;
+    bool _isProbeRTTDoneTimeSet { false };
+    int64_t _probeRTTRoundDoneAt { 0 };
+
+    SequenceNumber _lastFastRetransmit; // last sequence number we asked to fast re-transmit
+};
+
+}
+
+#endif // hifi_BBRCC_h
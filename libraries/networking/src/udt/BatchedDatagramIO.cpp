@@ -0,0 +1,260 @@
+//
+//  BatchedDatagramIO.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BatchedDatagramIO.h"
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <netinet/udp.h>
+
+#include "../NetworkLogging.h"
+#include "Constants.h"
+
+using namespace udt;
+
+#ifdef UDP_SEGMENT
+static std::atomic<bool> segmentationOffloadEnabled { true };
+#else
+static std::atomic<bool> segmentationOffloadEnabled { false };
+#endif
+
+// the kernel caps a GSO send at 64 segments and the size of a single UDP datagram
+static const int MAX_SEGMENTS_PER_SEND = 64;
+static const int MAX_SEGMENTED_SEND_BYTES = 65000;
+
+ReceiveBatch::ReceiveBatch() {
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        _buffers[i] = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+
+        _iovecs[i].iov_base = _buffers[i].get();
+        _iovecs[i].iov_len = MAX_PACKET_SIZE;
+
+        memset(&_messages[i], 0, sizeof(mmsghdr));
+        _messages[i].msg_hdr.msg_iov = &_iovecs[i];
+        _messages[i].msg_hdr.msg_iovlen = 1;
+        _messages[i].msg_hdr.msg_name = &_senders[i];
+    }
+}
+
+bool ReceiveBatch::enableKernelDropReporting(int socketDescriptor) {
+#ifdef SO_RXQ_OVFL
+    int enabled = 1;
+    return setsockopt(socketDescriptor, SOL_SOCKET, SO_RXQ_OVFL, &enabled, sizeof(enabled)) == 0;
+#else
+    Q_UNUSED(socketDescriptor);
+    return false;
+#endif
+}
+
+int ReceiveBatch::receive(int socketDescriptor) {
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        auto& message = _messages[i];
+        message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        message.msg_hdr.msg_control = _controlBuffers[i].data;
+        message.msg_hdr.msg_controllen = sizeof(_controlBuffers[i].data);
+        message.msg_hdr.msg_flags = 0;
+        message.msg_len = 0;
+    }
+
+    int numReceived = recvmmsg(socketDescriptor, _messages.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+    if (numReceived < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+#ifdef SO_RXQ_OVFL
+    // the kernel only attaches the drop counter once it is non-zero, and it only ever grows
+    for (int i = 0; i < numReceived; ++i) {
+        auto header = &_messages[i].msg_hdr;
+        for (cmsghdr* control = CMSG_FIRSTHDR(header); control; control = CMSG_NXTHDR(header, control)) {
+            if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL) {
+                memcpy(&_kernelDropCount, CMSG_DATA(control), sizeof(_kernelDropCount));
+            }
+        }
+    }
+#endif
+
+    return numReceived;
+}
+
+HifiSockAddr ReceiveBatch::getSender(int index) const {
+    return HifiSockAddr(reinterpret_cast<const sockaddr*>(&_senders[index]));
+}
+
+PacketBuffer ReceiveBatch::takeBuffer(int index) {
+    auto buffer = std::move(_buffers[index]);
+
+    // replace the buffer we're giving away so this slot is ready for the next receive
+    _buffers[index] = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+    _iovecs[index].iov_base = _buffers[index].get();
+
+    return buffer;
+}
+
+bool SendBatch::isSegmentationOffloadEnabled() {
+    return segmentationOffloadEnabled;
+}
+
+qint64 SendBatch::send(int socketDescriptor, const HifiSockAddr& destination) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(destination.getPort());
+    address.sin_addr.s_addr = htonl(destination.getAddress().toIPv4Address());
+
+    int count = (int)_datagrams.size();
+    int next = 0;
+    qint64 bytesSent = 0;
+
+    while (next < count) {
+        int runLength = 1;
+        qint64 result = -1;
+
+        if (canSendSegmented(next, 2)) {
+            // grow the run of datagrams that can be sent as segments of one large datagram
+            while (next + runLength < count && runLength < MAX_SEGMENTS_PER_SEND
+                   && canSendSegmented(next, runLength + 1)) {
+                ++runLength;
+            }
+
+            result = sendSegmented(socketDescriptor, address, next, runLength);
+
+            if (result < 0 && !isSegmentationOffloadEnabled()) {
+                // the kernel refused GSO, go around again and send this run through sendmmsg
+                continue;
+            }
+        } else {
+            // send everything up to the next run that could be segmented in one go
+            while (next + runLength < count && !canSendSegmented(next + runLength, 2)) {
+                ++runLength;
+            }
+
+            result = sendMultiple(socketDescriptor, address, next, runLength);
+        }
+
+        if (result < 0) {
+            // the socket buffer is full or the send failed, drop the rest like a failed writeDatagram would
+            break;
+        }
+
+        bytesSent += result;
+        next += runLength;
+    }
+
+    return (bytesSent > 0 || count == 0) ? bytesSent : -1;
+}
+
+bool SendBatch::canSendSegmented(int first, int count) const {
+    if (!segmentationOffloadEnabled || first + count > (int)_datagrams.size()) {
+        return false;
+    }
+
+    // every segment but the last must be the same size, and the last can't be larger
+    int segmentSize = _datagrams[first].size;
+    int totalSize = 0;
+    for (int i = first; i < first + count; ++i) {
+        int size = _datagrams[i].size;
+        if (size > segmentSize || (size < segmentSize && i != first + count - 1)) {
+            return false;
+        }
+        totalSize += size;
+    }
+
+    return totalSize <= MAX_SEGMENTED_SEND_BYTES;
+}
+
+qint64 SendBatch::sendSegmented(int socketDescriptor, const sockaddr_in& destination, int first, int count) {
+#ifdef UDP_SEGMENT
+    // GSO needs the segments in one contiguous buffer
+    _segmentBuffer.clear();
+    for (int i = first; i < first + count; ++i) {
+        _segmentBuffer.insert(_segmentBuffer.end(), _datagrams[i].data, _datagrams[i].data + _datagrams[i].size);
+    }
+
+    iovec iov;
+    iov.iov_base = _segmentBuffer.data();
+    iov.iov_len = _segmentBuffer.size();
+
+    char control[CMSG_SPACE(sizeof(uint16_t))];
+    memset(control, 0, sizeof(control));
+
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = const_cast<sockaddr_in*>(&destination);
+    message.msg_namelen = sizeof(sockaddr_in);
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr* segmentMessage = CMSG_FIRSTHDR(&message);
+    segmentMessage->cmsg_level = IPPROTO_UDP;
+    segmentMessage->cmsg_type = UDP_SEGMENT;
+    segmentMessage->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t segmentSize = _datagrams[first].size;
+    memcpy(CMSG_DATA(segmentMessage), &segmentSize, sizeof(segmentSize));
+
+    auto result = sendmsg(socketDescriptor, &message, 0);
+
+    if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+        // this kernel or interface can't segment for us (EIO, EINVAL, ENOPROTOOPT...) - don't try again
+        qCDebug(networking) << "UDP segmentation offload unavailable (" << strerror(errno)
+            << ") - falling back to sendmmsg";
+        segmentationOffloadEnabled = false;
+    }
+
+    return result;
+#else
+    Q_UNUSED(socketDescriptor);
+    Q_UNUSED(destination);
+    Q_UNUSED(first);
+    Q_UNUSED(count);
+    return -1;
+#endif
+}
+
+qint64 SendBatch::sendMultiple(int socketDescriptor, const sockaddr_in& destination, int first, int count) {
+    std::vector<iovec> iovecs(count);
+    std::vector<mmsghdr> messages(count);
+
+    for (int i = 0; i < count; ++i) {
+        iovecs[i].iov_base = const_cast<char*>(_datagrams[first + i].data);
+        iovecs[i].iov_len = _datagrams[first + i].size;
+
+        memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_name = const_cast<sockaddr_in*>(&destination);
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    qint64 bytesSent = 0;
+    int numSent = 0;
+
+    while (numSent < count) {
+        int result = sendmmsg(socketDescriptor, messages.data() + numSent, count - numSent, 0);
+        if (result <= 0) {
+            break;
+        }
+
+        for (int i = numSent; i < numSent + result; ++i) {
+            bytesSent += messages[i].msg_len;
+        }
+        numSent += result;
+    }
+
+    return numSent > 0 ? bytesSent : -1;
+}
+
+#endif // UDT_BATCHED_DATAGRAM_IO
@@ -0,0 +1,119 @@
+//
+//  BatchedDatagramIO.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_udt_BatchedDatagramIO_h
+#define hifi_udt_BatchedDatagramIO_h
+
+#include <QtCore/QtGlobal>
+
+// recvmmsg/sendmmsg let us move many datagrams per system call, they're only used where we know they're available
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#define UDT_BATCHED_DATAGRAM_IO
+#endif
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "../HifiSockAddr.h"
+#include "PacketBufferPool.h"
+
+namespace udt {
+
+// A ring of receive buffers filled by a single recvmmsg call.
+//
+// Buffers are handed to the packets built from them with takeBuffer, which replaces the slot with a fresh buffer
+// from the PacketBufferPool so that the received data is never copied.
+class ReceiveBatch {
+public:
+    static const int BATCH_SIZE = 32;
+
+    ReceiveBatch();
+
+    // receives up to BATCH_SIZE datagrams without blocking
+    // returns the number of datagrams received, 0 if none were waiting, or -1 on error
+    int receive(int socketDescriptor);
+
+    // true if the datagram didn't fit in our buffer, it should be dropped
+    bool wasTruncated(int index) const { return _messages[index].msg_hdr.msg_flags & MSG_TRUNC; }
+
+    int getSize(int index) const { return _messages[index].msg_len; }
+    HifiSockAddr getSender(int index) const;
+    PacketBuffer takeBuffer(int index);
+
+    // the number of datagrams the kernel has dropped on this socket because its receive buffer was full, as of the
+    // last receive - only reported once SO_RXQ_OVFL is turned on for the socket (see enableKernelDropReporting)
+    uint32_t getKernelDropCount() const { return _kernelDropCount; }
+    void resetKernelDropCount() { _kernelDropCount = 0; }
+
+    static bool enableKernelDropReporting(int socketDescriptor);
+
+private:
+    // room for the SO_RXQ_OVFL drop counter the kernel can attach to each datagram
+    struct alignas(cmsghdr) ControlBuffer {
+        char data[CMSG_SPACE(sizeof(uint32_t))];
+    };
+
+    ReceiveBatch(const ReceiveBatch&) = delete;
+    ReceiveBatch& operator=(const ReceiveBatch&) = delete;
+
+    std::array<PacketBuffer, BATCH_SIZE> _buffers;
+    std::array<mmsghdr, BATCH_SIZE> _messages;
+    std::array<iovec, BATCH_SIZE> _iovecs;
+    std::array<sockaddr_in, BATCH_SIZE> _senders;
+    std::array<ControlBuffer, BATCH_SIZE> _controlBuffers;
+
+    uint32_t _kernelDropCount { 0 };
+};
+
+// Sends datagrams to a single destination in as few system calls as possible.
+//
+// Runs of equally sized datagrams (what a PacketList splits into) go out as one UDP GSO send where the kernel supports
+// it, everything else goes out through sendmmsg.
+class SendBatch {
+public:
+    void append(const char* data, int size) { _datagrams.push_back({ data, size }); }
+    void clear() { _datagrams.clear(); }
+    bool isEmpty() const { return _datagrams.empty(); }
+    int getDatagramCount() const { return (int)_datagrams.size(); }
+
+    // returns the number of bytes sent, or -1 if nothing could be sent
+    qint64 send(int socketDescriptor, const HifiSockAddr& destination);
+
+    // GSO support is probed on first use, a failure turns it off for the rest of the process
+    static bool isSegmentationOffloadEnabled();
+
+private:
+    struct Datagram {
+        const char* data;
+        int size;
+    };
+
+    bool canSendSegmented(int first, int count) const;
+    qint64 sendSegmented(int socketDescriptor, const sockaddr_in& destination, int first, int count);
+    qint64 sendMultiple(int socketDescriptor, const sockaddr_in& destination, int first, int count);
+
+    std::vector<Datagram> _datagrams;
+    std::vector<char> _segmentBuffer;
+};
+
+}
+
+#endif // UDT_BATCHED_DATAGRAM_IO
+
+#endif // hifi_udt_BatchedDatagramIO_h
@@ -21,6 +21,8 @@
 #include "LossList.h"
 #include "SequenceNumber.h"
 
+class HifiSockAddr;
+
 namespace udt {
     
 static const int32_t DEFAULT_SYN_INTERVAL = 10000; // 10 ms
@@ -98,6 +100,9 @@ public:
     static int synInterval() { return DEFAULT_SYN_INTERVAL; }
     
     virtual std::unique_ptr<CongestionControl> create() = 0;
+
+    // lets a factory pick the congestion control based on who the connection is to, by default they all get the same
+    virtual std::unique_ptr<CongestionControl> createForDestination(const HifiSockAddr& destination) { return create(); }
 };
 
 template <class T> class CongestionControlFactory: public CongestionControlVirtualFactory {
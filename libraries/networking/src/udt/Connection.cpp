@@ -11,9 +11,9 @@
 
 #include "Connection.h"
 
+#include <algorithm>
 #include <random>
 
-#include <QtCore/QThread>
 
 #include <NumericalConstants.h>
 
@@ -77,27 +77,21 @@ Connection::~Connection() {
     stopSendQueue();
 
     // Fail any pending received messages
-    for (auto& pendingMessage : _pendingReceivedMessages) {
-        _parentSocket->messageFailed(this, pendingMessage.first);
+    for (auto& streamMessages : _pendingReceivedMessages) {
+        for (auto& pendingMessage : streamMessages) {
+            _parentSocket->messageFailed(this, pendingMessage.first);
+        }
     }
 }
 
 void Connection::stopSendQueue() {
-    if (auto sendQueue = _sendQueue.release()) {
-        // grab the send queue thread so we can wait on it
-        QThread* sendQueueThread = sendQueue->thread();
-        
-        // tell the send queue to stop and be deleted
-        
+    if (auto sendQueue = std::move(_sendQueue)) {
+        // tell the send queue to stop, this waits for the send scheduler to be done with it
         sendQueue->stop();
 
         _lastMessageNumber = sendQueue->getCurrentMessageNumber();
 
-        sendQueue->deleteLater();
-        
-        // wait on the send queue thread so we know the send queue is gone
-        sendQueueThread->quit();
-        sendQueueThread->wait();
+        // the send queue is deleted as it goes out of scope
     }
 }
 
@@ -110,6 +104,15 @@ void Connection::setMaxBandwidth(int maxBandwidth) {
     _congestionControl->setMaxBandwidth(maxBandwidth);
 }
 
+void Connection::setStreamScheduling(StreamScheduling scheduling, const StreamWeights& weights) {
+    _streamScheduling = scheduling;
+    _streamWeights = weights;
+
+    if (_sendQueue) {
+        _sendQueue->setStreamScheduling(_streamScheduling, _streamWeights);
+    }
+}
+
 SendQueue& Connection::getSendQueue() {
     if (!_sendQueue) {
         // we may have a sequence number from the previous inactive queue - re-use that so that the
@@ -130,6 +133,8 @@ SendQueue& Connection::getSendQueue() {
         qCDebug(networking) << "Created SendQueue for connection to" << _destination;
 #endif
         
+        _sendQueue->setStreamScheduling(_streamScheduling, _streamWeights);
+
         QObject::connect(_sendQueue.get(), &SendQueue::packetSent, this, &Connection::packetSent);
         QObject::connect(_sendQueue.get(), &SendQueue::packetSent, this, &Connection::recordSentPackets);
         QObject::connect(_sendQueue.get(), &SendQueue::packetRetransmitted, this, &Connection::recordRetransmission);
@@ -186,8 +191,13 @@ void Connection::sendReliablePacketList(std::unique_ptr<PacketList> packetList)
 void Connection::queueReceivedMessagePacket(std::unique_ptr<Packet> packet) {
     Q_ASSERT(packet->isPartOfMessage());
 
+    // each stream's messages are reassembled apart, so nothing queued on one can hold up another
     auto messageNumber = packet->getMessageNumber();
-    auto& pendingMessage = _pendingReceivedMessages[messageNumber];
+    auto stream = packet->getStream();
+    auto& streamMessages = _pendingReceivedMessages[(int)stream];
+    auto& pendingMessage = streamMessages[messageNumber];
+
+    _stats.recordStreamReceivedPacket(stream, packet->getPayloadSize());
 
     pendingMessage.enqueuePacket(std::move(packet));
 
@@ -208,7 +218,8 @@ void Connection::queueReceivedMessagePacket(std::unique_ptr<Packet> packet) {
     }
 
     if (processedLastOrOnly) {
-        _pendingReceivedMessages.erase(messageNumber);
+        _stats.recordStreamReceivedMessage(stream);
+        streamMessages.erase(messageNumber);
     }
 }
 
@@ -252,15 +263,18 @@ void Connection::sync() {
     }
 }
 
-void Connection::recordSentPackets(int wireSize, int payloadSize,
-                                   SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+void Connection::recordSentPackets(int wireSize, int payloadSize, SequenceNumber seqNum,
+                                   p_high_resolution_clock::time_point timePoint, quint8 stream) {
     _stats.recordSentPackets(payloadSize, wireSize);
+    _stats.recordStreamSentPacket((Stream)stream, payloadSize);
 
     _congestionControl->onPacketSent(wireSize, seqNum, timePoint);
 }
 
-void Connection::recordRetransmission(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+void Connection::recordRetransmission(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint,
+                                      quint8 stream) {
     _stats.record(ConnectionStats::Stats::Retransmission);
+    _stats.recordStreamRetransmission((Stream)stream);
 
     _congestionControl->onPacketSent(wireSize, seqNum, timePoint);
 }
@@ -719,7 +733,8 @@ void Connection::processACK2(ControlPacketPointer controlPacket) {
     controlPacket->readPrimitive(&subSequenceNumber);
 
     // check if we had that subsequence number in our map
-    auto it = std::find_if_not(_sentACKs.begin(), _sentACKs.end(), [&subSequenceNumber](const ACKListPair& pair){
+    auto it = std::lower_bound(_sentACKs.begin(), _sentACKs.end(), subSequenceNumber,
+                               [](const ACKListPair& pair, const SequenceNumber& subSequenceNumber){
         return pair.first < subSequenceNumber;
     });
     
@@ -887,10 +902,12 @@ void Connection::resetReceiveState() {
     _receivedControlProbeTail = false;
     
     // clear any pending received messages
-    for (auto& pendingMessage : _pendingReceivedMessages) {
-        _parentSocket->messageFailed(this, pendingMessage.first);
+    for (auto& streamMessages : _pendingReceivedMessages) {
+        for (auto& pendingMessage : streamMessages) {
+            _parentSocket->messageFailed(this, pendingMessage.first);
+        }
+        streamMessages.clear();
     }
-    _pendingReceivedMessages.clear();
 }
 
 void Connection::updateRTT(int rtt) {
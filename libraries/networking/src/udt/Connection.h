@@ -12,7 +12,8 @@
 #ifndef hifi_Connection_h
 #define hifi_Connection_h
 
-#include <list>
+#include <array>
+#include <deque>
 #include <memory>
 
 #include <QtCore/QObject>
@@ -40,7 +41,7 @@ public:
     bool hasAvailablePackets() const;
     std::unique_ptr<Packet> removeNextPacket();
     
-    std::list<std::unique_ptr<Packet>> _packets;
+    std::deque<std::unique_ptr<Packet>> _packets;
 
 private:
     bool _hasLastPacket { false };
@@ -53,7 +54,7 @@ class Connection : public QObject {
 public:
     using SequenceNumberTimePair = std::pair<SequenceNumber, p_high_resolution_clock::time_point>;
     using ACKListPair = std::pair<SequenceNumber, SequenceNumberTimePair>;
-    using SentACKList = std::list<ACKListPair>;
+    using SentACKList = std::deque<ACKListPair>; // sorted by ACK sub-sequence number
     using ControlPacketPointer = std::unique_ptr<ControlPacket>;
     
     Connection(Socket* parentSocket, HifiSockAddr destination, std::unique_ptr<CongestionControl> congestionControl);
@@ -76,6 +77,8 @@ public:
 
     void setMaxBandwidth(int maxBandwidth);
 
+    void setStreamScheduling(StreamScheduling scheduling, const StreamWeights& weights);
+
     void sendHandshakeRequest();
 
 signals:
@@ -83,8 +86,10 @@ signals:
     void receiverHandshakeRequestComplete(const HifiSockAddr& sockAddr);
 
 private slots:
-    void recordSentPackets(int wireSize, int payloadSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint);
-    void recordRetransmission(int wireSize, SequenceNumber sequenceNumber, p_high_resolution_clock::time_point timePoint);
+    void recordSentPackets(int wireSize, int payloadSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint,
+                           quint8 stream);
+    void recordRetransmission(int wireSize, SequenceNumber sequenceNumber, p_high_resolution_clock::time_point timePoint,
+                              quint8 stream);
     void queueInactive();
     void queueTimeout();
     void queueShortCircuitLoss(quint32 sequenceNumber);
@@ -169,7 +174,10 @@ private:
    
     std::unique_ptr<SendQueue> _sendQueue;
     
-    std::map<MessageNumber, PendingReceivedMessage> _pendingReceivedMessages;
+    std::array<std::map<MessageNumber, PendingReceivedMessage>, NUM_STREAMS> _pendingReceivedMessages; // per stream
+
+    StreamScheduling _streamScheduling { StreamScheduling::WeightedFair };
+    StreamWeights _streamWeights { DEFAULT_STREAM_WEIGHTS };
     
     int _packetsSinceACK { 0 }; // The number of packets that have been received during the current ACK interval
 
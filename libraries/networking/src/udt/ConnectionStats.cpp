@@ -58,6 +58,32 @@ void ConnectionStats::recordReceivedPackets(int payload, int total) {
     _total.receivedBytes += total;
 }
 
+void ConnectionStats::recordStreamSentPacket(Stream stream, int payload) {
+    ++_currentSample.streams[(int)stream].sentPackets;
+    ++_total.streams[(int)stream].sentPackets;
+
+    _currentSample.streams[(int)stream].sentUtilBytes += payload;
+    _total.streams[(int)stream].sentUtilBytes += payload;
+}
+
+void ConnectionStats::recordStreamRetransmission(Stream stream) {
+    ++_currentSample.streams[(int)stream].retransmissions;
+    ++_total.streams[(int)stream].retransmissions;
+}
+
+void ConnectionStats::recordStreamReceivedPacket(Stream stream, int payload) {
+    ++_currentSample.streams[(int)stream].receivedPackets;
+    ++_total.streams[(int)stream].receivedPackets;
+
+    _currentSample.streams[(int)stream].receivedUtilBytes += payload;
+    _total.streams[(int)stream].receivedUtilBytes += payload;
+}
+
+void ConnectionStats::recordStreamReceivedMessage(Stream stream) {
+    ++_currentSample.streams[(int)stream].receivedMessages;
+    ++_total.streams[(int)stream].receivedMessages;
+}
+
 void ConnectionStats::recordUnreliableSentPackets(int payload, int total) {
     ++_currentSample.sentUnreliablePackets;
     ++_total.sentUnreliablePackets;
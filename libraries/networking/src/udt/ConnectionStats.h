@@ -15,6 +15,8 @@
 #include <chrono>
 #include <array>
 
+#include "Streams.h"
+
 namespace udt {
 
 class ConnectionStats {
@@ -69,6 +71,18 @@ public:
         int rtt { 0 };
         int congestionWindowSize { 0 };
         int packetSendPeriod { 0 };
+
+        // reliable traffic per stream (see Streams.h), indexed by Stream - what is received can only be put on a stream
+        // when it is part of a message, since that is where the stream is on the wire
+        struct StreamStats {
+            int sentPackets { 0 };
+            int sentUtilBytes { 0 };
+            int retransmissions { 0 };
+            int receivedPackets { 0 };
+            int receivedUtilBytes { 0 };
+            int receivedMessages { 0 };
+        };
+        std::array<StreamStats, NUM_STREAMS> streams;
         
         // TODO: Remove once Win build supports brace initialization: `Events events {{ 0 }};`
         Stats() { events.fill(0); }
@@ -84,6 +98,11 @@ public:
     void recordSentPackets(int payload, int total);
     void recordReceivedPackets(int payload, int total);
     
+    void recordStreamSentPacket(Stream stream, int payload);
+    void recordStreamRetransmission(Stream stream);
+    void recordStreamReceivedPacket(Stream stream, int payload);
+    void recordStreamReceivedMessage(Stream stream);
+
     void recordUnreliableSentPackets(int payload, int total);
     void recordUnreliableReceivedPackets(int payload, int total);
     
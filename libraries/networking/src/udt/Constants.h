@@ -68,6 +68,11 @@ namespace udt {
 
     static const uint32_t MESSAGE_PART_NUMBER_MASK = ~uint32_t(0);
 
+    // The top bits of the message number are the stream the message is on (see Streams.h)
+    static const int MESSAGE_STREAM_SIZE = 2;
+    static const int MESSAGE_STREAM_OFFSET = MESSAGE_NUMBER_OFFSET + MESSAGE_NUMBER_SIZE - MESSAGE_STREAM_SIZE;
+    static const uint32_t MESSAGE_STREAM_MASK = uint32_t(3) << MESSAGE_STREAM_OFFSET;
+
 
     // Static checks
     static_assert(CONTROL_BIT_SIZE + RELIABILITY_BIT_SIZE + MESSAGE_BIT_SIZE +
@@ -11,34 +11,38 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+
 #include "ControlPacket.h"
 
 using namespace udt;
 using namespace std;
 
+static const int MIN_RING_SIZE = 16;
+
 void LossList::append(SequenceNumber seq) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < seq), "LossList::append(SequenceNumber)",
+    Q_ASSERT_X(_numRanges == 0 || (rangeAt(_numRanges - 1).second < seq), "LossList::append(SequenceNumber)",
                "SequenceNumber appended is not greater than the last SequenceNumber in the list");
-    
-    if (getLength() > 0 && _lossList.back().second + 1 == seq) {
-        ++_lossList.back().second;
+
+    if (getLength() > 0 && rangeAt(_numRanges - 1).second + 1 == seq) {
+        ++rangeAt(_numRanges - 1).second;
     } else {
-        _lossList.push_back(make_pair(seq, seq));
+        insertRange(_numRanges, make_pair(seq, seq));
     }
     _length += 1;
 }
 
 void LossList::append(SequenceNumber start, SequenceNumber end) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < start),
+    Q_ASSERT_X(_numRanges == 0 || (rangeAt(_numRanges - 1).second < start),
                "LossList::append(SequenceNumber, SequenceNumber)",
                "SequenceNumber range appended is not greater than the last SequenceNumber in the list");
     Q_ASSERT_X(start <= end,
                "LossList::append(SequenceNumber, SequenceNumber)", "Range start greater than range end");
 
-    if (getLength() > 0 && _lossList.back().second + 1 == start) {
-        _lossList.back().second = end;
+    if (getLength() > 0 && rangeAt(_numRanges - 1).second + 1 == start) {
+        rangeAt(_numRanges - 1).second = end;
     } else {
-        _lossList.push_back(make_pair(start, end));
+        insertRange(_numRanges, make_pair(start, end));
     }
     _length += seqlen(start, end);
 }
@@ -46,64 +50,70 @@ void LossList::append(SequenceNumber start, SequenceNumber end) {
 void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
-    
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
-    
-    if (it == _lossList.end() || end < it->first) {
+
+    // a range ending right before start is extended rather than left next to a new one
+    int index = findFirstRangeEndingAtOrAfter(start - 1);
+
+    if (index == _numRanges || end + 1 < rangeAt(index).first) {
         // No overlap, simply insert
         _length += seqlen(start, end);
-        _lossList.insert(it, make_pair(start, end));
+        insertRange(index, make_pair(start, end));
     } else {
+        auto& range = rangeAt(index);
+
         // If it starts before segment, extend segment
-        if (start < it->first) {
-            _length += seqlen(start, it->first - 1);
-            it->first = start;
+        if (start < range.first) {
+            _length += seqlen(start, range.first - 1);
+            range.first = start;
         }
-        
+
         // If it ends after segment, extend segment
-        if (end > it->second) {
-            _length += seqlen(it->second + 1, end);
-            it->second = end;
+        if (end > range.second) {
+            _length += seqlen(range.second + 1, end);
+            range.second = end;
         }
-        
-        auto it2 = it;
-        ++it2;
+
         // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
+        int numMerged = 0;
+        while (index + 1 + numMerged < _numRanges && range.second >= rangeAt(index + 1 + numMerged).first - 1) {
+            const auto& next = rangeAt(index + 1 + numMerged);
+
             // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
+            if (range.second < next.second) {
+                _length += seqlen(range.second + 1, next.second);
+                range.second = next.second;
             }
-            
+
             // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
+            _length -= seqlen(next.first, next.second);
+            ++numMerged;
+        }
+
+        if (numMerged > 0) {
+            eraseRanges(index + 1, numMerged);
         }
     }
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
-    
-    if (it != end(_lossList)) {
-        if (it->first == it->second) {
-            _lossList.erase(it);
-        } else if (seq == it->first) {
-            ++it->first;
-        } else if (seq == it->second) {
-            --it->second;
+    int index = findFirstRangeEndingAtOrAfter(seq);
+
+    if (index != _numRanges && rangeAt(index).first <= seq) {
+        auto& range = rangeAt(index);
+
+        if (range.first == range.second) {
+            eraseRanges(index, 1);
+        } else if (seq == range.first) {
+            ++range.first;
+        } else if (seq == range.second) {
+            --range.second;
         } else {
-            auto temp = it->second;
-            it->second = seq - 1;
-            _lossList.insert(++it, make_pair(seq + 1, temp));
+            auto temp = range.second;
+            range.second = seq - 1;
+            insertRange(index + 1, make_pair(seq + 1, temp));
         }
         _length -= 1;
-        
+
         // this sequence number was found in the loss list, return true
         return true;
     } else {
@@ -116,69 +126,144 @@ void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
-    });
-    
+    int index = findFirstRangeEndingAtOrAfter(start);
+
     // If we found one
-    if (it != _lossList.end()) {
-        
+    if (index != _numRanges && rangeAt(index).first <= end) {
+        int firstErased = index;
+
         // While the end of the current segment is contained, either shorten it (first one only - sometimes)
         // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
+        while (index != _numRanges && end >= rangeAt(index).second) {
+            auto& range = rangeAt(index);
+            if (start <= range.first) {
+                // Segment is contained, update new length and erase it (once we know how many go).
+                _length -= seqlen(range.first, range.second);
             } else {
                 // Beginning of segment not contained, modify end of segment.
                 // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
+                _length -= seqlen(start, range.second);
+                range.second = start - 1;
+                ++firstErased;
             }
+            ++index;
         }
-        
+
         // There might be more to remove
-        if (it != _lossList.end() && it->first <= end) {
-            if (start <= it->first) {
+        if (index != _numRanges && rangeAt(index).first <= end) {
+            auto& range = rangeAt(index);
+            if (start <= range.first) {
                 // Truncate beginning of segment
-                _length -= seqlen(it->first, end);
-                it->first = end + 1;
+                _length -= seqlen(range.first, end);
+                range.first = end + 1;
             } else {
                 // Cut it in half if the range we are removing is contained within one segment
                 _length -= seqlen(start, end);
-                auto temp = it->second;
-                it->second = start - 1;
-                _lossList.insert(++it, make_pair(end + 1, temp));
+                auto temp = range.second;
+                range.second = start - 1;
+                insertRange(index + 1, make_pair(end + 1, temp));
             }
         }
+
+        if (index > firstErased) {
+            eraseRanges(firstErased, index - firstErased);
+        }
     }
 }
 
 SequenceNumber LossList::getFirstSequenceNumber() const {
     Q_ASSERT_X(getLength() > 0, "LossList::getFirstSequenceNumber()", "Trying to get first element of an empty list");
-    return _lossList.front().first;
+    return rangeAt(0).first;
 }
 
 SequenceNumber LossList::popFirstSequenceNumber() {
     auto front = getFirstSequenceNumber();
-    remove(front);
+
+    auto& range = rangeAt(0);
+    if (range.first == range.second) {
+        eraseRanges(0, 1);
+    } else {
+        ++range.first;
+    }
+    _length -= 1;
+
     return front;
 }
 
 void LossList::write(ControlPacket& packet, int maxPairs) {
-    int writtenPairs = 0;
-    
-    for (const auto& pair : _lossList) {
-        packet.writePrimitive(pair.first);
-        packet.writePrimitive(pair.second);
-        
-        ++writtenPairs;
-        
-        // check if we've written the maximum number we were told to write
-        if (maxPairs != -1 && writtenPairs >= maxPairs) {
-            break;
+    int numPairs = (maxPairs != -1 && maxPairs < _numRanges) ? maxPairs : _numRanges;
+
+    for (int i = 0; i < numPairs; ++i) {
+        const auto& range = rangeAt(i);
+        packet.writePrimitive(range.first);
+        packet.writePrimitive(range.second);
+    }
+}
+
+int LossList::findFirstRangeEndingAtOrAfter(SequenceNumber seq) const {
+    int low = 0;
+    int high = _numRanges;
+
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (rangeAt(middle).second < seq) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+void LossList::insertRange(int index, const Range& range) {
+    if (_numRanges == (int)_ranges.size()) {
+        grow();
+    }
+
+    int mask = (int)_ranges.size() - 1;
+
+    if (index < _numRanges - index) {
+        // fewer ranges before the insertion point, move the head back and shift those down
+        _head = (_head - 1) & mask;
+        for (int i = 0; i < index; ++i) {
+            rangeAt(i) = rangeAt(i + 1);
+        }
+    } else {
+        for (int i = _numRanges; i > index; --i) {
+            rangeAt(i) = rangeAt(i - 1);
         }
     }
+
+    ++_numRanges;
+    rangeAt(index) = range;
+}
+
+void LossList::eraseRanges(int index, int count) {
+    int numAfter = _numRanges - index - count;
+
+    if (index < numAfter) {
+        // fewer ranges before the erased ones, shift those up and move the head forward
+        for (int i = index - 1; i >= 0; --i) {
+            rangeAt(i + count) = rangeAt(i);
+        }
+        _head = (_head + count) & ((int)_ranges.size() - 1);
+    } else {
+        for (int i = index; i < index + numAfter; ++i) {
+            rangeAt(i) = rangeAt(i + count);
+        }
+    }
+
+    _numRanges -= count;
+}
+
+void LossList::grow() {
+    std::vector<Range> ranges(std::max(MIN_RING_SIZE, (int)_ranges.size() * 2));
+
+    for (int i = 0; i < _numRanges; ++i) {
+        ranges[i] = rangeAt(i);
+    }
+
+    _ranges.swap(ranges);
+    _head = 0;
 }
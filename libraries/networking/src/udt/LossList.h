@@ -12,19 +12,24 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <vector>
 
 #include "SequenceNumber.h"
 
 namespace udt {
 
 class ControlPacket;
-    
+
+// Sorted, disjoint ranges of lost sequence numbers, held in a ring buffer that only grows.
+//
+// Appending and removing from the front (the common cases for NAK processing) are constant time and never allocate
+// once the ring is big enough. Ranges are found with a binary search, and inserting or removing a range in the middle
+// only shifts the ranges on the shorter side.
 class LossList {
 public:
     LossList() {}
     
-    void clear() { _length = 0; _lossList.clear(); }
+    void clear() { _length = 0; _head = 0; _numRanges = 0; }
     
     // must always add at the end - faster than insert
     void append(SequenceNumber seq);
@@ -44,7 +49,21 @@ public:
     void write(ControlPacket& packet, int maxPairs = -1);
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    using Range = std::pair<SequenceNumber, SequenceNumber>;
+
+    Range& rangeAt(int index) { return _ranges[(_head + index) & (_ranges.size() - 1)]; }
+    const Range& rangeAt(int index) const { return _ranges[(_head + index) & (_ranges.size() - 1)]; }
+
+    // returns the index of the first range that ends at or after seq, or the number of ranges if there is none
+    int findFirstRangeEndingAtOrAfter(SequenceNumber seq) const;
+
+    void insertRange(int index, const Range& range);
+    void eraseRanges(int index, int count);
+    void grow();
+
+    std::vector<Range> _ranges; // the ring, its size is always zero or a power of two
+    int _head { 0 }; // index in _ranges of the first range
+    int _numRanges { 0 };
     int _length { 0 };
 };
     
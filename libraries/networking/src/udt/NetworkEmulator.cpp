@@ -0,0 +1,203 @@
+//
+//  NetworkEmulator.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkEmulator.h"
+
+#include <algorithm>
+
+#include <QtCore/QStringList>
+
+using namespace udt;
+using namespace std::chrono;
+
+bool NetworkEmulator::Settings::fromString(const QString& description, Settings& settings) {
+    for (const auto& entry : description.split(',', QString::SkipEmptyParts)) {
+        auto parts = entry.split('=');
+        if (parts.size() != 2) {
+            return false;
+        }
+
+        auto key = parts[0].trimmed().toLower();
+        bool ok = false;
+        double value = parts[1].trimmed().toDouble(&ok);
+        if (!ok || value < 0.0) {
+            return false;
+        }
+
+        auto milliseconds = microseconds((int64_t)(value * 1000.0));
+
+        if (key == "loss") {
+            settings.lossRate = value;
+        } else if (key == "burst") {
+            settings.burstEnterRate = value;
+        } else if (key == "burstexit") {
+            settings.burstExitRate = value;
+        } else if (key == "burstloss") {
+            settings.burstLossRate = value;
+        } else if (key == "duplicate") {
+            settings.duplicateRate = value;
+        } else if (key == "reorder") {
+            settings.reorderRate = value;
+        } else if (key == "latency") {
+            settings.latency = milliseconds;
+        } else if (key == "jitter") {
+            settings.jitter = milliseconds;
+        } else if (key == "reorderdelay") {
+            settings.reorderDelay = milliseconds;
+        } else if (key == "queue") {
+            settings.maxQueueDelay = milliseconds;
+        } else if (key == "bandwidth") {
+            settings.bandwidth = (int64_t)value;
+        } else if (key == "seed") {
+            settings.seed = (uint32_t)value;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+microseconds NetworkEmulator::Stats::getQueueDelayPercentile(double fraction) const {
+    uint64_t threshold = (uint64_t)(fraction * queued);
+    uint64_t count = 0;
+    for (size_t i = 0; i < queueDelayHistogram.size(); ++i) {
+        count += queueDelayHistogram[i];
+        if (count > threshold) {
+            return milliseconds(i);
+        }
+    }
+    return milliseconds(queueDelayHistogram.empty() ? 0 : queueDelayHistogram.size() - 1);
+}
+
+NetworkEmulator::NetworkEmulator(const Settings& settings, DatagramWriter writer) :
+    _settings(settings),
+    _writer(writer),
+    _generator(settings.seed),
+    _thread(&NetworkEmulator::run, this)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.queueDelayHistogram.resize(duration_cast<milliseconds>(settings.maxQueueDelay).count() + 1);
+}
+
+NetworkEmulator::~NetworkEmulator() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shouldStop = true;
+    }
+    _condition.notify_one();
+    _thread.join();
+}
+
+void NetworkEmulator::submit(const char* data, qint64 size, const HifiSockAddr& destination) {
+    auto now = Clock::now();
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_stats.submitted;
+
+    if (_inBurst) {
+        _inBurst = chance(_generator) >= _settings.burstExitRate;
+    } else if (_settings.burstEnterRate > 0.0) {
+        _inBurst = chance(_generator) < _settings.burstEnterRate;
+    }
+
+    if (_inBurst && chance(_generator) < _settings.burstLossRate) {
+        ++_stats.burstLost;
+        return;
+    }
+
+    if (_settings.lossRate > 0.0 && chance(_generator) < _settings.lossRate) {
+        ++_stats.randomlyLost;
+        return;
+    }
+
+    auto departure = now;
+
+    if (_settings.bandwidth > 0) {
+        // the datagram starts leaving once everything queued ahead of it has
+        auto start = std::max(now, _lastDeparture);
+        if (start - now > _settings.maxQueueDelay) {
+            ++_stats.queueDropped;
+            return;
+        }
+
+        departure = start + microseconds(size * 8 * 1000000 / _settings.bandwidth);
+        _lastDeparture = departure;
+
+        auto queueDelay = duration_cast<microseconds>(start - now);
+        ++_stats.queued;
+        _stats.totalQueueDelay += queueDelay;
+        auto bucket = std::min((size_t)duration_cast<milliseconds>(queueDelay).count(),
+                               _stats.queueDelayHistogram.size() - 1);
+        ++_stats.queueDelayHistogram[bucket];
+    }
+
+    int copies = 1;
+    if (_settings.duplicateRate > 0.0 && chance(_generator) < _settings.duplicateRate) {
+        copies = 2;
+        ++_stats.duplicated;
+    }
+
+    // the copies share the data, the writes never modify it
+    QByteArray datagram(data, size);
+
+    for (int i = 0; i < copies; ++i) {
+        auto deliveryTime = departure + _settings.latency;
+
+        if (_settings.jitter.count() > 0) {
+            std::uniform_int_distribution<int64_t> jitter(0, _settings.jitter.count());
+            deliveryTime += microseconds(jitter(_generator));
+        }
+
+        if (_settings.reorderRate > 0.0 && chance(_generator) < _settings.reorderRate) {
+            deliveryTime += _settings.reorderDelay;
+            ++_stats.reordered;
+        }
+
+        _pending.push({ deliveryTime, _nextOrder++, datagram, destination });
+    }
+
+    _condition.notify_one();
+}
+
+NetworkEmulator::Stats NetworkEmulator::getStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void NetworkEmulator::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_shouldStop) {
+        if (_pending.empty()) {
+            _condition.wait(lock);
+            continue;
+        }
+
+        auto deliveryTime = _pending.top().deliveryTime;
+        if (Clock::now() < deliveryTime) {
+            // a datagram submitted meanwhile may be due sooner, so this wakes on submit too
+            _condition.wait_until(lock, deliveryTime);
+            continue;
+        }
+
+        auto pending = _pending.top();
+        _pending.pop();
+
+        // write without the lock so submit isn't held up by the socket
+        lock.unlock();
+        _writer(pending.datagram, pending.destination);
+        lock.lock();
+
+        // only counted once it has been written, so whoever waits on the count sees what was written
+        ++_stats.delivered;
+    }
+}
@@ -0,0 +1,136 @@
+//
+//  NetworkEmulator.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_udt_NetworkEmulator_h
+#define hifi_udt_NetworkEmulator_h
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+// Impairs the datagrams a Socket sends, the way netem would, so transport behaviour can be tested in one process.
+//
+// Each datagram handed to submit can be lost (at random or in bursts), held in a bandwidth limited queue, delayed
+// with jitter, held back further so it arrives out of order, or duplicated. The survivors are written by a thread of
+// the emulator's own, through the DatagramWriter, once they are due. All the randomness comes from one seeded
+// generator so a run can be repeated.
+class NetworkEmulator {
+public:
+    struct Settings {
+        double lossRate { 0.0 }; // chance any datagram is dropped
+
+        // Gilbert-Elliott burst loss: the chance, per datagram, of going into and out of a burst, and the chance a
+        // datagram is dropped while in one
+        double burstEnterRate { 0.0 };
+        double burstExitRate { 0.25 };
+        double burstLossRate { 1.0 };
+
+        double duplicateRate { 0.0 }; // chance a datagram is sent twice
+        double reorderRate { 0.0 }; // chance a datagram is held back by reorderDelay on top of the latency
+
+        std::chrono::microseconds latency { 0 }; // one-way delay
+        std::chrono::microseconds jitter { 0 }; // uniformly random extra delay, up to this
+        std::chrono::microseconds reorderDelay { 10000 };
+
+        int64_t bandwidth { 0 }; // bits per second through the bottleneck, 0 for unlimited
+        std::chrono::microseconds maxQueueDelay { 200000 }; // datagrams that would queue longer are tail dropped
+
+        uint32_t seed { 1 };
+
+        // parses a comma separated list like "loss=0.05,latency=40,jitter=5,bandwidth=10000000", where loss, burst,
+        // burstexit, burstloss, duplicate and reorder are probabilities, latency, jitter, reorderdelay and queue are
+        // milliseconds, and bandwidth is bits per second - returns false if anything in it is not understood
+        static bool fromString(const QString& description, Settings& settings);
+    };
+
+    struct Stats {
+        uint64_t submitted { 0 };
+        uint64_t randomlyLost { 0 };
+        uint64_t burstLost { 0 };
+        uint64_t queueDropped { 0 };
+        uint64_t duplicated { 0 };
+        uint64_t reordered { 0 };
+        uint64_t delivered { 0 };
+
+        // what the bandwidth limited queue did to the datagrams that went through it
+        uint64_t queued { 0 };
+        std::chrono::microseconds totalQueueDelay { 0 };
+        std::vector<uint64_t> queueDelayHistogram; // how many waited each whole millisecond, up to maxQueueDelay
+
+        // how long the given fraction of the queued datagrams waited at most, to the millisecond
+        std::chrono::microseconds getQueueDelayPercentile(double fraction) const;
+    };
+
+    using DatagramWriter = std::function<void(const QByteArray& datagram, const HifiSockAddr& destination)>;
+
+    NetworkEmulator(const Settings& settings, DatagramWriter writer);
+    ~NetworkEmulator();
+
+    // may be called from any thread
+    void submit(const char* data, qint64 size, const HifiSockAddr& destination);
+
+    Stats getStats();
+
+    const Settings& getSettings() const { return _settings; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingDatagram {
+        Clock::time_point deliveryTime;
+        uint64_t order; // breaks ties so equal delivery times keep the submit order
+        QByteArray datagram;
+        HifiSockAddr destination;
+
+        bool operator>(const PendingDatagram& other) const {
+            return deliveryTime != other.deliveryTime ? deliveryTime > other.deliveryTime : order > other.order;
+        }
+    };
+
+    NetworkEmulator(const NetworkEmulator&) = delete;
+    NetworkEmulator& operator=(const NetworkEmulator&) = delete;
+
+    void run();
+
+    const Settings _settings;
+    DatagramWriter _writer;
+
+    std::mutex _mutex; // protects everything below
+    std::condition_variable _condition;
+    std::priority_queue<PendingDatagram, std::vector<PendingDatagram>, std::greater<PendingDatagram>> _pending;
+    uint64_t _nextOrder { 0 };
+    std::mt19937 _generator;
+    bool _inBurst { false };
+    Clock::time_point _lastDeparture; // when the last datagram finishes leaving the bottleneck
+    Stats _stats;
+    bool _shouldStop { false };
+
+    std::thread _thread;
+};
+
+}
+
+#endif // hifi_udt_NetworkEmulator_h
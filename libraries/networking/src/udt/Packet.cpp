@@ -61,7 +61,7 @@ std::unique_ptr<Packet> Packet::create(qint64 size, bool isReliable, bool isPart
     return packet;
 }
 
-std::unique_ptr<Packet> Packet::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) {
+std::unique_ptr<Packet> Packet::fromReceivedPacket(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) {
     // Fail with invalid size
     Q_ASSERT(size >= 0);
 
@@ -87,7 +87,7 @@ Packet::Packet(qint64 size, bool isReliable, bool isPartOfMessage) :
     writeHeader();
 }
 
-Packet::Packet(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+Packet::Packet(PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     BasePacket(std::move(data), size, senderSockAddr)
 {
     readHeader();
@@ -139,11 +139,19 @@ Packet& Packet::operator=(Packet&& other) {
     return *this;
 }
 
+// the stream a message number says its message is on - a peer can put anything in those bits, so values past the
+// streams we know are taken as the default one
+static Stream streamInMessageNumber(MessageNumber messageNumber) {
+    int stream = (messageNumber & MESSAGE_STREAM_MASK) >> MESSAGE_STREAM_OFFSET;
+    return stream < NUM_STREAMS ? (Stream)stream : Stream::Default;
+}
+
 void Packet::writeMessageNumber(MessageNumber messageNumber, PacketPosition position, MessagePartNumber messagePartNumber) {
     _isPartOfMessage = true;
     _messageNumber = messageNumber;
     _packetPosition = position;
     _messagePartNumber = messagePartNumber;
+    _stream = streamInMessageNumber(messageNumber);
     writeHeader();
 }
 
@@ -172,6 +180,7 @@ void Packet::copyMembers(const Packet& other) {
     _packetPosition = other._packetPosition;
     _messageNumber = other._messageNumber;
     _messagePartNumber = other._messagePartNumber;
+    _stream = other._stream;
 }
 
 void Packet::readHeader() const {
@@ -189,6 +198,7 @@ void Packet::readHeader() const {
 
         _messageNumber = *messageNumberAndBitField & MESSAGE_NUMBER_MASK;
         _packetPosition = static_cast<PacketPosition>(*messageNumberAndBitField >> PACKET_POSITION_OFFSET);
+        _stream = streamInMessageNumber(_messageNumber);
 
         MessagePartNumber* messagePartNumber = messageNumberAndBitField + 1;
         _messagePartNumber = *messagePartNumber;
@@ -0,0 +1,186 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QProcessEnvironment>
+
+#include "Constants.h"
+
+using namespace udt;
+
+namespace {
+
+struct SizeClass {
+    qint64 bufferSize;
+    size_t maxRetained; // buffers beyond this are deleted rather than kept
+};
+
+// most packets are either small control packets or full sized, only the full size class needs to hold a lot
+const SizeClass SIZE_CLASSES[] = {
+    { 128, 2048 },
+    { 512, 2048 },
+    { MAX_PACKET_SIZE, 8192 }
+};
+const int NUM_SIZE_CLASSES = sizeof(SIZE_CLASSES) / sizeof(SizeClass);
+
+struct FreeList {
+    std::mutex mutex;
+    std::vector<char*> buffers;
+};
+
+struct Pool {
+    Pool() {
+        for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+            // reserved up front so recycling a buffer never has to grow the list
+            freeLists[i].buffers.reserve(SIZE_CLASSES[i].maxRetained);
+        }
+
+        static const QString POOL_ENV = "HIFI_PACKET_BUFFER_POOL";
+        enabled = QProcessEnvironment::systemEnvironment().value(POOL_ENV, "1") != "0";
+    }
+
+    FreeList freeLists[NUM_SIZE_CLASSES];
+
+    std::atomic<bool> enabled { true };
+
+    std::atomic<uint64_t> pooledAllocations { 0 };
+    std::atomic<uint64_t> heapAllocations { 0 };
+    std::atomic<uint64_t> recycledBuffers { 0 };
+    std::atomic<uint64_t> freedBuffers { 0 };
+    std::atomic<int64_t> outstandingBuffers { 0 };
+};
+
+Pool& getPool() {
+    // never destroyed, packets can outlive static destruction and still need somewhere to return their buffer
+    static Pool* pool = new Pool;
+    return *pool;
+}
+
+int sizeClassFor(qint64 size) {
+    for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        if (size <= SIZE_CLASSES[i].bufferSize) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+}
+
+void PacketBufferDeleter::operator()(char* buffer) const {
+    if (sizeClass < 0) {
+        delete[] buffer;
+    } else {
+        PacketBufferPool::release(buffer, sizeClass);
+    }
+}
+
+PacketBuffer PacketBufferPool::allocate(qint64 size, bool zeroed) {
+    auto& pool = getPool();
+
+    int sizeClass = pool.enabled ? sizeClassFor(size) : -1;
+
+    if (sizeClass < 0) {
+        pool.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        return zeroed ? PacketBuffer(new char[size]()) : PacketBuffer(new char[size]);
+    }
+
+    char* buffer = nullptr;
+    {
+        auto& freeList = pool.freeLists[sizeClass];
+        std::lock_guard<std::mutex> lock(freeList.mutex);
+        if (!freeList.buffers.empty()) {
+            buffer = freeList.buffers.back();
+            freeList.buffers.pop_back();
+        }
+    }
+
+    if (buffer) {
+        pool.pooledAllocations.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        pool.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        buffer = new char[SIZE_CLASSES[sizeClass].bufferSize];
+    }
+
+    pool.outstandingBuffers.fetch_add(1, std::memory_order_relaxed);
+
+    if (zeroed) {
+        memset(buffer, 0, size);
+    }
+
+    return PacketBuffer(buffer, PacketBufferDeleter(sizeClass));
+}
+
+void PacketBufferPool::release(char* buffer, int sizeClass) {
+    auto& pool = getPool();
+    pool.outstandingBuffers.fetch_sub(1, std::memory_order_relaxed);
+
+    {
+        auto& freeList = pool.freeLists[sizeClass];
+        std::lock_guard<std::mutex> lock(freeList.mutex);
+        if (freeList.buffers.size() < SIZE_CLASSES[sizeClass].maxRetained) {
+            freeList.buffers.push_back(buffer);
+            buffer = nullptr;
+        }
+    }
+
+    if (buffer) {
+        pool.freedBuffers.fetch_add(1, std::memory_order_relaxed);
+        delete[] buffer;
+    } else {
+        pool.recycledBuffers.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool PacketBufferPool::isEnabled() {
+    return getPool().enabled;
+}
+
+void PacketBufferPool::setEnabled(bool enabled) {
+    // buffers already handed out still go back to their size class when they are released
+    getPool().enabled = enabled;
+}
+
+PacketBufferPool::Stats PacketBufferPool::getStats() {
+    auto& pool = getPool();
+
+    Stats stats;
+    stats.pooledAllocations = pool.pooledAllocations.load(std::memory_order_relaxed);
+    stats.heapAllocations = pool.heapAllocations.load(std::memory_order_relaxed);
+    stats.recycledBuffers = pool.recycledBuffers.load(std::memory_order_relaxed);
+    stats.freedBuffers = pool.freedBuffers.load(std::memory_order_relaxed);
+    stats.outstandingBuffers = pool.outstandingBuffers.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PacketBufferPool::trim() {
+    auto& pool = getPool();
+
+    for (auto& freeList : pool.freeLists) {
+        std::vector<char*> buffers;
+        buffers.reserve(freeList.buffers.capacity());
+
+        {
+            std::lock_guard<std::mutex> lock(freeList.mutex);
+            buffers.swap(freeList.buffers);
+        }
+
+        for (char* buffer : buffers) {
+            delete[] buffer;
+        }
+        pool.freedBuffers.fetch_add(buffers.size(), std::memory_order_relaxed);
+    }
+}
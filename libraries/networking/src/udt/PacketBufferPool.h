@@ -0,0 +1,73 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_udt_PacketBufferPool_h
+#define hifi_udt_PacketBufferPool_h
+
+#include <cstdint>
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+namespace udt {
+
+// Returns a packet buffer to the pool it came from, or deletes it if it didn't come from one.
+struct PacketBufferDeleter {
+    PacketBufferDeleter() = default;
+    explicit PacketBufferDeleter(int sizeClass) : sizeClass(sizeClass) {}
+
+    // lets a plain std::unique_ptr<char[]> be passed anywhere a PacketBuffer is expected
+    PacketBufferDeleter(const std::default_delete<char[]>&) {}
+
+    void operator()(char* buffer) const;
+
+    int sizeClass { -1 }; // -1 for a buffer allocated with new[] rather than taken from the pool
+};
+
+using PacketBuffer = std::unique_ptr<char[], PacketBufferDeleter>;
+
+// A thread-safe pool of packet buffers in a few fixed size classes, the largest being MAX_PACKET_SIZE.
+//
+// Buffers go back to their size class when the PacketBuffer holding them is destroyed, so once enough packets have
+// been in flight the send and receive paths stop touching the heap for packet data. Requests larger than the largest
+// size class, or made while the pool is disabled, fall through to new[].
+class PacketBufferPool {
+public:
+    struct Stats {
+        uint64_t pooledAllocations { 0 }; // buffers handed out from the pool
+        uint64_t heapAllocations { 0 }; // buffers that had to be allocated with new[]
+        uint64_t recycledBuffers { 0 }; // buffers returned to the pool
+        uint64_t freedBuffers { 0 }; // buffers deleted because their size class was full
+        int64_t outstandingBuffers { 0 }; // pool-sized buffers currently held by packets
+    };
+
+    // the returned buffer is uninitialized unless zeroed is true
+    static PacketBuffer allocate(qint64 size, bool zeroed = false);
+
+    // turned off with HIFI_PACKET_BUFFER_POOL=0, or at runtime to compare against new[]
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    static Stats getStats();
+
+    // deletes every buffer currently held by the pool
+    static void trim();
+
+private:
+    friend struct PacketBufferDeleter;
+
+    static void release(char* buffer, int sizeClass);
+};
+
+}
+
+#endif // hifi_udt_PacketBufferPool_h
@@ -33,12 +33,12 @@ PacketVersion versionForPacketType(PacketType packetType) {
             return static_cast<PacketVersion>(EntityVersion::SoftEntities);
 
         case PacketType::EntityQuery:
-            return static_cast<PacketVersion>(EntityQueryPacketVersion::RemovedJurisdictions);
+            return static_cast<PacketVersion>(EntityQueryPacketVersion::CompressionDictionary);
         case PacketType::AvatarIdentity:
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
         case PacketType::KillAvatar:
-            return static_cast<PacketVersion>(AvatarMixerPacketVersion::FBXReaderNodeReparenting);
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::SipHashVerification);
         case PacketType::MessagesData:
             return static_cast<PacketVersion>(MessageDataVersion::TextOrBinaryData);
         case PacketType::ICEServerHeartbeat:
@@ -57,7 +57,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
             return static_cast<PacketVersion>(DomainConnectionDeniedVersion::IncludesExtraInfo);
 
         case PacketType::DomainConnectRequest:
-            return static_cast<PacketVersion>(DomainConnectRequestVersion::AlwaysHasMachineFingerprint);
+            return static_cast<PacketVersion>(DomainConnectRequestVersion::MessageStreams);
 
         case PacketType::DomainServerAddedNode:
             return static_cast<PacketVersion>(DomainServerAddedNodeVersion::PermissionsGrid);
@@ -71,7 +71,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::MicrophoneAudioNoEcho:
         case PacketType::MicrophoneAudioWithEcho:
         case PacketType::AudioStreamStats:
-            return static_cast<PacketVersion>(AudioVersion::HighDynamicRangeVolume);
+            return static_cast<PacketVersion>(AudioVersion::SipHashVerification);
         case PacketType::ICEPing:
             return static_cast<PacketVersion>(IcePingVersion::SendICEPeerID);
         case PacketType::DomainSettings:
@@ -81,6 +81,65 @@ PacketVersion versionForPacketType(PacketType packetType) {
     }
 }
 
+PacketVerificationMethod verificationMethodForPacket(PacketType packetType, PacketVersion packetVersion) {
+    // the mixer packet types verify the most packets, they are the ones moved to SipHash so far
+    switch (packetType) {
+        case PacketType::AvatarIdentity:
+        case PacketType::AvatarData:
+        case PacketType::BulkAvatarData:
+        case PacketType::KillAvatar:
+            return packetVersion >= static_cast<PacketVersion>(AvatarMixerPacketVersion::SipHashVerification)
+                ? PacketVerificationMethod::SipHash : PacketVerificationMethod::MD5;
+
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+        case PacketType::InjectAudio:
+        case PacketType::MicrophoneAudioNoEcho:
+        case PacketType::MicrophoneAudioWithEcho:
+        case PacketType::AudioStreamStats:
+            return packetVersion >= static_cast<PacketVersion>(AudioVersion::SipHashVerification)
+                ? PacketVerificationMethod::SipHash : PacketVerificationMethod::MD5;
+
+        default:
+            return PacketVerificationMethod::MD5;
+    }
+}
+
+udt::Stream streamForPacketType(PacketType packetType) {
+    switch (packetType) {
+        // small messages that joining, seeing others arrive and leave, or a moderation action wait on
+        case PacketType::DomainList:
+        case PacketType::DomainConnectionDenied:
+        case PacketType::DomainServerAddedNode:
+        case PacketType::DomainServerRemovedNode:
+        case PacketType::DomainSettings:
+        case PacketType::AvatarIdentity:
+        case PacketType::KillAvatar:
+        case PacketType::ReplicatedAvatarIdentity:
+        case PacketType::ReplicatedKillAvatar:
+        case PacketType::NegotiateAudioFormat:
+        case PacketType::SelectedAudioFormat:
+        case PacketType::NodeIgnoreRequest:
+        case PacketType::RadiusIgnoreRequest:
+        case PacketType::NodeKickRequest:
+        case PacketType::NodeMuteRequest:
+        case PacketType::NoisyMute:
+        case PacketType::MuteEnvironment:
+        case PacketType::StopNode:
+            return udt::Stream::Urgent;
+
+        // payloads that can run to megabytes
+        case PacketType::AssetGetReply:
+        case PacketType::AssetUpload:
+        case PacketType::OctreeFileReplacement:
+        case PacketType::EntityServerScriptLog:
+            return udt::Stream::Bulk;
+
+        default:
+            return udt::Stream::Default;
+    }
+}
+
 uint qHash(const PacketType& key, uint seed) {
     // seems odd that Qt couldn't figure out this cast itself, but this fixes a compile error after switch
     // to strongly typed enum for PacketType
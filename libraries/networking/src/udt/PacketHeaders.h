@@ -22,6 +22,8 @@
 #include <QtCore/QSet>
 #include <QtCore/QUuid>
 
+#include "Streams.h"
+
 // The enums are inside this PacketTypeEnum for run-time conversion of enum value to string via
 // Q_ENUMS, without requiring a macro that is called for each enum value.
 class PacketTypeEnum {
@@ -56,7 +58,7 @@ public:
         ICEServerPeerInformation,
         ICEServerQuery,
         OctreeStats,
-        UNUSED_PACKET_TYPE_1,
+        OctreeCompressionDictionary,
         UNUSED_PACKET_TYPE_2,
         AssignmentClientStatus,
         NoisyMute,
@@ -186,6 +188,18 @@ const int NUM_BYTES_MD5_HASH = 16;
 typedef char PacketVersion;
 
 PacketVersion versionForPacketType(PacketType packetType);
+
+// How the verification hash in the header of a sourced packet is computed. Both ends agree on it through the packet
+// version, so a packet type moves to a cheaper MAC by bumping its version.
+enum class PacketVerificationMethod {
+    MD5, // MD5 of the payload followed by the connection secret
+    SipHash // SipHash-2-4 (128 bit output) of the payload, keyed with the connection secret
+};
+
+PacketVerificationMethod verificationMethodForPacket(PacketType packetType, PacketVersion packetVersion);
+// The stream a reliable packet or packet list of this type is sent on, unless the sender picks one itself.
+udt::Stream streamForPacketType(PacketType packetType);
+
 QByteArray protocolVersionsSignature(); /// returns a unqiue signature for all the current protocols
 QString protocolVersionsSignatureBase64();
 
@@ -218,7 +232,8 @@ enum class EntityQueryPacketVersion: PacketVersion {
     JSONFilter = 18,
     JSONFilterWithFamilyTree = 19,
     ConnectionIdentifier = 20,
-    RemovedJurisdictions = 21
+    RemovedJurisdictions = 21,
+    CompressionDictionary = 22
 };
 
 enum class AssetServerPacketVersion: PacketVersion {
@@ -249,7 +264,8 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     AvatarIdentityLookAtSnapping,
     UpdatedMannequinDefaultAvatar,
     AvatarJointDefaultPoseFlags,
-    FBXReaderNodeReparenting
+    FBXReaderNodeReparenting,
+    SipHashVerification
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
@@ -258,7 +274,9 @@ enum class DomainConnectRequestVersion : PacketVersion {
     HasProtocolVersions,
     HasMACAddress,
     HasMachineFingerprint,
-    AlwaysHasMachineFingerprint
+    AlwaysHasMachineFingerprint,
+    // the top two bits of udt message numbers carry the message stream
+    MessageStreams
 };
 
 enum class DomainConnectionDeniedVersion : PacketVersion {
@@ -287,6 +305,7 @@ enum class AudioVersion : PacketVersion {
     SpaceBubbleChanges,
     HasPersonalMute,
     HighDynamicRangeVolume,
+    SipHashVerification,
 };
 
 enum class MessageDataVersion : PacketVersion {
@@ -30,6 +30,9 @@ std::unique_ptr<PacketList> PacketList::create(PacketType packetType, QByteArray
 std::unique_ptr<PacketList> PacketList::fromReceivedPackets(std::list<std::unique_ptr<Packet>>&& packets) {
     auto packetList = std::unique_ptr<PacketList>(new PacketList(PacketType::Unknown, QByteArray(), true, true));
     packetList->_packets = std::move(packets);
+    if (!packetList->_packets.empty()) {
+        packetList->_stream = packetList->_packets.front()->getStream();
+    }
     packetList->open(ReadOnly);
     return packetList;
 }
@@ -38,6 +41,7 @@ PacketList::PacketList(PacketType packetType, QByteArray extendedHeader, bool is
     _packetType(packetType),
     _isOrdered(isOrdered),
     _isReliable(isReliable),
+    _stream(streamForPacketType(packetType)),
     _extendedHeader(extendedHeader)
 {
     Q_ASSERT_X(!(!_isReliable && _isOrdered), "PacketList", "Unreliable ordered PacketLists are not currently supported");
@@ -48,6 +52,7 @@ PacketList::PacketList(PacketList&& other) :
     _packets(std::move(other._packets)),
     _isOrdered(other._isOrdered),
     _isReliable(other._isReliable),
+    _stream(other._stream),
     _extendedHeader(std::move(other._extendedHeader))
 {
 }
@@ -38,6 +38,10 @@ public:
     PacketType getType() const { return _packetType; }
     bool isReliable() const { return _isReliable; }
     bool isOrdered() const { return _isOrdered; }
+
+    // the stream the list is sent on, see Streams.h
+    Stream getStream() const { return _stream; }
+    void setStream(Stream stream) { _stream = stream; }
     
     size_t getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0); }
     size_t getDataSize() const;
@@ -97,6 +101,7 @@ private:
     
     Packet::MessageNumber _messageNumber;
     bool _isReliable = false;
+    Stream _stream { Stream::Default };
     
     std::unique_ptr<Packet> _currentPacket;
     
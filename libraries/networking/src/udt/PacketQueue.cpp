@@ -11,37 +11,32 @@
 
 #include "PacketQueue.h"
 
+#include <algorithm>
+
 #include "PacketList.h"
 
 using namespace udt;
 
-PacketQueue::PacketQueue(MessageNumber messageNumber) : _currentMessageNumber(messageNumber) {
-    _channels.emplace_back(new std::list<PacketPointer>());
-}
+static_assert(NUM_STREAMS <= (1 << MESSAGE_STREAM_SIZE), "The message number does not have room for every stream");
 
-MessageNumber PacketQueue::getNextMessageNumber() {
-    static const MessageNumber MAX_MESSAGE_NUMBER = MessageNumber(1) << MESSAGE_NUMBER_SIZE;
-    _currentMessageNumber = (_currentMessageNumber + 1) % MAX_MESSAGE_NUMBER;
-    return _currentMessageNumber;
+PacketQueue::StreamQueue::StreamQueue() {
+    channels.emplace_back(new std::list<PacketPointer>());
 }
 
-bool PacketQueue::isEmpty() const {
-    LockGuard locker(_packetsLock);
+bool PacketQueue::StreamQueue::isEmpty() const {
     // Only the main channel and it is empty
-    return (_channels.size() == 1) && _channels.front()->empty();
+    return (channels.size() == 1) && channels.front()->empty();
 }
 
-PacketQueue::PacketPointer PacketQueue::takePacket() {
-    LockGuard locker(_packetsLock);
-    if (isEmpty()) {
-        return PacketPointer();
-    }
+PacketQueue::PacketPointer PacketQueue::StreamQueue::takePacket() {
+    Q_ASSERT(!isEmpty());
 
     // Find next non empty channel
-    if (_channels[nextIndex()]->empty()) {
-        nextIndex();
+    currentIndex = (currentIndex + 1) % channels.size();
+    if (channels[currentIndex]->empty()) {
+        currentIndex = (currentIndex + 1) % channels.size();
     }
-    auto& channel = _channels[_currentIndex];
+    auto& channel = channels[currentIndex];
     Q_ASSERT(!channel->empty());
 
     // Take front packet
@@ -49,31 +44,101 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     channel->pop_front();
 
     // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentIndex != 0) {
-        channel->swap(*_channels.back());
-        _channels.pop_back();
-        --_currentIndex;
+    if (channel->empty() && currentIndex != 0) {
+        channel->swap(*channels.back());
+        channels.pop_back();
+        --currentIndex;
     }
 
     return packet;
 }
 
-unsigned int PacketQueue::nextIndex() {
-    _currentIndex = (_currentIndex + 1) % _channels.size();
-    return _currentIndex;
+PacketQueue::PacketQueue(MessageNumber messageNumber) :
+    _currentMessageNumber(messageNumber & ~MESSAGE_STREAM_MASK)
+{
+
+}
+
+MessageNumber PacketQueue::getNextMessageNumber(Stream stream) {
+    static const MessageNumber MAX_MESSAGE_NUMBER = MessageNumber(1) << MESSAGE_STREAM_OFFSET;
+    _currentMessageNumber = (_currentMessageNumber + 1) % MAX_MESSAGE_NUMBER;
+    return _currentMessageNumber | (MessageNumber(stream) << MESSAGE_STREAM_OFFSET);
+}
+
+bool PacketQueue::isEmpty() const {
+    LockGuard locker(_packetsLock);
+    return std::all_of(_streams.begin(), _streams.end(), [](const StreamQueue& stream) { return stream.isEmpty(); });
+}
+
+PacketQueue::PacketPointer PacketQueue::takePacket() {
+    LockGuard locker(_packetsLock);
+    if (isEmpty()) {
+        return PacketPointer();
+    }
+
+    auto& stream = _streams[nextStream()];
+    auto packet = stream.takePacket();
+
+    if (_scheduling == StreamScheduling::WeightedFair) {
+        stream.deficit -= packet->getDataSize();
+    }
+
+    return packet;
+}
+
+int PacketQueue::nextStream() {
+    if (_scheduling == StreamScheduling::StrictPriority) {
+        auto it = std::find_if(_streams.begin(), _streams.end(), [](const StreamQueue& stream) { return !stream.isEmpty(); });
+        return (int)std::distance(_streams.begin(), it);
+    }
+
+    // deficit round robin: a stream keeps sending until it has used its share of the round, then the next stream
+    // with something queued gets its share added - a share is always at least a full packet so this terminates
+    while (true) {
+        auto& stream = _streams[_currentStream];
+        if (stream.isEmpty()) {
+            // idle streams don't bank credit for later
+            stream.deficit = 0;
+        } else if (stream.deficit > 0) {
+            return _currentStream;
+        }
+
+        _currentStream = (_currentStream + 1) % NUM_STREAMS;
+
+        auto& next = _streams[_currentStream];
+        if (!next.isEmpty()) {
+            next.deficit += _weights[_currentStream] * MAX_PACKET_SIZE;
+        }
+    }
 }
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _streams[(int)packet->getStream()].channels.front()->push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
+    auto stream = packetList->getStream();
+
+    LockGuard locker(_packetsLock);
+
     if (packetList->isOrdered()) {
-        packetList->preparePackets(getNextMessageNumber());
+        packetList->preparePackets(getNextMessageNumber(stream));
+    } else {
+        for (auto& packet : packetList->_packets) {
+            packet->setStream(stream);
+        }
     }
 
+    auto& channels = _streams[(int)stream].channels;
+    channels.emplace_back(new std::list<PacketPointer>());
+    channels.back()->swap(packetList->_packets);
+}
+
+void PacketQueue::setStreamScheduling(StreamScheduling scheduling, const StreamWeights& weights) {
     LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    _scheduling = scheduling;
+
+    // a stream with no weight would never send
+    std::transform(weights.begin(), weights.end(), _weights.begin(), [](int weight) { return std::max(weight, 1); });
 }
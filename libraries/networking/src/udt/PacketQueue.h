@@ -12,12 +12,14 @@
 #ifndef hifi_PacketQueue_h
 #define hifi_PacketQueue_h
 
+#include <array>
 #include <list>
 #include <vector>
 #include <memory>
 #include <mutex>
 
 #include "Packet.h"
+#include "Streams.h"
 
 namespace udt {
     
@@ -43,20 +45,38 @@ public:
     
     Mutex& getLock() { return _packetsLock; }
 
+    // the message numbers of all the streams come from this one counter, the stream is added in the top bits
     MessageNumber getCurrentMessageNumber() const { return _currentMessageNumber; }
+
+    void setStreamScheduling(StreamScheduling scheduling, const StreamWeights& weights);
     
 private:
-    MessageNumber getNextMessageNumber();
-    unsigned int nextIndex();
+    // the packets queued on one stream, the channels take turns
+    struct StreamQueue {
+        StreamQueue();
+
+        bool isEmpty() const;
+        PacketPointer takePacket();
+
+        Channels channels; // One channel per packet list + Main channel
+        unsigned int currentIndex { 0 };
+        int deficit { 0 }; // bytes the stream may still send in this round of WeightedFair scheduling
+    };
+
+    MessageNumber getNextMessageNumber(Stream stream);
+    int nextStream(); // must be called with the lock held and something queued
     
     MessageNumber _currentMessageNumber { 0 };
     
     mutable Mutex _packetsLock; // Protects the packets to be sent.
-    Channels _channels; // One channel per packet list + Main channel
-    unsigned int _currentIndex { 0 };
+    std::array<StreamQueue, NUM_STREAMS> _streams;
+    int _currentStream { 0 };
+
+    StreamScheduling _scheduling { StreamScheduling::WeightedFair };
+    StreamWeights _weights { DEFAULT_STREAM_WEIGHTS };
 };
 
 }
 
 
-#endif // hifi_PacketQueue_h
\ No newline at end of file
+#endif // hifi_PacketQueue_h
@@ -0,0 +1,82 @@
+//
+//  SPSCQueue.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_udt_SPSCQueue_h
+#define hifi_udt_SPSCQueue_h
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace udt {
+
+// A bounded lock-free ring with a single producer and a single consumer.
+//
+// The slots are allocated once up front and reused, so pushing and popping never allocate. push must only ever be
+// called from one thread, and pop from one (other) thread. A full queue refuses the push rather than growing.
+template <typename T>
+class SPSCQueue {
+public:
+    // the capacity is rounded up to a power of two
+    explicit SPSCQueue(size_t capacity) {
+        size_t roundedCapacity = 1;
+        while (roundedCapacity < capacity) {
+            roundedCapacity <<= 1;
+        }
+        _slots.resize(roundedCapacity);
+        _mask = roundedCapacity - 1;
+    }
+
+    size_t getCapacity() const { return _slots.size(); }
+
+    // how many more values can be pushed right now - exact for the producer, a lower bound for anyone else
+    size_t getFreeSpace() const {
+        return _slots.size() - (_tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_acquire));
+    }
+
+    bool push(T&& value) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == _slots.size()) {
+            return false;
+        }
+
+        _slots[tail & _mask] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = std::move(_slots[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    std::vector<T> _slots;
+    size_t _mask { 0 };
+
+    // kept on separate cache lines so the producer and consumer don't contend for one
+    alignas(64) std::atomic<size_t> _head { 0 }; // the next slot to pop, only written by the consumer
+    alignas(64) std::atomic<size_t> _tail { 0 }; // the next slot to push, only written by the producer
+};
+
+}
+
+#endif // hifi_udt_SPSCQueue_h
@@ -13,12 +13,10 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 
 #include <QtCore/QObject>
 #include <QtCore/QReadWriteLock>
@@ -29,8 +27,10 @@
 
 #include "Constants.h"
 #include "PacketQueue.h"
+#include "SendScheduler.h"
 #include "SequenceNumber.h"
 #include "LossList.h"
+#include "SentPacketHistory.h"
 
 namespace udt {
     
@@ -40,7 +40,7 @@ class Packet;
 class PacketList;
 class Socket;
     
-class SendQueue : public QObject {
+class SendQueue : public QObject, public SendScheduler::Client {
     Q_OBJECT
     
 public:
@@ -71,6 +71,10 @@ public:
     void setSyncInterval(int syncInterval) { _syncInterval = syncInterval; }
 
     void setProbePacketEnabled(bool enabled);
+
+    void setStreamScheduling(StreamScheduling scheduling, const StreamWeights& weights) {
+        _packets.setStreamScheduling(scheduling, weights);
+    }
     
 public slots:
     void stop();
@@ -82,23 +86,33 @@ public slots:
     void handshakeACK();
 
 signals:
-    void packetSent(int wireSize, int payloadSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint);
-    void packetRetransmitted(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint);
+    void packetSent(int wireSize, int payloadSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint,
+                    quint8 stream);
+    void packetRetransmitted(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint,
+                             quint8 stream);
     
     void queueInactive();
 
     void shortCircuitLoss(quint32 sequenceNumber);
     void timeout();
     
-private slots:
-    void run();
-    
 private:
+    // what the queue is waiting for when it has nothing to send
+    enum class IdleWait {
+        None,
+        Handshake, // the handshake has not been ACKed, re-send it if the ACK doesn't arrive before the deadline
+        Inactive, // everything sent has been ACKed, deactivate if nothing new is queued before the deadline
+        ACKTimeout // packets are unACKed, treat them as lost if no ACK or NAK arrives before the deadline
+    };
+
     SendQueue(Socket* socket, HifiSockAddr dest, SequenceNumber currentSequenceNumber,
               MessageNumber currentMessageNumber, bool hasReceivedHandshakeACK);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
+    // called by the SendScheduler when this queue's deadline is due, sends what it can and returns the next deadline
+    SendScheduler::NextService service(bool wasWoken) override;
+
     void sendHandshake();
     
     int sendPacket(const Packet& packet);
@@ -107,7 +121,7 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    bool hasNothingToSend() const; // must be called with both the packets and NAKs locks held
     void deactivate(); // makes the queue inactive and cleans it up
 
     bool isFlowWindowFull() const;
@@ -137,15 +151,14 @@ private:
     LossList _naks; // Sequence numbers of packets to resend
     
     mutable QReadWriteLock _sentLock; // Protects the sent packet list
-    using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
-    std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
+    SentPacketHistory _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
 
+    // only touched from service, which the SendScheduler never runs concurrently for one queue
+    p_high_resolution_clock::time_point _nextHandshakeTimestamp; // when the next handshake should be re-sent
+    p_high_resolution_clock::time_point _nextPacketTimestamp; // when the next packet should be sent, for pacing
+    IdleWait _idleWait { IdleWait::None };
 
     std::atomic<bool> _shouldSendProbes { true };
 };
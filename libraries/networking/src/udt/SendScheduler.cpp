@@ -0,0 +1,184 @@
+//
+//  SendScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendScheduler.h"
+
+#include <algorithm>
+
+#include <QtCore/QThread>
+
+#include "../NetworkLogging.h"
+
+using namespace udt;
+
+const int SendScheduler::DEFAULT_THREAD_COUNT = 2;
+const int SendScheduler::MAX_THREAD_COUNT = 32;
+
+std::atomic<int> SendScheduler::_threadCount { SendScheduler::DEFAULT_THREAD_COUNT };
+
+void SendScheduler::setThreadCount(int threadCount) {
+    _threadCount = std::max(1, std::min(threadCount, MAX_THREAD_COUNT));
+}
+
+int SendScheduler::getThreadCount() {
+    return _threadCount;
+}
+
+SendScheduler& SendScheduler::getInstance() {
+    // never destroyed, so that connections torn down during static destruction can still unschedule their queues
+    static SendScheduler* instance = new SendScheduler(_threadCount);
+    return *instance;
+}
+
+SendScheduler::SendScheduler(int threadCount) {
+    qCDebug(networking) << "Starting udt send scheduler with" << threadCount << "threads";
+
+    for (int i = 0; i < threadCount; ++i) {
+        _workers.emplace_back([this, i] {
+            QThread::currentThread()->setObjectName("Networking: SendScheduler " + QString::number(i)); // Name thread for easier debug
+            workerLoop();
+        });
+    }
+}
+
+SendScheduler::~SendScheduler() {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+        _stopping = true;
+    }
+    _workCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void SendScheduler::schedule(Client* queue) {
+    std::lock_guard<std::mutex> locker(_mutex);
+
+    auto& entry = _entries[queue];
+    pushDeadline(queue, entry, p_high_resolution_clock::now(), false);
+}
+
+void SendScheduler::wake(Client* queue) {
+    std::lock_guard<std::mutex> locker(_mutex);
+
+    auto it = _entries.find(queue);
+    if (it == _entries.end()) {
+        return;
+    }
+
+    auto& entry = it->second;
+    if (entry.servicing) {
+        // the queue may be about to go idle without having seen whatever woke it, make sure it comes straight back
+        entry.wokenWhileServicing = true;
+    } else if (entry.wakeable) {
+        entry.woken = true;
+        pushDeadline(queue, entry, p_high_resolution_clock::now(), false);
+    }
+}
+
+void SendScheduler::unschedule(Client* queue) {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    auto it = _entries.find(queue);
+    if (it == _entries.end()) {
+        return;
+    }
+
+    // the worker servicing the queue (if any) removes the entry once it is done with it
+    it->second.removed = true;
+    _servicedCondition.wait(locker, [&] {
+        auto current = _entries.find(queue);
+        return current == _entries.end() || !current->second.servicing;
+    });
+
+    // any deadline left in the heap for this queue is now stale and will be skipped
+    _entries.erase(queue);
+}
+
+int SendScheduler::getScheduledCount() {
+    std::lock_guard<std::mutex> locker(_mutex);
+    return (int)std::count_if(_entries.begin(), _entries.end(), [](const std::pair<Client* const, Entry>& entry) {
+        return !entry.second.removed;
+    });
+}
+
+void SendScheduler::pushDeadline(Client* queue, Entry& entry, TimePoint deadline, bool wakeable) {
+    entry.generation = _nextGeneration++;
+    entry.wakeable = wakeable;
+
+    bool isNewEarliest = _deadlines.empty() || deadline < _deadlines.top().time;
+    _deadlines.push({ deadline, entry.generation, queue });
+
+    if (isNewEarliest) {
+        // a worker may be sleeping until a later deadline
+        _workCondition.notify_one();
+    }
+}
+
+void SendScheduler::workerLoop() {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    while (!_stopping) {
+        if (_deadlines.empty()) {
+            _workCondition.wait(locker);
+            continue;
+        }
+
+        Deadline next = _deadlines.top();
+
+        auto it = _entries.find(next.queue);
+        if (it == _entries.end() || it->second.generation != next.generation || it->second.removed) {
+            // this queue was unscheduled or has been re-scheduled since this deadline was pushed
+            _deadlines.pop();
+            continue;
+        }
+
+        if (next.time > p_high_resolution_clock::now()) {
+            _workCondition.wait_until(locker, next.time);
+            continue;
+        }
+
+        _deadlines.pop();
+
+        auto& entry = it->second;
+        bool wasWoken = entry.woken;
+        entry.woken = false;
+        entry.wakeable = false;
+        entry.servicing = true;
+        entry.wokenWhileServicing = false;
+
+        // if another deadline is already due, let another worker pick it up while we service this queue
+        if (!_deadlines.empty()) {
+            _workCondition.notify_one();
+        }
+
+        locker.unlock();
+        NextService nextService = next.queue->service(wasWoken);
+        locker.lock();
+
+        // references into an unordered_map survive a rehash, and unschedule waits for us before erasing
+        entry.servicing = false;
+
+        if (entry.removed || nextService.stopped) {
+            _entries.erase(next.queue);
+            _servicedCondition.notify_all();
+            continue;
+        }
+
+        if (nextService.wakeable && entry.wokenWhileServicing) {
+            entry.woken = true;
+            pushDeadline(next.queue, entry, p_high_resolution_clock::now(), false);
+        } else {
+            pushDeadline(next.queue, entry, nextService.deadline, nextService.wakeable);
+        }
+    }
+}
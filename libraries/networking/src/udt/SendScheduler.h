@@ -0,0 +1,126 @@
+//
+//  SendScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendScheduler_h
+#define hifi_SendScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+// Services every SendQueue in the process from a small, fixed pool of threads.
+//
+// Each scheduled queue has a single deadline - the time its next packet may go out, or the end of the interval it is
+// idling for - held in a shared min-heap. A worker pops the earliest deadline that is due, lets the queue send what it
+// can (SendQueue::service) and re-inserts the queue with whatever deadline it asks for next. Queues waiting for work
+// (handshake ACK, new packets, ACKs or NAKs) are woken early by wake(), queues that are pacing are not.
+class SendScheduler {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    // what a SendQueue asks of the scheduler after it has been serviced
+    struct NextService {
+        TimePoint deadline;
+        bool wakeable { false }; // true if the queue is waiting for work and should be serviced early if woken
+        bool stopped { false }; // true if the queue has stopped and should no longer be serviced
+    };
+
+    // what the scheduler services - a SendQueue, or a stand-in for one in tests
+    class Client {
+    public:
+        virtual ~Client() {}
+
+    protected:
+        friend class SendScheduler;
+
+        // sends what it can and returns when it next wants to be serviced, never called concurrently for one client
+        virtual NextService service(bool wasWoken) = 0;
+    };
+
+    static const int DEFAULT_THREAD_COUNT;
+    static const int MAX_THREAD_COUNT;
+
+    // must be called before the first SendQueue is created, later calls have no effect on the running pool
+    static void setThreadCount(int threadCount);
+    static int getThreadCount();
+
+    static SendScheduler& getInstance();
+
+    // the shared instance is never destroyed, others stop and join their threads when they are
+    SendScheduler(int threadCount);
+    ~SendScheduler();
+
+    // starts servicing the queue as soon as a worker is free
+    void schedule(Client* queue);
+
+    // services the queue now if it is waiting for work, otherwise does nothing
+    void wake(Client* queue);
+
+    // stops servicing the queue, blocking until any in progress service of it has returned
+    void unschedule(Client* queue);
+
+    // the number of queues that are scheduled and have not stopped or been unscheduled
+    int getScheduledCount();
+
+private:
+    struct Entry {
+        uint64_t generation { 0 }; // matches the heap item that is currently valid for this queue
+        bool wakeable { false };
+        bool woken { false };
+        bool servicing { false };
+        bool wokenWhileServicing { false };
+        bool removed { false };
+    };
+
+    struct Deadline {
+        TimePoint time;
+        uint64_t generation;
+        Client* queue;
+
+        bool operator>(const Deadline& other) const { return time > other.time; }
+    };
+
+    SendScheduler(const SendScheduler&) = delete;
+    SendScheduler& operator=(const SendScheduler&) = delete;
+
+    void workerLoop();
+
+    // must be called with _mutex held
+    void pushDeadline(Client* queue, Entry& entry, TimePoint deadline, bool wakeable);
+
+    static std::atomic<int> _threadCount;
+
+    std::mutex _mutex;
+    std::condition_variable _workCondition; // a new earliest deadline was pushed
+    std::condition_variable _servicedCondition; // a worker finished servicing a queue
+
+    std::unordered_map<Client*, Entry> _entries;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> _deadlines;
+
+    // generations are never re-used, so a stale heap item can't match a new queue allocated at the same address
+    uint64_t _nextGeneration { 1 };
+
+    bool _stopping { false };
+
+    std::vector<std::thread> _workers;
+};
+
+}
+
+#endif // hifi_SendScheduler_h
@@ -0,0 +1,106 @@
+//
+//  SentPacketHistory.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketHistory.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+static const int MIN_RING_SIZE = 64;
+
+// far more packets than can be in flight, a larger jump means the sequence numbers were reset
+static const int MAX_RING_SPAN = 1 << 20;
+
+void SentPacketHistory::add(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet) {
+    if (_count == 0) {
+        _firstSequenceNumber = sequenceNumber;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, sequenceNumber);
+
+    if (offset < 0 || offset >= MAX_RING_SPAN) {
+        // the sequence numbers were reset, nothing we hold can be matched to a NAK any more
+        Q_ASSERT_X(false, "SentPacketHistory::add", "Packet added out of sequence number order");
+        clear();
+        _firstSequenceNumber = sequenceNumber;
+        offset = 0;
+    }
+
+    if (offset >= (int)_entries.size()) {
+        grow(offset + 1);
+    }
+
+    auto& entry = entryAt(offset);
+    Q_ASSERT_X(!entry.packet, "SentPacketHistory::add", "Overriden packet in sent list");
+
+    entry.resendCount = 0;
+    entry.packet = std::move(packet);
+
+    _count = std::max(_count, offset + 1);
+}
+
+SentPacketHistory::Entry* SentPacketHistory::find(SequenceNumber sequenceNumber) {
+    if (_count == 0) {
+        return nullptr;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, sequenceNumber);
+    if (offset < 0 || offset >= _count) {
+        return nullptr;
+    }
+
+    auto& entry = entryAt(offset);
+    return entry.packet ? &entry : nullptr;
+}
+
+void SentPacketHistory::removeUpTo(SequenceNumber sequenceNumber) {
+    if (_count == 0) {
+        return;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, sequenceNumber);
+    if (offset < 0) {
+        return;
+    }
+
+    int numRemoved = std::min(offset + 1, _count);
+    for (int i = 0; i < numRemoved; ++i) {
+        entryAt(i).packet.reset();
+    }
+
+    _head = (_head + numRemoved) & ((int)_entries.size() - 1);
+    _count -= numRemoved;
+    _firstSequenceNumber = _firstSequenceNumber + numRemoved;
+}
+
+void SentPacketHistory::clear() {
+    for (int i = 0; i < _count; ++i) {
+        entryAt(i).packet.reset();
+    }
+
+    _head = 0;
+    _count = 0;
+}
+
+void SentPacketHistory::grow(int minimumCapacity) {
+    int capacity = std::max(MIN_RING_SIZE, (int)_entries.size());
+    while (capacity < minimumCapacity) {
+        capacity *= 2;
+    }
+
+    std::vector<Entry> entries(capacity);
+    for (int i = 0; i < _count; ++i) {
+        entries[i] = std::move(entryAt(i));
+    }
+
+    _entries.swap(entries);
+    _head = 0;
+}
@@ -0,0 +1,63 @@
+//
+//  SentPacketHistory.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SentPacketHistory_h
+#define hifi_SentPacketHistory_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Packet.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+// The reliable packets a SendQueue has sent and not yet had ACKed, for re-sending on a NAK or timeout.
+//
+// Packets are held in a ring indexed by their sequence number's offset from the oldest un-ACKed packet, so finding
+// a packet to re-send and dropping ACKed packets are array accesses rather than hash or tree lookups. The ring only
+// grows, to fit the largest number of packets that have been in flight at once.
+class SentPacketHistory {
+public:
+    struct Entry {
+        uint8_t resendCount { 0 };
+        std::unique_ptr<Packet> packet;
+    };
+
+    // packets must be added in sequence number order
+    void add(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet);
+
+    // returns nullptr if the packet has been ACKed or was never added
+    Entry* find(SequenceNumber sequenceNumber);
+
+    // drops every packet up to and including the sequence number
+    void removeUpTo(SequenceNumber sequenceNumber);
+
+    void clear();
+
+    bool isEmpty() const { return _count == 0; }
+
+private:
+    Entry& entryAt(int offset) { return _entries[(_head + offset) & (_entries.size() - 1)]; }
+
+    void grow(int minimumCapacity);
+
+    std::vector<Entry> _entries; // the ring, its size is always zero or a power of two
+    int _head { 0 }; // index in _entries of _firstSequenceNumber
+    int _count { 0 }; // number of slots from _firstSequenceNumber to the last packet added
+    SequenceNumber _firstSequenceNumber;
+};
+
+}
+
+#endif // hifi_SentPacketHistory_h
@@ -15,6 +15,11 @@
 #include <sys/socket.h>
 #endif
 
+#ifdef UDT_BATCHED_DATAGRAM_IO
+#include <poll.h>
+#endif
+
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 
 #include <shared/QtHelpers.h>
@@ -37,6 +42,49 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     _readyReadBackupTimer(new QTimer(this)),
     _shouldChangeSocketOptions(shouldChangeSocketOptions)
 {
+    static const QString BATCHED_IO_ENV = "HIFI_UDT_BATCHED_IO";
+    static const bool batchedIOWanted = QProcessEnvironment::systemEnvironment().value(BATCHED_IO_ENV, "1") != "0";
+    setBatchedDatagramIOEnabled(batchedIOWanted);
+
+    static const QString RECEIVE_THREAD_ENV = "HIFI_UDT_RECEIVE_THREAD";
+    static const bool receiveThreadWanted = QProcessEnvironment::systemEnvironment().value(RECEIVE_THREAD_ENV, "0") == "1";
+    setDedicatedReceiveThreadEnabled(receiveThreadWanted);
+
+    static const QString NETWORK_EMULATION_ENV = "HIFI_UDT_NETWORK_EMULATION";
+    auto networkEmulation = QProcessEnvironment::systemEnvironment().value(NETWORK_EMULATION_ENV);
+    if (!networkEmulation.isEmpty()) {
+        NetworkEmulator::Settings settings;
+        if (NetworkEmulator::Settings::fromString(networkEmulation, settings)) {
+            startNetworkEmulation(settings);
+        } else {
+            qCWarning(networking) << "Ignoring invalid" << NETWORK_EMULATION_ENV << networkEmulation;
+        }
+    }
+
+    static const QString STREAM_SCHEDULING_ENV = "HIFI_UDT_STREAM_SCHEDULING";
+    auto streamScheduling = QProcessEnvironment::systemEnvironment().value(STREAM_SCHEDULING_ENV);
+    if (!streamScheduling.isEmpty()) {
+        auto parts = streamScheduling.split(':');
+        auto weights = DEFAULT_STREAM_WEIGHTS;
+        bool isValid = parts[0] == "strict" || parts[0] == "fair";
+
+        if (isValid && parts.size() > 1) {
+            auto weightStrings = parts[1].split(',');
+            isValid = weightStrings.size() == NUM_STREAMS;
+            for (int i = 0; isValid && i < NUM_STREAMS; ++i) {
+                weights[i] = weightStrings[i].toInt(&isValid);
+                isValid = isValid && weights[i] > 0;
+            }
+        }
+
+        if (isValid) {
+            setStreamScheduling(parts[0] == "strict" ? StreamScheduling::StrictPriority : StreamScheduling::WeightedFair,
+                                weights);
+        } else {
+            qCWarning(networking) << "Ignoring invalid" << STREAM_SCHEDULING_ENV << streamScheduling;
+        }
+    }
+
     connect(&_udpSocket, &QUdpSocket::readyRead, this, &Socket::readPendingDatagrams);
 
     // make sure our synchronization method is called every SYN interval
@@ -56,7 +104,21 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     _readyReadBackupTimer->start(READY_READ_BACKUP_CHECK_MSECS);
 }
 
+Socket::~Socket() {
+    // the emulator writes to our socket from its thread
+    stopNetworkEmulation();
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    // the receive thread uses our members, it must be gone before they are
+    stopReceiveThread();
+#endif
+}
+
 void Socket::bind(const QHostAddress& address, quint16 port) {
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    stopReceiveThread();
+#endif
+
     _udpSocket.bind(address, port);
 
     if (_shouldChangeSocketOptions) {
@@ -72,6 +134,20 @@ void Socket::bind(const QHostAddress& address, quint16 port) {
         setsockopt(sd, IPPROTO_IP, IP_DONTFRAGMENT, &val, sizeof(val));
 #endif
     }
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    // this is a new socket, so the kernel's count of dropped datagrams starts over
+    ReceiveBatch::enableKernelDropReporting(_udpSocket.socketDescriptor());
+    _kernelReceiveDrops = 0;
+    _lastSampledKernelReceiveDrops = 0;
+    if (_receiveBatch) {
+        _receiveBatch->resetKernelDropCount();
+    }
+
+    if (_dedicatedReceiveThreadEnabled) {
+        startReceiveThread();
+    }
+#endif
 }
 
 void Socket::rebind() {
@@ -79,10 +155,63 @@ void Socket::rebind() {
 }
 
 void Socket::rebind(quint16 localPort) {
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    // the receive thread must not be reading from the socket we're about to close
+    stopReceiveThread();
+#endif
+
     _udpSocket.close();
     bind(QHostAddress::AnyIPv4, localPort);
 }
 
+bool Socket::isBatchedDatagramIOAvailable() {
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Socket::setBatchedDatagramIOEnabled(bool enabled) {
+    _batchedDatagramIOEnabled = enabled && isBatchedDatagramIOAvailable();
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    if (_batchedDatagramIOEnabled && !_receiveBatch) {
+        _receiveBatch.reset(new ReceiveBatch());
+    }
+#endif
+}
+
+bool Socket::isDedicatedReceiveThreadAvailable() {
+    // the receive thread reads with recvmmsg, so it is available wherever batched IO is
+    return isBatchedDatagramIOAvailable();
+}
+
+void Socket::setDedicatedReceiveThreadEnabled(bool enabled) {
+    enabled = enabled && isDedicatedReceiveThreadAvailable();
+    if (enabled == _dedicatedReceiveThreadEnabled) {
+        return;
+    }
+
+    _dedicatedReceiveThreadEnabled = enabled;
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    if (!enabled) {
+        stopReceiveThread();
+
+        // pick up anything that arrived while we switched over
+        readPendingDatagrams();
+    } else if (_udpSocket.state() == QAbstractSocket::BoundState) {
+        startReceiveThread();
+    }
+#endif
+}
+
+void Socket::addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler) {
+    Lock lock(_unfilteredHandlersMutex);
+    _unfilteredHandlers[senderSockAddr] = handler;
+}
+
 void Socket::setSystemBufferSizes() {
     for (int i = 0; i < 2; i++) {
         QAbstractSocket::SocketOption bufferOpt;
@@ -186,9 +315,52 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
     }
 
     // Unerliable and Unordered
-    qint64 totalBytesSent = 0;
+    std::vector<std::unique_ptr<Packet>> packets;
+    packets.reserve(packetList->getNumPackets());
     while (!packetList->_packets.empty()) {
-        totalBytesSent += writePacket(packetList->takeFront<Packet>(), sockAddr);
+        packets.push_back(packetList->takeFront<Packet>());
+    }
+
+    return writePackets(std::move(packets), sockAddr);
+}
+
+qint64 Socket::writePackets(std::vector<std::unique_ptr<Packet>> packets, const HifiSockAddr& sockAddr) {
+    {
+        // write the correct sequence numbers to the packets up front, under a single lock
+        Lock lock(_unreliableSequenceNumbersMutex);
+        auto& sequenceNumber = _unreliableSequenceNumbers[sockAddr];
+        for (auto& packet : packets) {
+            Q_ASSERT_X(!packet->isReliable(), "Socket::writePackets", "Cannot send a reliable packet unreliably");
+            packet->writeSequenceNumber(++sequenceNumber);
+        }
+    }
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    if (_batchedDatagramIOEnabled && packets.size() > 1 && !isNetworkEmulationEnabled()) {
+        SendBatch batch;
+        for (auto& packet : packets) {
+            batch.append(packet->getData(), packet->getDataSize());
+        }
+
+        qint64 bytesWritten = batch.send(_udpSocket.socketDescriptor(), sockAddr);
+
+        if (bytesWritten < 0) {
+            // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
+            static const QString WRITE_ERROR_REGEX = "Socket::writePackets failed to send a batch of";
+            static QString repeatedMessage
+                = LogHandler::getInstance().addRepeatedMessageRegex(WRITE_ERROR_REGEX);
+
+            qCDebug(networking) << "Socket::writePackets failed to send a batch of" << packets.size() << "packets to"
+                << sockAddr;
+        }
+
+        return bytesWritten;
+    }
+#endif
+
+    qint64 totalBytesSent = 0;
+    for (auto& packet : packets) {
+        totalBytesSent += writeDatagram(packet->getData(), packet->getDataSize(), sockAddr);
     }
 
     return totalBytesSent;
@@ -224,7 +396,17 @@ qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr&
 }
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    auto networkEmulator = std::atomic_load(&_networkEmulator);
+    if (networkEmulator) {
+        // the emulator copies the data and writes it to the socket when it is due, if it survives
+        networkEmulator->submit(datagram.constData(), datagram.size(), sockAddr);
+        return datagram.size();
+    }
 
+    return writeDatagramToSocket(datagram, sockAddr);
+}
+
+qint64 Socket::writeDatagramToSocket(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
 
     if (bytesWritten < 0) {
@@ -253,9 +435,10 @@ Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
 #endif
             return nullptr;
         } else {
-            auto congestionControl = _ccFactory->create();
+            auto congestionControl = _ccFactory->createForDestination(sockAddr);
             congestionControl->setMaxBandwidth(_maxBandwidth);
             auto connection = std::unique_ptr<Connection>(new Connection(this, sockAddr, std::move(congestionControl)));
+            connection->setStreamScheduling(_streamScheduling, _streamWeights);
 
             // allow higher-level classes to find out when connections have completed a handshake
             QObject::connect(connection.get(), &Connection::receiverHandshakeRequestComplete,
@@ -308,6 +491,11 @@ void Socket::messageFailed(Connection* connection, Packet::MessageNumber message
 }
 
 void Socket::checkForReadyReadBackup() {
+    if (_dedicatedReceiveThreadEnabled) {
+        // the receive thread is draining the socket, anything pending is about to be read by it
+        return;
+    }
+
     if (_udpSocket.hasPendingDatagrams()) {
         qCDebug(networking) << "Socket::checkForReadyReadBackup() detected blocked readyRead signal. Flushing pending datagrams.";
 
@@ -326,6 +514,18 @@ void Socket::checkForReadyReadBackup() {
 }
 
 void Socket::readPendingDatagrams() {
+    if (_dedicatedReceiveThreadEnabled) {
+        // the receive thread reads the socket and hands us what it read through processReceivedDatagrams
+        return;
+    }
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    if (_batchedDatagramIOEnabled) {
+        readPendingDatagramBatches();
+        return;
+    }
+#endif
+
     int packetSizeWithHeader = -1;
 
     while ((packetSizeWithHeader = _udpSocket.pendingDatagramSize()) != -1) {
@@ -340,7 +540,7 @@ void Socket::readPendingDatagrams() {
         HifiSockAddr senderSockAddr;
 
         // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        auto buffer = PacketBufferPool::allocate(packetSizeWithHeader);
 
         // pull the datagram
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
@@ -356,70 +556,275 @@ void Socket::readPendingDatagrams() {
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime);
+    }
+}
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+
+void Socket::readPendingDatagramBatches() {
+    int socketDescriptor = _udpSocket.socketDescriptor();
+
+    int numReceived = 0;
+    do {
+        numReceived = _receiveBatch->receive(socketDescriptor);
+
+        if (numReceived <= 0) {
+            break;
+        }
+
+        // we're reading packets so re-start the readyRead backup timer
+        _readyReadBackupTimer->start();
+
+        // every packet in the batch came off the socket in the same system call, so they share a receive time
+        auto receiveTime = p_high_resolution_clock::now();
+
+        for (int i = 0; i < numReceived; ++i) {
+            HifiSockAddr senderSockAddr = _receiveBatch->getSender(i);
+            int size = _receiveBatch->getSize(i);
+
+            // save information for this packet, in case it is the one that sticks readyRead
+            _lastPacketSizeRead = size;
+            _lastPacketSockAddr = senderSockAddr;
+
+            if (size <= 0 || _receiveBatch->wasTruncated(i)) {
+                continue;
+            }
+
+            processDatagram(_receiveBatch->takeBuffer(i), size, senderSockAddr, receiveTime);
+        }
+    } while (numReceived == ReceiveBatch::BATCH_SIZE);
+
+    _kernelReceiveDrops = _receiveBatch->getKernelDropCount();
+
+    // QUdpSocket stops emitting readyRead until a datagram has been read through it, so finish with one read through it
+    // anything that arrived since our last batch is processed as usual, and nothing waiting isn't an error we care about
+    auto buffer = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+    HifiSockAddr senderSockAddr;
+    qint64 sizeRead = -1;
+    {
+        QSignalBlocker blocker(&_udpSocket);
+        sizeRead = _udpSocket.readDatagram(buffer.get(), MAX_PACKET_SIZE,
+                                           senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+    }
+
+    if (sizeRead > 0) {
+        _readyReadBackupTimer->start();
+        processDatagram(std::move(buffer), sizeRead, senderSockAddr, p_high_resolution_clock::now());
+    }
+}
+
+#endif
+
+void Socket::processDatagram(PacketBuffer buffer, int size, const HifiSockAddr& senderSockAddr,
+                             p_high_resolution_clock::time_point receiveTime) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        }
+
+        return;
+    }
+
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        controlPacket->setReceiveTime(receiveTime);
+
+        processControlPacket(std::move(controlPacket));
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            processVerifiedPacket(std::move(packet));
+        }
+    }
+}
+
+void Socket::processControlPacket(std::unique_ptr<ControlPacket> controlPacket) {
+    // move this control packet to the matching connection, if there is one
+    auto connection = findOrCreateConnection(controlPacket->getSenderSockAddr());
+
+    if (connection) {
+        connection->processControl(move(controlPacket));
+    }
+}
+
+void Socket::processVerifiedPacket(std::unique_ptr<Packet> packet) {
+    if (packet->isReliable()) {
+        // if this was a reliable packet then signal the matching connection with the sequence number
+        auto connection = findOrCreateConnection(packet->getSenderSockAddr());
+
+        if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                      packet->getDataSize(),
+                                                                      packet->getPayloadSize())) {
+            // the connection could not be created or indicated that we should not continue processing this packet
+            return;
+        }
+    }
+
+    if (packet->isPartOfMessage()) {
+        auto connection = findOrCreateConnection(packet->getSenderSockAddr());
+        if (connection) {
+            connection->queueReceivedMessagePacket(std::move(packet));
+        }
+    } else if (_packetHandler) {
+        // call the verified packet callback to let it handle this packet
+        _packetHandler(std::move(packet));
+    }
+}
+
+void Socket::processReceivedDatagrams() {
+    // clear the flag before draining so a push that lands after our last pop schedules another call
+    _hasPendingReceivedDatagrams = false;
+
+    ReceivedDatagram datagram;
+    while (_receivedDatagrams.pop(datagram)) {
+        if (datagram.unfilteredPacket) {
+            BasePacketHandler handler;
+            {
+                Lock lock(_unfilteredHandlersMutex);
+                auto it = _unfilteredHandlers.find(datagram.unfilteredPacket->getSenderSockAddr());
+                if (it != _unfilteredHandlers.end()) {
+                    handler = it->second;
+                }
             }
 
+            if (handler) {
+                handler(std::move(datagram.unfilteredPacket));
+            }
+        } else if (datagram.controlPacket) {
+            processControlPacket(std::move(datagram.controlPacket));
+        } else if (datagram.packet) {
+            // the filter operator looks at node state that lives on this thread, so it runs here and not on the
+            // receive thread
+            if (!_packetFilterOperator || _packetFilterOperator(*datagram.packet)) {
+                processVerifiedPacket(std::move(datagram.packet));
+            }
+        }
+
+        datagram = ReceivedDatagram();
+    }
+}
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+
+void Socket::startReceiveThread() {
+    if (_receiveThread.joinable() || _udpSocket.state() != QAbstractSocket::BoundState) {
+        return;
+    }
+
+    _receiveThreadShouldStop = false;
+    _receiveThread = std::thread(&Socket::receiveThreadLoop, this, (int)_udpSocket.socketDescriptor());
+}
+
+void Socket::stopReceiveThread() {
+    if (!_receiveThread.joinable()) {
+        return;
+    }
+
+    _receiveThreadShouldStop = true;
+    _receiveThread.join();
+}
+
+void Socket::receiveThreadLoop(int socketDescriptor) {
+    // how long poll waits before checking whether we've been asked to stop
+    static const int RECEIVE_POLL_TIMEOUT_MSECS = 100;
+
+    ReceiveBatch receiveBatch;
+
+    while (!_receiveThreadShouldStop) {
+        pollfd descriptor;
+        descriptor.fd = socketDescriptor;
+        descriptor.events = POLLIN;
+        descriptor.revents = 0;
+
+        if (_receivedDatagrams.getFreeSpace() < ReceiveBatch::BATCH_SIZE) {
+            // the Socket's thread is behind - leave what arrives with the kernel, which counts what it has to drop,
+            // and give that thread a moment to catch up
+            static const auto CATCH_UP_WAIT = std::chrono::milliseconds(1);
+            std::this_thread::sleep_for(CATCH_UP_WAIT);
             continue;
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        int pollResult = poll(&descriptor, 1, RECEIVE_POLL_TIMEOUT_MSECS);
+        if (pollResult <= 0) {
+            // timed out, or interrupted - either way check if we should stop and go around again
+            continue;
+        }
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+        bool pushedDatagrams = false;
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+        int numReceived = 0;
+        do {
+            numReceived = receiveBatch.receive(socketDescriptor);
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
+            if (numReceived <= 0) {
+                break;
             }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
-                        continue;
-                    }
+            auto receiveTime = p_high_resolution_clock::now();
+
+            for (int i = 0; i < numReceived; ++i) {
+                int size = receiveBatch.getSize(i);
+
+                if (size <= 0 || receiveBatch.wasTruncated(i)) {
+                    continue;
                 }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+                HifiSockAddr senderSockAddr = receiveBatch.getSender(i);
+                auto buffer = receiveBatch.takeBuffer(i);
+
+                ReceivedDatagram datagram;
+
+                bool hasUnfilteredHandler = false;
+                {
+                    Lock lock(_unfilteredHandlersMutex);
+                    hasUnfilteredHandler = _unfilteredHandlers.find(senderSockAddr) != _unfilteredHandlers.end();
                 }
+
+                if (hasUnfilteredHandler) {
+                    datagram.unfilteredPacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+                    datagram.unfilteredPacket->setReceiveTime(receiveTime);
+                } else if (*reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK) {
+                    datagram.controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+                    datagram.controlPacket->setReceiveTime(receiveTime);
+                } else {
+                    datagram.packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+                    datagram.packet->setReceiveTime(receiveTime);
+                }
+
+                // there was room for the whole batch before it was read
+                _receivedDatagrams.push(std::move(datagram));
+                pushedDatagrams = true;
             }
+        } while (numReceived == ReceiveBatch::BATCH_SIZE && _receivedDatagrams.getFreeSpace() >= ReceiveBatch::BATCH_SIZE);
+
+        _kernelReceiveDrops = receiveBatch.getKernelDropCount();
+
+        if (pushedDatagrams && !_hasPendingReceivedDatagrams.exchange(true)) {
+            // connections and handlers live on the Socket's thread, let it know there are packets for them
+            QMetaObject::invokeMethod(this, "processReceivedDatagrams", Qt::QueuedConnection);
         }
     }
 }
 
+#endif
+
 void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot) {
     auto it = _connectionsHash.find(destinationAddr);
     if (it != _connectionsHash.end()) {
@@ -464,6 +869,25 @@ void Socket::rateControlSync() {
     }
 }
 
+void Socket::startNetworkEmulation(const NetworkEmulator::Settings& settings) {
+    auto networkEmulator = std::make_shared<NetworkEmulator>(settings,
+        [this](const QByteArray& datagram, const HifiSockAddr& destination) {
+            writeDatagramToSocket(datagram, destination);
+        });
+
+    std::atomic_store(&_networkEmulator, networkEmulator);
+}
+
+void Socket::stopNetworkEmulation() {
+    // anything still held by the emulator is dropped
+    std::atomic_store(&_networkEmulator, std::shared_ptr<NetworkEmulator>());
+}
+
+NetworkEmulator::Stats Socket::getNetworkEmulationStats() const {
+    auto networkEmulator = std::atomic_load(&_networkEmulator);
+    return networkEmulator ? networkEmulator->getStats() : NetworkEmulator::Stats();
+}
+
 void Socket::setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory) {
     // swap the current unique_ptr for the new factory
     _ccFactory.swap(ccFactory);
@@ -483,6 +907,25 @@ void Socket::setConnectionMaxBandwidth(int maxBandwidth) {
     }
 }
 
+void Socket::setStreamScheduling(StreamScheduling scheduling, const StreamWeights& weights) {
+    _streamScheduling = scheduling;
+    _streamWeights = weights;
+    for (auto& pair : _connectionsHash) {
+        auto& connection = pair.second;
+        connection->setStreamScheduling(_streamScheduling, _streamWeights);
+    }
+}
+
+int Socket::sampleKernelReceiveDrops() {
+    uint32_t kernelReceiveDrops = _kernelReceiveDrops;
+
+    // the kernel's counter is 32 bits and wraps, unsigned subtraction handles that for us
+    int dropsSinceLastSample = (int)(kernelReceiveDrops - _lastSampledKernelReceiveDrops);
+    _lastSampledKernelReceiveDrops = kernelReceiveDrops;
+
+    return dropsSinceLastSample;
+}
+
 ConnectionStats::Stats Socket::sampleStatsForConnection(const HifiSockAddr& destination) {
     auto it = _connectionsHash.find(destination);
     if (it != _connectionsHash.end()) {
@@ -495,6 +938,7 @@ ConnectionStats::Stats Socket::sampleStatsForConnection(const HifiSockAddr& dest
 Socket::StatsVector Socket::sampleStatsForAllConnections() {
     StatsVector result;
     result.reserve(_connectionsHash.size());
+
     for (const auto& connectionPair : _connectionsHash) {
         result.emplace_back(connectionPair.first, connectionPair.second->sampleStats());
     }
@@ -14,15 +14,22 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
+#include <thread>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtNetwork/QUdpSocket>
 
 #include "../HifiSockAddr.h"
+#include "BatchedDatagramIO.h"
+#include "ControlPacket.h"
+#include "NetworkEmulator.h"
+#include "SPSCQueue.h"
+#include "Streams.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
 
@@ -55,6 +62,7 @@ public:
     using StatsVector = std::vector<std::pair<HifiSockAddr, ConnectionStats::Stats>>;
     
     Socket(QObject* object = 0, bool shouldChangeSocketOptions = true);
+    ~Socket();
     
     quint16 localPort() const { return _udpSocket.localPort(); }
     
@@ -65,6 +73,27 @@ public:
     qint64 writePacketList(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+
+    // writes unreliable packets to one destination, in as few system calls as the platform allows
+    qint64 writePackets(std::vector<std::unique_ptr<Packet>> packets, const HifiSockAddr& sockAddr);
+    
+    // batched (recvmmsg/sendmmsg) datagram IO is on by default where available, set HIFI_UDT_BATCHED_IO=0 to turn it off
+    static bool isBatchedDatagramIOAvailable();
+    bool isBatchedDatagramIOEnabled() const { return _batchedDatagramIOEnabled; }
+    void setBatchedDatagramIOEnabled(bool enabled);
+
+    // drains the socket on a dedicated thread, which also parses and verifies packets before handing them to the
+    // Socket's thread, rather than on readyRead - off by default, set HIFI_UDT_RECEIVE_THREAD=1 to turn it on
+    static bool isDedicatedReceiveThreadAvailable();
+    bool isDedicatedReceiveThreadEnabled() const { return _dedicatedReceiveThreadEnabled; }
+    void setDedicatedReceiveThreadEnabled(bool enabled);
+
+    // sends every datagram through an emulated lossy, delayed network rather than straight to the UDP socket - set
+    // HIFI_UDT_NETWORK_EMULATION to a description (see NetworkEmulator::Settings::fromString) to do it for every Socket
+    void startNetworkEmulation(const NetworkEmulator::Settings& settings);
+    void stopNetworkEmulation();
+    bool isNetworkEmulationEnabled() const { return (bool)std::atomic_load(&_networkEmulator); }
+    NetworkEmulator::Stats getNetworkEmulationStats() const;
     
     void bind(const QHostAddress& address, quint16 port = 0);
     void rebind(quint16 port);
@@ -77,17 +106,24 @@ public:
     void setConnectionCreationFilterOperator(ConnectionCreationFilterOperator filterOperator)
         { _connectionCreationFilterOperator = filterOperator; }
     
-    void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler)
-        { _unfilteredHandlers[senderSockAddr] = handler; }
+    void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler);
     
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
 
+    // how each connection picks which stream (see Streams.h) sends next - set HIFI_UDT_STREAM_SCHEDULING to "strict",
+    // "fair" or weights like "fair:16,4,1" to choose for every Socket
+    void setStreamScheduling(StreamScheduling scheduling, const StreamWeights& weights = DEFAULT_STREAM_WEIGHTS);
+
     void messageReceived(std::unique_ptr<Packet> packet);
     void messageFailed(Connection* connection, Packet::MessageNumber messageNumber);
     
     StatsVector sampleStatsForAllConnections();
 
+    // returns the datagrams the kernel dropped because the receive buffer was full (SO_RXQ_OVFL) since the last call -
+    // they are counted for the whole socket, not per connection, and only when reading with recvmmsg on Linux
+    int sampleKernelReceiveDrops();
+
 #if (PR_BUILD || DEV_BUILD)
     void sendFakedHandshakeRequest(const HifiSockAddr& sockAddr);
 #endif
@@ -101,6 +137,7 @@ public slots:
     
 private slots:
     void readPendingDatagrams();
+    void processReceivedDatagrams();
     void checkForReadyReadBackup();
     void rateControlSync();
 
@@ -109,6 +146,19 @@ private slots:
 
 private:
     void setSystemBufferSizes();
+    qint64 writeDatagramToSocket(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+    void processDatagram(PacketBuffer buffer, int size, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime);
+    void processControlPacket(std::unique_ptr<ControlPacket> controlPacket);
+    void processVerifiedPacket(std::unique_ptr<Packet> packet);
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    void readPendingDatagramBatches();
+
+    void startReceiveThread();
+    void stopReceiveThread();
+    void receiveThreadLoop(int socketDescriptor);
+#endif
+
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
@@ -129,6 +179,7 @@ private:
     ConnectionCreationFilterOperator _connectionCreationFilterOperator;
 
     Mutex _unreliableSequenceNumbersMutex;
+    Mutex _unfilteredHandlersMutex; // only taken to change the handlers, or to look at them from the receive thread
 
     std::unordered_map<HifiSockAddr, BasePacketHandler> _unfilteredHandlers;
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
@@ -141,10 +192,41 @@ private:
 
     int _maxBandwidth { -1 };
 
+    StreamScheduling _streamScheduling { StreamScheduling::WeightedFair };
+    StreamWeights _streamWeights { DEFAULT_STREAM_WEIGHTS };
+
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<TCPVegasCC>() };
 
     bool _shouldChangeSocketOptions { true };
 
+    bool _batchedDatagramIOEnabled { false };
+
+    // swapped atomically since the send queues write from their own threads
+    std::shared_ptr<NetworkEmulator> _networkEmulator;
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    std::unique_ptr<ReceiveBatch> _receiveBatch;
+#endif
+
+    // a datagram read and parsed on the receive thread, for the Socket's thread to finish processing
+    struct ReceivedDatagram {
+        std::unique_ptr<BasePacket> unfilteredPacket; // from a sender with an unfiltered handler
+        std::unique_ptr<ControlPacket> controlPacket;
+        std::unique_ptr<Packet> packet; // still to go through the packet filter operator, on the Socket's thread
+    };
+
+    // how many datagrams the receive thread can get ahead of the Socket's thread - past that they wait in the kernel
+    static const size_t RECEIVED_DATAGRAMS_CAPACITY = 4096;
+
+    bool _dedicatedReceiveThreadEnabled { false };
+    std::thread _receiveThread;
+    std::atomic<bool> _receiveThreadShouldStop { false };
+    SPSCQueue<ReceivedDatagram> _receivedDatagrams { RECEIVED_DATAGRAMS_CAPACITY };
+    std::atomic<bool> _hasPendingReceivedDatagrams { false }; // a call to processReceivedDatagrams is queued
+
+    // running count from SO_RXQ_OVFL, only known when reading with recvmmsg (batched IO or the receive thread)
+    std::atomic<uint32_t> _kernelReceiveDrops { 0 };
+    uint32_t _lastSampledKernelReceiveDrops { 0 };
+
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
@@ -0,0 +1,43 @@
+//
+//  Streams.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_udt_Streams_h
+#define hifi_udt_Streams_h
+
+#include <array>
+#include <cstdint>
+
+namespace udt {
+
+// Reliable traffic on a Connection is split across streams so a large transfer on one doesn't hold up small urgent
+// messages on another. Each stream is queued apart and the SendQueue picks between them by priority. For messages the
+// stream travels in the top bits of the message number, so the receiver reassembles each stream's messages apart.
+enum class Stream : uint8_t {
+    Urgent, // identity, kills, the domain list and other small messages the session is waiting on
+    Default,
+    Bulk // asset transfers, octree files and other large payloads
+};
+
+static const int NUM_STREAMS = 3;
+
+enum class StreamScheduling {
+    StrictPriority, // always send from the most urgent stream that has something queued
+    WeightedFair // share the sends between the streams that have something queued, in proportion to their weights
+};
+
+// the share of the sends each stream gets with WeightedFair scheduling, indexed by Stream
+using StreamWeights = std::array<int, NUM_STREAMS>;
+static const StreamWeights DEFAULT_STREAM_WEIGHTS {{ 16, 4, 1 }};
+
+}
+
+#endif // hifi_udt_Streams_h
@@ -0,0 +1,94 @@
+//
+//  OctreeCompressionDictionary.cpp
+//  libraries/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeCompressionDictionary.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QHash>
+
+#include <zlib.h>
+
+OctreeCompressionDictionary::OctreeCompressionDictionary(const QByteArray& bytes) :
+    _bytes(bytes.left(MAX_DICTIONARY_SIZE))
+{
+    _id = adler32(adler32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(_bytes.constData()), _bytes.size());
+}
+
+OctreeCompressionDictionaryPointer OctreeCompressionDictionary::train(const QVector<QByteArray>& samples, int maxSize) {
+    maxSize = std::min(maxSize, (int)MAX_DICTIONARY_SIZE);
+
+    // a sample that fills a good part of the dictionary on its own would crowd out everything else
+    const int MIN_SAMPLE_SIZE = 8;
+    const int maxSampleSize = maxSize / 8;
+
+    QHash<QByteArray, int> occurrences;
+    for (const auto& sample : samples) {
+        if (sample.size() >= MIN_SAMPLE_SIZE && sample.size() <= maxSampleSize) {
+            ++occurrences[sample];
+        }
+    }
+
+    // score each distinct sample by the bytes it would have cost across the whole scene
+    struct ScoredSample {
+        QByteArray sample;
+        qint64 score;
+    };
+    std::vector<ScoredSample> scored;
+    scored.reserve(occurrences.size());
+    for (auto it = occurrences.constBegin(); it != occurrences.constEnd(); ++it) {
+        scored.push_back({ it.key(), (qint64)it.key().size() * it.value() });
+    }
+    std::sort(scored.begin(), scored.end(), [](const ScoredSample& a, const ScoredSample& b) {
+        return a.score > b.score;
+    });
+
+    std::vector<const QByteArray*> chosen;
+    int dictionarySize = 0;
+    for (const auto& candidate : scored) {
+        if (dictionarySize + candidate.sample.size() <= maxSize) {
+            chosen.push_back(&candidate.sample);
+            dictionarySize += candidate.sample.size();
+        }
+    }
+
+    if (chosen.empty()) {
+        return nullptr;
+    }
+
+    // zlib encodes short distances more cheaply, so the most valuable samples go at the end of the dictionary
+    QByteArray bytes;
+    bytes.reserve(dictionarySize);
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+        bytes.append(**it);
+    }
+
+    return std::make_shared<OctreeCompressionDictionary>(bytes);
+}
+
+quint32 OctreeCompressionDictionary::requiredDictionaryID(const unsigned char* data, int length) {
+    // qCompress framing is a 4 byte uncompressed size, then the zlib header (CMF, FLG) and the DICTID if FLG has FDICT
+    const int ZLIB_HEADER_OFFSET = 4;
+    const int DICTIONARY_ID_OFFSET = ZLIB_HEADER_OFFSET + 2;
+    const unsigned char FDICT_BIT = 0x20;
+
+    if (!data || length < DICTIONARY_ID_OFFSET + (int)sizeof(quint32)) {
+        return 0;
+    }
+
+    if ((data[ZLIB_HEADER_OFFSET + 1] & FDICT_BIT) == 0) {
+        return 0;
+    }
+
+    const unsigned char* dictionaryID = data + DICTIONARY_ID_OFFSET;
+    return ((quint32)dictionaryID[0] << 24) | ((quint32)dictionaryID[1] << 16) |
+        ((quint32)dictionaryID[2] << 8) | (quint32)dictionaryID[3];
+}
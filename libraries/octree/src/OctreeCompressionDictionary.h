@@ -0,0 +1,55 @@
+//
+//  OctreeCompressionDictionary.h
+//  libraries/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeCompressionDictionary_h
+#define hifi_OctreeCompressionDictionary_h
+
+#include <memory>
+
+#include <QByteArray>
+#include <QVector>
+
+class OctreeCompressionDictionary;
+using OctreeCompressionDictionaryPointer = std::shared_ptr<const OctreeCompressionDictionary>;
+
+// A preset zlib dictionary shared by an octree server and its clients.
+//
+// Each octree packet section is compressed on its own, so strings that show up over and over across a scene (model
+// URLs, script URLs, userData) are paid for in full in every packet that carries them. Priming the compressor with a
+// dictionary built from those strings lets a section refer back to them instead. The server trains the dictionary
+// from its content and sends it to each client once, and only uses it for a client once that client's query says
+// it has it.
+class OctreeCompressionDictionary {
+public:
+    // zlib can only look back 32K, and the section being compressed needs some of that window too
+    static const int MAX_DICTIONARY_SIZE = 30 * 1024;
+    static const int DEFAULT_DICTIONARY_SIZE = 16 * 1024;
+
+    explicit OctreeCompressionDictionary(const QByteArray& bytes);
+
+    // builds a dictionary from the given samples (one per property value), favouring the samples that occur most often
+    // returns nullptr if there is nothing worth putting in a dictionary
+    static OctreeCompressionDictionaryPointer train(const QVector<QByteArray>& samples,
+                                                    int maxSize = DEFAULT_DICTIONARY_SIZE);
+
+    const QByteArray& getBytes() const { return _bytes; }
+
+    // the adler32 of the dictionary, which zlib also writes in the header of every stream compressed with it
+    quint32 getID() const { return _id; }
+
+    // returns the ID of the dictionary a qCompress-framed section was compressed with, or 0 if it needs none
+    static quint32 requiredDictionaryID(const unsigned char* data, int length);
+
+private:
+    QByteArray _bytes;
+    quint32 _id { 0 };
+};
+
+#endif // hifi_OctreeCompressionDictionary_h
@@ -37,8 +37,16 @@ OctreeEditPacketSender::~OctreeEditPacketSender() {
 
 
 bool OctreeEditPacketSender::serversExist() const {
-    auto node = DependencyManager::get<NodeList>()->soloNodeOfType(getMyNodeType());
-    return node && node->getActiveSocket();
+    // a domain may run several servers of our type (one per shard) - we only need one of them to be up
+    bool hasActiveServer = false;
+    DependencyManager::get<NodeList>()->eachNodeBreakable([&](const SharedNodePointer& node) {
+        if (node->getType() == getMyNodeType() && node->getActiveSocket()) {
+            hasActiveServer = true;
+            return false;
+        }
+        return true;
+    });
+    return hasActiveServer;
 }
 
 // This method is called when the edit packet layer has determined that it has a fully formed packet destined for
@@ -55,8 +63,8 @@ void OctreeEditPacketSender::queuePacketToNode(const QUuid& nodeUUID, std::uniqu
             // jump to the beginning of the payload
             packet->seek(0);
 
-            // pack sequence number
-            quint16 sequence = _outgoingSequenceNumbers[nodeUUID]++;
+            // pack sequence number - tracked per receiving node, since a null nodeUUID means "all of them"
+            quint16 sequence = _outgoingSequenceNumbers[node->getUUID()]++;
             packet->writePrimitive(sequence);
 
             // debugging output...
@@ -79,7 +87,7 @@ void OctreeEditPacketSender::queuePacketToNode(const QUuid& nodeUUID, std::uniqu
             }
 
             // add packet to history
-            _sentPacketHistories[nodeUUID].packetSent(sequence, *packet);
+            _sentPacketHistories[node->getUUID()].packetSent(sequence, *packet);
 
             queuePacketForSending(node, NLPacket::createCopy(*packet));
         }
@@ -151,10 +159,8 @@ void OctreeEditPacketSender::queuePacketToNodes(std::unique_ptr<NLPacket> packet
 
     assert(serversExist()); // we must have servers to be here!!
 
-    auto node = DependencyManager::get<NodeList>()->soloNodeOfType(getMyNodeType());
-    if (node && node->getActiveSocket()) {
-        queuePacketToNode(node->getUUID(), std::move(packet));
-    }
+    // queuePacketToNode with a null UUID sends to every server of our type
+    queuePacketToNode(QUuid(), std::move(packet));
 }
 
 
@@ -186,10 +192,16 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
 
     _packetsQueueLock.lock();
 
-    auto node = DependencyManager::get<NodeList>()->soloNodeOfType(getMyNodeType());
-    if (node && node->getActiveSocket()) {
+    // with a sharded domain there is more than one server of our type, and each of them decides if the edit is for an
+    // entity it owns, so the edit goes to all of them
+    DependencyManager::get<NodeList>()->eachMatchingNode([&](const SharedNodePointer& node) {
+        return node->getType() == getMyNodeType() && node->getActiveSocket();
+    }, [&](const SharedNodePointer& node) {
         QUuid nodeUUID = node->getUUID();
 
+        // each server gets its own copy of the message since it is adjusted for that server's clock skew
+        QByteArray nodeEditMessage = editMessage;
+
         // for edit messages, we will attempt to combine multiple edit commands where possible, we
         // don't do this for add because we send those reliably
         if (type == PacketType::EntityAdd) {
@@ -208,10 +220,10 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
             // We call this virtual function that allows our specific type of EditPacketSender to
             // fixup the buffer for any clock skew
             if (nodeClockSkew != 0) {
-                adjustEditPacketForClockSkew(type, editMessage, nodeClockSkew);
+                adjustEditPacketForClockSkew(type, nodeEditMessage, nodeClockSkew);
             }
 
-            newPacket->write(editMessage);
+            newPacket->write(nodeEditMessage);
 
             // release the new packet
             releaseQueuedPacketList(nodeUUID, std::move(newPacket));
@@ -228,7 +240,7 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
             } else {
                 // If we're switching type, then we send the last one and start over
                 if ((type != bufferedPacket->getType() && bufferedPacket->getPayloadSize() > 0) ||
-                    (editMessage.size() >= bufferedPacket->bytesAvailableForWrite())) {
+                    (nodeEditMessage.size() >= bufferedPacket->bytesAvailableForWrite())) {
 
                     // create the new packet and swap it with the packet in _pendingEditPackets
                     auto packetToRelease = initializePacket(type, node->getClockSkewUsec());
@@ -244,12 +256,12 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
             // We call this virtual function that allows our specific type of EditPacketSender to
             // fixup the buffer for any clock skew
             if (node->getClockSkewUsec() != 0) {
-                adjustEditPacketForClockSkew(type, editMessage, node->getClockSkewUsec());
+                adjustEditPacketForClockSkew(type, nodeEditMessage, node->getClockSkewUsec());
             }
 
-            bufferedPacket->write(editMessage);
+            bufferedPacket->write(nodeEditMessage);
         }
-    }
+    });
 
     _packetsQueueLock.unlock();
 
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <zlib.h>
+
 #include <GLMHelpers.h>
 #include <PerfStat.h>
 
@@ -29,7 +31,16 @@ struct aaCubeData {
     float scale;
 };
 
-OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
+static void endDeflateStream(z_stream* stream) {
+    if (stream) {
+        deflateEnd(stream);
+        delete stream;
+    }
+}
+
+OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) :
+    _deflateStream(nullptr, &endDeflateStream)
+{
     changeSettings(enableCompression, targetSize); // does reset...
 }
 
@@ -585,6 +596,10 @@ bool OctreePacketData::compressContent() {
     const uchar* uncompressedData = &_uncompressed[0];
     int uncompressedSize = _bytesInUse;
 
+    if (_dictionary) {
+        return compressContentWithDictionary();
+    }
+
     QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
 
     if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
@@ -597,12 +612,119 @@ bool OctreePacketData::compressContent() {
 }
 
 
+// qCompress framing - the uncompressed size as a big endian 32 bit integer, followed by the zlib stream
+const int UNCOMPRESSED_SIZE_BYTES = sizeof(quint32);
+
+bool OctreePacketData::compressContentWithDictionary() {
+    const int MAX_COMPRESSION = 9;
+    const int MAX_WINDOW_BITS = 15;
+    const int DEFAULT_MEM_LEVEL = 8;
+
+    if (!_deflateStream) {
+        z_stream* stream = new z_stream;
+        stream->zalloc = Z_NULL;
+        stream->zfree = Z_NULL;
+        stream->opaque = Z_NULL;
+
+        if (deflateInit2(stream, MAX_COMPRESSION, Z_DEFLATED, MAX_WINDOW_BITS, DEFAULT_MEM_LEVEL,
+                         Z_DEFAULT_STRATEGY) != Z_OK) {
+            delete stream;
+            return false;
+        }
+        _deflateStream.reset(stream);
+    } else if (deflateReset(_deflateStream.get()) != Z_OK) {
+        return false;
+    }
+
+    // the stream itself is reused between sections, so we only pay for the zlib allocations once per send thread
+    z_stream* stream = _deflateStream.get();
+    const QByteArray& dictionary = _dictionary->getBytes();
+    if (deflateSetDictionary(stream, reinterpret_cast<const Bytef*>(dictionary.constData()), dictionary.size()) != Z_OK) {
+        return false;
+    }
+
+    int compressedCapacity = qMin(_compressedByteArray.size(), (int)MAX_OCTREE_PACKET_DATA_SIZE);
+    if (compressedCapacity <= UNCOMPRESSED_SIZE_BYTES) {
+        return false;
+    }
+
+    _compressed[0] = (unsigned char)((_bytesInUse >> 24) & 0xFF);
+    _compressed[1] = (unsigned char)((_bytesInUse >> 16) & 0xFF);
+    _compressed[2] = (unsigned char)((_bytesInUse >> 8) & 0xFF);
+    _compressed[3] = (unsigned char)(_bytesInUse & 0xFF);
+
+    stream->next_in = _uncompressed;
+    stream->avail_in = _bytesInUse;
+    stream->next_out = _compressed + UNCOMPRESSED_SIZE_BYTES;
+    stream->avail_out = compressedCapacity - UNCOMPRESSED_SIZE_BYTES;
+
+    // if it doesn't all fit in one go it's larger than a packet, which we treat the same as a failed qCompress
+    if (deflate(stream, Z_FINISH) != Z_STREAM_END) {
+        return false;
+    }
+
+    _compressedBytes = UNCOMPRESSED_SIZE_BYTES + (int)stream->total_out;
+    _dirty = false;
+    return true;
+}
+
+bool OctreePacketData::uncompressContentWithDictionary(const unsigned char* data, int length) {
+    if (!_dictionary || _dictionary->getID() != OctreeCompressionDictionary::requiredDictionaryID(data, length)) {
+        return false;
+    }
+
+    int uncompressedSize = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+    if (uncompressedSize < 0 || uncompressedSize > _bytesAvailable) {
+        return false;
+    }
+
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = const_cast<Bytef*>(data + UNCOMPRESSED_SIZE_BYTES);
+    stream.avail_in = length - UNCOMPRESSED_SIZE_BYTES;
+
+    if (inflateInit(&stream) != Z_OK) {
+        return false;
+    }
+
+    stream.next_out = _uncompressed;
+    stream.avail_out = uncompressedSize;
+
+    int status = inflate(&stream, Z_FINISH);
+    if (status == Z_NEED_DICT) {
+        const QByteArray& dictionary = _dictionary->getBytes();
+        status = inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.constData()), dictionary.size());
+        if (status == Z_OK) {
+            status = inflate(&stream, Z_FINISH);
+        }
+    }
+
+    bool success = status == Z_STREAM_END && (int)stream.total_out == uncompressedSize;
+    inflateEnd(&stream);
+
+    if (success) {
+        _bytesInUse = uncompressedSize;
+        _bytesAvailable -= uncompressedSize;
+    }
+    return success;
+}
+
 void OctreePacketData::loadFinalizedContent(const unsigned char* data, int length) {
     reset();
 
     if (data && length > 0) {
 
-        if (_enableCompression) {
+        if (_enableCompression && OctreeCompressionDictionary::requiredDictionaryID(data, length) != 0) {
+            _compressedBytes = length;
+            memcpy(_compressed, data, _compressedBytes);
+
+            if (!uncompressContentWithDictionary(data, length)) {
+                qCDebug(octree) << "OctreePacketData::loadFinalizedContent()... unable to uncompress section that needs"
+                    << "compression dictionary" << OctreeCompressionDictionary::requiredDictionaryID(data, length);
+            }
+        } else if (_enableCompression) {
             _compressedBytes = length;
             memcpy(_compressed, data, _compressedBytes);
 
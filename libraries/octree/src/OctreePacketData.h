@@ -23,6 +23,7 @@
 #define hifi_OctreePacketData_h
 
 #include <atomic>
+#include <memory>
 
 #include <QByteArray>
 #include <QString>
@@ -33,11 +34,14 @@
 #include <NLPacket.h>
 #include <udt/PacketHeaders.h>
 
+#include "OctreeCompressionDictionary.h"
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
+struct z_stream_s;
+
 typedef unsigned char OCTREE_PACKET_FLAGS;
 typedef uint16_t OCTREE_PACKET_SEQUENCE;
 const uint16_t MAX_OCTREE_PACKET_SEQUENCE = 65535;
@@ -90,6 +94,11 @@ public:
 
     /// reset completely, all data is discarded
     void reset();
+
+    /// sets the preset dictionary used to compress on finalization, and to uncompress sections that were compressed
+    /// with it, pass nullptr to go back to plain per-section compression. Kept across changeSettings() and reset()
+    void setCompressionDictionary(const OctreeCompressionDictionaryPointer& dictionary) { _dictionary = dictionary; }
+    const OctreeCompressionDictionaryPointer& getCompressionDictionary() const { return _dictionary; }
     
     /// call to begin encoding a subtree starting at this point, this will append the octcode to the uncompressed stream
     /// at this point. May fail if new datastream is too long. In failure case the stream remains in it's previous state.
@@ -286,6 +295,11 @@ private:
     int _subTreeBytesReserved; // the number of reserved bytes at start of a subtree
 
     bool compressContent();
+    bool compressContentWithDictionary();
+    bool uncompressContentWithDictionary(const unsigned char* data, int length);
+
+    OctreeCompressionDictionaryPointer _dictionary;
+    std::unique_ptr<z_stream_s, void(*)(z_stream_s*)> _deflateStream;
     
     QByteArray _compressedByteArray;
     unsigned char* _compressed { nullptr };
@@ -125,9 +125,14 @@ void OctreeProcessor::processDatagram(ReceivedMessage& message, SharedNodePointe
                 _tree->withWriteLock([&] {
                     startUncompress = usecTimestampNow();
 
+                    auto sectionData = reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition());
+
                     OctreePacketData packetData(packetIsCompressed);
-                    packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition()),
-                        sectionLength);
+                    quint32 dictionaryID = OctreeCompressionDictionary::requiredDictionaryID(sectionData, sectionLength);
+                    if (packetIsCompressed && dictionaryID != 0) {
+                        packetData.setCompressionDictionary(findCompressionDictionary(sourceUUID, dictionaryID));
+                    }
+                    packetData.loadFinalizedContent(sectionData, sectionLength);
                     if (extraDebugging) {
                         qCDebug(octree) << "OctreeProcessor::processDatagram() ... "
                             "Got Packet Section color:" << packetIsColored <<
@@ -197,6 +202,51 @@ void OctreeProcessor::processDatagram(ReceivedMessage& message, SharedNodePointe
     }
 }
 
+void OctreeProcessor::processCompressionDictionary(ReceivedMessage& message, SharedNodePointer sourceNode) {
+    if (!sourceNode) {
+        return;
+    }
+
+    auto dictionary = std::make_shared<OctreeCompressionDictionary>(message.readAll());
+
+    qCDebug(octree) << "Received" << dictionary->getBytes().size() << "byte compression dictionary" << dictionary->getID()
+        << "from" << sourceNode->getUUID();
+
+    std::lock_guard<std::mutex> lock(_compressionDictionariesMutex);
+    auto& dictionaries = _compressionDictionaries[sourceNode->getUUID()];
+
+    // sections the server compressed with the dictionary it's replacing may still be on their way
+    if (dictionaries.current && dictionaries.current->getID() != dictionary->getID()) {
+        dictionaries.previous = dictionaries.current;
+    }
+    dictionaries.current = dictionary;
+}
+
+quint32 OctreeProcessor::getCompressionDictionaryID(const QUuid& serverID) const {
+    std::lock_guard<std::mutex> lock(_compressionDictionariesMutex);
+    auto it = _compressionDictionaries.find(serverID);
+    return (it != _compressionDictionaries.end() && it->current) ? it->current->getID() : 0;
+}
+
+void OctreeProcessor::removeCompressionDictionary(const QUuid& serverID) {
+    std::lock_guard<std::mutex> lock(_compressionDictionariesMutex);
+    _compressionDictionaries.remove(serverID);
+}
+
+OctreeCompressionDictionaryPointer OctreeProcessor::findCompressionDictionary(const QUuid& serverID,
+                                                                              quint32 dictionaryID) const {
+    std::lock_guard<std::mutex> lock(_compressionDictionariesMutex);
+    auto it = _compressionDictionaries.find(serverID);
+    if (it != _compressionDictionaries.end()) {
+        if (it->current && it->current->getID() == dictionaryID) {
+            return it->current;
+        } else if (it->previous && it->previous->getID() == dictionaryID) {
+            return it->previous;
+        }
+    }
+    return nullptr;
+}
+
 void OctreeProcessor::clear() {
     if (_tree) {
         _tree->withWriteLock([&] {
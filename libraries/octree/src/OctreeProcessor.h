@@ -13,8 +13,10 @@
 #define hifi_OctreeProcessor_h
 
 #include <glm/glm.hpp>
+#include <mutex>
 #include <stdint.h>
 
+#include <QHash>
 #include <QObject>
 
 #include <udt/PacketHeaders.h>
@@ -40,6 +42,13 @@ public:
     /// process incoming data
     virtual void processDatagram(ReceivedMessage& message, SharedNodePointer sourceNode);
 
+    /// keeps the compression dictionary an octree server sent us, so we can decode the sections it compresses with it
+    void processCompressionDictionary(ReceivedMessage& message, SharedNodePointer sourceNode);
+
+    /// the ID of the compression dictionary we have from the given server, 0 if we don't have one
+    quint32 getCompressionDictionaryID(const QUuid& serverID) const;
+    void removeCompressionDictionary(const QUuid& serverID);
+
     /// initialize and GPU/rendering related resources
     virtual void init();
 
@@ -74,6 +83,15 @@ protected:
     SimpleMovingAverage _uncompressPerPacket;
     SimpleMovingAverage _readBitstreamPerPacket;
 
+    OctreeCompressionDictionaryPointer findCompressionDictionary(const QUuid& serverID, quint32 dictionaryID) const;
+
+    struct ServerCompressionDictionaries {
+        OctreeCompressionDictionaryPointer current;
+        OctreeCompressionDictionaryPointer previous;
+    };
+    mutable std::mutex _compressionDictionariesMutex;
+    QHash<QUuid, ServerCompressionDictionaries> _compressionDictionaries;
+
     quint64 _lastWindowAt = 0;
     int _packetsInLastWindow = 0;
     int _elementsInLastWindow = 0;
@@ -103,6 +103,11 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
         destinationBuffer += binaryParametersBytes;
     }
     
+    // the compression dictionary we have for this server, if any
+    quint32 compressionDictionaryID = _compressionDictionaryID;
+    memcpy(destinationBuffer, &compressionDictionaryID, sizeof(compressionDictionaryID));
+    destinationBuffer += sizeof(compressionDictionaryID);
+
     return destinationBuffer - bufferStart;
 }
 
@@ -182,6 +187,12 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
         _jsonParameters = newJsonDocument.object();
     }
     
+    quint32 compressionDictionaryID;
+    memcpy(&compressionDictionaryID, sourceBuffer, sizeof(compressionDictionaryID));
+    sourceBuffer += sizeof(compressionDictionaryID);
+    _compressionDictionaryID = compressionDictionaryID;
+
+
     return sourceBuffer - startPosition;
 }
 
@@ -12,6 +12,7 @@
 #ifndef hifi_OctreeQuery_h
 #define hifi_OctreeQuery_h
 
+#include <atomic>
 #include <inttypes.h>
 
 #include <glm/glm.hpp>
@@ -60,6 +61,10 @@ public:
     void setJSONParameters(const QJsonObject& jsonParameters)
         { QWriteLocker locker { &_jsonParametersLock }; _jsonParameters = jsonParameters; }
     
+    // the compression dictionary the querying client has for this server, 0 if it has none
+    quint32 getCompressionDictionaryID() const { return _compressionDictionaryID; }
+    void setCompressionDictionaryID(quint32 compressionDictionaryID) { _compressionDictionaryID = compressionDictionaryID; }
+
     // related to Octree Sending strategies
     int getMaxQueryPacketsPerSecond() const { return _maxQueryPPS; }
     float getOctreeSizeScale() const { return _octreeElementSizeScale; }
@@ -102,6 +107,8 @@ protected:
     QJsonObject _jsonParameters;
     QReadWriteLock _jsonParametersLock;
 
+    std::atomic<quint32> _compressionDictionaryID { 0 };
+
     bool _hasReceivedFirstQuery { false };
     
 private:
@@ -77,6 +77,13 @@ public:
 
     bool hasLodChanged() const { return _lodChanged; }
 
+    // the compression dictionary we last sent this client, and when, so we don't keep sending it while we wait for
+    // its query to say it has it
+    quint32 getCompressionDictionarySentID() const { return _compressionDictionarySentID; }
+    quint64 getCompressionDictionarySentAt() const { return _compressionDictionarySentAt; }
+    void setCompressionDictionarySent(quint32 dictionaryID, quint64 sentAt)
+        { _compressionDictionarySentID = dictionaryID; _compressionDictionarySentAt = sentAt; }
+
     OctreeSceneStats stats;
 
     void dumpOutOfView();
@@ -153,6 +160,9 @@ private:
     QJsonObject _lastCheckJSONParameters;
 
     bool _shouldForceFullScene { false };
+
+    quint32 _compressionDictionarySentID { 0 };
+    quint64 _compressionDictionarySentAt { 0 };
 };
 
 #endif // hifi_OctreeQueryNode_h
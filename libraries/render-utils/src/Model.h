@@ -246,7 +246,7 @@ public:
     virtual bool updateGeometry();
     void setCollisionMesh(graphics::MeshPointer mesh);
 
-    void setLoadingPriority(float priority) { _loadingPriority = priority; }
+    void setLoadingPriority(float priority);
 
     size_t getRenderInfoVertexCount() const { return _renderInfoVertexCount; }
     size_t getRenderInfoTextureSize();
@@ -0,0 +1,114 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+namespace {
+
+const int COMPRESSION_ROUNDS = 2;
+const int FINALIZATION_ROUNDS = 4;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t readLittleEndian64(const uint8_t* bytes) {
+    return (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8) | ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24)
+        | ((uint64_t)bytes[4] << 32) | ((uint64_t)bytes[5] << 40) | ((uint64_t)bytes[6] << 48)
+        | ((uint64_t)bytes[7] << 56);
+}
+
+inline void writeLittleEndian64(uint64_t value, uint8_t* bytes) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+struct SipState {
+    uint64_t v0, v1, v2, v3;
+
+    void rounds(int count) {
+        for (int i = 0; i < count; ++i) {
+            v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32);
+            v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2;
+            v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0;
+            v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32);
+        }
+    }
+
+    void compress(uint64_t block) {
+        v3 ^= block;
+        rounds(COMPRESSION_ROUNDS);
+        v0 ^= block;
+    }
+
+    uint64_t finalize(uint64_t marker) {
+        v2 ^= marker;
+        rounds(FINALIZATION_ROUNDS);
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+};
+
+// initializes the state and absorbs the whole message, leaving only finalization
+SipState absorb(const uint8_t key[SIPHASH_KEY_SIZE], const void* data, size_t size, bool wideOutput) {
+    uint64_t k0 = readLittleEndian64(key);
+    uint64_t k1 = readLittleEndian64(key + 8);
+
+    SipState state;
+    state.v0 = k0 ^ 0x736f6d6570736575ULL;
+    state.v1 = k1 ^ 0x646f72616e646f6dULL;
+    state.v2 = k0 ^ 0x6c7967656e657261ULL;
+    state.v3 = k1 ^ 0x7465646279746573ULL;
+
+    if (wideOutput) {
+        state.v1 ^= 0xee;
+    }
+
+    auto bytes = static_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + (size - (size % 8));
+
+    for (; bytes != end; bytes += 8) {
+        state.compress(readLittleEndian64(bytes));
+    }
+
+    // the last block holds the remaining bytes and the low byte of the length in its top byte
+    uint64_t lastBlock = (uint64_t)size << 56;
+    switch (size % 8) {
+        case 7: lastBlock |= (uint64_t)bytes[6] << 48; // fall through
+        case 6: lastBlock |= (uint64_t)bytes[5] << 40; // fall through
+        case 5: lastBlock |= (uint64_t)bytes[4] << 32; // fall through
+        case 4: lastBlock |= (uint64_t)bytes[3] << 24; // fall through
+        case 3: lastBlock |= (uint64_t)bytes[2] << 16; // fall through
+        case 2: lastBlock |= (uint64_t)bytes[1] << 8; // fall through
+        case 1: lastBlock |= (uint64_t)bytes[0]; break;
+        default: break;
+    }
+
+    state.compress(lastBlock);
+
+    return state;
+}
+
+}
+
+uint64_t sipHash64(const uint8_t key[SIPHASH_KEY_SIZE], const void* data, size_t size) {
+    SipState state = absorb(key, data, size, false);
+    return state.finalize(0xff);
+}
+
+void sipHash128(const uint8_t key[SIPHASH_KEY_SIZE], const void* data, size_t size, uint8_t out[SIPHASH_128_SIZE]) {
+    SipState state = absorb(key, data, size, true);
+
+    writeLittleEndian64(state.finalize(0xee), out);
+
+    state.v1 ^= 0xdd;
+    state.rounds(FINALIZATION_ROUNDS);
+    writeLittleEndian64(state.v0 ^ state.v1 ^ state.v2 ^ state.v3, out + 8);
+}
@@ -0,0 +1,28 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <cstddef>
+#include <cstdint>
+
+// SipHash-2-4 (Aumasson and Bernstein), a keyed hash that is fast on short inputs and safe to use as a MAC.
+// Neither function allocates, keys and outputs are byte arrays in the reference implementation's byte order.
+
+const int SIPHASH_KEY_SIZE = 16;
+const int SIPHASH_128_SIZE = 16;
+
+uint64_t sipHash64(const uint8_t key[SIPHASH_KEY_SIZE], const void* data, size_t size);
+void sipHash128(const uint8_t key[SIPHASH_KEY_SIZE], const void* data, size_t size, uint8_t out[SIPHASH_128_SIZE]);
+
+#endif // hifi_SipHash_h
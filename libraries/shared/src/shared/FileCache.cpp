@@ -12,12 +12,15 @@
 #include "FileCache.h"
 
 
+#include <algorithm>
 #include <unordered_set>
-#include <queue>
 #include <cassert>
+#include <functional>
+#include <vector>
 
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QSaveFile>
 #include <QtCore/QStorageInfo>
 
@@ -44,6 +47,41 @@ const size_t FileCache::DEFAULT_MAX_SIZE { GB_TO_BYTES(5) };
 const size_t FileCache::MAX_MAX_SIZE { GB_TO_BYTES(100) };
 const size_t FileCache::DEFAULT_MIN_FREE_STORAGE_SPACE { GB_TO_BYTES(1) };
 
+// prefetches mostly wait on the disk, a couple at a time keeps it busy without competing with the real reads
+static const int PREFETCH_THREAD_COUNT = 2;
+static const size_t PREFETCH_PAGE_SIZE = 4096;
+
+namespace {
+    // touches every page of part of a file so the OS reads it in
+    class PrefetchTask : public QRunnable {
+    public:
+        PrefetchTask(const std::string& filepath, size_t offset, size_t length, std::function<void()> done) :
+            _filepath(filepath), _offset(offset), _length(length), _done(done) {}
+
+        void run() override {
+            QFile file(_filepath.c_str());
+            if (file.open(QIODevice::ReadOnly) && _offset < (size_t)file.size()) {
+                auto length = std::min<size_t>(_length ? _length : file.size(), file.size() - _offset);
+                auto mapped = file.map(_offset, length);
+                if (mapped) {
+                    volatile uint8_t sum = 0;
+                    for (size_t i = 0; i < length; i += PREFETCH_PAGE_SIZE) {
+                        sum += mapped[i];
+                    }
+                    file.unmap(mapped);
+                }
+            }
+            _done();
+        }
+
+    private:
+        const std::string _filepath;
+        const size_t _offset;
+        const size_t _length;
+        const std::function<void()> _done;
+    };
+}
+
 
 std::string getCacheName(const std::string& dirname_str) {
     QString dirname { dirname_str.c_str() };
@@ -80,6 +118,7 @@ FileCache::FileCache(const std::string& dirname, const std::string& ext, QObject
     _ext(ext),
     _dirname(getCacheName(dirname)),
     _dirpath(getCachePath(dirname)) {
+    _prefetchPool.setMaxThreadCount(PREFETCH_THREAD_COUNT);
 }
 
 FileCache::~FileCache() {
@@ -87,7 +126,6 @@ FileCache::~FileCache() {
 }
 
 void FileCache::initialize() {
-    Lock lock(_mutex);
     if (_initialized) {
         qCWarning(file_cache) << "File cache already initialized";
         return;
@@ -106,7 +144,10 @@ void FileCache::initialize() {
             const Key key = filename.section('.', 0, 0).toStdString();
             const std::string filepath = dir.filePath(filename).toStdString();
             const size_t length = QFileInfo(filepath.c_str()).size();
-            addFile(Metadata(key, length), filepath);
+
+            auto& shard = getShard(key);
+            Lock lock(shard.mutex);
+            addFile(shard, Metadata(key, length), filepath);
         }
 
         qCDebug(file_cache, "[%s] Initialized %s", _dirname.c_str(), _dirpath.c_str());
@@ -122,7 +163,7 @@ std::unique_ptr<File> FileCache::createFile(Metadata&& metadata, const std::stri
     return std::unique_ptr<File>(new cache::File(std::move(metadata), filepath));
 }
 
-FilePointer FileCache::addFile(Metadata&& metadata, const std::string& filepath) {
+FilePointer FileCache::addFile(Shard& shard, Metadata&& metadata, const std::string& filepath) {
     File* rawFile = createFile(std::move(metadata), filepath).release();
     FilePointer file(rawFile, std::bind(&File::deleter, rawFile));
     if (file) {
@@ -132,7 +173,7 @@ FilePointer FileCache::addFile(Metadata&& metadata, const std::string& filepath)
         file->_locked = true;
         emit dirty();
 
-        _files[file->getKey()] = file;
+        shard.files[file->getKey()] = file;
     }
     return file;
 }
@@ -145,14 +186,14 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
         return file;
     }
 
-
-    Lock lock(_mutex);
-
     if (!_initialized) {
         qCWarning(file_cache) << "File cache used before initialization";
         return file;
     }
 
+    auto& shard = getShard(metadata.key);
+    Lock lock(shard.mutex);
+
     std::string filepath = getFilepath(metadata.key);
 
     // if file already exists, return it
@@ -172,7 +213,7 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
         && saveFile.write(data, metadata.length) == static_cast<qint64>(metadata.length)
         && saveFile.commit()) {
 
-        file = addFile(std::move(metadata), filepath);
+        file = addFile(shard, std::move(metadata), filepath);
     } else {
         qCWarning(file_cache, "[%s] Failed to write %s", _dirname.c_str(), metadata.key.c_str());
     }
@@ -182,22 +223,23 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
 
 
 FilePointer FileCache::getFile(const Key& key) {
-    Lock lock(_mutex);
-
     FilePointer file;
     if (!_initialized) {
         qCWarning(file_cache) << "File cache used before initialization";
         return file;
     }
 
+    auto& shard = getShard(key);
+    Lock lock(shard.mutex);
+
     // check if file exists
-    const auto it = _files.find(key);
-    if (it != _files.cend()) {
+    const auto it = shard.files.find(key);
+    if (it != shard.files.cend()) {
         file = it->second.lock();
         if (file) {
             file->touch();
             // if it exists, it is active - remove it from the cache
-            if (_unusedFiles.erase(file)) {
+            if (shard.unusedFiles.erase(file)) {
                 assert(!file->_locked);
                 file->_locked = true;
                 _numUnusedFiles -= 1;
@@ -209,7 +251,7 @@ FilePointer FileCache::getFile(const Key& key) {
             emit dirty();
         } else {
             // if not, remove the weak_ptr
-            _files.erase(it);
+            shard.files.erase(it);
         }
     }
 
@@ -217,22 +259,51 @@ FilePointer FileCache::getFile(const Key& key) {
     return file;
 }
 
+void FileCache::prefetch(const Key& key, size_t offset, size_t length) {
+    if (!_initialized) {
+        return;
+    }
+
+    {
+        auto& shard = getShard(key);
+        Lock lock(shard.mutex);
+        if (shard.files.find(key) == shard.files.end()) {
+            return;
+        }
+    }
+
+    auto filepath = getFilepath(key);
+    auto prefetchKey = filepath + ':' + std::to_string(offset);
+
+    {
+        // a prefetch of the same part that hasn't run yet will do
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        if (!_pendingPrefetches.insert(prefetchKey).second) {
+            return;
+        }
+    }
+
+    _prefetchPool.start(new PrefetchTask(filepath, offset, length, [this, prefetchKey] {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        _pendingPrefetches.erase(prefetchKey);
+    }));
+}
+
 std::string FileCache::getFilepath(const Key& key) {
     return _dirpath + DIR_SEP + key + EXT_SEP + _ext;
 }
 
-// This is a non-public function that uses the mutex because it's 
-// essentially a public function specifically to a File object
-void FileCache::addUnusedFile(const FilePointer& file) {
+FileCache::Shard& FileCache::getShard(const Key& key) {
+    return _shards[std::hash<Key>()(key) % NUM_SHARDS];
+}
+
+void FileCache::addUnusedFile(Shard& shard, const FilePointer& file) {
     assert(file->_locked);
     file->_locked = false;
-    _files[file->getKey()] = file;
-    _unusedFiles.insert(file);
+    shard.files[file->getKey()] = file;
+    shard.unusedFiles.insert(file);
     _numUnusedFiles += 1;
     _unusedFilesSize += file->getLength();
-    clean();
-
-    emit dirty();
 }
 
 size_t FileCache::getOverbudgetAmount() const {
@@ -250,31 +321,35 @@ size_t FileCache::getOverbudgetAmount() const {
     return result;
 }
 
-namespace cache {
-    struct FilePointerComparator {
-        bool operator()(const FilePointer& a, const FilePointer& b) {
-            return a->_modified > b->_modified;
-        }
-    };
-}
-
 // Take file pointer by value to insure it doesn't get destructed during the "erase()" calls
-void FileCache::eject(FilePointer file) {
+void FileCache::eject(Shard& shard, FilePointer file) {
     file->_locked = false;
     const auto& length = file->getLength();
     const auto& key = file->getKey();
 
-    if (0 != _files.erase(key)) {
+    if (0 != shard.files.erase(key)) {
         _numTotalFiles -= 1;
         _totalFilesSize -= length;
     }
-    if (0 != _unusedFiles.erase(file)) {
+    if (0 != shard.unusedFiles.erase(file)) {
         _numUnusedFiles -= 1;
         _unusedFilesSize -= length;
     }
 }
 
-void FileCache::clean() {
+void FileCache::clean(bool wait) {
+    // the files are ejected after the shard locks are let go, when the last of these references goes. Declared before
+    // the clean lock so they go after it is unlocked: a file released while it was a candidate is re-added as unused
+    // when its last reference goes, and that cleans again
+    std::vector<std::pair<int64_t, FilePointer>> candidates;
+
+    std::unique_lock<std::mutex> cleanLock(_cleanMutex, std::defer_lock);
+    if (wait) {
+        cleanLock.lock();
+    } else if (!cleanLock.try_lock()) {
+        return;
+    }
+
     size_t overbudgetAmount = getOverbudgetAmount();
 
     // Avoid sorting the unused files by LRU if we're not over budget / under free space
@@ -282,50 +357,79 @@ void FileCache::clean() {
         return;
     }
 
-    using Queue = std::priority_queue<FilePointer, std::vector<FilePointer>, FilePointerComparator>;
-    Queue queue;
-    for (const auto& file : _unusedFiles) {
-        queue.push(file);
+    for (auto& shard : _shards) {
+        Lock lock(shard.mutex);
+        for (const auto& file : shard.unusedFiles) {
+            candidates.emplace_back(file->_modified, file);
+        }
     }
 
-    while (!queue.empty() && overbudgetAmount > 0) {
-        auto file = queue.top();
-        queue.pop();
-        eject(file);
+    // least recently used first
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<int64_t, FilePointer>& a,
+                                                       const std::pair<int64_t, FilePointer>& b) {
+        return a.first < b.first;
+    });
+
+    for (const auto& candidate : candidates) {
+        if (0 == overbudgetAmount) {
+            break;
+        }
+
+        const auto& file = candidate.second;
+        auto& shard = getShard(file->getKey());
+        Lock lock(shard.mutex);
+
+        // skip files that were taken back into use since they were collected
+        if (0 == shard.unusedFiles.count(file)) {
+            continue;
+        }
+
+        eject(shard, file);
         auto length = file->getLength();
         overbudgetAmount -= std::min(length, overbudgetAmount);
     }
 }
 
 void FileCache::wipe() {
-    Lock lock(_mutex);
-    while (!_unusedFiles.empty()) {
-        eject(*_unusedFiles.begin());
+    for (auto& shard : _shards) {
+        Lock lock(shard.mutex);
+        while (!shard.unusedFiles.empty()) {
+            eject(shard, *shard.unusedFiles.begin());
+        }
     }
 }
 
 void FileCache::clear() {
-    Lock lock(_mutex);
-
     // Eliminate any overbudget files
     clean();
 
     // Mark everything remaining as persisted while effectively ejecting from the cache
-    for (auto& file : _unusedFiles) {
-        file->_shouldPersist = true;
-        file->_parent.reset();
-        qCDebug(file_cache, "[%s] Persisting %s", _dirname.c_str(), file->getKey().c_str());
+    for (auto& shard : _shards) {
+        Lock lock(shard.mutex);
+        for (auto& file : shard.unusedFiles) {
+            file->_shouldPersist = true;
+            file->_parent.reset();
+            qCDebug(file_cache, "[%s] Persisting %s", _dirname.c_str(), file->getKey().c_str());
+        }
+        shard.unusedFiles.clear();
     }
-    _unusedFiles.clear();
 }
 
 void FileCache::releaseFile(File* file) {
-    Lock lock(_mutex);
-    if (file->_locked) {
-        addUnusedFile(FilePointer(file, std::bind(&File::deleter, file)));
-    } else {
-        delete file;
+    {
+        auto& shard = getShard(file->getKey());
+        Lock lock(shard.mutex);
+        if (!file->_locked) {
+            delete file;
+            return;
+        }
+        addUnusedFile(shard, FilePointer(file, std::bind(&File::deleter, file)));
     }
+
+    // clean with no shard locked - a thread already cleaning is making room, so don't wait on it
+    clean(false);
+
+    emit dirty();
 }
 
 void File::deleter(File* file) {
@@ -356,8 +460,25 @@ File::~File() {
     }
 }
 
+std::shared_ptr<storage::FileStorage> File::map() const {
+    std::lock_guard<std::mutex> lock(_mappingMutex);
+
+    auto mapping = _mapping.lock();
+    if (!mapping) {
+        mapping = std::make_shared<storage::FileStorage>(_filepath.c_str());
+        _mapping = mapping;
+    }
+    return mapping;
+}
+
+void File::prefetch(size_t offset, size_t length) const {
+    FileCachePointer cache = _parent.lock();
+    if (cache) {
+        cache->prefetch(_key, offset, length);
+    }
+}
+
 void File::touch() {
     utime(_filepath.c_str(), nullptr);
     _modified = std::max<int64_t>(QFileInfo(_filepath.c_str()).lastRead().toMSecsSinceEpoch(), _modified);
 }
-
@@ -10,6 +10,7 @@
 #ifndef hifi_FileCache_h
 #define hifi_FileCache_h
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <cstddef>
@@ -21,6 +22,9 @@
 
 #include <QObject>
 #include <QLoggingCategory>
+#include <QThreadPool>
+
+#include "Storage.h"
 
 Q_DECLARE_LOGGING_CATEGORY(file_cache)
 
@@ -99,6 +103,10 @@ public:
     FilePointer writeFile(const char* data, Metadata&& metadata, bool overwrite = false);
     FilePointer getFile(const Key& key);
 
+    // Read a cached file (or length bytes of it from offset, 0 for the rest of the file) on a background thread so
+    // the OS has it in memory by the time it is used.  Does nothing for files that aren't in the cache.
+    void prefetch(const Key& key, size_t offset = 0, size_t length = 0);
+
     /// create a file
     virtual std::unique_ptr<File> createFile(Metadata&& metadata, const std::string& filepath);
 
@@ -109,17 +117,30 @@ private:
     using Set = std::unordered_set<FilePointer>;
     using KeySet = std::unordered_set<Key>;
 
+    // The index is split by key into shards with a lock each, so many threads looking up files at once (as when a
+    // scene's textures load from the cache) don't all wait on each other
+    static const size_t NUM_SHARDS = 16;
+    struct Shard {
+        Mutex mutex;
+        Map files;
+        Set unusedFiles;
+    };
+
     friend class File;
 
     std::string getFilepath(const Key& key);
+    Shard& getShard(const Key& key);
+
+    // the shard of the file must be locked for these
+    FilePointer addFile(Shard& shard, Metadata&& metadata, const std::string& filepath);
+    void addUnusedFile(Shard& shard, const FilePointer& file);
+    // Remove a file from the cache
+    void eject(Shard& shard, FilePointer file);
 
-    FilePointer addFile(Metadata&& metadata, const std::string& filepath);
-    void addUnusedFile(const FilePointer& file);
     void releaseFile(File* file);
-    void clean();
+    // eject unused files until the cache is within budget, without waiting if another thread is already at it
+    void clean(bool wait = true);
     void clear();
-    // Remove a file from the cache
-    void eject(FilePointer file);
 
     size_t getOverbudgetAmount() const;
 
@@ -135,11 +156,15 @@ private:
     const std::string _ext;
     const std::string _dirname;
     const std::string _dirpath;
-    bool _initialized { false };
+    std::atomic<bool> _initialized { false };
+
+    std::array<Shard, NUM_SHARDS> _shards;
+    std::mutex _cleanMutex;
 
-    Mutex _mutex;
-    Map _files;
-    Set _unusedFiles;
+    std::mutex _prefetchMutex;
+    std::unordered_set<std::string> _pendingPrefetches;
+    // last, so it is done with the prefetches before the rest goes away
+    QThreadPool _prefetchPool;
 };
 
 class File {
@@ -155,13 +180,18 @@ public:
     /// overrides should call File::deleter to maintain caching behavior
     static void deleter(File* file);
 
+    /// the file mapped in memory - the readers of a file at the same time share one mapping
+    std::shared_ptr<storage::FileStorage> map() const;
+
+    /// read part of the file ahead of use, see FileCache::prefetch
+    void prefetch(size_t offset = 0, size_t length = 0) const;
+
 protected:
     /// when constructed, the file has already been created/written
     File(Metadata&& metadata, const std::string& filepath);
 
 private:
     friend class FileCache;
-    friend struct FilePointerComparator;
     friend class ::FileCacheTests;
 
     const Key _key;
@@ -174,6 +204,9 @@ private:
     bool _locked { false };
 
     bool _shouldPersist { false };
+
+    mutable std::mutex _mappingMutex;
+    mutable std::weak_ptr<storage::FileStorage> _mapping;
 };
 
 }
@@ -0,0 +1,235 @@
+//
+//  ChunkStoreTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ChunkStoreTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDirIterator>
+#include <QtCore/QTemporaryDir>
+
+#include <ChunkStore.h>
+
+QTEST_MAIN(ChunkStoreTests)
+
+static const int DATA_SIZE = 4 * 1024 * 1024;
+
+static QByteArray randomData(int size, unsigned int seed) {
+    std::mt19937 random(seed);
+    QByteArray data(size, 0);
+    for (auto& byte : data) {
+        byte = (char)random();
+    }
+    return data;
+}
+
+static AssetUtils::AssetHash hashOf(const QByteArray& data) {
+    return AssetUtils::hashData(data).toHex();
+}
+
+static int countChunkFiles(const QDir& chunksDirectory) {
+    int count = 0;
+    QDirIterator it(chunksDirectory.path(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        ++count;
+    }
+    return count;
+}
+
+void ChunkStoreTests::boundaryTest() {
+    auto data = randomData(DATA_SIZE, 1);
+
+    auto boundaries = ChunkStore::findChunkBoundaries(data);
+    QCOMPARE(ChunkStore::findChunkBoundaries(data), boundaries);
+    QVERIFY(boundaries.size() > 1);
+    QCOMPARE(boundaries.back(), DATA_SIZE);
+
+    int start = 0;
+    for (size_t i = 0; i < boundaries.size(); ++i) {
+        auto size = boundaries[i] - start;
+        QVERIFY(size <= ChunkStore::MAX_CHUNK_SIZE);
+        if (i + 1 < boundaries.size()) {
+            QVERIFY(size >= ChunkStore::MIN_CHUNK_SIZE);
+        }
+        start = boundaries[i];
+    }
+
+    // bytes inserted near the start shift the later cuts along with the content instead of moving them
+    const int INSERT_SIZE = 100;
+    auto edited = data;
+    edited.insert(1000, QByteArray(INSERT_SIZE, 'x'));
+
+    auto editedBoundaries = ChunkStore::findChunkBoundaries(edited);
+    size_t shifted = 0;
+    for (auto boundary : boundaries) {
+        if (std::find(editedBoundaries.begin(), editedBoundaries.end(), boundary + INSERT_SIZE) != editedBoundaries.end()) {
+            ++shifted;
+        }
+    }
+    QVERIFY(shifted >= boundaries.size() - 2);
+}
+
+void ChunkStoreTests::roundTripTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QDir files(directory.path());
+    QDir chunks(directory.filePath("chunks"));
+
+    auto data = randomData(DATA_SIZE, 2);
+    auto hash = hashOf(data);
+
+    {
+        ChunkStore store(files, chunks);
+        QVERIFY(store.load());
+        QVERIFY(!store.hasAsset(hash));
+        QCOMPARE(store.getAssetSize(hash), (qint64)-1);
+
+        QVERIFY(store.storeAsset(hash, data));
+        QVERIFY(store.hasAsset(hash));
+        QCOMPARE(store.getAssetSize(hash), (qint64)DATA_SIZE);
+    }
+
+    ChunkStore store(files, chunks);
+    QVERIFY(store.load());
+    auto stats = store.getStats();
+    QCOMPARE(stats.assets, (uint64_t)1);
+    QCOMPARE(stats.logicalBytes, (uint64_t)DATA_SIZE);
+    QCOMPARE(stats.storedBytes, (uint64_t)DATA_SIZE);
+    QCOMPARE(stats.uniqueChunks, (uint64_t)ChunkStore::findChunkBoundaries(data).size());
+
+    QByteArray read;
+    QVERIFY(store.readAsset(hash, read));
+    QCOMPARE(read, data);
+
+    // ranges inside one chunk and across several
+    auto firstBoundary = ChunkStore::findChunkBoundaries(data).front();
+    QVERIFY(store.readAsset(hash, read, 10, 100));
+    QCOMPARE(read, data.mid(10, 100));
+    QVERIFY(store.readAsset(hash, read, firstBoundary - 50, 3 * ChunkStore::MAX_CHUNK_SIZE));
+    QCOMPARE(read, data.mid(firstBoundary - 50, 3 * ChunkStore::MAX_CHUNK_SIZE));
+    QVERIFY(store.readAsset(hash, read, DATA_SIZE - 7));
+    QCOMPARE(read, data.right(7));
+
+    // only the bytes asked for are read from the chunks, but a read across chunks opens each of them
+    stats = store.getStats();
+    QCOMPARE(stats.chunkBytesRead, stats.bytesRequested);
+    QCOMPARE(stats.reads, (uint64_t)4);
+    QVERIFY(stats.chunksRead > stats.reads);
+
+    QVERIFY(!store.readAsset(hash, read, DATA_SIZE - 7, 8));
+    QVERIFY(!store.readAsset(hash, read, -1, 8));
+
+    // storing the same asset again adds nothing
+    QVERIFY(store.storeAsset(hash, data));
+    QCOMPARE(store.getStats().assets, (uint64_t)1);
+    QCOMPARE(store.getStats().storedBytes, (uint64_t)DATA_SIZE);
+}
+
+void ChunkStoreTests::removeTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QDir files(directory.path());
+    QDir chunks(directory.filePath("chunks"));
+
+    ChunkStore store(files, chunks);
+    QVERIFY(store.load());
+
+    // the second asset is the first with more on the end, so they share all but the last chunks
+    auto first = randomData(DATA_SIZE, 3);
+    auto second = first + randomData(DATA_SIZE / 4, 4);
+    auto firstHash = hashOf(first);
+    auto secondHash = hashOf(second);
+
+    QVERIFY(store.storeAsset(firstHash, first));
+    auto firstChunkFiles = countChunkFiles(chunks);
+    QVERIFY(store.storeAsset(secondHash, second));
+    auto bothChunkFiles = countChunkFiles(chunks);
+    QVERIFY(bothChunkFiles > firstChunkFiles);
+    QVERIFY(store.getStats().storedBytes < (uint64_t)(first.size() + second.size()));
+
+    QVERIFY(store.removeAsset(firstHash));
+    QVERIFY(!store.hasAsset(firstHash));
+    QVERIFY(countChunkFiles(chunks) < bothChunkFiles);
+
+    QByteArray read;
+    QVERIFY(store.readAsset(secondHash, read));
+    QCOMPARE(read, second);
+
+    QVERIFY(store.removeAsset(secondHash));
+    QCOMPARE(countChunkFiles(chunks), 0);
+
+    auto stats = store.getStats();
+    QCOMPARE(stats.assets, (uint64_t)0);
+    QCOMPARE(stats.uniqueChunks, (uint64_t)0);
+    QCOMPARE(stats.storedBytes, (uint64_t)0);
+    QCOMPARE(stats.logicalBytes, (uint64_t)0);
+}
+
+void ChunkStoreTests::truncatedRecipeTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QDir files(directory.path());
+    QDir chunks(directory.filePath("chunks"));
+
+    // a recipe header that says it lists a billion chunks, without any of them
+    const AssetUtils::AssetHash hash = hashOf("truncated");
+    QFile recipe(files.filePath(hash + ChunkStore::RECIPE_EXTENSION));
+    QVERIFY(recipe.open(QIODevice::WriteOnly));
+    QDataStream stream(&recipe);
+    stream << (quint32)0x48464352 << (quint32)1 << (qint64)1000 << (quint32)1000000000;
+    recipe.close();
+
+    ChunkStore store(files, chunks);
+    QVERIFY(store.load());
+    QCOMPARE(store.getStats().assets, (uint64_t)0);
+    QCOMPARE(store.getAssetSize(hash), (qint64)-1);
+
+    QByteArray read;
+    QVERIFY(!store.readAsset(hash, read));
+}
+
+void ChunkStoreTests::readWhileRemovingTest() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QDir files(directory.path());
+    QDir chunks(directory.filePath("chunks"));
+
+    ChunkStore store(files, chunks);
+    QVERIFY(store.load());
+
+    auto data = randomData(DATA_SIZE, 5);
+    auto hash = hashOf(data);
+    QVERIFY(store.storeAsset(hash, data));
+
+    // a read racing the removal gets either the whole asset or nothing, never part of it
+    std::atomic<bool> isRemoved { false };
+    std::atomic<int> partialReads { 0 };
+    std::thread reader([&] {
+        QByteArray read;
+        while (!isRemoved) {
+            if (store.readAsset(hash, read) && read != data) {
+                ++partialReads;
+            }
+        }
+    });
+
+    QThread::msleep(50);
+    QVERIFY(store.removeAsset(hash));
+    isRemoved = true;
+    reader.join();
+
+    QCOMPARE(partialReads.load(), 0);
+    QCOMPARE(countChunkFiles(chunks), 0);
+}
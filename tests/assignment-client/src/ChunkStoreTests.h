@@ -0,0 +1,37 @@
+//
+//  ChunkStoreTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ChunkStoreTests_h
+#define hifi_ChunkStoreTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ChunkStoreTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the same content is always cut the same way, and that an insert only moves the chunks around it
+    void boundaryTest();
+
+    // Test that stored assets read back whole and by range, from a freshly loaded store too
+    void roundTripTest();
+
+    // Test that a chunk shared by assets stays until the last asset using it is removed
+    void removeTest();
+
+    // Test that a recipe claiming more chunks than its file holds is refused
+    void truncatedRecipeTest();
+
+    // Test that removing an asset while it is being read doesn't take its chunks away from the read
+    void readWhileRemovingTest();
+};
+
+#endif // hifi_ChunkStoreTests_h
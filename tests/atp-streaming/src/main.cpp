@@ -0,0 +1,259 @@
+//
+//  main.cpp
+//  tests/atp-streaming/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Measures how soon the first usable bytes of a large asset arrive through AssetRequest, requesting it whole versus
+//  streaming it as pipelined ranges.
+//
+//  The test runs itself a second time as a stand-in asset-server: a NodeList of type AssetServer that answers
+//  AssetGetInfo and AssetGet the way AssetServer and SendAssetTask do, from an asset made of the same bytes in both
+//  processes. This process is an Agent with an AssetClient that has the other one as its asset-server, and times
+//  AssetRequests to it - when the first data could be handed to a decoder and when the whole asset was there. The
+//  link is emulated with HIFI_UDT_NETWORK_EMULATION: what the asset-server sends gets the given description, the
+//  requests only its latency.
+//
+//  usage: atp-streaming-test [asset size in MB] ["emulation description"]
+//
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QUuid>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <AssetClient.h>
+#include <AssetRequest.h>
+#include <AssetUtils.h>
+#include <ByteRange.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <ReceivedMessage.h>
+#include <udt/NetworkEmulator.h>
+
+static const QString ASSET_SERVER_OPTION = "--asset-server";
+static const QString NETWORK_EMULATION_ENV = "HIFI_UDT_NETWORK_EMULATION";
+static const QString PORT_PREFIX = "port ";
+
+struct TransferStats {
+    double firstDataMsecs { 0.0 };
+    double completeMsecs { 0.0 };
+    bool completed { false };
+};
+
+// the asset both processes agree on, distinct bytes so a range put in the wrong place fails the hash check
+QByteArray makeAsset(qint64 size) {
+    QByteArray data(size, 0);
+    for (qint64 i = 0; i < size; ++i) {
+        data[i] = (char)(i * 7 + i / 256);
+    }
+    return data;
+}
+
+void setUpNodeList(NodeType_t ownerType, const QUuid& sessionID) {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(ownerType, 0);
+    DependencyManager::get<NodeList>()->setSessionUUID(sessionID);
+}
+
+// there is no domain to introduce the two processes, so each adds the other itself, already activated
+void addPeer(const QUuid& peerID, NodeType_t peerType, quint16 port, const QUuid& connectionSecret) {
+    HifiSockAddr address(QHostAddress::LocalHost, port);
+    auto node = DependencyManager::get<NodeList>()->addOrUpdateNode(peerID, peerType, address, address,
+                                                                     false, false, connectionSecret);
+    node->activatePublicSocket();
+}
+
+class StandInAssetServer : public QObject {
+    Q_OBJECT
+public:
+    StandInAssetServer(qint64 assetSize) : _asset(makeAsset(assetSize)) {
+        auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+        packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
+        packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
+    }
+
+private slots:
+    void handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+        MessageID messageID;
+        message->readPrimitive(&messageID);
+        auto hash = message->read(AssetUtils::SHA256_HASH_LENGTH);
+
+        auto reply = NLPacket::create(PacketType::AssetGetInfoReply, -1, true);
+        reply->writePrimitive(messageID);
+        reply->write(hash);
+        reply->writePrimitive(AssetUtils::AssetServerError::NoError);
+        reply->writePrimitive((qint64)_asset.size());
+        DependencyManager::get<NodeList>()->sendPacket(std::move(reply), *senderNode);
+    }
+
+    void handleAssetGet(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+        MessageID messageID;
+        ByteRange byteRange;
+        message->readPrimitive(&messageID);
+        auto hash = message->read(AssetUtils::SHA256_HASH_LENGTH);
+        message->readPrimitive(&byteRange.fromInclusive);
+        message->readPrimitive(&byteRange.toExclusive);
+
+        auto reply = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+        reply->write(hash);
+        reply->writePrimitive(messageID);
+
+        byteRange.fixupRange(_asset.size());
+        if (!byteRange.isValid() || byteRange.fromInclusive < 0 || byteRange.toExclusive > _asset.size()) {
+            reply->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
+        } else {
+            reply->writePrimitive(AssetUtils::AssetServerError::NoError);
+            reply->writePrimitive(byteRange.size());
+            reply->write(_asset.constData() + byteRange.fromInclusive, byteRange.size());
+        }
+        DependencyManager::get<NodeList>()->sendPacketList(std::move(reply), *senderNode);
+    }
+
+private:
+    QByteArray _asset;
+};
+
+// atp-streaming-test --asset-server <asset size> <agent port> <agent ID> <asset-server ID> <connection secret>
+int runAssetServer(QCoreApplication& app, const QStringList& arguments) {
+    if (arguments.size() < 7) {
+        return -1;
+    }
+
+    qint64 assetSize = arguments[2].toLongLong();
+    quint16 agentPort = arguments[3].toUShort();
+    QUuid agentID(arguments[4]);
+    QUuid assetServerID(arguments[5]);
+    QUuid connectionSecret(arguments[6]);
+
+    setUpNodeList(NodeType::AssetServer, assetServerID);
+    addPeer(agentID, NodeType::Agent, agentPort, connectionSecret);
+    StandInAssetServer assetServer(assetSize);
+
+    // tell the agent where we are
+    printf("%s%d\n", qPrintable(PORT_PREFIX), DependencyManager::get<NodeList>()->getSocketLocalPort());
+    fflush(stdout);
+
+    return app.exec();
+}
+
+TransferStats runTransfer(const QString& hash, bool streaming) {
+    const qint64 TIMEOUT_MSECS = 120 * MSECS_PER_SECOND;
+
+    TransferStats stats;
+    bool isFinished = false;
+    bool hasData = false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto request = DependencyManager::get<AssetClient>()->createRequest(hash);
+    request->setStreaming(streaming);
+    QObject::connect(request, &AssetRequest::dataReceived, [&](QByteArray) {
+        if (!hasData) {
+            hasData = true;
+            stats.firstDataMsecs = (double)timer.nsecsElapsed() / NSECS_PER_MSEC;
+        }
+    });
+    QObject::connect(request, &AssetRequest::finished, [&](AssetRequest* finishedRequest) {
+        isFinished = true;
+        stats.completeMsecs = (double)timer.nsecsElapsed() / NSECS_PER_MSEC;
+        stats.completed = finishedRequest->getError() == AssetRequest::NoError;
+        if (!stats.completed) {
+            qDebug() << "The request failed:" << finishedRequest->getErrorString();
+        }
+        if (!hasData) {
+            // a whole asset is only usable once all of it is here
+            stats.firstDataMsecs = stats.completeMsecs;
+        }
+    });
+    request->start();
+
+    while (!isFinished && timer.elapsed() < TIMEOUT_MSECS) {
+        QCoreApplication::processEvents();
+    }
+
+    request->deleteLater();
+    return stats;
+}
+
+void printStats(const QString& name, const TransferStats& stats) {
+    qDebug().noquote() << QString("%1 first usable data %2 ms, whole asset %3 ms%4")
+        .arg(name, -10).arg(stats.firstDataMsecs, 9, 'f', 1).arg(stats.completeMsecs, 9, 'f', 1)
+        .arg(stats.completed ? "" : " - FAILED");
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    auto arguments = app.arguments();
+    if (arguments.size() > 1 && arguments[1] == ASSET_SERVER_OPTION) {
+        return runAssetServer(app, arguments);
+    }
+
+    qint64 assetSizeMB = argc > 1 ? atoi(argv[1]) : 16;
+    QString description = argc > 2 ? argv[2] : "bandwidth=50000000,queue=200,latency=40";
+
+    udt::NetworkEmulator::Settings settings;
+    if (assetSizeMB <= 0 || !udt::NetworkEmulator::Settings::fromString(description, settings)) {
+        qDebug() << "usage:" << argv[0] << "[asset size in MB] [\"emulation description\"]";
+        return -1;
+    }
+
+    auto assetSize = assetSizeMB * 1024 * 1024;
+    auto hash = AssetUtils::hashData(makeAsset(assetSize)).toHex();
+
+    QUuid agentID = QUuid::createUuid();
+    QUuid assetServerID = QUuid::createUuid();
+    QUuid connectionSecret = QUuid::createUuid();
+
+    // requests only see the latency, the sockets read the emulation from the environment when they are made
+    qputenv(qPrintable(NETWORK_EMULATION_ENV), qPrintable(QString("latency=%1").arg(settings.latency.count() / USECS_PER_MSEC)));
+    setUpNodeList(NodeType::Agent, agentID);
+    DependencyManager::set<AssetClient>();
+
+    QProcess assetServerProcess;
+    auto environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(NETWORK_EMULATION_ENV, description);
+    assetServerProcess.setProcessEnvironment(environment);
+    assetServerProcess.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    assetServerProcess.start(app.applicationFilePath(), {
+        ASSET_SERVER_OPTION, QString::number(assetSize),
+        QString::number(DependencyManager::get<NodeList>()->getSocketLocalPort()),
+        agentID.toString(), assetServerID.toString(), connectionSecret.toString()
+    });
+
+    QString portLine;
+    while (!portLine.startsWith(PORT_PREFIX) && assetServerProcess.waitForReadyRead()) {
+        portLine = assetServerProcess.readLine().trimmed();
+    }
+    if (!portLine.startsWith(PORT_PREFIX)) {
+        qDebug() << "The asset-server process did not start";
+        return -1;
+    }
+    addPeer(assetServerID, NodeType::AssetServer, portLine.mid(PORT_PREFIX.size()).toUShort(), connectionSecret);
+
+    qDebug().noquote() << QString("A %1 MB asset over \"%2\":").arg(assetSizeMB).arg(description);
+
+    printStats("whole", runTransfer(hash, false));
+    printStats("streamed", runTransfer(hash, true));
+
+    assetServerProcess.kill();
+    assetServerProcess.waitForFinished();
+
+    DependencyManager::destroy<AssetClient>();
+    DependencyManager::destroy<NodeList>();
+
+    return 0;
+}
+
+#include "main.moc"
@@ -0,0 +1,121 @@
+//
+//  MeshOptimizerTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshOptimizerTests.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include <MeshOptimizer.h>
+
+QTEST_MAIN(MeshOptimizerTests)
+
+static const int GRID_SIZE = 64;
+
+// a flat grid of GRID_SIZE x GRID_SIZE quads, with its triangles in a random order
+static void makeShuffledGrid(QVector<int>& indices, QVector<glm::vec3>& positions) {
+    for (int y = 0; y <= GRID_SIZE; ++y) {
+        for (int x = 0; x <= GRID_SIZE; ++x) {
+            positions.append(glm::vec3(x, y, 0.0f));
+        }
+    }
+
+    std::vector<std::array<int, 3>> triangles;
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            int corner = y * (GRID_SIZE + 1) + x;
+            triangles.push_back({ { corner, corner + 1, corner + GRID_SIZE + 1 } });
+            triangles.push_back({ { corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1 } });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(2018));
+
+    for (const auto& triangle : triangles) {
+        indices.append(triangle[0]);
+        indices.append(triangle[1]);
+        indices.append(triangle[2]);
+    }
+}
+
+// the triangles of a list, in a canonical order, to see the optimizations neither lose nor turn any
+static std::vector<std::array<int, 3>> sortedTriangles(const QVector<int>& indices) {
+    std::vector<std::array<int, 3>> triangles;
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<int, 3> triangle { { indices[i], indices[i + 1], indices[i + 2] } };
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+void MeshOptimizerTests::testAnalyzeVertexCache() {
+    // two triangles sharing an edge transform four vertices
+    auto stats = MeshOptimizer::analyzeVertexCache({ 0, 1, 2, 1, 3, 2 }, 4);
+    QCOMPARE(stats.triangles, 2);
+    QCOMPARE(stats.vertices, 4);
+    QCOMPARE(stats.misses, 4);
+    QCOMPARE(stats.getACMR(), 2.0f);
+    QCOMPARE(stats.getATVR(), 1.0f);
+
+    // with a cache of three, the first vertex is gone by the time it comes back
+    stats = MeshOptimizer::analyzeVertexCache({ 0, 1, 2, 3, 4, 0 }, 5, 3);
+    QCOMPARE(stats.vertices, 5);
+    QCOMPARE(stats.misses, 6);
+}
+
+void MeshOptimizerTests::testVertexCacheKeepsTriangles() {
+    QVector<int> indices;
+    QVector<glm::vec3> positions;
+    makeShuffledGrid(indices, positions);
+
+    auto optimized = MeshOptimizer::optimizeVertexCache(indices, positions.size());
+    QCOMPARE(optimized.size(), indices.size());
+    QVERIFY(sortedTriangles(optimized) == sortedTriangles(indices));
+}
+
+void MeshOptimizerTests::testVertexCacheLowersMisses() {
+    QVector<int> indices;
+    QVector<glm::vec3> positions;
+    makeShuffledGrid(indices, positions);
+
+    auto before = MeshOptimizer::analyzeVertexCache(indices, positions.size());
+    auto after = MeshOptimizer::analyzeVertexCache(MeshOptimizer::optimizeVertexCache(indices, positions.size()),
+                                                   positions.size());
+
+    // shuffled, nearly every vertex of every triangle is a miss; ordered, a grid needs not much more than one per quad
+    QVERIFY(before.getACMR() > 2.5f);
+    QVERIFY(after.getACMR() < 0.8f);
+    QVERIFY(after.getATVR() < 1.5f);
+}
+
+void MeshOptimizerTests::testOverdrawKeepsTriangles() {
+    QVector<int> indices;
+    QVector<glm::vec3> positions;
+    makeShuffledGrid(indices, positions);
+
+    auto cacheOptimized = MeshOptimizer::optimizeVertexCache(indices, positions.size());
+    auto optimized = MeshOptimizer::optimizeOverdraw(cacheOptimized, positions);
+    QCOMPARE(optimized.size(), indices.size());
+    QVERIFY(sortedTriangles(optimized) == sortedTriangles(indices));
+
+    // the clusters are broken up where the cache starts over, so the reordering costs few misses
+    auto cacheStats = MeshOptimizer::analyzeVertexCache(cacheOptimized, positions.size());
+    auto overdrawStats = MeshOptimizer::analyzeVertexCache(optimized, positions.size());
+    QVERIFY(overdrawStats.getACMR() < cacheStats.getACMR() * 1.1f);
+}
+
+void MeshOptimizerTests::testInvalidIndices() {
+    // indices outside the mesh are left for the caller to deal with
+    QVector<int> indices { 0, 1, 2, 2, 1, 5 };
+    QCOMPARE(MeshOptimizer::optimizeVertexCache(indices, 3), indices);
+    QCOMPARE(MeshOptimizer::optimizeOverdraw(indices, { glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(2.0f) }), indices);
+}
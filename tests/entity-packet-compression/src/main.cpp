@@ -0,0 +1,181 @@
+//
+//  main.cpp
+//  tests/entity-packet-compression/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Replays the initial scene download for a persisted entities file (a backup of a domain's models.json.gz, say)
+//  through each of the ways the entity server can compress the sections it sends, and reports the bytes on the wire
+//  and the CPU spent compressing and uncompressing for each.
+//
+//  usage: entity-packet-compression-test <entities file> [dictionary size in bytes] [link speed in Mbps]
+//
+
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <OctreeCompressionDictionary.h>
+#include <OctreePacketData.h>
+#include <SharedUtil.h>
+
+struct SectionStats {
+    QString mode;
+    int entities { 0 };
+    int sections { 0 };
+    int wirePackets { 0 };
+    quint64 uncompressedBytes { 0 };
+    quint64 wireBytes { 0 };
+    quint64 compressUsecs { 0 };
+    quint64 uncompressUsecs { 0 };
+    bool roundTripped { true };
+};
+
+// packs every entity into sections the way EntityTreeSendThread does, finalizing (compressing) each section once it's full
+SectionStats replayScene(const QString& mode, const QVector<EntityItemPointer>& entities, bool compressed,
+                         const OctreeCompressionDictionaryPointer& dictionary) {
+    SectionStats stats;
+    stats.mode = mode;
+
+    const int SECTION_TARGET_SIZE = MAX_OCTREE_PACKET_DATA_SIZE - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+
+    OctreePacketData packetData(compressed, SECTION_TARGET_SIZE);
+    packetData.setCompressionDictionary(dictionary);
+
+    OctreePacketData receivedData(compressed);
+    receivedData.setCompressionDictionary(dictionary);
+
+    int wirePacketBytesLeft = 0;
+
+    auto finalizeSection = [&] {
+        if (!packetData.hasContent()) {
+            return;
+        }
+
+        quint64 compressStart = usecTimestampNow();
+        int finalizedSize = packetData.getFinalizedSize();
+        const unsigned char* finalizedData = packetData.getFinalizedData();
+        stats.compressUsecs += usecTimestampNow() - compressStart;
+
+        int uncompressedSize = packetData.getUncompressedSize();
+
+        quint64 uncompressStart = usecTimestampNow();
+        receivedData.loadFinalizedContent(finalizedData, finalizedSize);
+        stats.uncompressUsecs += usecTimestampNow() - uncompressStart;
+
+        if (receivedData.getUncompressedSize() != uncompressedSize ||
+            memcmp(receivedData.getUncompressedData(), packetData.getUncompressedData(), uncompressedSize) != 0) {
+            stats.roundTripped = false;
+        }
+
+        // compressed sections share wire packets when they fit, uncompressed ones fill a packet each
+        int sectionWireBytes = finalizedSize + (int)sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+        if (sectionWireBytes > wirePacketBytesLeft) {
+            ++stats.wirePackets;
+            stats.wireBytes += NLPacket::MAX_PACKET_HEADER_SIZE + OCTREE_PACKET_EXTRA_HEADERS_SIZE;
+            wirePacketBytesLeft = MAX_OCTREE_PACKET_DATA_SIZE;
+        }
+        wirePacketBytesLeft -= sectionWireBytes;
+
+        ++stats.sections;
+        stats.uncompressedBytes += uncompressedSize;
+        stats.wireBytes += sectionWireBytes;
+
+        packetData.reset();
+    };
+
+    EncodeBitstreamParams params;
+    for (const auto& entity : entities) {
+        LevelDetails entityLevel = packetData.startLevel();
+        OctreeElement::AppendState appendState = entity->appendEntityData(&packetData, params, nullptr);
+
+        if (appendState != OctreeElement::COMPLETED) {
+            // didn't fit - send what we have and start this entity in a fresh section
+            packetData.discardLevel(entityLevel);
+            finalizeSection();
+
+            entityLevel = packetData.startLevel();
+            entity->appendEntityData(&packetData, params, nullptr);
+        }
+
+        packetData.endLevel(entityLevel);
+        ++stats.entities;
+    }
+    finalizeSection();
+
+    return stats;
+}
+
+void printStats(const SectionStats& stats, const SectionStats& baseline, float linkMbps, int extraBytes) {
+    quint64 wireBytes = stats.wireBytes + extraBytes;
+    float ratio = (float)wireBytes / (float)baseline.wireBytes;
+    float downloadSeconds = (float)wireBytes * BITS_IN_BYTE / (linkMbps * 1000.0f * 1000.0f);
+    float compressMBps = stats.compressUsecs > 0 ?
+        (float)stats.uncompressedBytes / (float)stats.compressUsecs : 0.0f; // bytes per usec is MB per second
+    float uncompressMBps = stats.uncompressUsecs > 0 ?
+        (float)stats.uncompressedBytes / (float)stats.uncompressUsecs : 0.0f;
+
+    qDebug().noquote() << QString("%1 %2 sections %3 packets %4 bytes (%5 of uncompressed) %6 s at %7 Mbps")
+        .arg(stats.mode, -24).arg(stats.sections, 7).arg(stats.wirePackets, 7).arg(wireBytes, 11)
+        .arg(QString::number(ratio * 100.0f, 'f', 1) + "%", 7)
+        .arg(downloadSeconds, 7, 'f', 2).arg(linkMbps);
+    qDebug().noquote() << QString("%1 compress %2 usecs (%3 MB/s)  uncompress %4 usecs (%5 MB/s)%6")
+        .arg("", -24).arg(stats.compressUsecs, 9).arg(compressMBps, 7, 'f', 1)
+        .arg(stats.uncompressUsecs, 9).arg(uncompressMBps, 7, 'f', 1)
+        .arg(stats.roundTripped ? "" : "  ROUND TRIP FAILED");
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    if (argc < 2) {
+        qDebug() << "usage:" << argv[0] << "<entities file> [dictionary size in bytes] [link speed in Mbps]";
+        return -1;
+    }
+
+    int dictionarySize = argc > 2 ? atoi(argv[2]) : OctreeCompressionDictionary::DEFAULT_DICTIONARY_SIZE;
+    float linkMbps = argc > 3 ? (float)atof(argv[3]) : 10.0f;
+
+    DependencyManager::set<NodeList>(NodeType::Unassigned);
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    if (!tree->readFromFile(argv[1])) {
+        qDebug() << "Unable to read entities from" << argv[1];
+        return -1;
+    }
+
+    QVector<EntityItemPointer> entities;
+    tree->withReadLock([&] {
+        tree->findEntities(AACube(glm::vec3(-HALF_TREE_SCALE), TREE_SCALE), entities);
+    });
+    qDebug() << "Replaying initial scene download of" << entities.size() << "entities from" << argv[1];
+
+    quint64 trainStart = usecTimestampNow();
+    auto dictionary = OctreeCompressionDictionary::train(tree->getCompressionDictionarySamples(), dictionarySize);
+    quint64 trainUsecs = usecTimestampNow() - trainStart;
+    if (dictionary) {
+        qDebug() << "Trained" << dictionary->getBytes().size() << "byte dictionary in" << trainUsecs << "usecs";
+    } else {
+        qDebug() << "Nothing in this scene worth putting in a dictionary";
+    }
+
+    SectionStats uncompressed = replayScene("uncompressed", entities, false, nullptr);
+    SectionStats perSection = replayScene("per-section zlib", entities, true, nullptr);
+
+    printStats(uncompressed, uncompressed, linkMbps, 0);
+    printStats(perSection, uncompressed, linkMbps, 0);
+
+    if (dictionary) {
+        // the client has to download the dictionary before the server can use it, so it counts against this mode
+        SectionStats withDictionary = replayScene("dictionary zlib", entities, true, dictionary);
+        printStats(withDictionary, uncompressed, linkMbps, dictionary->getBytes().size());
+    }
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+//
+//  main.cpp
+//  tests/fbx-parse/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Times how long FBXReader takes to read models, as the ModelCache loading thread does.
+//
+//  Each model is read from memory a number of times and we report the best time to parse it into FBXNodes (and how
+//  fast that went through the file) and the best time to extract the geometry from the nodes, with the meshes
+//  extracted on a single thread and on all of them. Without any models given, all those under the marketplace
+//  scripts that come with the source are read.
+//
+//  usage: fbx-parse-test [repeats] [fbx file or directory]...
+//
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QDebug>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+
+#include <tbb/task_arena.h>
+
+#include <FBXReader.h>
+#include <NumericalConstants.h>
+#include <TBBHelpers.h>
+
+static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+struct ParseStats {
+    qint64 bytes { 0 };
+    int meshes { 0 };
+    quint64 parseUsecs { std::numeric_limits<quint64>::max() };
+    quint64 serialExtractUsecs { std::numeric_limits<quint64>::max() };
+    quint64 parallelExtractUsecs { std::numeric_limits<quint64>::max() };
+};
+
+QStringList findModels(const QStringList& paths) {
+    QStringList models;
+    for (const auto& path : paths) {
+        if (QFileInfo(path).isDir()) {
+            QDirIterator it(path, { "*.fbx" }, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                models.append(it.next());
+            }
+        } else {
+            models.append(path);
+        }
+    }
+    std::sort(models.begin(), models.end());
+    return models;
+}
+
+FBXNode parse(const QByteArray& data) {
+    QBuffer buffer(const_cast<QByteArray*>(&data));
+    buffer.open(QIODevice::ReadOnly);
+    return FBXReader::parseFBX(&buffer);
+}
+
+// answers how many meshes were extracted
+int extract(const FBXNode& rootNode, const QString& url) {
+    FBXReader reader;
+    reader._rootNode = rootNode;
+    std::unique_ptr<FBXGeometry> geometry(reader.extractFBXGeometry({}, url));
+    return geometry->meshes.size();
+}
+
+bool measure(const QString& path, int repeats, ParseStats& stats) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Could not open" << path;
+        return false;
+    }
+    QByteArray data = file.readAll();
+    stats.bytes = data.size();
+
+    // the meshes are extracted in this arena to see how long they took one after the other
+    tbb::task_arena singleThread(1);
+    QElapsedTimer timer;
+
+    try {
+        for (int i = 0; i < repeats; ++i) {
+            timer.start();
+            FBXNode rootNode = parse(data);
+            stats.parseUsecs = std::min(stats.parseUsecs, (quint64)timer.nsecsElapsed() / NSECS_PER_USEC);
+
+            timer.start();
+            singleThread.execute([&] {
+                stats.meshes = extract(rootNode, path);
+            });
+            stats.serialExtractUsecs = std::min(stats.serialExtractUsecs, (quint64)timer.nsecsElapsed() / NSECS_PER_USEC);
+
+            timer.start();
+            stats.meshes = extract(rootNode, path);
+            stats.parallelExtractUsecs = std::min(stats.parallelExtractUsecs, (quint64)timer.nsecsElapsed() / NSECS_PER_USEC);
+        }
+    } catch (const QString& error) {
+        qDebug() << "Could not read" << path << "-" << error;
+        return false;
+    }
+
+    return true;
+}
+
+void printStats(const QString& name, const ParseStats& stats) {
+    double parseSeconds = (double)stats.parseUsecs / USECS_PER_SECOND;
+    double megabytesPerSecond = parseSeconds > 0.0 ? stats.bytes / BYTES_PER_MEGABYTE / parseSeconds : 0.0;
+
+    qDebug().noquote() << QString("%1 %2 MB %3 meshes: parse %4 ms (%5 MB/s), extract %6 ms on one thread, %7 ms on all")
+        .arg(name, -40).arg(stats.bytes / BYTES_PER_MEGABYTE, 7, 'f', 2).arg(stats.meshes, 4)
+        .arg((double)stats.parseUsecs / USECS_PER_MSEC, 8, 'f', 2).arg(megabytesPerSecond, 7, 'f', 1)
+        .arg((double)stats.serialExtractUsecs / USECS_PER_MSEC, 8, 'f', 2)
+        .arg((double)stats.parallelExtractUsecs / USECS_PER_MSEC, 8, 'f', 2);
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    int repeats = argc > 1 ? atoi(argv[1]) : 5;
+    if (repeats <= 0) {
+        qDebug() << "usage:" << argv[0] << "[repeats] [fbx file or directory]...";
+        return -1;
+    }
+
+    QStringList paths;
+    for (int i = 2; i < argc; ++i) {
+        paths.append(argv[i]);
+    }
+    if (paths.isEmpty()) {
+        paths.append(DEFAULT_MODELS_DIR);
+    }
+
+    auto models = findModels(paths);
+    if (models.isEmpty()) {
+        qDebug() << "No models found in" << paths;
+        return -1;
+    }
+
+    ParseStats total;
+    total.parseUsecs = total.serialExtractUsecs = total.parallelExtractUsecs = 0;
+    for (const auto& model : models) {
+        ParseStats stats;
+        if (!measure(model, repeats, stats)) {
+            continue;
+        }
+        printStats(QFileInfo(model).fileName(), stats);
+
+        total.bytes += stats.bytes;
+        total.meshes += stats.meshes;
+        total.parseUsecs += stats.parseUsecs;
+        total.serialExtractUsecs += stats.serialExtractUsecs;
+        total.parallelExtractUsecs += stats.parallelExtractUsecs;
+    }
+    printStats(QString("all %1 models").arg(models.size()), total);
+
+    return 0;
+}
@@ -0,0 +1,232 @@
+//
+//  GLTFReaderTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "GLTFReaderTests.h"
+
+#include <memory>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <GLTFReader.h>
+
+QTEST_MAIN(GLTFReaderTests)
+
+static const QVector<glm::vec3> TRIANGLE { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+static const QVector<int> TRIANGLE_INDICES { 0, 1, 2 };
+
+// builds the buffer of a test model out of the values of each view
+class BufferBuilder {
+public:
+    template<typename T>
+    void append(const QVector<T>& values) {
+        _data.append(reinterpret_cast<const char*>(values.constData()), values.size() * (int)sizeof(T));
+        // views start on 4 byte boundaries
+        while (_data.size() % 4 != 0) {
+            _data.append('\0');
+        }
+    }
+
+    // adds a view of everything appended since the last one
+    QJsonObject view(int byteStride = 0) {
+        QJsonObject view {
+            { "buffer", 0 },
+            { "byteOffset", _viewStart },
+            { "byteLength", _data.size() - _viewStart }
+        };
+        if (byteStride > 0) {
+            view["byteStride"] = byteStride;
+        }
+        _viewStart = _data.size();
+        return view;
+    }
+
+    const QByteArray& data() const { return _data; }
+
+private:
+    QByteArray _data;
+    int _viewStart { 0 };
+};
+
+static QJsonObject accessor(int bufferView, int byteOffset, int componentType, int count, const QString& type) {
+    QJsonObject accessor {
+        { "byteOffset", byteOffset },
+        { "componentType", componentType },
+        { "count", count },
+        { "type", type }
+    };
+    if (bufferView >= 0) {
+        accessor["bufferView"] = bufferView;
+    }
+    return accessor;
+}
+
+static QJsonObject primitive(int position, int normal = -1, int indices = -1) {
+    QJsonObject attributes { { "POSITION", position } };
+    if (normal >= 0) {
+        attributes["NORMAL"] = normal;
+    }
+    QJsonObject primitive { { "attributes", attributes } };
+    if (indices >= 0) {
+        primitive["indices"] = indices;
+    }
+    return primitive;
+}
+
+// a binary glTF of a single node with a mesh of the primitives
+static QByteArray makeGLB(const QJsonArray& bufferViews, const QJsonArray& accessors, const QJsonArray& primitives,
+                          const QByteArray& buffer) {
+    QJsonObject document {
+        { "asset", QJsonObject { { "version", "2.0" } } },
+        { "buffers", QJsonArray { QJsonObject { { "byteLength", buffer.size() } } } },
+        { "bufferViews", bufferViews },
+        { "accessors", accessors },
+        { "meshes", QJsonArray { QJsonObject { { "primitives", primitives } } } },
+        { "nodes", QJsonArray { QJsonObject { { "mesh", 0 } } } },
+        { "scenes", QJsonArray { QJsonObject { { "nodes", QJsonArray { 0 } } } } },
+        { "scene", 0 }
+    };
+
+    QByteArray json = QJsonDocument(document).toJson(QJsonDocument::Compact);
+    while (json.size() % 4 != 0) {
+        json.append(' ');
+    }
+
+    QByteArray glb;
+    QDataStream stream(&glb, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << (quint32)0x46546C67 << (quint32)2 << (quint32)(12 + 8 + json.size() + 8 + buffer.size());
+    stream << (quint32)json.size() << (quint32)0x4E4F534A;
+    stream.writeRawData(json.constData(), json.size());
+    stream << (quint32)buffer.size() << (quint32)0x004E4942;
+    stream.writeRawData(buffer.constData(), buffer.size());
+    return glb;
+}
+
+static std::unique_ptr<FBXGeometry> readGLB(QByteArray glb) {
+    GLTFReader reader;
+    return std::unique_ptr<FBXGeometry>(reader.readGLTF(glb, QVariantHash(), QUrl("file:///test.glb")));
+}
+
+void GLTFReaderTests::glbParseTest() {
+    BufferBuilder buffer;
+    buffer.append(TRIANGLE);
+    auto positionView = buffer.view();
+    buffer.append(QVector<quint32> { 0, 1, 2 });
+    auto indexView = buffer.view();
+
+    auto geometry = readGLB(makeGLB({ positionView, indexView }, {
+        accessor(0, 0, GLTFAccessorComponentType::FLOAT, 3, "VEC3"),
+        accessor(1, 0, GLTFAccessorComponentType::UNSIGNED_INT, 3, "SCALAR")
+    }, { primitive(0, -1, 1) }, buffer.data()));
+
+    QCOMPARE(geometry->meshes.size(), 1);
+    QVERIFY(geometry->meshes[0].vertices == TRIANGLE);
+    QCOMPARE(geometry->meshes[0].parts.size(), 1);
+    QCOMPARE(geometry->meshes[0].parts[0].triangleIndices, TRIANGLE_INDICES);
+}
+
+void GLTFReaderTests::strideTest() {
+    // each vertex is its position then its normal
+    const QVector<glm::vec3> NORMALS { { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+    QVector<glm::vec3> interleaved;
+    for (int i = 0; i < TRIANGLE.size(); ++i) {
+        interleaved << TRIANGLE[i] << NORMALS[i];
+    }
+
+    BufferBuilder buffer;
+    buffer.append(interleaved);
+    auto vertexView = buffer.view(2 * sizeof(glm::vec3));
+
+    auto geometry = readGLB(makeGLB({ vertexView }, {
+        accessor(0, 0, GLTFAccessorComponentType::FLOAT, 3, "VEC3"),
+        accessor(0, sizeof(glm::vec3), GLTFAccessorComponentType::FLOAT, 3, "VEC3")
+    }, { primitive(0, 1) }, buffer.data()));
+
+    QCOMPARE(geometry->meshes.size(), 1);
+    QVERIFY(geometry->meshes[0].vertices == TRIANGLE);
+    QVERIFY(geometry->meshes[0].normals == NORMALS);
+    // without indices the vertices are drawn in order
+    QCOMPARE(geometry->meshes[0].parts[0].triangleIndices, TRIANGLE_INDICES);
+}
+
+void GLTFReaderTests::sparseTest() {
+    const glm::vec3 MOVED { 5.0f, 6.0f, 7.0f };
+
+    BufferBuilder buffer;
+    buffer.append(TRIANGLE);
+    auto positionView = buffer.view();
+    buffer.append(QVector<quint16> { 1 });
+    auto sparseIndexView = buffer.view();
+    buffer.append(QVector<glm::vec3> { MOVED });
+    auto sparseValueView = buffer.view();
+
+    QJsonObject sparse {
+        { "count", 1 },
+        { "indices", QJsonObject { { "bufferView", 1 }, { "componentType", GLTFAccessorComponentType::UNSIGNED_SHORT } } },
+        { "values", QJsonObject { { "bufferView", 2 } } }
+    };
+    auto overView = accessor(0, 0, GLTFAccessorComponentType::FLOAT, 3, "VEC3");
+    overView["sparse"] = sparse;
+    auto overZeros = accessor(-1, 0, GLTFAccessorComponentType::FLOAT, 3, "VEC3");
+    overZeros["sparse"] = sparse;
+
+    auto geometry = readGLB(makeGLB({ positionView, sparseIndexView, sparseValueView }, { overView, overZeros },
+                                    { primitive(0), primitive(1) }, buffer.data()));
+
+    QCOMPARE(geometry->meshes.size(), 2);
+    auto expected = TRIANGLE;
+    expected[1] = MOVED;
+    QVERIFY(geometry->meshes[0].vertices == expected);
+    QVERIFY(geometry->meshes[1].vertices == (QVector<glm::vec3> { glm::vec3(0.0f), MOVED, glm::vec3(0.0f) }));
+}
+
+void GLTFReaderTests::indexWideningTest() {
+    // indices past what a signed byte could hold
+    const QVector<int> INDICES { 0, 200, 2, 1, 255, 0 };
+    QVector<glm::vec3> positions(256, glm::vec3(1.0f));
+
+    BufferBuilder buffer;
+    buffer.append(positions);
+    auto positionView = buffer.view();
+    buffer.append(QVector<quint8> { 0, 200, 2, 1, 255, 0 });
+    auto byteView = buffer.view();
+    buffer.append(QVector<quint16> { 0, 200, 2, 1, 255, 0 });
+    auto shortView = buffer.view();
+
+    auto geometry = readGLB(makeGLB({ positionView, byteView, shortView }, {
+        accessor(0, 0, GLTFAccessorComponentType::FLOAT, positions.size(), "VEC3"),
+        accessor(1, 0, GLTFAccessorComponentType::UNSIGNED_BYTE, INDICES.size(), "SCALAR"),
+        accessor(2, 0, GLTFAccessorComponentType::UNSIGNED_SHORT, INDICES.size(), "SCALAR")
+    }, { primitive(0, -1, 1), primitive(0, -1, 2) }, buffer.data()));
+
+    QCOMPARE(geometry->meshes.size(), 2);
+    QCOMPARE(geometry->meshes[0].parts[0].triangleIndices, INDICES);
+    QCOMPARE(geometry->meshes[1].parts[0].triangleIndices, INDICES);
+}
+
+void GLTFReaderTests::invalidAccessorTest() {
+    BufferBuilder buffer;
+    buffer.append(TRIANGLE);
+    auto positionView = buffer.view();
+
+    // the first primitive asks for more vertices than the view holds, the second is fine
+    auto geometry = readGLB(makeGLB({ positionView }, {
+        accessor(0, 0, GLTFAccessorComponentType::FLOAT, 1000, "VEC3"),
+        accessor(0, 0, GLTFAccessorComponentType::FLOAT, 3, "VEC3"),
+        accessor(5, 0, GLTFAccessorComponentType::UNSIGNED_INT, 3, "SCALAR")
+    }, { primitive(0), primitive(1), primitive(1, -1, 2) }, buffer.data()));
+
+    QCOMPARE(geometry->meshes.size(), 1);
+    QVERIFY(geometry->meshes[0].vertices == TRIANGLE);
+    QCOMPARE(geometry->meshes[0].parts[0].triangleIndices, TRIANGLE_INDICES);
+}
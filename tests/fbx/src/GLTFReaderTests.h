@@ -0,0 +1,37 @@
+//
+//  GLTFReaderTests.h
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_GLTFReaderTests_h
+#define hifi_GLTFReaderTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class GLTFReaderTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test reading the mesh of a binary glTF from its binary chunk
+    void glbParseTest();
+
+    // Test reading attributes interleaved in one buffer view
+    void strideTest();
+
+    // Test sparse accessors, over a buffer view and over zeros
+    void sparseTest();
+
+    // Test that 8 and 16 bit indices are widened
+    void indexWideningTest();
+
+    // Test that a primitive with an accessor past the end of its buffer view is skipped
+    void invalidAccessorTest();
+};
+
+#endif // hifi_GLTFReaderTests_h
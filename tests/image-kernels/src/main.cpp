@@ -0,0 +1,168 @@
+//
+//  main.cpp
+//  tests/image-kernels/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Times the pixel conversions textures are processed with, in each of the versions this CPU can run.
+//
+//  Every version converts the same made up 2048x2048 image a number of times and we report the best time it took
+//  (and how many pixels a second that makes), after checking it gave the same pixels as the reference version.
+//
+//  usage: image-kernels-test [repeats]
+//
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <NumericalConstants.h>
+
+#include <image/ImageKernels.h>
+
+using namespace image;
+
+static const int IMAGE_SIZE = 2048;
+static const size_t PIXEL_COUNT = IMAGE_SIZE * IMAGE_SIZE;
+
+struct TestImages {
+    std::vector<float> rgb;
+    std::vector<uint32_t> argb;
+    // the rows of a grayscale image, each with its edge pixels repeated on both sides
+    std::vector<uint8_t> paddedGray;
+};
+
+TestImages makeImages() {
+    std::mt19937 random(0);
+    std::uniform_int_distribution<uint32_t> bits;
+    std::uniform_real_distribution<float> color(0.0f, 4.0f);
+
+    TestImages images;
+    images.rgb.resize(PIXEL_COUNT * 3);
+    for (auto& value : images.rgb) {
+        value = color(random);
+    }
+    // and the values the packing treats specially, in every channel and lane: NaNs, negatives, the ones below
+    // R11G11B10F's smallest (6.10e-5) that become 0 and the ones above its largest (6.5e4) that are clamped
+    const float SPECIAL_VALUES[] = {
+        std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::quiet_NaN(),
+        -1.0f, -0.0f, -std::numeric_limits<float>::infinity(), 0.0f, 1.0e-5f, 6.09e-5f, 6.10e-5f,
+        6.5e4f, 6.6e4f, 1.0e6f, std::numeric_limits<float>::max(), std::numeric_limits<float>::infinity()
+    };
+    const size_t SPECIAL_VALUE_COUNT = sizeof(SPECIAL_VALUES) / sizeof(SPECIAL_VALUES[0]);
+    for (size_t i = 0; i < images.rgb.size(); i += 1 + random() % 7) {
+        images.rgb[i] = SPECIAL_VALUES[random() % SPECIAL_VALUE_COUNT];
+    }
+    images.argb.resize(PIXEL_COUNT);
+    for (auto& pixel : images.argb) {
+        pixel = bits(random);
+    }
+
+    const int paddedWidth = IMAGE_SIZE + 2;
+    images.paddedGray.resize(paddedWidth * IMAGE_SIZE);
+    for (int y = 0; y < IMAGE_SIZE; ++y) {
+        uint8_t* row = &images.paddedGray[y * paddedWidth];
+        for (int x = 1; x <= IMAGE_SIZE; ++x) {
+            row[x] = (uint8_t)bits(random);
+        }
+        row[0] = row[1];
+        row[paddedWidth - 1] = row[paddedWidth - 2];
+    }
+    return images;
+}
+
+void convertBumpMap(const kernels::Implementation& implementation, const TestImages& images, uint32_t* normals) {
+    const int paddedWidth = IMAGE_SIZE + 2;
+    for (int y = 0; y < IMAGE_SIZE; ++y) {
+        const uint8_t* above = &images.paddedGray[std::max(y - 1, 0) * paddedWidth + 1];
+        const uint8_t* row = &images.paddedGray[y * paddedWidth + 1];
+        const uint8_t* below = &images.paddedGray[std::min(y + 1, IMAGE_SIZE - 1) * paddedWidth + 1];
+        implementation.convertBumpToNormals(above, row, below, &normals[y * IMAGE_SIZE], IMAGE_SIZE);
+    }
+}
+
+// answers the best time of a number of runs, in microseconds
+quint64 measure(int repeats, const std::function<void()>& run) {
+    quint64 bestUsecs = std::numeric_limits<quint64>::max();
+    QElapsedTimer timer;
+    for (int i = 0; i < repeats; ++i) {
+        timer.start();
+        run();
+        bestUsecs = std::min(bestUsecs, (quint64)timer.nsecsElapsed() / NSECS_PER_USEC);
+    }
+    return bestUsecs;
+}
+
+void printStats(const QString& name, quint64 usecs) {
+    double seconds = (double)usecs / USECS_PER_SECOND;
+    double megapixelsPerSecond = seconds > 0.0 ? PIXEL_COUNT / 1.0e6 / seconds : 0.0;
+
+    qDebug().noquote() << QString("%1 %2 ms (%3 Mpixels/s)")
+        .arg(name, -40).arg((double)usecs / USECS_PER_MSEC, 8, 'f', 2).arg(megapixelsPerSecond, 8, 'f', 1);
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    int repeats = argc > 1 ? atoi(argv[1]) : 10;
+    if (repeats <= 0) {
+        qDebug() << "usage:" << argv[0] << "[repeats]";
+        return -1;
+    }
+
+    const TestImages images = makeImages();
+    const auto implementations = kernels::getImplementations();
+    const auto& reference = implementations.front();
+
+    std::vector<uint32_t> expectedPacked(PIXEL_COUNT);
+    std::vector<uint32_t> expectedConverted(PIXEL_COUNT);
+    std::vector<uint32_t> expectedNormals(PIXEL_COUNT);
+    reference.packR11G11B10F(images.rgb.data(), expectedPacked.data(), PIXEL_COUNT);
+    reference.convertSRGBToR11G11B10F(images.argb.data(), expectedConverted.data(), PIXEL_COUNT);
+    convertBumpMap(reference, images, expectedNormals.data());
+
+    std::vector<uint32_t> output(PIXEL_COUNT);
+    for (const auto& implementation : implementations) {
+        const QString name = implementation.name;
+
+        implementation.packR11G11B10F(images.rgb.data(), output.data(), PIXEL_COUNT);
+        bool isMatching = output == expectedPacked;
+        implementation.convertSRGBToR11G11B10F(images.argb.data(), output.data(), PIXEL_COUNT);
+        isMatching = isMatching && output == expectedConverted;
+        convertBumpMap(implementation, images, output.data());
+        isMatching = isMatching && output == expectedNormals;
+        output = images.argb;
+        implementation.invertPixels(output.data(), PIXEL_COUNT);
+        for (size_t i = 0; isMatching && i < PIXEL_COUNT; ++i) {
+            isMatching = output[i] == ~images.argb[i];
+        }
+        if (!isMatching) {
+            qDebug() << "The" << name << "version does not give the same pixels as the reference";
+            return -1;
+        }
+
+        printStats(name + " packR11G11B10F", measure(repeats, [&] {
+            implementation.packR11G11B10F(images.rgb.data(), output.data(), PIXEL_COUNT);
+        }));
+        printStats(name + " convertSRGBToR11G11B10F", measure(repeats, [&] {
+            implementation.convertSRGBToR11G11B10F(images.argb.data(), output.data(), PIXEL_COUNT);
+        }));
+        printStats(name + " convertBumpToNormals", measure(repeats, [&] {
+            convertBumpMap(implementation, images, output.data());
+        }));
+        printStats(name + " invertPixels", measure(repeats, [&] {
+            implementation.invertPixels(output.data(), PIXEL_COUNT);
+        }));
+    }
+
+    return 0;
+}
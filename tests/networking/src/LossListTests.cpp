@@ -0,0 +1,210 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <vector>
+
+#include <udt/ControlPacket.h>
+#include <udt/LossList.h>
+
+using namespace udt;
+
+QTEST_MAIN(LossListTests)
+
+using Ranges = std::vector<std::pair<int, int>>;
+
+static SequenceNumber seq(int value) {
+    return SequenceNumber(value);
+}
+
+// the ranges of the list, read back from the NAK it writes
+static Ranges rangesOf(LossList& lossList) {
+    auto packet = ControlPacket::create(ControlPacket::NAK);
+    lossList.write(*packet);
+    packet->seek(0);
+
+    Ranges ranges;
+    while (packet->bytesLeftToRead() >= (qint64)(2 * sizeof(SequenceNumber))) {
+        SequenceNumber first, last;
+        packet->readPrimitive(&first);
+        packet->readPrimitive(&last);
+        ranges.emplace_back((SequenceNumber::Type)first, (SequenceNumber::Type)last);
+    }
+    return ranges;
+}
+
+void LossListTests::insertMergeTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(12));
+    lossList.append(seq(13));
+    lossList.append(seq(20), seq(22));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 10, 13 }, { 20, 22 } }));
+    QCOMPARE(lossList.getLength(), 7);
+
+    // before, between and after the ranges, touching none
+    lossList.insert(seq(1), seq(2));
+    lossList.insert(seq(16), seq(17));
+    lossList.insert(seq(30), seq(30));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 1, 2 }, { 10, 13 }, { 16, 17 }, { 20, 22 }, { 30, 30 } }));
+    QCOMPARE(lossList.getLength(), 12);
+
+    // right after one range and right before the next
+    lossList.insert(seq(14), seq(15));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 1, 2 }, { 10, 17 }, { 20, 22 }, { 30, 30 } }));
+    lossList.insert(seq(3), seq(3));
+    lossList.insert(seq(29), seq(29));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 1, 3 }, { 10, 17 }, { 20, 22 }, { 29, 30 } }));
+    QCOMPARE(lossList.getLength(), 16);
+
+    // overlapping the end of one range, all of the next and the start of the one after
+    lossList.insert(seq(15), seq(29));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 1, 3 }, { 10, 30 } }));
+    QCOMPARE(lossList.getLength(), 24);
+
+    // already in the list
+    lossList.insert(seq(12), seq(20));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 1, 3 }, { 10, 30 } }));
+    QCOMPARE(lossList.getLength(), 24);
+
+    // covering everything
+    lossList.insert(seq(0), seq(40));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 0, 40 } }));
+    QCOMPARE(lossList.getLength(), 41);
+}
+
+void LossListTests::removeTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(20));
+    lossList.append(seq(30), seq(40));
+    lossList.append(seq(50), seq(60));
+
+    QVERIFY(!lossList.remove(seq(25)));
+    QVERIFY(lossList.remove(seq(10)));
+    QVERIFY(lossList.remove(seq(20)));
+    QVERIFY(lossList.remove(seq(15)));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 11, 14 }, { 16, 19 }, { 30, 40 }, { 50, 60 } }));
+    QCOMPARE(lossList.getLength(), 30);
+
+    // from the middle of a range, splitting it
+    lossList.remove(seq(33), seq(36));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 11, 14 }, { 16, 19 }, { 30, 32 }, { 37, 40 }, { 50, 60 } }));
+    QCOMPARE(lossList.getLength(), 26);
+
+    // the end of one range, the whole of the next ones and the start of another
+    lossList.remove(seq(13), seq(52));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 11, 12 }, { 53, 60 } }));
+    QCOMPARE(lossList.getLength(), 10);
+
+    // only between ranges
+    lossList.remove(seq(20), seq(40));
+    QCOMPARE(lossList.getLength(), 10);
+
+    lossList.remove(seq(0), seq(100));
+    QVERIFY(lossList.isEmpty());
+    QVERIFY(rangesOf(lossList).empty());
+}
+
+void LossListTests::popFirstSequenceNumberTest() {
+    LossList lossList;
+    lossList.append(seq(5), seq(6));
+    lossList.append(seq(9));
+    lossList.insert(seq(1), seq(1));
+
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(1));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(1));
+
+    // from the front of a range, leaving the rest of it
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(5));
+    QCOMPARE(rangesOf(lossList), (Ranges { { 6, 6 }, { 9, 9 } }));
+    QCOMPARE(lossList.getLength(), 2);
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(6));
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(9));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(9));
+    QVERIFY(lossList.isEmpty());
+
+    // and it can be filled again once empty
+    lossList.append(seq(20));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(20));
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::growWrappedTest() {
+    LossList lossList;
+    Ranges expected;
+
+    // ten ranges, then drop the first six so the head of the ring moves along
+    for (int i = 0; i < 10; ++i) {
+        lossList.append(seq(i * 10), seq(i * 10 + 1));
+        expected.emplace_back(i * 10, i * 10 + 1);
+    }
+    lossList.remove(seq(0), seq(55));
+    expected.erase(expected.begin(), expected.begin() + 6);
+    QCOMPARE(rangesOf(lossList), expected);
+
+    // fill the ring past its end and back round to where it starts, then grow it
+    for (int i = 10; i < 40; ++i) {
+        lossList.append(seq(i * 10), seq(i * 10 + 1));
+        expected.emplace_back(i * 10, i * 10 + 1);
+        QCOMPARE(rangesOf(lossList), expected);
+    }
+
+    // inserting near the front moves the head back past the start of the ring
+    lossList.insert(seq(0), seq(0));
+    lossList.insert(seq(20), seq(20));
+    expected.insert(expected.begin(), { { 0, 0 }, { 20, 20 } });
+    QCOMPARE(rangesOf(lossList), expected);
+    QCOMPARE(lossList.getLength(), 2 + 2 * 34);
+
+    // and erasing near the back shifts the ones after
+    lossList.remove(seq(380), seq(385));
+    expected.erase(expected.end() - 2);
+    QCOMPARE(rangesOf(lossList), expected);
+
+    for (const auto& range : expected) {
+        for (int value = range.first; value <= range.second; ++value) {
+            QCOMPARE(lossList.popFirstSequenceNumber(), seq(value));
+        }
+    }
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::sequenceNumberWrapTest() {
+    const int MAX = SequenceNumber::MAX;
+
+    LossList lossList;
+    lossList.append(seq(MAX - 3), seq(MAX - 1));
+    lossList.append(seq(MAX));
+    lossList.append(seq(0), seq(2));
+    QCOMPARE(rangesOf(lossList), (Ranges { { MAX - 3, 2 } }));
+    QCOMPARE(lossList.getLength(), 7);
+
+    // splitting it either side of zero
+    QVERIFY(lossList.remove(seq(0)));
+    QCOMPARE(rangesOf(lossList), (Ranges { { MAX - 3, MAX }, { 1, 2 } }));
+    lossList.remove(seq(MAX - 1), seq(MAX));
+    QCOMPARE(rangesOf(lossList), (Ranges { { MAX - 3, MAX - 2 }, { 1, 2 } }));
+    QCOMPARE(lossList.getLength(), 4);
+
+    // and joining it back up across zero
+    lossList.insert(seq(MAX), seq(0));
+    QCOMPARE(rangesOf(lossList), (Ranges { { MAX - 3, MAX - 2 }, { MAX, 2 } }));
+    lossList.insert(seq(MAX - 1), seq(MAX - 1));
+    QCOMPARE(rangesOf(lossList), (Ranges { { MAX - 3, 2 } }));
+    QCOMPARE(lossList.getLength(), 7);
+
+    lossList.remove(seq(MAX - 2), seq(1));
+    QCOMPARE(rangesOf(lossList), (Ranges { { MAX - 3, MAX - 3 }, { 2, 2 } }));
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(MAX - 3));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(2));
+    QVERIFY(lossList.isEmpty());
+}
@@ -0,0 +1,37 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that appended and inserted ranges merge with the ones they overlap or touch
+    void insertMergeTest();
+
+    // Test removing single sequence numbers and ranges, including from the middle of a range
+    void removeTest();
+
+    // Test taking sequence numbers off the front, one at a time
+    void popFirstSequenceNumberTest();
+
+    // Test that the ranges stay in order when the ring grows while it wraps around its end
+    void growWrappedTest();
+
+    // Test ranges that run past the largest sequence number and back to zero
+    void sequenceNumberWrapTest();
+};
+
+#endif // hifi_LossListTests_h
@@ -0,0 +1,255 @@
+//
+//  NetworkEmulatorTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkEmulatorTests.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <udt/NetworkEmulator.h>
+
+using namespace udt;
+using namespace std::chrono;
+
+QTEST_MAIN(NetworkEmulatorTests)
+
+using Clock = steady_clock;
+
+// collects what the emulator writes, each datagram carries the index it was submitted with
+struct Collector {
+    struct Arrival {
+        int index;
+        Clock::time_point time;
+    };
+
+    NetworkEmulator::DatagramWriter writer() {
+        return [this](const QByteArray& datagram, const HifiSockAddr&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            arrivals.push_back({ *reinterpret_cast<const int*>(datagram.constData()), Clock::now() });
+        };
+    }
+
+    std::vector<Arrival> take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return arrivals;
+    }
+
+    std::mutex mutex;
+    std::vector<Arrival> arrivals;
+};
+
+static void submitIndices(NetworkEmulator& emulator, int count, int size = sizeof(int)) {
+    QByteArray datagram(size, 0);
+    for (int i = 0; i < count; ++i) {
+        memcpy(datagram.data(), &i, sizeof(int));
+        emulator.submit(datagram.constData(), datagram.size(), HifiSockAddr());
+    }
+}
+
+// waits until the emulator has written everything it is going to
+static NetworkEmulator::Stats waitForDelivery(NetworkEmulator& emulator) {
+    const auto TIMEOUT = seconds(5);
+    auto start = Clock::now();
+
+    while (Clock::now() - start < TIMEOUT) {
+        auto stats = emulator.getStats();
+        auto expected = stats.submitted + stats.duplicated - stats.randomlyLost - stats.burstLost - stats.queueDropped;
+        if (stats.delivered == expected) {
+            return stats;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    return emulator.getStats();
+}
+
+void NetworkEmulatorTests::passThroughTest() {
+    const int COUNT = 1000;
+
+    Collector collector;
+    NetworkEmulator emulator(NetworkEmulator::Settings(), collector.writer());
+
+    submitIndices(emulator, COUNT);
+    auto stats = waitForDelivery(emulator);
+
+    QCOMPARE(stats.delivered, (uint64_t)COUNT);
+
+    auto arrivals = collector.take();
+    QCOMPARE((int)arrivals.size(), COUNT);
+    for (int i = 0; i < COUNT; ++i) {
+        QCOMPARE(arrivals[i].index, i);
+    }
+}
+
+void NetworkEmulatorTests::lossTest() {
+    const int COUNT = 20000;
+    const double LOSS_RATE = 0.1;
+
+    NetworkEmulator::Settings settings;
+    settings.lossRate = LOSS_RATE;
+
+    Collector collector;
+    NetworkEmulator emulator(settings, collector.writer());
+
+    submitIndices(emulator, COUNT);
+    auto stats = waitForDelivery(emulator);
+
+    double lostShare = (double)stats.randomlyLost / COUNT;
+    QVERIFY(lostShare > LOSS_RATE - 0.01 && lostShare < LOSS_RATE + 0.01);
+    QCOMPARE((uint64_t)collector.take().size(), stats.delivered);
+}
+
+void NetworkEmulatorTests::burstLossTest() {
+    const int COUNT = 20000;
+
+    NetworkEmulator::Settings settings;
+    settings.burstEnterRate = 0.02;
+    settings.burstExitRate = 0.25;
+    settings.burstLossRate = 1.0;
+
+    Collector collector;
+    NetworkEmulator emulator(settings, collector.writer());
+
+    submitIndices(emulator, COUNT);
+    auto stats = waitForDelivery(emulator);
+    QVERIFY(stats.burstLost > 0);
+    QCOMPARE(stats.randomlyLost, (uint64_t)0);
+
+    // count the runs of missing indices
+    auto arrivals = collector.take();
+    int runs = 0;
+    int expected = 0;
+    for (const auto& arrival : arrivals) {
+        if (arrival.index != expected) {
+            ++runs;
+        }
+        expected = arrival.index + 1;
+    }
+    if (expected != COUNT) {
+        ++runs;
+    }
+
+    // with a 1 in 4 chance of leaving a burst, runs should average about 4 datagrams
+    double averageRun = (double)stats.burstLost / runs;
+    QVERIFY(averageRun > 2.0);
+}
+
+void NetworkEmulatorTests::duplicateTest() {
+    const int COUNT = 10000;
+
+    NetworkEmulator::Settings settings;
+    settings.duplicateRate = 0.2;
+
+    Collector collector;
+    NetworkEmulator emulator(settings, collector.writer());
+
+    submitIndices(emulator, COUNT);
+    auto stats = waitForDelivery(emulator);
+
+    QVERIFY(stats.duplicated > COUNT * 0.18 && stats.duplicated < COUNT * 0.22);
+    QCOMPARE(stats.delivered, COUNT + stats.duplicated);
+
+    std::vector<int> timesSeen(COUNT, 0);
+    for (const auto& arrival : collector.take()) {
+        ++timesSeen[arrival.index];
+    }
+    QCOMPARE((uint64_t)std::count(timesSeen.begin(), timesSeen.end(), 2), stats.duplicated);
+    QCOMPARE(std::count(timesSeen.begin(), timesSeen.end(), 0), (std::ptrdiff_t)0);
+}
+
+void NetworkEmulatorTests::reorderTest() {
+    const int COUNT = 2000;
+
+    NetworkEmulator::Settings settings;
+    settings.reorderRate = 0.1;
+    settings.reorderDelay = milliseconds(5);
+
+    Collector collector;
+    NetworkEmulator emulator(settings, collector.writer());
+
+    // spread the submits out so later datagrams are due before the held back ones
+    QByteArray datagram(sizeof(int), 0);
+    for (int i = 0; i < COUNT; ++i) {
+        memcpy(datagram.data(), &i, sizeof(int));
+        emulator.submit(datagram.constData(), datagram.size(), HifiSockAddr());
+        if (i % 100 == 0) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    }
+    auto stats = waitForDelivery(emulator);
+
+    QVERIFY(stats.reordered > 0);
+    QCOMPARE(stats.delivered, (uint64_t)COUNT);
+
+    int outOfOrder = 0;
+    auto arrivals = collector.take();
+    for (size_t i = 1; i < arrivals.size(); ++i) {
+        if (arrivals[i].index < arrivals[i - 1].index) {
+            ++outOfOrder;
+        }
+    }
+    QVERIFY(outOfOrder > 0);
+}
+
+void NetworkEmulatorTests::latencyAndBandwidthTest() {
+    const int COUNT = 50;
+    const int DATAGRAM_SIZE = 1000;
+
+    NetworkEmulator::Settings settings;
+    settings.latency = milliseconds(20);
+    settings.bandwidth = 8000000; // a byte per microsecond, so each datagram takes 1ms to leave
+
+    {
+        Collector collector;
+        NetworkEmulator emulator(settings, collector.writer());
+
+        auto start = Clock::now();
+        submitIndices(emulator, COUNT, DATAGRAM_SIZE);
+        auto stats = waitForDelivery(emulator);
+        QCOMPARE(stats.delivered, (uint64_t)COUNT);
+
+        auto arrivals = collector.take();
+        QVERIFY(arrivals.front().time - start >= milliseconds(21));
+        QVERIFY(arrivals.back().time - start >= milliseconds(20 + COUNT));
+
+        // each datagram waited in the queue for those ahead of it to leave
+        QCOMPARE(stats.queued, (uint64_t)COUNT);
+        auto medianQueueDelay = stats.getQueueDelayPercentile(0.5);
+        QVERIFY(medianQueueDelay >= milliseconds(20) && medianQueueDelay <= milliseconds(COUNT / 2));
+        QVERIFY(stats.getQueueDelayPercentile(1.0) >= medianQueueDelay);
+    }
+
+    // a queue that holds 10ms drops everything past the first 11 datagrams
+    settings.maxQueueDelay = milliseconds(10);
+    {
+        Collector collector;
+        NetworkEmulator emulator(settings, collector.writer());
+
+        submitIndices(emulator, COUNT, DATAGRAM_SIZE);
+        auto stats = waitForDelivery(emulator);
+        QVERIFY(stats.queueDropped > 0);
+        QVERIFY(stats.delivered >= 10 && stats.delivered <= 12);
+    }
+}
+
+void NetworkEmulatorTests::settingsFromStringTest() {
+    NetworkEmulator::Settings settings;
+    QVERIFY(NetworkEmulator::Settings::fromString("loss=0.05, latency=40,jitter=2.5,bandwidth=10000000,burst=0.01", settings));
+    QCOMPARE(settings.lossRate, 0.05);
+    QCOMPARE(settings.burstEnterRate, 0.01);
+    QCOMPARE(settings.latency.count(), (int64_t)40000);
+    QCOMPARE(settings.jitter.count(), (int64_t)2500);
+    QCOMPARE(settings.bandwidth, (int64_t)10000000);
+
+    QVERIFY(!NetworkEmulator::Settings::fromString("loss", settings));
+    QVERIFY(!NetworkEmulator::Settings::fromString("speed=10", settings));
+    QVERIFY(!NetworkEmulator::Settings::fromString("latency=-1", settings));
+}
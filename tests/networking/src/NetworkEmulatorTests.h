@@ -0,0 +1,43 @@
+//
+//  NetworkEmulatorTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkEmulatorTests_h
+#define hifi_NetworkEmulatorTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class NetworkEmulatorTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that with no impairments every datagram arrives once, intact and in order
+    void passThroughTest();
+
+    // Test that random loss drops about the configured share of datagrams
+    void lossTest();
+
+    // Test that burst loss drops datagrams in runs rather than one at a time
+    void burstLossTest();
+
+    // Test that duplicated datagrams arrive twice
+    void duplicateTest();
+
+    // Test that held back datagrams arrive after ones submitted later
+    void reorderTest();
+
+    // Test that latency and the bandwidth cap delay delivery, that the queueing is reported and a full queue drops
+    void latencyAndBandwidthTest();
+
+    // Test parsing the HIFI_UDT_NETWORK_EMULATION description
+    void settingsFromStringTest();
+};
+
+#endif // hifi_NetworkEmulatorTests_h
@@ -0,0 +1,136 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <thread>
+
+#include <NLPacket.h>
+#include <udt/PacketBufferPool.h>
+
+using namespace udt;
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+// what a mixer does with a packet: build it, send it, and receive one like it into a fresh buffer
+static void sendAndReceivePacket(const QByteArray& payload) {
+    auto packet = NLPacket::create(PacketType::SilentAudioFrame);
+    packet->write(payload);
+
+    auto size = packet->getDataSize();
+    auto buffer = PacketBufferPool::allocate(udt::MAX_PACKET_SIZE);
+    memcpy(buffer.get(), packet->getData(), size);
+
+    auto receivedPacket = NLPacket::fromReceivedPacket(std::move(buffer), size, HifiSockAddr());
+    QCOMPARE(receivedPacket->getPayloadSize(), (qint64)payload.size());
+}
+
+void PacketBufferPoolTests::recycleTest() {
+    char* firstBuffer = nullptr;
+    {
+        auto buffer = PacketBufferPool::allocate(udt::MAX_PACKET_SIZE);
+        firstBuffer = buffer.get();
+    }
+
+    auto before = PacketBufferPool::getStats();
+
+    auto buffer = PacketBufferPool::allocate(udt::MAX_PACKET_SIZE);
+    QCOMPARE(buffer.get(), firstBuffer);
+
+    auto after = PacketBufferPool::getStats();
+    QCOMPARE(after.pooledAllocations - before.pooledAllocations, (uint64_t)1);
+    QCOMPARE(after.heapAllocations, before.heapAllocations);
+    QCOMPARE(after.outstandingBuffers - before.outstandingBuffers, (int64_t)1);
+}
+
+void PacketBufferPoolTests::bypassTest() {
+    auto before = PacketBufferPool::getStats();
+
+    {
+        auto buffer = PacketBufferPool::allocate(udt::MAX_PACKET_SIZE + 1);
+        QCOMPARE(buffer.get_deleter().sizeClass, -1);
+    }
+
+    {
+        // a buffer from new[] is deleted, not recycled
+        PacketBuffer buffer = std::unique_ptr<char[]>(new char[udt::MAX_PACKET_SIZE]);
+        QCOMPARE(buffer.get_deleter().sizeClass, -1);
+    }
+
+    auto after = PacketBufferPool::getStats();
+    QCOMPARE(after.heapAllocations - before.heapAllocations, (uint64_t)1);
+    QCOMPARE(after.recycledBuffers, before.recycledBuffers);
+    QCOMPARE(after.outstandingBuffers, before.outstandingBuffers);
+}
+
+void PacketBufferPoolTests::crossThreadTest() {
+    const int NUM_PACKETS = 1000;
+    QByteArray payload(100, 'x');
+
+    std::vector<std::unique_ptr<NLPacket>> packets;
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        auto packet = NLPacket::create(PacketType::SilentAudioFrame);
+        packet->write(payload);
+        packets.push_back(std::move(packet));
+    }
+
+    auto before = PacketBufferPool::getStats();
+
+    std::thread releaser([&packets] {
+        packets.clear();
+    });
+    releaser.join();
+
+    auto after = PacketBufferPool::getStats();
+    QCOMPARE(after.recycledBuffers + after.freedBuffers - before.recycledBuffers - before.freedBuffers,
+             (uint64_t)NUM_PACKETS);
+    QCOMPARE(before.outstandingBuffers - after.outstandingBuffers, (int64_t)NUM_PACKETS);
+}
+
+void PacketBufferPoolTests::steadyStateTest() {
+    QByteArray payload(NLPacket::maxPayloadSize(PacketType::SilentAudioFrame), 'x');
+
+    // warm up so the pool has every buffer this path needs
+    sendAndReceivePacket(payload);
+
+    auto before = PacketBufferPool::getStats();
+
+    const int NUM_ITERATIONS = 10000;
+    for (int i = 0; i < NUM_ITERATIONS; ++i) {
+        sendAndReceivePacket(payload);
+    }
+
+    auto after = PacketBufferPool::getStats();
+    QCOMPARE(after.heapAllocations, before.heapAllocations);
+    QCOMPARE(after.pooledAllocations - before.pooledAllocations, (uint64_t)(2 * NUM_ITERATIONS));
+}
+
+void PacketBufferPoolTests::packetPathBenchmark_data() {
+    QTest::addColumn<bool>("pooled");
+
+    QTest::newRow("new[]") << false;
+    QTest::newRow("pool") << true;
+}
+
+void PacketBufferPoolTests::packetPathBenchmark() {
+    QFETCH(bool, pooled);
+
+    bool wasEnabled = PacketBufferPool::isEnabled();
+    PacketBufferPool::setEnabled(pooled);
+
+    QByteArray payload(NLPacket::maxPayloadSize(PacketType::SilentAudioFrame), 'x');
+    sendAndReceivePacket(payload);
+
+    QBENCHMARK {
+        sendAndReceivePacket(payload);
+    }
+
+    PacketBufferPool::setEnabled(wasEnabled);
+}
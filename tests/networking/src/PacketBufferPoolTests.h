@@ -0,0 +1,38 @@
+//
+//  PacketBufferPoolTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferPoolTests_h
+#define hifi_PacketBufferPoolTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketBufferPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a released buffer is handed out again
+    void recycleTest();
+
+    // Test that oversized requests and plain buffers bypass the pool
+    void bypassTest();
+
+    // Test that packets released on another thread go back to the pool
+    void crossThreadTest();
+
+    // Test that the send and receive path for a full packet stops allocating once warmed up
+    void steadyStateTest();
+
+    // Compare creating, receiving and destroying packets with and without the pool
+    void packetPathBenchmark_data();
+    void packetPathBenchmark();
+};
+
+#endif // hifi_PacketBufferPoolTests_h
@@ -0,0 +1,133 @@
+//
+//  PacketQueueTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketQueueTests.h"
+
+#include <udt/PacketList.h>
+#include <udt/PacketQueue.h>
+
+using namespace udt;
+
+QTEST_MAIN(PacketQueueTests)
+
+static std::unique_ptr<Packet> createFullPacket(Stream stream) {
+    auto packet = Packet::create(-1, true);
+    packet->write(QByteArray(Packet::maxPayloadSize(), 'x'));
+    packet->setStream(stream);
+    return packet;
+}
+
+static std::unique_ptr<PacketList> createMessage(Stream stream, int numPackets) {
+    auto packetList = PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+    packetList->setStream(stream);
+    packetList->write(QByteArray(numPackets * packetList->getMaxSegmentSize(), 'x'));
+    packetList->closeCurrentPacket();
+    return packetList;
+}
+
+void PacketQueueTests::strictPriorityTest() {
+    PacketQueue queue;
+    queue.setStreamScheduling(StreamScheduling::StrictPriority, DEFAULT_STREAM_WEIGHTS);
+
+    queue.queuePacketList(createMessage(Stream::Bulk, 10));
+    queue.queuePacket(createFullPacket(Stream::Default));
+    queue.queuePacket(createFullPacket(Stream::Urgent));
+    queue.queuePacket(createFullPacket(Stream::Urgent));
+
+    QCOMPARE(queue.takePacket()->getStream(), Stream::Urgent);
+    QCOMPARE(queue.takePacket()->getStream(), Stream::Urgent);
+    QCOMPARE(queue.takePacket()->getStream(), Stream::Default);
+
+    // an urgent packet queued in the middle of the bulk message goes out next
+    QCOMPARE(queue.takePacket()->getStream(), Stream::Bulk);
+    queue.queuePacket(createFullPacket(Stream::Urgent));
+    QCOMPARE(queue.takePacket()->getStream(), Stream::Urgent);
+
+    int bulkPackets = 0;
+    while (!queue.isEmpty()) {
+        QCOMPARE(queue.takePacket()->getStream(), Stream::Bulk);
+        ++bulkPackets;
+    }
+    QCOMPARE(bulkPackets, 9);
+}
+
+void PacketQueueTests::weightedFairTest() {
+    const int PACKETS_PER_STREAM = 400;
+    const StreamWeights WEIGHTS {{ 6, 3, 1 }};
+
+    PacketQueue queue;
+    queue.setStreamScheduling(StreamScheduling::WeightedFair, WEIGHTS);
+
+    for (int i = 0; i < PACKETS_PER_STREAM; ++i) {
+        queue.queuePacket(createFullPacket(Stream::Urgent));
+        queue.queuePacket(createFullPacket(Stream::Default));
+        queue.queuePacket(createFullPacket(Stream::Bulk));
+    }
+
+    // while all three are busy they should share the sends 6:3:1
+    const int SENDS = 500;
+    std::array<int, NUM_STREAMS> sent {{ 0, 0, 0 }};
+    for (int i = 0; i < SENDS; ++i) {
+        ++sent[(int)queue.takePacket()->getStream()];
+    }
+
+    QVERIFY(std::abs(sent[(int)Stream::Urgent] - SENDS * 6 / 10) <= 6);
+    QVERIFY(std::abs(sent[(int)Stream::Default] - SENDS * 3 / 10) <= 6);
+    QVERIFY(std::abs(sent[(int)Stream::Bulk] - SENDS * 1 / 10) <= 6);
+
+    int remaining = 0;
+    while (!queue.isEmpty()) {
+        queue.takePacket();
+        ++remaining;
+    }
+    QCOMPARE(remaining, PACKETS_PER_STREAM * NUM_STREAMS - SENDS);
+}
+
+void PacketQueueTests::singleStreamTest() {
+    PacketQueue queue;
+    queue.setStreamScheduling(StreamScheduling::WeightedFair, DEFAULT_STREAM_WEIGHTS);
+
+    queue.queuePacketList(createMessage(Stream::Bulk, 5));
+    queue.queuePacketList(createMessage(Stream::Bulk, 5));
+
+    int taken = 0;
+    while (auto packet = queue.takePacket()) {
+        QCOMPARE(packet->getStream(), Stream::Bulk);
+        ++taken;
+    }
+    QCOMPARE(taken, 10);
+}
+
+void PacketQueueTests::messageStreamTest() {
+    PacketQueue queue(41);
+
+    queue.queuePacketList(createMessage(Stream::Bulk, 1));
+    queue.queuePacketList(createMessage(Stream::Urgent, 1));
+
+    auto bulkPacket = queue.takePacket();
+    auto urgentPacket = queue.takePacket();
+    if (bulkPacket->getStream() != Stream::Bulk) {
+        std::swap(bulkPacket, urgentPacket);
+    }
+
+    // both streams draw on the one counter, the stream is added on top
+    QCOMPARE(bulkPacket->getMessageNumber() & ~MESSAGE_STREAM_MASK, (MessageNumber)42);
+    QCOMPARE(urgentPacket->getMessageNumber() & ~MESSAGE_STREAM_MASK, (MessageNumber)43);
+    QCOMPARE(queue.getCurrentMessageNumber(), (MessageNumber)43);
+
+    auto size = bulkPacket->getDataSize();
+    auto data = std::unique_ptr<char[]>(new char[size]);
+    memcpy(data.get(), bulkPacket->getData(), size);
+    auto receivedPacket = Packet::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+
+    QVERIFY(receivedPacket->isPartOfMessage());
+    QCOMPARE(receivedPacket->getStream(), Stream::Bulk);
+    QCOMPARE(receivedPacket->getMessageNumber(), bulkPacket->getMessageNumber());
+}
@@ -0,0 +1,34 @@
+//
+//  PacketQueueTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketQueueTests_h
+#define hifi_PacketQueueTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketQueueTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that strict priority scheduling always sends from the most urgent stream first
+    void strictPriorityTest();
+
+    // Test that weighted fair scheduling shares the sends between busy streams by weight
+    void weightedFairTest();
+
+    // Test that a stream that is alone gets every send, whatever its weight
+    void singleStreamTest();
+
+    // Test that the stream of a message survives the trip through the packet header
+    void messageStreamTest();
+};
+
+#endif // hifi_PacketQueueTests_h
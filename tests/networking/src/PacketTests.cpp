@@ -13,6 +13,7 @@
 #include "../QTestExtensions.h"
 
 #include <NLPacket.h>
+#include <udt/Constants.h>
 
 QTEST_MAIN(PacketTests)
 
@@ -180,3 +181,20 @@ void PacketTests::primitiveTest() {
     QCOMPARE(recvPacket->peekPrimitive(&noValue), 0);
     QCOMPARE(recvPacket->readPrimitive(&noValue), 0);
 }
+
+void PacketTests::invalidStreamTest() {
+    // there are only 3 streams, but a peer can send all 4 values of the stream bits
+    const udt::MessageNumber messageNumber = (udt::MessageNumber(3) << udt::MESSAGE_STREAM_OFFSET) | 5;
+
+    auto packet = udt::Packet::create(-1, true, true);
+    packet->writeMessageNumber(messageNumber, udt::Packet::ONLY, 0);
+    QCOMPARE(packet->getStream(), udt::Stream::Default);
+
+    auto size = packet->getDataSize();
+    auto data = std::unique_ptr<char[]>(new char[size]);
+    memcpy(data.get(), packet->getData(), size);
+    auto recvPacket = udt::Packet::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+
+    QCOMPARE(recvPacket->getMessageNumber(), messageNumber);
+    QCOMPARE(recvPacket->getStream(), udt::Stream::Default);
+}
@@ -36,6 +36,9 @@ private slots:
 
     // Test set/get packet type
     void packetTypeTest();
+
+    // Test a received message number with stream bits past the known streams
+    void invalidStreamTest();
 };
 
 #endif // hifi_PacketTests_h
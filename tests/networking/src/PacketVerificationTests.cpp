@@ -0,0 +1,136 @@
+//
+//  PacketVerificationTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketVerificationTests.h"
+
+#include <NLPacket.h>
+#include <SipHash.h>
+
+QTEST_MAIN(PacketVerificationTests)
+
+Q_DECLARE_METATYPE(PacketVerificationMethod)
+
+// builds a sourced, verified packet the way LimitedNodeList does, then hands back a copy as it would be received
+static std::unique_ptr<NLPacket> createReceivedPacket(PacketType type, PacketVerificationMethod method,
+                                                      int payloadSize, const QUuid& connectionSecret) {
+    auto packet = NLPacket::create(type);
+
+    if (method == PacketVerificationMethod::MD5) {
+        // the last version of these types before they moved to SipHash
+        packet->setVersion(type == PacketType::BulkAvatarData
+            ? static_cast<PacketVersion>(AvatarMixerPacketVersion::FBXReaderNodeReparenting)
+            : static_cast<PacketVersion>(AudioVersion::HighDynamicRangeVolume));
+    }
+
+    QByteArray payload(payloadSize, 0);
+    for (int i = 0; i < payloadSize; ++i) {
+        payload[i] = (char)(i * 31);
+    }
+    packet->write(payload);
+
+    packet->writeSourceID(QUuid::createUuid());
+    packet->writeVerificationHashGivenSecret(connectionSecret);
+
+    auto size = packet->getDataSize();
+    auto buffer = std::unique_ptr<char[]>(new char[size]);
+    memcpy(buffer.get(), packet->getData(), size);
+    return NLPacket::fromReceivedPacket(std::move(buffer), size, HifiSockAddr());
+}
+
+void PacketVerificationTests::sipHashVectorsTest() {
+    uint8_t key[SIPHASH_KEY_SIZE];
+    uint8_t message[15];
+    for (int i = 0; i < SIPHASH_KEY_SIZE; ++i) {
+        key[i] = i;
+    }
+    for (int i = 0; i < (int)sizeof(message); ++i) {
+        message[i] = i;
+    }
+
+    QCOMPARE(sipHash64(key, message, 0), (uint64_t)0x726fdb47dd0e0e31ULL);
+    QCOMPARE(sipHash64(key, message, 15), (uint64_t)0xa129ca6149be45e5ULL);
+
+    const uint8_t EMPTY_128[SIPHASH_128_SIZE] = {
+        0xa3, 0x81, 0x7f, 0x04, 0xba, 0x25, 0xa8, 0xe6, 0x6d, 0xf6, 0x72, 0x14, 0xc7, 0x55, 0x02, 0x93
+    };
+    uint8_t out[SIPHASH_128_SIZE];
+    sipHash128(key, message, 0, out);
+    QVERIFY(memcmp(out, EMPTY_128, SIPHASH_128_SIZE) == 0);
+}
+
+void PacketVerificationTests::verificationMethodTest() {
+    QCOMPARE(verificationMethodForPacket(PacketType::BulkAvatarData, versionForPacketType(PacketType::BulkAvatarData)),
+             PacketVerificationMethod::SipHash);
+    QCOMPARE(verificationMethodForPacket(PacketType::MixedAudio, versionForPacketType(PacketType::MixedAudio)),
+             PacketVerificationMethod::SipHash);
+    QCOMPARE(verificationMethodForPacket(PacketType::MixedAudio,
+                                         static_cast<PacketVersion>(AudioVersion::HighDynamicRangeVolume)),
+             PacketVerificationMethod::MD5);
+    QCOMPARE(verificationMethodForPacket(PacketType::EntityEdit, versionForPacketType(PacketType::EntityEdit)),
+             PacketVerificationMethod::MD5);
+}
+
+void PacketVerificationTests::verifyTest_data() {
+    QTest::addColumn<PacketVerificationMethod>("method");
+
+    QTest::newRow("md5") << PacketVerificationMethod::MD5;
+    QTest::newRow("siphash") << PacketVerificationMethod::SipHash;
+}
+
+void PacketVerificationTests::verifyTest() {
+    QFETCH(PacketVerificationMethod, method);
+
+    QUuid connectionSecret = QUuid::createUuid();
+    auto packet = createReceivedPacket(PacketType::MicrophoneAudioNoEcho, method, 200, connectionSecret);
+
+    QVERIFY(NLPacket::verificationHashMatches(*packet, connectionSecret));
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, QUuid::createUuid()));
+
+    // the allocating path must agree with what went into the header
+    QCOMPARE(NLPacket::hashForPacketAndSecret(*packet, connectionSecret), NLPacket::verificationHashInHeader(*packet));
+
+    packet->getData()[packet->getDataSize() - 1] ^= 1;
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, connectionSecret));
+}
+
+void PacketVerificationTests::verifyBenchmark_data() {
+    QTest::addColumn<int>("type");
+    QTest::addColumn<PacketVerificationMethod>("method");
+    QTest::addColumn<int>("payloadSize");
+
+    // a compressed microphone frame, an uncompressed one, and a full bulk avatar data packet
+    QList<QPair<PacketType, int>> sizes = {
+        { PacketType::MicrophoneAudioNoEcho, 100 },
+        { PacketType::MicrophoneAudioNoEcho, 480 },
+        { PacketType::BulkAvatarData, NLPacket::maxPayloadSize(PacketType::BulkAvatarData) }
+    };
+
+    for (auto& size : sizes) {
+        QTest::newRow(qPrintable(QString("md5 %1 bytes").arg(size.second)))
+            << (int)size.first << PacketVerificationMethod::MD5 << size.second;
+        QTest::newRow(qPrintable(QString("siphash %1 bytes").arg(size.second)))
+            << (int)size.first << PacketVerificationMethod::SipHash << size.second;
+    }
+}
+
+void PacketVerificationTests::verifyBenchmark() {
+    QFETCH(int, type);
+    QFETCH(PacketVerificationMethod, method);
+    QFETCH(int, payloadSize);
+
+    QUuid connectionSecret = QUuid::createUuid();
+    auto packet = createReceivedPacket((PacketType)type, method, payloadSize, connectionSecret);
+
+    bool verified = false;
+    QBENCHMARK {
+        verified = NLPacket::verificationHashMatches(*packet, connectionSecret);
+    }
+    QVERIFY(verified);
+}
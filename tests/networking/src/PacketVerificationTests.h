@@ -0,0 +1,36 @@
+//
+//  PacketVerificationTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketVerificationTests_h
+#define hifi_PacketVerificationTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketVerificationTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test SipHash against the reference implementation's vectors
+    void sipHashVectorsTest();
+
+    // Test that the method follows the packet version
+    void verificationMethodTest();
+
+    // Test that a hashed packet verifies, and that a changed payload or secret doesn't
+    void verifyTest_data();
+    void verifyTest();
+
+    // Measure the cost of verifying a packet at mixer packet sizes
+    void verifyBenchmark_data();
+    void verifyBenchmark();
+};
+
+#endif // hifi_PacketVerificationTests_h
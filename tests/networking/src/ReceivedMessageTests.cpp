@@ -0,0 +1,181 @@
+//
+//  ReceivedMessageTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedMessageTests.h"
+
+#include <thread>
+
+#include <QtCore/QBuffer>
+
+#include <ReceivedMessage.h>
+
+QTEST_MAIN(ReceivedMessageTests)
+
+static const int NUM_PACKETS = 4;
+
+// what the message carries, distinct bytes so an off by one read shows up
+static QByteArray messageData() {
+    QByteArray data(NUM_PACKETS * NLPacket::maxPayloadSize(PacketType::AssetGetReply, true) - 100, 0);
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = (char)(i * 7 + i / 256);
+    }
+    return data;
+}
+
+// the packet of the data at the index, as it comes out of the receiving side
+static std::unique_ptr<NLPacket> receivedPacket(const QByteArray& data, int index) {
+    const int PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::AssetGetReply, true);
+    int numPackets = (data.size() + PAYLOAD_SIZE - 1) / PAYLOAD_SIZE;
+
+    auto packet = NLPacket::create(PacketType::AssetGetReply, -1, true, true);
+    packet->write(data.mid(index * PAYLOAD_SIZE, PAYLOAD_SIZE));
+
+    auto position = numPackets == 1 ? udt::Packet::ONLY :
+        index == 0 ? udt::Packet::FIRST : index == numPackets - 1 ? udt::Packet::LAST : udt::Packet::MIDDLE;
+    packet->writeMessageNumber(1, position, index);
+
+    std::unique_ptr<char[]> buffer { new char[packet->getDataSize()] };
+    memcpy(buffer.get(), packet->getData(), packet->getDataSize());
+    return NLPacket::fromReceivedPacket(std::move(buffer), packet->getDataSize(), HifiSockAddr());
+}
+
+// splits the data in packets and runs them through the receiving side, as PacketReceiver does
+static QSharedPointer<ReceivedMessage> receiveMessage(const QByteArray& data) {
+    const int PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::AssetGetReply, true);
+    int numPackets = (data.size() + PAYLOAD_SIZE - 1) / PAYLOAD_SIZE;
+
+    auto message = QSharedPointer<ReceivedMessage>::create(receivedPacket(data, 0));
+    for (int i = 1; i < numPackets; ++i) {
+        message->appendPacket(receivedPacket(data, i));
+    }
+    return message;
+}
+
+void ReceivedMessageTests::chunkedReadTest() {
+    auto data = messageData();
+    auto message = receiveMessage(data);
+
+    QVERIFY(message->isComplete());
+    QCOMPARE(message->getNumChunks(), NUM_PACKETS);
+    QCOMPARE(message->getSize(), (qint64)data.size());
+
+    // primitives that straddle a packet boundary
+    const int PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::AssetGetReply, true);
+    message->seek(PAYLOAD_SIZE - 3);
+    quint64 value = 0;
+    QCOMPARE(message->peekPrimitive(&value), (qint64)sizeof(value));
+    QCOMPARE(memcmp(&value, data.constData() + PAYLOAD_SIZE - 3, sizeof(value)), 0);
+    QCOMPARE(message->readPrimitive(&value), (qint64)sizeof(value));
+    QCOMPARE(message->getPosition(), (qint64)(PAYLOAD_SIZE - 3 + sizeof(value)));
+
+    // a read across several packets
+    message->seek(10);
+    QCOMPARE(message->read(3 * PAYLOAD_SIZE), data.mid(10, 3 * PAYLOAD_SIZE));
+
+    // reads stop at the end of the message
+    message->seek(data.size() - 5);
+    QCOMPARE(message->readAll(), data.right(5));
+    QCOMPARE(message->getBytesLeftToRead(), (qint64)0);
+    QCOMPARE(message->readPrimitive(&value), (qint64)0);
+
+    // the head is the start of the first packet
+    message->seek(0);
+    QCOMPARE(message->readHead(16), data.left(16));
+}
+
+void ReceivedMessageTests::contiguousViewTest() {
+    auto data = messageData();
+    auto message = receiveMessage(data);
+
+    const int PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::AssetGetReply, true);
+
+    // data inside a single packet comes straight out of it
+    message->seek(PAYLOAD_SIZE + 1);
+    auto inPacket = message->readWithoutCopy(100);
+    QCOMPARE(inPacket, data.mid(PAYLOAD_SIZE + 1, 100));
+
+    // data across packets needs the contiguous copy, which must not invalidate what was handed out before
+    message->seek(PAYLOAD_SIZE - 50);
+    auto acrossPackets = message->readWithoutCopy(100);
+    QCOMPARE(acrossPackets, data.mid(PAYLOAD_SIZE - 50, 100));
+    QCOMPARE(inPacket, data.mid(PAYLOAD_SIZE + 1, 100));
+
+    QCOMPARE(message->getMessage(), data);
+    QCOMPARE(memcmp(message->getRawMessage(), data.constData(), data.size()), 0);
+
+    // a message that arrived whole is not copied
+    auto single = receiveMessage(data.left(200));
+    QCOMPARE(single->getNumChunks(), 1);
+    QCOMPARE(single->getMessage(), data.left(200));
+    QCOMPARE(memcmp(single->getRawMessage(), data.constData(), 200), 0);
+}
+
+void ReceivedMessageTests::streamingReadTest() {
+    auto data = messageData();
+    auto message = receiveMessage(data);
+
+    QByteArray reassembled;
+    int chunks = 0;
+    for (auto chunk = message->readChunkWithoutCopy(); !chunk.isEmpty(); chunk = message->readChunkWithoutCopy()) {
+        reassembled.append(chunk);
+        ++chunks;
+    }
+    QCOMPARE(chunks, NUM_PACKETS);
+    QCOMPARE(reassembled, data);
+
+    // streaming from the middle of a chunk starts where the position is
+    message->seek(123);
+    QByteArray written;
+    QBuffer buffer { &written };
+    buffer.open(QIODevice::WriteOnly);
+    QCOMPARE(message->readAll(buffer), (qint64)(data.size() - 123));
+    QCOMPARE(written, data.mid(123));
+}
+
+void ReceivedMessageTests::concurrentReadTest() {
+    // enough packets that the chunk list grows several times while it is read
+    const int NUM_CONCURRENT_PACKETS = 1000;
+    const int PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::AssetGetReply, true);
+    QByteArray data(NUM_CONCURRENT_PACKETS * PAYLOAD_SIZE, 0);
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = (char)(i * 7 + i / 256);
+    }
+
+    // the first packet is handed out before the rest arrive, as PacketReceiver does for a message with a progress
+    // callback, and the rest are appended from another thread while this one reads
+    auto message = QSharedPointer<ReceivedMessage>::create(receivedPacket(data, 0));
+    std::thread appender([&] {
+        for (int i = 1; i < NUM_CONCURRENT_PACKETS; ++i) {
+            message->appendPacket(receivedPacket(data, i));
+        }
+    });
+
+    QByteArray reassembled;
+    while (reassembled.size() < data.size()) {
+        auto chunk = message->readChunkWithoutCopy();
+        if (chunk.isEmpty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        reassembled.append(chunk);
+
+        // a copying read of data that is already in also has to see a consistent chunk list
+        QByteArray copied;
+        copied.resize(reassembled.size() < 64 ? reassembled.size() : 64);
+        message->seek(message->getPosition() - copied.size());
+        QCOMPARE(message->read(copied.data(), copied.size()), (qint64)copied.size());
+        QCOMPARE(copied, reassembled.right(copied.size()));
+    }
+    appender.join();
+
+    QVERIFY(message->isComplete());
+    QCOMPARE(message->getNumChunks(), NUM_CONCURRENT_PACKETS);
+    QCOMPARE(reassembled, data);
+}
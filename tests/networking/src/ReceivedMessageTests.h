@@ -0,0 +1,34 @@
+//
+//  ReceivedMessageTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedMessageTests_h
+#define hifi_ReceivedMessageTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceivedMessageTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a message received in several packets keeps one chunk per packet and reads across them
+    void chunkedReadTest();
+
+    // Test that the contiguous views of a chunked message match what was sent
+    void contiguousViewTest();
+
+    // Test reading a message a chunk at a time, and streaming it into a device
+    void streamingReadTest();
+
+    // Test reading a message while its packets are still being appended on another thread
+    void concurrentReadTest();
+};
+
+#endif // hifi_ReceivedMessageTests_h
@@ -0,0 +1,68 @@
+//
+//  ResourceEvictionPolicyTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceEvictionPolicyTests.h"
+
+#include <ResourceEvictionPolicy.h>
+
+QTEST_GUILESS_MAIN(ResourceEvictionPolicyTests)
+
+using Entry = ResourceEvictionPolicy::Entry;
+
+static const qint64 SCRIPT_SIZE = 2 * 1024;
+static const qint64 TEXTURE_SIZE = 200 * 1024 * 1024;
+static const quint64 SCRIPT_COST_USECS = 100 * 1000;
+static const quint64 TEXTURE_COST_USECS = 4 * 1000 * 1000;
+
+void ResourceEvictionPolicyTests::lruTest() {
+    LRUEvictionPolicy policy;
+
+    auto script = policy.getPriority({ SCRIPT_SIZE, SCRIPT_COST_USECS, 10 });
+    auto texture = policy.getPriority({ TEXTURE_SIZE, TEXTURE_COST_USECS, 1 });
+    QVERIFY(script < texture);
+}
+
+void ResourceEvictionPolicyTests::gdsfTest() {
+    GDSFEvictionPolicy policy;
+
+    // a large texture saves less time per byte than a small script
+    auto texture = policy.getPriority({ TEXTURE_SIZE, TEXTURE_COST_USECS, 1 });
+    auto script = policy.getPriority({ SCRIPT_SIZE, SCRIPT_COST_USECS, 1 });
+    QVERIFY(texture < script);
+
+    // of two the same size, the one that took longer to process is worth more
+    auto cheapModel = policy.getPriority({ TEXTURE_SIZE, SCRIPT_COST_USECS, 1 });
+    QVERIFY(cheapModel < texture);
+
+    // and so is the one that was asked for more often
+    auto popularTexture = policy.getPriority({ TEXTURE_SIZE, TEXTURE_COST_USECS, 5 });
+    QVERIFY(texture < popularTexture);
+}
+
+void ResourceEvictionPolicyTests::gdsfAgingTest() {
+    GDSFEvictionPolicy policy;
+
+    auto script = policy.getPriority({ SCRIPT_SIZE, SCRIPT_COST_USECS, 1 });
+    policy.evicted(script);
+
+    // once something as valuable as the script has been evicted, even a texture released later is worth more
+    auto texture = policy.getPriority({ TEXTURE_SIZE, TEXTURE_COST_USECS, 1 });
+    QVERIFY(script < texture);
+}
+
+void ResourceEvictionPolicyTests::createTest() {
+    for (const auto& name : ResourceEvictionPolicy::getNames()) {
+        auto policy = ResourceEvictionPolicy::create(name);
+        QVERIFY(policy.get());
+        QCOMPARE(policy->getName(), name);
+    }
+    QCOMPARE(ResourceEvictionPolicy::create(QString())->getName(), ResourceEvictionPolicy::GDSF);
+    QVERIFY(!ResourceEvictionPolicy::create("fifo"));
+}
@@ -0,0 +1,34 @@
+//
+//  ResourceEvictionPolicyTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceEvictionPolicyTests_h
+#define hifi_ResourceEvictionPolicyTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ResourceEvictionPolicyTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the least recently released resource goes first with LRU, whatever it costs
+    void lruTest();
+
+    // Test that GDSF keeps the resources that cost the most to load again per byte, and the most used ones
+    void gdsfTest();
+
+    // Test that the resources GDSF kept age out once newer ones are evicted
+    void gdsfAgingTest();
+
+    // Test that the policies are found by name
+    void createTest();
+};
+
+#endif // hifi_ResourceEvictionPolicyTests_h
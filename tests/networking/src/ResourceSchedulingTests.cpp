@@ -0,0 +1,107 @@
+//
+//  ResourceSchedulingTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceSchedulingTests.h"
+
+#include <DependencyManager.h>
+#include <ResourceCache.h>
+
+QTEST_GUILESS_MAIN(ResourceSchedulingTests)
+
+static QSharedPointer<Resource> makeResource(const QString& url, QObject* owner, float priority) {
+    auto resource = QSharedPointer<Resource>::create(QUrl(url));
+    resource->setSelf(resource);
+    resource->setLoadPriority(owner, priority);
+    return resource;
+}
+
+void ResourceSchedulingTests::initTestCase() {
+    DependencyManager::set<ResourceCacheSharedItems>();
+}
+
+void ResourceSchedulingTests::priorityOrderTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+
+    auto low = makeResource("http://example.com/low.fbx", &owner, 0.1f);
+    auto high = makeResource("http://example.com/high.fbx", &owner, 0.5f);
+    auto middle = makeResource("http://example.com/middle.fbx", &owner, 0.3f);
+
+    sharedItems->appendPendingRequest(low);
+    sharedItems->appendPendingRequest(high);
+    sharedItems->appendPendingRequest(middle);
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)3);
+
+    QCOMPARE(sharedItems->getHighestPendingRequest(), high);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), middle);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), low);
+    QVERIFY(sharedItems->getHighestPendingRequest().isNull());
+}
+
+void ResourceSchedulingTests::loweredPriorityTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+
+    auto first = makeResource("atp:/first.fbx", &owner, 0.5f);
+    auto second = makeResource("atp:/second.fbx", &owner, 0.3f);
+
+    sharedItems->appendPendingRequest(first);
+    sharedItems->appendPendingRequest(second);
+
+    first->setLoadPriority(&owner, 0.1f);
+
+    QCOMPARE(sharedItems->getHighestPendingRequest(), second);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), first);
+    QVERIFY(sharedItems->getHighestPendingRequest().isNull());
+}
+
+void ResourceSchedulingTests::reprioritizeTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+
+    auto behind = makeResource("http://example.com/behind.fbx", &owner, 0.1f);
+    auto ahead = makeResource("http://example.com/ahead.fbx", &owner, 0.2f);
+
+    sharedItems->appendPendingRequest(behind);
+    sharedItems->appendPendingRequest(ahead);
+
+    // as if we turned around
+    behind->setLoadPriority(&owner, 0.9f);
+    sharedItems->reprioritize();
+
+    QCOMPARE(sharedItems->getHighestPendingRequest(), behind);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), ahead);
+    QVERIFY(sharedItems->getHighestPendingRequest().isNull());
+}
+
+void ResourceSchedulingTests::filesFirstTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+
+    auto network = makeResource("http://example.com/model.fbx", &owner, 0.9f);
+    auto file = makeResource("file:///tmp/model.fbx", &owner, 0.1f);
+
+    sharedItems->appendPendingRequest(network);
+    sharedItems->appendPendingRequest(file);
+
+    QCOMPARE(sharedItems->getHighestPendingRequest(), file);
+    QCOMPARE(sharedItems->getHighestPendingRequest(), network);
+
+    auto stats = sharedItems->getStats();
+    QCOMPARE(stats.pending, (uint32_t)0);
+}
+
+void ResourceSchedulingTests::protocolTest() {
+    QCOMPARE(ResourceCacheSharedItems::getProtocol(QUrl("file:///tmp/model.fbx")), ResourceCacheSharedItems::FILE_PROTOCOL);
+    QCOMPARE(ResourceCacheSharedItems::getProtocol(QUrl("qrc:///meshes/model.fbx")), ResourceCacheSharedItems::FILE_PROTOCOL);
+    QCOMPARE(ResourceCacheSharedItems::getProtocol(QUrl("atp:/model.fbx")), ResourceCacheSharedItems::ATP_PROTOCOL);
+    QCOMPARE(ResourceCacheSharedItems::getProtocol(QUrl("https://example.com/model.fbx")),
+             ResourceCacheSharedItems::HTTP_PROTOCOL);
+}
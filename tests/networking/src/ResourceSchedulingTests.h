@@ -0,0 +1,39 @@
+//
+//  ResourceSchedulingTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceSchedulingTests_h
+#define hifi_ResourceSchedulingTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ResourceSchedulingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    // Test that pending requests are started highest priority first
+    void priorityOrderTest();
+
+    // Test that a request whose priority dropped while it was pending makes way for the others
+    void loweredPriorityTest();
+
+    // Test that reprioritizing picks up priorities that were raised while the requests were pending
+    void reprioritizeTest();
+
+    // Test that local files are started before network requests of any priority
+    void filesFirstTest();
+
+    // Test that the requests are scheduled by the protocol of their url
+    void protocolTest();
+};
+
+#endif // hifi_ResourceSchedulingTests_h
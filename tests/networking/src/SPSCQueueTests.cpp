@@ -0,0 +1,76 @@
+//
+//  SPSCQueueTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SPSCQueueTests.h"
+
+#include <memory>
+#include <thread>
+
+#include <udt/SPSCQueue.h>
+
+using namespace udt;
+
+QTEST_MAIN(SPSCQueueTests)
+
+void SPSCQueueTests::boundedTest() {
+    SPSCQueue<std::unique_ptr<int>> queue(5);
+    QCOMPARE(queue.getCapacity(), (size_t)8);
+    QCOMPARE(queue.getFreeSpace(), (size_t)8);
+
+    for (int i = 0; i < 8; ++i) {
+        QVERIFY(queue.push(std::unique_ptr<int>(new int(i))));
+    }
+    QCOMPARE(queue.getFreeSpace(), (size_t)0);
+
+    std::unique_ptr<int> refused(new int(8));
+    QVERIFY(!queue.push(std::move(refused)));
+
+    std::unique_ptr<int> value;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(*value, 0);
+    QCOMPARE(queue.getFreeSpace(), (size_t)1);
+
+    // the freed slot is reused as the queue wraps around
+    QVERIFY(queue.push(std::unique_ptr<int>(new int(8))));
+    for (int i = 1; i <= 8; ++i) {
+        QVERIFY(queue.pop(value));
+        QCOMPARE(*value, i);
+    }
+    QVERIFY(!queue.pop(value));
+}
+
+void SPSCQueueTests::crossThreadTest() {
+    const int COUNT = 100000;
+    SPSCQueue<int> queue(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < COUNT; ++i) {
+            while (!queue.push(int(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < COUNT) {
+        int value;
+        if (queue.pop(value)) {
+            inOrder = inOrder && value == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    QVERIFY(inOrder);
+    QCOMPARE(queue.getFreeSpace(), queue.getCapacity());
+}
@@ -0,0 +1,28 @@
+//
+//  SPSCQueueTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SPSCQueueTests_h
+#define hifi_SPSCQueueTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class SPSCQueueTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that values come out in the order they went in and a full queue refuses more
+    void boundedTest();
+
+    // Test that values pushed on one thread all arrive, in order, on another
+    void crossThreadTest();
+};
+
+#endif // hifi_SPSCQueueTests_h
@@ -0,0 +1,329 @@
+//
+//  SendSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendSchedulerTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <udt/SendScheduler.h>
+
+using namespace udt;
+using namespace std::chrono;
+
+QTEST_MAIN(SendSchedulerTests)
+
+using NextService = SendScheduler::NextService;
+
+// a stand-in for a SendQueue, that answers each service with whatever its handler returns
+class TestQueue : public SendScheduler::Client {
+public:
+    using Handler = std::function<NextService(int serviceCount, bool)>;
+
+    TestQueue(SendScheduler& scheduler, Handler handler) : _scheduler(scheduler), _handler(handler) {}
+
+    // like a SendQueue, stop being serviced before going away
+    ~TestQueue() { _scheduler.unschedule(this); }
+
+    int getServiceCount() const { return _serviceCount; }
+    bool wasLastWoken() const { return _wasLastWoken; }
+
+protected:
+    NextService service(bool wasWoken) override {
+        _wasLastWoken = wasWoken;
+        return _handler(++_serviceCount, wasWoken);
+    }
+
+private:
+    SendScheduler& _scheduler;
+    Handler _handler;
+    std::atomic<int> _serviceCount { 0 };
+    std::atomic<bool> _wasLastWoken { false };
+};
+
+static NextService after(milliseconds delay, bool wakeable = false) {
+    NextService next;
+    next.deadline = p_high_resolution_clock::now() + delay;
+    next.wakeable = wakeable;
+    return next;
+}
+
+static NextService stop() {
+    NextService next;
+    next.stopped = true;
+    return next;
+}
+
+static const int TIMEOUT_MSECS = 5000;
+
+void SendSchedulerTests::deadlineOrderTest() {
+    SendScheduler scheduler(1);
+
+    // deadlines in a different order than the queues are scheduled in
+    const std::vector<int> DEADLINE_MSECS { 70, 20, 50, 80, 10, 40, 60, 30 };
+    const auto start = p_high_resolution_clock::now() + milliseconds(100);
+
+    std::mutex mutex;
+    std::vector<int> serviced;
+
+    std::vector<std::unique_ptr<TestQueue>> queues;
+    for (int deadlineMsecs : DEADLINE_MSECS) {
+        queues.emplace_back(new TestQueue(scheduler, [&, deadlineMsecs](int serviceCount, bool) {
+            if (serviceCount == 1) {
+                NextService next;
+                next.deadline = start + milliseconds(deadlineMsecs);
+                return next;
+            }
+            std::lock_guard<std::mutex> locker(mutex);
+            serviced.push_back(deadlineMsecs);
+            return stop();
+        }));
+        scheduler.schedule(queues.back().get());
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(scheduler.getScheduledCount(), 0, TIMEOUT_MSECS);
+
+    std::lock_guard<std::mutex> locker(mutex);
+    QCOMPARE(serviced.size(), DEADLINE_MSECS.size());
+    QVERIFY(std::is_sorted(serviced.begin(), serviced.end()));
+}
+
+void SendSchedulerTests::earlyWakeTest() {
+    SendScheduler scheduler(1);
+
+    std::mutex mutex;
+    std::vector<QString> serviced;
+    auto record = [&](const QString& name) {
+        std::lock_guard<std::mutex> locker(mutex);
+        serviced.push_back(name);
+    };
+
+    // waiting for work, and woken long before its deadline
+    TestQueue idle(scheduler, [&](int serviceCount, bool) {
+        if (serviceCount == 1) {
+            return after(seconds(10), true);
+        }
+        record("idle");
+        return stop();
+    });
+    // pacing, so it keeps its deadline whatever wakes it
+    TestQueue pacing(scheduler, [&](int serviceCount, bool) {
+        if (serviceCount > 1) {
+            record("pacing");
+        }
+        return after(seconds(10));
+    });
+    // due well after the wake
+    TestQueue later(scheduler, [&](int serviceCount, bool) {
+        if (serviceCount == 1) {
+            return after(milliseconds(300));
+        }
+        record("later");
+        return stop();
+    });
+
+    scheduler.schedule(&idle);
+    scheduler.schedule(&pacing);
+    scheduler.schedule(&later);
+    QTRY_VERIFY_WITH_TIMEOUT(idle.getServiceCount() == 1 && pacing.getServiceCount() == 1
+        && later.getServiceCount() == 1, TIMEOUT_MSECS);
+
+    scheduler.wake(&pacing);
+    scheduler.wake(&idle);
+
+    QTRY_COMPARE_WITH_TIMEOUT(later.getServiceCount(), 2, TIMEOUT_MSECS);
+    QCOMPARE(idle.getServiceCount(), 2);
+    QVERIFY(idle.wasLastWoken());
+    QCOMPARE(pacing.getServiceCount(), 1);
+
+    std::lock_guard<std::mutex> locker(mutex);
+    QCOMPARE(serviced, (std::vector<QString> { "idle", "later" }));
+}
+
+void SendSchedulerTests::wakeWhileServicingTest() {
+    SendScheduler scheduler(1);
+
+    std::atomic<bool> isServicing { false };
+    std::atomic<bool> wasWokenDuringService { false };
+
+    // goes idle at the end of its first service, as it hasn't seen the packet it was woken for
+    TestQueue queue(scheduler, [&](int serviceCount, bool) {
+        if (serviceCount == 1) {
+            isServicing = true;
+            while (!wasWokenDuringService) {
+                std::this_thread::yield();
+            }
+        }
+        return after(seconds(10), true);
+    });
+
+    scheduler.schedule(&queue);
+    QTRY_VERIFY_WITH_TIMEOUT(isServicing, TIMEOUT_MSECS);
+    scheduler.wake(&queue);
+    wasWokenDuringService = true;
+
+    QTRY_COMPARE_WITH_TIMEOUT(queue.getServiceCount(), 2, TIMEOUT_MSECS);
+    QVERIFY(queue.wasLastWoken());
+}
+
+void SendSchedulerTests::unscheduleTest() {
+    SendScheduler scheduler(1);
+
+    // with a deadline still in the heap
+    {
+        std::atomic<int> serviceCount { 0 };
+        auto queue = std::unique_ptr<TestQueue>(new TestQueue(scheduler, [&](int, bool) {
+            ++serviceCount;
+            return after(milliseconds(100));
+        }));
+        scheduler.schedule(queue.get());
+        QTRY_COMPARE_WITH_TIMEOUT(serviceCount.load(), 1, TIMEOUT_MSECS);
+
+        scheduler.unschedule(queue.get());
+        queue.reset();
+        QCOMPARE(scheduler.getScheduledCount(), 0);
+
+        QTest::qWait(300);
+        QCOMPARE(serviceCount.load(), 1);
+    }
+
+    // before it was ever serviced, while the only worker is busy with another queue
+    {
+        std::atomic<bool> isBlocking { false };
+        std::atomic<bool> shouldRelease { false };
+        TestQueue blocker(scheduler, [&](int, bool) {
+            isBlocking = true;
+            while (!shouldRelease) {
+                std::this_thread::yield();
+            }
+            return stop();
+        });
+        scheduler.schedule(&blocker);
+        QTRY_VERIFY_WITH_TIMEOUT(isBlocking, TIMEOUT_MSECS);
+
+        std::atomic<int> serviceCount { 0 };
+        auto queue = std::unique_ptr<TestQueue>(new TestQueue(scheduler, [&](int, bool) {
+            ++serviceCount;
+            return after(milliseconds(0));
+        }));
+        scheduler.schedule(queue.get());
+        queue.reset();
+        QCOMPARE(scheduler.getScheduledCount(), 1);
+
+        shouldRelease = true;
+        QTRY_COMPARE_WITH_TIMEOUT(scheduler.getScheduledCount(), 0, TIMEOUT_MSECS);
+        QTest::qWait(100);
+        QCOMPARE(serviceCount.load(), 0);
+    }
+
+    // while it is being serviced, which unschedule waits for
+    {
+        std::atomic<int> serviceCount { 0 };
+        std::atomic<bool> shouldRelease { false };
+        auto queue = std::unique_ptr<TestQueue>(new TestQueue(scheduler, [&](int, bool) {
+            ++serviceCount;
+            while (!shouldRelease) {
+                std::this_thread::yield();
+            }
+            return after(milliseconds(0));
+        }));
+        scheduler.schedule(queue.get());
+        QTRY_COMPARE_WITH_TIMEOUT(serviceCount.load(), 1, TIMEOUT_MSECS);
+
+        std::atomic<bool> isUnscheduled { false };
+        std::thread unscheduler([&] {
+            scheduler.unschedule(queue.get());
+            isUnscheduled = true;
+        });
+        QTest::qWait(100);
+        QVERIFY(!isUnscheduled);
+
+        shouldRelease = true;
+        unscheduler.join();
+        QVERIFY(isUnscheduled);
+        queue.reset();
+        QCOMPARE(scheduler.getScheduledCount(), 0);
+
+        QTest::qWait(100);
+        QCOMPARE(serviceCount.load(), 1);
+    }
+}
+
+void SendSchedulerTests::starvationTest() {
+    const int THREAD_COUNT = 2;
+    const int QUEUE_COUNT = 16;
+    SendScheduler scheduler(THREAD_COUNT);
+
+    std::atomic<int> servicing { 0 };
+    std::atomic<int> mostServicing { 0 };
+    std::atomic<bool> wasServicedTwiceAtOnce { false };
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    // every queue always has something to send
+    std::vector<std::unique_ptr<std::atomic<bool>>> isServicing;
+    std::vector<std::unique_ptr<TestQueue>> queues;
+    for (int i = 0; i < QUEUE_COUNT; ++i) {
+        isServicing.emplace_back(new std::atomic<bool> { false });
+        auto& isQueueServicing = *isServicing.back();
+        queues.emplace_back(new TestQueue(scheduler, [&](int, bool) {
+            if (isQueueServicing.exchange(true)) {
+                wasServicedTwiceAtOnce = true;
+            }
+            int nowServicing = ++servicing;
+            int most = mostServicing;
+            while (nowServicing > most && !mostServicing.compare_exchange_weak(most, nowServicing)) {
+            }
+            {
+                std::lock_guard<std::mutex> locker(mutex);
+                threads.insert(std::this_thread::get_id());
+            }
+
+            std::this_thread::sleep_for(milliseconds(1));
+
+            --servicing;
+            isQueueServicing = false;
+            return after(milliseconds(0));
+        }));
+    }
+
+    for (auto& queue : queues) {
+        scheduler.schedule(queue.get());
+    }
+    std::this_thread::sleep_for(milliseconds(500));
+    for (auto& queue : queues) {
+        scheduler.unschedule(queue.get());
+    }
+
+    QVERIFY(!wasServicedTwiceAtOnce);
+    QVERIFY(mostServicing <= THREAD_COUNT);
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        QVERIFY((int)threads.size() <= THREAD_COUNT);
+    }
+
+    int fewest = std::numeric_limits<int>::max();
+    int most = 0;
+    for (auto& queue : queues) {
+        fewest = std::min(fewest, queue->getServiceCount());
+        most = std::max(most, queue->getServiceCount());
+    }
+    QVERIFY2(fewest > 0 && fewest * 2 >= most,
+        qPrintable(QString("serviced between %1 and %2 times").arg(fewest).arg(most)));
+}
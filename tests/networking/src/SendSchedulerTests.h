@@ -0,0 +1,37 @@
+//
+//  SendSchedulerTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendSchedulerTests_h
+#define hifi_SendSchedulerTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class SendSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that queues that are due are serviced in the order of their deadlines
+    void deadlineOrderTest();
+
+    // Test that waking an idle queue services it before a later deadline, and that a pacing queue isn't woken
+    void earlyWakeTest();
+
+    // Test that a queue woken while it is being serviced comes straight back instead of going idle
+    void wakeWhileServicingTest();
+
+    // Test that an unscheduled queue is never serviced again and is no longer held by the scheduler
+    void unscheduleTest();
+
+    // Test that many busy queues share a small pool without any of them starving
+    void starvationTest();
+};
+
+#endif // hifi_SendSchedulerTests_h
@@ -0,0 +1,125 @@
+//
+//  SentPacketHistoryTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketHistoryTests.h"
+
+#include <map>
+
+#include <udt/SentPacketHistory.h>
+
+using namespace udt;
+
+QTEST_MAIN(SentPacketHistoryTests)
+
+// adds a packet for each of count sequence numbers from first, and remembers which packet went with which
+static void addPackets(SentPacketHistory& history, std::map<int, Packet*>& packets, int first, int count) {
+    SequenceNumber sequenceNumber(first);
+    for (int i = 0; i < count; ++i, ++sequenceNumber) {
+        auto packet = Packet::create(-1, true);
+        packets[(SequenceNumber::Type)sequenceNumber] = packet.get();
+        history.add(sequenceNumber, std::move(packet));
+    }
+}
+
+static Packet* findPacket(SentPacketHistory& history, int sequenceNumber) {
+    auto entry = history.find(SequenceNumber(sequenceNumber));
+    return entry ? entry->packet.get() : nullptr;
+}
+
+void SentPacketHistoryTests::findTest() {
+    SentPacketHistory history;
+    QVERIFY(history.isEmpty());
+    QVERIFY(!history.find(SequenceNumber(0)));
+
+    std::map<int, Packet*> packets;
+    addPackets(history, packets, 100, 10);
+    QVERIFY(!history.isEmpty());
+
+    for (const auto& packet : packets) {
+        QCOMPARE(findPacket(history, packet.first), packet.second);
+    }
+    QVERIFY(!findPacket(history, 99));
+    QVERIFY(!findPacket(history, 110));
+
+    // the resend count belongs to the entry, and starts again for a new packet
+    history.find(SequenceNumber(105))->resendCount = 3;
+    QCOMPARE(history.find(SequenceNumber(105))->resendCount, (uint8_t)3);
+    QCOMPARE(history.find(SequenceNumber(106))->resendCount, (uint8_t)0);
+
+    // packets can be skipped, a gap holds nothing
+    auto packet = Packet::create(-1, true);
+    auto skippedTo = packet.get();
+    history.add(SequenceNumber(115), std::move(packet));
+    QVERIFY(!findPacket(history, 112));
+    QCOMPARE(findPacket(history, 115), skippedTo);
+
+    history.clear();
+    QVERIFY(history.isEmpty());
+    QVERIFY(!findPacket(history, 100));
+}
+
+void SentPacketHistoryTests::removeUpToTest() {
+    SentPacketHistory history;
+    std::map<int, Packet*> packets;
+
+    addPackets(history, packets, 0, 50);
+    history.removeUpTo(SequenceNumber(39));
+    for (int i = 0; i < 40; ++i) {
+        QVERIFY(!findPacket(history, i));
+        packets.erase(i);
+    }
+
+    // past the end of the ring and round to where it starts, then far enough that it has to grow
+    addPackets(history, packets, 50, 70);
+    for (const auto& packet : packets) {
+        QCOMPARE(findPacket(history, packet.first), packet.second);
+    }
+
+    // removing what was already removed changes nothing
+    history.removeUpTo(SequenceNumber(20));
+    QCOMPARE(findPacket(history, 40), packets[40]);
+
+    history.removeUpTo(SequenceNumber(100));
+    for (const auto& packet : packets) {
+        QCOMPARE(findPacket(history, packet.first), packet.first <= 100 ? nullptr : packet.second);
+    }
+
+    // past the last packet removes them all, and the next one added starts afresh
+    history.removeUpTo(SequenceNumber(1000));
+    QVERIFY(history.isEmpty());
+    QVERIFY(!findPacket(history, 119));
+
+    packets.clear();
+    addPackets(history, packets, 2000, 5);
+    QCOMPARE(findPacket(history, 2000), packets[2000]);
+    QCOMPARE(findPacket(history, 2004), packets[2004]);
+}
+
+void SentPacketHistoryTests::sequenceNumberWrapTest() {
+    const int MAX = SequenceNumber::MAX;
+
+    SentPacketHistory history;
+    std::map<int, Packet*> packets;
+    addPackets(history, packets, MAX - 4, 10);
+    QVERIFY(packets.count(MAX) == 1 && packets.count(0) == 1 && packets.count(4) == 1);
+
+    for (const auto& packet : packets) {
+        QCOMPARE(findPacket(history, packet.first), packet.second);
+    }
+    QVERIFY(!findPacket(history, MAX - 5));
+    QVERIFY(!findPacket(history, 5));
+
+    // everything from before zero goes along with 0 and 1
+    history.removeUpTo(SequenceNumber(1));
+    for (const auto& packet : packets) {
+        bool isKept = packet.first >= 2 && packet.first <= 4;
+        QCOMPARE(findPacket(history, packet.first), isKept ? packet.second : nullptr);
+    }
+}
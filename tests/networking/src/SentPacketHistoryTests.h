@@ -0,0 +1,31 @@
+//
+//  SentPacketHistoryTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SentPacketHistoryTests_h
+#define hifi_SentPacketHistoryTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class SentPacketHistoryTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test finding the packets that were added, and not the ones that weren't
+    void findTest();
+
+    // Test that ACKed packets are dropped and the rest can still be found, as the ring wraps and grows
+    void removeUpToTest();
+
+    // Test packets whose sequence numbers run past the largest one and back to zero
+    void sequenceNumberWrapTest();
+};
+
+#endif // hifi_SentPacketHistoryTests_h
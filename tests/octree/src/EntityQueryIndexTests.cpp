@@ -0,0 +1,104 @@
+//
+//  EntityQueryIndexTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryIndexTests.h"
+
+#include <QJsonArray>
+
+#include <EntityQueryFilter.h>
+#include <EntityQueryIndex.h>
+#include <ModelEntityItem.h>
+#include <ShapeEntityItem.h>
+
+QTEST_MAIN(EntityQueryIndexTests)
+
+void EntityQueryIndexTests::filterCompileTest() {
+    // an empty query, or one with only flags, has no terms
+    QVERIFY(EntityQueryFilter(QJsonObject()).isEmpty());
+    QVERIFY(EntityQueryFilter(QJsonObject { { "flags", QJsonObject { { "includeAncestors", true } } } }).isEmpty());
+
+    // the legacy serverScripts filter is indexable
+    EntityQueryFilter serverScripts(QJsonObject { { "serverScripts", "+" } });
+    QCOMPARE((int)serverScripts.getTerms().size(), 1);
+    QVERIFY(serverScripts.isIndexable());
+
+    // the common side of a boolean property can't seed a candidate set
+    QVERIFY(!EntityQueryFilter(QJsonObject { { "visible", true } }).isIndexable());
+    QVERIFY(!EntityQueryFilter(QJsonObject { { "locked", false } }).isIndexable());
+    QVERIFY(EntityQueryFilter(QJsonObject { { "visible", false } }).isIndexable());
+    QVERIFY(EntityQueryFilter(QJsonObject { { "locked", true } }).isIndexable());
+
+    // each userData key is its own term
+    EntityQueryFilter userDataKeys(QJsonObject { { "userDataKeys", QJsonArray { "grabbableKey", "botKey" } } });
+    QCOMPARE((int)userDataKeys.getTerms().size(), 2);
+}
+
+void EntityQueryIndexTests::filterMatchTest() {
+    ModelEntityItem model(EntityItemID(QUuid::createUuid()));
+    model.setUserData("{ \"botKey\": 1 }");
+
+    QVERIFY(EntityQueryFilter(QJsonObject()).matches(model));
+    QVERIFY(EntityQueryFilter(QJsonObject { { "type", "Model" } }).matches(model));
+    QVERIFY(!EntityQueryFilter(QJsonObject { { "type", "Box" } }).matches(model));
+    QVERIFY(EntityQueryFilter(QJsonObject { { "userDataKeys", "botKey" } }).matches(model));
+    QVERIFY(!EntityQueryFilter(QJsonObject { { "userDataKeys", QJsonArray { "botKey", "otherKey" } } }).matches(model));
+    QVERIFY(!EntityQueryFilter(QJsonObject { { "serverScripts", "+" } }).matches(model));
+
+    model.setServerScripts("http://example.com/server.js");
+    QVERIFY(EntityQueryFilter(QJsonObject { { "serverScripts", "+" } }).matches(model));
+    QVERIFY(model.matchesJSONFilters(QJsonObject { { "serverScripts", "+" } }));
+}
+
+void EntityQueryIndexTests::indexCandidatesTest() {
+    EntityQueryIndex index;
+
+    ModelEntityItem lockedModel(EntityItemID(QUuid::createUuid()));
+    lockedModel.setLocked(true);
+    ModelEntityItem model(EntityItemID(QUuid::createUuid()));
+    ShapeEntityItem lockedShape(EntityItemID(QUuid::createUuid()));
+    lockedShape.setLocked(true);
+
+    index.updateEntity(lockedModel);
+    index.updateEntity(model);
+    index.updateEntity(lockedShape);
+    QCOMPARE(index.getIndexedEntityCount(), 3);
+
+    auto lockedModels = index.findCandidates(EntityQueryFilter(QJsonObject { { "type", "Model" }, { "locked", true } }));
+    QCOMPARE(lockedModels.size(), 1);
+    QCOMPARE(lockedModels.first(), lockedModel.getEntityItemID());
+
+    auto models = index.findCandidates(EntityQueryFilter(QJsonObject { { "type", "Model" } }));
+    QCOMPARE(models.size(), 2);
+
+    auto owned = index.findCandidates(EntityQueryFilter(QJsonObject { { "owningAvatarID", QUuid::createUuid().toString() } }));
+    QVERIFY(owned.isEmpty());
+}
+
+void EntityQueryIndexTests::indexUpdateTest() {
+    EntityQueryIndex index;
+    EntityQueryFilter botFilter(QJsonObject { { "userDataKeys", "botKey" } });
+
+    ModelEntityItem model(EntityItemID(QUuid::createUuid()));
+    index.updateEntity(model);
+    QVERIFY(index.findCandidates(botFilter).isEmpty());
+
+    // an edit that adds the key moves the entity into the posting list
+    model.setUserData("{ \"botKey\": true }");
+    index.updateEntity(model);
+    QCOMPARE(index.findCandidates(botFilter).size(), 1);
+
+    // and one that removes it takes it back out
+    model.setUserData("");
+    index.updateEntity(model);
+    QVERIFY(index.findCandidates(botFilter).isEmpty());
+
+    index.removeEntity(model.getEntityItemID());
+    QCOMPARE(index.getIndexedEntityCount(), 0);
+}
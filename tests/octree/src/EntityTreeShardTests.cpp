@@ -0,0 +1,72 @@
+//
+//  EntityTreeShardTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeShardTests.h"
+
+#include <algorithm>
+
+#include <EntityTreeShard.h>
+
+QTEST_MAIN(EntityTreeShardTests)
+
+void EntityTreeShardTests::unshardedTest() {
+    EntityTreeShard shard;
+    QVERIFY(!shard.isSharded());
+    QVERIFY(shard.ownsPosition(glm::vec3(-100.0f, 5.0f, 1000.0f)));
+    QVERIFY(shard.ownsAvatarChild(QUuid::createUuid()));
+    QCOMPARE(shard.shardPersistFilePath("models.json.gz"), QString("models.json.gz"));
+}
+
+void EntityTreeShardTests::positionOwnershipTest() {
+    const int SHARD_COUNT = 3;
+    std::vector<glm::vec3> positions {
+        { -1.0f, -1.0f, -1.0f }, { -1.0f, -1.0f, 1.0f }, { -1.0f, 1.0f, -1.0f }, { -1.0f, 1.0f, 1.0f },
+        { 1.0f, -1.0f, -1.0f }, { 1.0f, -1.0f, 1.0f }, { 1.0f, 1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f }
+    };
+
+    // every position is owned by exactly one shard
+    for (const auto& position : positions) {
+        int owners = 0;
+        for (int i = 0; i < SHARD_COUNT; ++i) {
+            if (EntityTreeShard(i, SHARD_COUNT).ownsPosition(position)) {
+                ++owners;
+            }
+        }
+        QCOMPARE(owners, 1);
+    }
+
+    // and every shard owns at least one octant
+    for (int i = 0; i < SHARD_COUNT; ++i) {
+        EntityTreeShard shard(i, SHARD_COUNT);
+        QVERIFY(std::any_of(positions.begin(), positions.end(), [&](const glm::vec3& position) {
+            return shard.ownsPosition(position);
+        }));
+    }
+}
+
+void EntityTreeShardTests::avatarChildOwnershipTest() {
+    const int SHARD_COUNT = 4;
+    for (int n = 0; n < 16; ++n) {
+        QUuid avatarID = QUuid::createUuid();
+        int owners = 0;
+        for (int i = 0; i < SHARD_COUNT; ++i) {
+            if (EntityTreeShard(i, SHARD_COUNT).ownsAvatarChild(avatarID)) {
+                ++owners;
+            }
+        }
+        QCOMPARE(owners, 1);
+    }
+}
+
+void EntityTreeShardTests::persistFilePathTest() {
+    EntityTreeShard shard(1, 4);
+    QCOMPARE(shard.shardPersistFilePath("models.json.gz"), QString("models.shard-2-of-4.json.gz"));
+    QCOMPARE(shard.shardPersistFilePath("/data/entities"), QString("/data/entities.shard-2-of-4"));
+}
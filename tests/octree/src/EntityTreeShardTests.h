@@ -0,0 +1,26 @@
+//
+//  EntityTreeShardTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeShardTests_h
+#define hifi_EntityTreeShardTests_h
+
+#include <QtTest/QtTest>
+
+class EntityTreeShardTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void unshardedTest();
+    void positionOwnershipTest();
+    void avatarChildOwnershipTest();
+    void persistFilePathTest();
+};
+
+#endif // hifi_EntityTreeShardTests_h
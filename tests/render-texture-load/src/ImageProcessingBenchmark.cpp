@@ -0,0 +1,127 @@
+//
+//  ImageProcessingBenchmark.cpp
+//  tests/render-texture-load/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ImageProcessingBenchmark.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include <tbb/task_arena.h>
+
+#include <image/Image.h>
+#include <NumericalConstants.h>
+
+static const double PIXELS_PER_MEGAPIXEL = 1.0e6;
+
+struct ProcessingStats {
+    double megapixels { 0.0 };
+    quint64 decodeUsecs { std::numeric_limits<quint64>::max() };
+    quint64 serialUsecs { std::numeric_limits<quint64>::max() };
+    quint64 parallelUsecs { std::numeric_limits<quint64>::max() };
+};
+
+static bool measure(const QString& path, image::TextureUsage::Type type, int repeats, ProcessingStats& stats) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Could not open" << path;
+        return false;
+    }
+    QByteArray content = file.readAll();
+
+    // the textures are processed in this arena to see how long their mips took one after the other
+    tbb::task_arena singleThread(1);
+
+    for (int i = 0; i < repeats; ++i) {
+        image::ProcessingTimings timings;
+        gpu::TexturePointer texture;
+        singleThread.execute([&] {
+            texture = image::processImage(QByteArray(content), path.toStdString(), std::numeric_limits<int>::max(),
+                                          type, false, &timings);
+        });
+        if (!texture) {
+            qDebug() << "Could not process" << path;
+            return false;
+        }
+        stats.megapixels = (double)texture->getWidth() * texture->getHeight() * texture->getNumFaces() / PIXELS_PER_MEGAPIXEL;
+        stats.decodeUsecs = std::min(stats.decodeUsecs, timings.decodeUsecs);
+        stats.serialUsecs = std::min(stats.serialUsecs, timings.processUsecs);
+
+        image::processImage(QByteArray(content), path.toStdString(), std::numeric_limits<int>::max(), type, false, &timings);
+        stats.parallelUsecs = std::min(stats.parallelUsecs, timings.processUsecs);
+    }
+
+    return true;
+}
+
+static void printStats(const QString& name, const ProcessingStats& stats) {
+    double speedup = stats.parallelUsecs > 0 ? (double)stats.serialUsecs / stats.parallelUsecs : 0.0;
+    qDebug().noquote() << QString("%1 %2 Mpx: decode %3 ms, process %4 ms on one thread, %5 ms on all (%6x)")
+        .arg(name, -40).arg(stats.megapixels, 6, 'f', 2)
+        .arg((double)stats.decodeUsecs / USECS_PER_MSEC, 8, 'f', 2)
+        .arg((double)stats.serialUsecs / USECS_PER_MSEC, 8, 'f', 2)
+        .arg((double)stats.parallelUsecs / USECS_PER_MSEC, 8, 'f', 2)
+        .arg(speedup, 4, 'f', 1);
+}
+
+int runImageProcessingBenchmark(const QDir& dataDir, int repeats) {
+    image::setColorTexturesCompressionEnabled(true);
+    image::setNormalTexturesCompressionEnabled(true);
+    image::setGrayscaleTexturesCompressionEnabled(true);
+    image::setCubeTexturesCompressionEnabled(true);
+
+    QStringList nameFilters;
+    for (const auto& format : image::getSupportedFormats()) {
+        nameFilters.append("*." + format);
+    }
+    QStringList paths;
+    QDirIterator it(dataDir.path(), nameFilters, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        paths.append(it.next());
+    }
+    std::sort(paths.begin(), paths.end());
+    if (paths.isEmpty()) {
+        qDebug() << "No textures found in" << dataDir.path();
+        return -1;
+    }
+
+    // the color textures go through nvtt's own mip chain, the cube maps through ours, a face at a time
+    const std::vector<std::pair<QString, image::TextureUsage::Type>> TYPES {
+        { "albedo", image::TextureUsage::ALBEDO_TEXTURE },
+        { "cube", image::TextureUsage::CUBE_TEXTURE }
+    };
+
+    for (const auto& type : TYPES) {
+        ProcessingStats total;
+        total.decodeUsecs = total.serialUsecs = total.parallelUsecs = 0;
+        int processed = 0;
+        for (const auto& path : paths) {
+            ProcessingStats stats;
+            // most of the textures aren't laid out as cube maps, those are simply left out
+            if (!measure(path, type.second, repeats, stats)) {
+                continue;
+            }
+            printStats(type.first + " " + QFileInfo(path).fileName(), stats);
+
+            ++processed;
+            total.megapixels += stats.megapixels;
+            total.decodeUsecs += stats.decodeUsecs;
+            total.serialUsecs += stats.serialUsecs;
+            total.parallelUsecs += stats.parallelUsecs;
+        }
+        printStats(QString("%1: all %2 textures").arg(type.first).arg(processed), total);
+    }
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+//
+//  ImageProcessingBenchmark.h
+//  tests/render-texture-load/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_ImageProcessingBenchmark_h
+#define hifi_ImageProcessingBenchmark_h
+
+#include <QtCore/QDir>
+
+// Times image::processImage with the textures of the data set, with their mips compressed on one thread and on all
+// of them, and answers the exit code for the test.
+int runImageProcessingBenchmark(const QDir& dataDir, int repeats);
+
+#endif // hifi_ImageProcessingBenchmark_h
@@ -41,6 +41,7 @@
 
 
 #include "GLIHelpers.h"
+#include "ImageProcessingBenchmark.h"
 #include <shared/RateCounter.h>
 #include <AssetClient.h>
 #include <PathUtils.h>
@@ -659,6 +660,12 @@ int main(int argc, char** argv) {
         }).waitForDownload();
     }
 
+    // render-texture-load --benchmark [repeats] times the processing of the textures instead of showing them
+    if (argc > 1 && QString(argv[1]) == "--benchmark") {
+        int repeats = argc > 2 ? atoi(argv[2]) : 3;
+        return runImageProcessingBenchmark(DATA_DIR, std::max(repeats, 1));
+    }
+
     QTestWindow::setup();
     QTestWindow window;
     app.exec();
@@ -0,0 +1,326 @@
+//
+//  main.cpp
+//  tests/resource-cache-replay/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Compares the eviction policies of the resource caches by replaying resource accesses against each of them.
+//
+//  The accesses come from a log recorded by the interface (run it with --resource-access-log <file>) or, without one,
+//  from a made up session of teleporting back and forth between a few domains. Each cache of the log gets its own
+//  budget for unused resources, as in the interface, and we report how many of the requests for resources that had
+//  been loaded before had to load them again, and how long that took when they were first loaded.
+//
+//  usage: resource-cache-replay-test [unused cache size in MB] [access log]
+//
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+
+#include <NumericalConstants.h>
+#include <ResourceAccessLog.h>
+#include <ResourceEvictionPolicy.h>
+
+using Record = ResourceAccessLog::Record;
+
+static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+
+struct Known {
+    qint64 size { 0 };
+    quint64 costUsecs { 0 };
+};
+
+struct ReplayStats {
+    int requests { 0 };
+    int loads { 0 };
+    int reloads { 0 };
+    qint64 reloadedBytes { 0 };
+    quint64 reloadUsecs { 0 };
+};
+
+// the unused resources of one cache, kept and evicted as ResourceCache does
+class SimulatedCache {
+public:
+    SimulatedCache(const QString& policy, qint64 maxSize) :
+        _policy(ResourceEvictionPolicy::create(policy)), _maxSize(maxSize) {}
+
+    void get(const QString& url, const Known& known, ReplayStats& stats) {
+        ++stats.requests;
+
+        auto it = _resources.find(url);
+        if (it != _resources.end()) {
+            // still loaded, in use or in the cache
+            ++it->uses;
+            if (it->isUnused) {
+                _unused.erase(it->key);
+                _unusedSize -= it->size;
+                it->isUnused = false;
+            }
+            return;
+        }
+
+        ++stats.loads;
+        if (_everLoaded.contains(url)) {
+            ++stats.reloads;
+            stats.reloadedBytes += known.size;
+            stats.reloadUsecs += known.costUsecs;
+        }
+        _everLoaded.insert(url);
+
+        Resource resource;
+        resource.uses = 1;
+        _resources.insert(url, resource);
+    }
+
+    void release(const QString& url, const Known& known) {
+        auto it = _resources.find(url);
+        if (it == _resources.end() || it->isUnused) {
+            return;
+        }
+
+        // If it doesn't fit or its size is unknown, it is let go of
+        if (known.size == 0 || known.size > _maxSize) {
+            _resources.erase(it);
+            return;
+        }
+
+        while (!_unused.empty() && _unusedSize + known.size > _maxSize) {
+            auto evicted = _unused.begin();
+            _policy->evicted(evicted->first.first);
+            _unusedSize -= _resources[evicted->second].size;
+            _resources.remove(evicted->second);
+            _unused.erase(evicted);
+        }
+
+        it = _resources.find(url);
+        it->size = known.size;
+        it->isUnused = true;
+        it->key = { _policy->getPriority({ known.size, known.costUsecs, it->uses }), ++_lastKey };
+        _unused[it->key] = url;
+        _unusedSize += known.size;
+    }
+
+private:
+    using Key = std::pair<double, quint64>;
+
+    struct Resource {
+        quint32 uses { 0 };
+        qint64 size { 0 };
+        bool isUnused { false };
+        Key key;
+    };
+
+    std::unique_ptr<ResourceEvictionPolicy> _policy;
+    qint64 _maxSize;
+    qint64 _unusedSize { 0 };
+    quint64 _lastKey { 0 };
+
+    QHash<QString, Resource> _resources;
+    std::map<Key, QString> _unused;
+    QSet<QString> _everLoaded;
+};
+
+bool readLog(const QString& path, std::vector<Record>& records) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Could not open" << path;
+        return false;
+    }
+
+    int skipped = 0;
+    while (!file.atEnd()) {
+        Record record;
+        if (ResourceAccessLog::parse(file.readLine(), record)) {
+            records.push_back(record);
+        } else {
+            ++skipped;
+        }
+    }
+
+    if (skipped > 0) {
+        qDebug() << "Skipped" << skipped << "lines of" << path << "that could not be read";
+    }
+    return true;
+}
+
+// A session of teleporting between domains: each has its own models, textures and sounds, most visits go to a few
+// favourite domains, and the avatars are around wherever we go. A resource is loaded once per visit and released
+// when we leave, and the sizes and costs stand in for those the interface measures when it loads them.
+std::vector<Record> makeTeleportSession() {
+    const int NUM_DOMAINS = 6;
+    const int NUM_VISITS = 60;
+    const quint64 DWELL_USECS = 60 * USECS_PER_SECOND;
+
+    struct ResourceType {
+        QString cache;
+        QString extension;
+        int perDomain;
+        double minSize;
+        double maxSize;
+        double bytesPerSecond; // how fast it downloads and is processed
+    };
+    const std::vector<ResourceType> TYPES {
+        { "TextureCache", "ktx", 120, 64.0 * 1024, 64.0 * 1024 * 1024, 40.0e6 },
+        { "ModelCache", "fbx", 60, 32.0 * 1024, 32.0 * 1024 * 1024, 8.0e6 },
+        { "SoundCache", "wav", 20, 16.0 * 1024, 8.0 * 1024 * 1024, 30.0e6 },
+        { "ScriptCache", "js", 20, 2.0 * 1024, 256.0 * 1024, 1.0e6 }
+    };
+    const quint64 REQUEST_LATENCY_USECS = 80 * USECS_PER_MSEC;
+
+    std::mt19937 random(2018);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    struct Resource {
+        QString cache;
+        QString url;
+        Known known;
+        int references;
+    };
+
+    auto makeResource = [&](const ResourceType& type, const QString& url) {
+        Resource resource { type.cache, url, {}, 1 + (int)(unit(random) * unit(random) * 8) };
+        // sizes are spread evenly on a log scale, there are as many small files as large ones
+        resource.known.size = (qint64)(type.minSize * std::pow(type.maxSize / type.minSize, unit(random)));
+        resource.known.costUsecs = REQUEST_LATENCY_USECS + (quint64)(resource.known.size / type.bytesPerSecond * USECS_PER_SECOND);
+        return resource;
+    };
+
+    std::vector<std::vector<Resource>> domains(NUM_DOMAINS);
+    for (int domain = 0; domain < NUM_DOMAINS; ++domain) {
+        for (const auto& type : TYPES) {
+            for (int i = 0; i < type.perDomain; ++i) {
+                auto url = QString("https://domain%1.example.com/%2.%3").arg(domain).arg(i).arg(type.extension);
+                domains[domain].push_back(makeResource(type, url));
+            }
+        }
+    }
+
+    std::vector<Record> records;
+    quint64 now = 0;
+    auto record = [&](ResourceAccessLog::Event event, const Resource& resource) {
+        Record result;
+        result.usecs = now;
+        result.event = event;
+        result.cache = resource.cache;
+        result.url = resource.url;
+        if (event == ResourceAccessLog::RELEASE) {
+            result.size = resource.known.size;
+            result.costUsecs = resource.known.costUsecs;
+        }
+        records.push_back(result);
+        now += USECS_PER_MSEC;
+    };
+
+    // the avatars (a model and its textures each) that are wherever we go
+    std::vector<Resource> avatars;
+    for (int i = 0; i < 20; ++i) {
+        avatars.push_back(makeResource(TYPES[1], QString("https://avatars.example.com/%1.fbx").arg(i)));
+        avatars.push_back(makeResource(TYPES[0], QString("https://avatars.example.com/%1.ktx").arg(i)));
+    }
+    for (const auto& avatar : avatars) {
+        record(ResourceAccessLog::GET, avatar);
+    }
+
+    for (int visit = 0; visit < NUM_VISITS; ++visit) {
+        // the favourite domains get most of the visits
+        int domain = std::min((int)(NUM_DOMAINS * unit(random) * unit(random)), NUM_DOMAINS - 1);
+
+        auto resources = domains[domain];
+        std::shuffle(resources.begin(), resources.end(), random);
+        for (const auto& resource : resources) {
+            for (int i = 0; i < resource.references; ++i) {
+                record(ResourceAccessLog::GET, resource);
+            }
+        }
+
+        now += DWELL_USECS;
+
+        for (const auto& resource : resources) {
+            record(ResourceAccessLog::RELEASE, resource);
+        }
+    }
+
+    return records;
+}
+
+ReplayStats replay(const std::vector<Record>& records, const QString& policy, qint64 maxSize) {
+    // the sizes and costs are only known once a resource has loaded, so a reload is charged what the first load took
+    QHash<QString, Known> known;
+    for (const auto& record : records) {
+        if (record.size > 0 && !known.contains(record.url)) {
+            known[record.url] = { record.size, record.costUsecs };
+        }
+    }
+
+    ReplayStats stats;
+    std::map<QString, SimulatedCache> caches;
+    for (const auto& record : records) {
+        auto it = caches.find(record.cache);
+        if (it == caches.end()) {
+            it = caches.emplace(record.cache, SimulatedCache(policy, maxSize)).first;
+        }
+
+        if (record.event == ResourceAccessLog::GET) {
+            it->second.get(record.url, known.value(record.url), stats);
+        } else {
+            // what was measured when it was released beats what we guessed
+            Known measured { record.size, record.costUsecs };
+            it->second.release(record.url, measured);
+        }
+    }
+
+    return stats;
+}
+
+void printStats(const QString& policy, qint64 maxSize, const ReplayStats& stats) {
+    double hitRatio = stats.requests > 0 ? 1.0 - (double)stats.loads / stats.requests : 0.0;
+    qDebug().noquote() << QString("%1 %2 MB: %3 requests, %4% hits, %5 reloads of %6 MB taking %7 s")
+        .arg(policy, -6).arg(maxSize / BYTES_PER_MEGABYTE, 6)
+        .arg(stats.requests, 7).arg(hitRatio * 100.0, 5, 'f', 1)
+        .arg(stats.reloads, 6).arg((double)stats.reloadedBytes / BYTES_PER_MEGABYTE, 8, 'f', 1)
+        .arg((double)stats.reloadUsecs / USECS_PER_SECOND, 8, 'f', 1);
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    std::vector<qint64> sizesInMB { 256, 1024, 4096 };
+    if (argc > 1) {
+        sizesInMB = { atoll(argv[1]) };
+        if (sizesInMB.front() <= 0) {
+            qDebug() << "usage:" << argv[0] << "[unused cache size in MB] [access log]";
+            return -1;
+        }
+    }
+
+    std::vector<Record> records;
+    if (argc > 2) {
+        if (!readLog(argv[2], records)) {
+            return -1;
+        }
+        qDebug() << "Replaying" << records.size() << "accesses from" << argv[2];
+    } else {
+        records = makeTeleportSession();
+        qDebug() << "Replaying" << records.size() << "accesses of a session teleporting between domains";
+    }
+
+    for (auto sizeInMB : sizesInMB) {
+        for (const auto& policy : ResourceEvictionPolicy::getNames()) {
+            printStats(policy, sizeInMB * BYTES_PER_MEGABYTE, replay(records, policy, sizeInMB * BYTES_PER_MEGABYTE));
+        }
+    }
+
+    return 0;
+}
@@ -156,6 +156,29 @@ void FileCacheTests::testWipe() {
     QCOMPARE(getCacheDirectorySize(), (size_t)0);
 }
 
+void FileCacheTests::testMapping() {
+    auto cache = makeFileCache(_testDir.path());
+    std::string key = getFileKey(0);
+    auto file = cache->writeFile(TEST_DATA.data(), FileCache::Metadata(key, TEST_DATA.size()));
+    QVERIFY(file.get());
+
+    // every reader of a file shares the one mapping while any of them holds it
+    auto mapping = file->map();
+    QVERIFY(mapping.get());
+    QCOMPARE((size_t)mapping->size(), (size_t)TEST_DATA.size());
+    QCOMPARE(file->map(), mapping);
+    QCOMPARE(memcmp(mapping->data(), TEST_DATA.data(), TEST_DATA.size()), 0);
+
+    // prefetches of missing files are ignored, and those of a file don't change what's in the cache
+    cache->prefetch(getFileKey(1));
+    file->prefetch(0, TEST_DATA.size() / 2);
+    QCOMPARE(cache->getNumTotalFiles(), (size_t)1);
+
+    mapping.reset();
+    file.reset();
+    cache->wipe();
+    QCOMPARE(cache->getNumTotalFiles(), (size_t)0);
+}
 
 void FileCacheTests::cleanupTestCase() {
 }
@@ -21,6 +21,7 @@ private slots:
     void testFreeSpacePreservation();
     void cleanupTestCase();
     void testWipe();
+    void testMapping();
 
 private:
     size_t getFreeSpace() const;
@@ -0,0 +1,128 @@
+//
+//  main.cpp
+//  tests/udt-batched-io/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Pushes unreliable packets between two udt::Sockets over loopback, first through the QUdpSocket path and then
+//  through the batched (recvmmsg/sendmmsg) path, and reports the packet rate and CPU cost per packet of each.
+//
+//  usage: udt-batched-io-test [packet count] [packets per batch] [payload bytes]
+//
+
+#include <ctime>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <NumericalConstants.h>
+#include <udt/Packet.h>
+#include <udt/Socket.h>
+
+struct RunStats {
+    QString mode;
+    int sent { 0 };
+    int received { 0 };
+    qint64 elapsedUsecs { 0 };
+    double cpuSeconds { 0.0 };
+};
+
+RunStats runTransfer(bool batched, int packetCount, int batchSize, const QByteArray& payload) {
+    RunStats stats;
+    stats.mode = batched ? "recvmmsg/sendmmsg" : "QUdpSocket";
+
+    udt::Socket receiver;
+    receiver.setBatchedDatagramIOEnabled(batched);
+    receiver.bind(QHostAddress::LocalHost);
+    receiver.setPacketHandler([&](std::unique_ptr<udt::Packet>) {
+        ++stats.received;
+    });
+
+    udt::Socket sender;
+    sender.setBatchedDatagramIOEnabled(batched);
+    sender.bind(QHostAddress::LocalHost);
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+
+    QElapsedTimer timer;
+    timer.start();
+    std::clock_t cpuStart = std::clock();
+
+    while (stats.sent < packetCount) {
+        std::vector<std::unique_ptr<udt::Packet>> packets;
+        for (int i = 0; i < batchSize && stats.sent + (int)packets.size() < packetCount; ++i) {
+            auto packet = udt::Packet::create(payload.size());
+            packet->write(payload);
+            packets.push_back(std::move(packet));
+        }
+
+        stats.sent += (int)packets.size();
+        sender.writePackets(std::move(packets), destination);
+
+        // let the receiver drain its socket
+        QCoreApplication::processEvents();
+    }
+
+    // wait for the stragglers, giving up once nothing has arrived for a little while
+    const qint64 DRAIN_TIMEOUT_MSECS = 250;
+    QElapsedTimer drainTimer;
+    drainTimer.start();
+    int lastReceived = stats.received;
+    while (stats.received < stats.sent && drainTimer.elapsed() < DRAIN_TIMEOUT_MSECS) {
+        QCoreApplication::processEvents();
+        if (stats.received != lastReceived) {
+            lastReceived = stats.received;
+            drainTimer.restart();
+        }
+    }
+
+    stats.elapsedUsecs = timer.nsecsElapsed() / 1000;
+    stats.cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    return stats;
+}
+
+void printStats(const RunStats& stats) {
+    double seconds = (double)stats.elapsedUsecs / USECS_PER_SECOND;
+    double packetsPerSecond = seconds > 0.0 ? stats.received / seconds : 0.0;
+    double cpuUsecsPerPacket = stats.received > 0 ? stats.cpuSeconds * USECS_PER_SECOND / stats.received : 0.0;
+
+    qDebug().noquote() << QString("%1 sent %2 received %3 (%4 dropped) in %5 s - %6 packets/s, %7 CPU usecs/packet")
+        .arg(stats.mode, -18).arg(stats.sent, 9).arg(stats.received, 9).arg(stats.sent - stats.received, 7)
+        .arg(seconds, 6, 'f', 3).arg(packetsPerSecond, 10, 'f', 0).arg(cpuUsecsPerPacket, 6, 'f', 2);
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    int packetCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    int batchSize = argc > 2 ? atoi(argv[2]) : 32;
+    int payloadSize = argc > 3 ? atoi(argv[3]) : udt::Packet::maxPayloadSize(false);
+
+    if (packetCount <= 0 || batchSize <= 0 || payloadSize <= 0 || payloadSize > udt::Packet::maxPayloadSize(false)) {
+        qDebug() << "usage:" << argv[0] << "[packet count] [packets per batch] [payload bytes]";
+        return -1;
+    }
+
+    qDebug() << "Sending" << packetCount << "packets of" << payloadSize << "payload bytes in batches of" << batchSize;
+
+    QByteArray payload(payloadSize, 'x');
+
+    printStats(runTransfer(false, packetCount, batchSize, payload));
+
+#ifdef UDT_BATCHED_DATAGRAM_IO
+    printStats(runTransfer(true, packetCount, batchSize, payload));
+
+    // a failed GSO send turns it off for the rest of the process, so this tells us whether the run above used it
+    qDebug() << "UDP segmentation offload" << (udt::SendBatch::isSegmentationOffloadEnabled() ? "was" : "was not")
+        << "used for equally sized packets";
+#else
+    qDebug() << "Batched datagram IO is not available on this platform";
+#endif
+
+    return 0;
+}
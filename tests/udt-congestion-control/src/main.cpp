@@ -0,0 +1,164 @@
+//
+//  main.cpp
+//  tests/udt-congestion-control/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Compares the udt congestion controls over an emulated long-haul lossy link.
+//
+//  Two udt::Sockets talk on loopback through the NetworkEmulator. What the sender writes goes through a rate limited
+//  bottleneck with a tail-drop queue, random loss and a fixed one-way delay; what comes back only gets the delay. Each
+//  congestion control sends reliable packets for a fixed time and we report its goodput, the queueing delay it caused
+//  at the bottleneck, and how many packets it lost to the queue as opposed to the random loss.
+//
+//  usage: udt-congestion-control-test [Mbps] [one-way delay ms] [loss %] [max queue ms] [seconds per run]
+//
+
+#include <functional>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <NumericalConstants.h>
+#include <udt/BBRCC.h>
+#include <udt/CongestionControl.h>
+#include <udt/NetworkEmulator.h>
+#include <udt/Packet.h>
+#include <udt/Socket.h>
+#include <udt/TCPVegasCC.h>
+
+using std::chrono::microseconds;
+
+struct LinkSettings {
+    double megabitsPerSecond { 20.0 };
+    int oneWayDelayMsecs { 40 };
+    double lossRate { 0.01 };
+    int maxQueueMsecs { 100 };
+
+    // the sender's side of the link: the bottleneck, its queue and the loss
+    udt::NetworkEmulator::Settings forward() const {
+        udt::NetworkEmulator::Settings settings = back();
+        settings.bandwidth = (int64_t)(megabitsPerSecond * 1000000.0);
+        settings.maxQueueDelay = microseconds(maxQueueMsecs * USECS_PER_MSEC);
+        settings.lossRate = lossRate;
+        return settings;
+    }
+
+    // the way back only has the delay
+    udt::NetworkEmulator::Settings back() const {
+        udt::NetworkEmulator::Settings settings;
+        settings.latency = microseconds(oneWayDelayMsecs * USECS_PER_MSEC);
+        settings.seed = 12345;
+        return settings;
+    }
+};
+
+struct RunStats {
+    QString name;
+    qint64 receivedBytes { 0 };
+    int received { 0 };
+    double seconds { 0.0 };
+    int retransmissions { 0 };
+    udt::NetworkEmulator::Stats link;
+};
+
+RunStats runTransfer(const QString& name, std::function<udt::CongestionControlVirtualFactory*()> createFactory,
+                     const LinkSettings& settings, int seconds) {
+    const int MAX_PACKETS_QUEUED = 4096;
+
+    RunStats stats;
+    stats.name = name;
+
+    udt::Socket receiver;
+    receiver.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(createFactory()));
+    receiver.bind(QHostAddress::LocalHost);
+    receiver.startNetworkEmulation(settings.back());
+    receiver.setPacketHandler([&](std::unique_ptr<udt::Packet> packet) {
+        ++stats.received;
+        stats.receivedBytes += packet->getPayloadSize();
+    });
+
+    udt::Socket sender;
+    sender.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(createFactory()));
+    sender.bind(QHostAddress::LocalHost);
+    sender.startNetworkEmulation(settings.forward());
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+
+    QByteArray payload(udt::Packet::maxPayloadSize(true), 'x');
+    int sent = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.elapsed() < seconds * (qint64)MSECS_PER_SECOND) {
+        // keep the send queue topped up so the congestion control is always what limits us
+        while (sent - stats.received < MAX_PACKETS_QUEUED) {
+            auto packet = udt::Packet::create(payload.size(), true);
+            packet->write(payload);
+            sender.writePacket(std::move(packet), destination);
+            ++sent;
+        }
+
+        QCoreApplication::processEvents();
+    }
+
+    stats.seconds = (double)timer.elapsed() / MSECS_PER_SECOND;
+    stats.retransmissions = sender.sampleStatsForConnection(destination).events[udt::ConnectionStats::Stats::Retransmission];
+    stats.link = sender.getNetworkEmulationStats();
+
+    return stats;
+}
+
+void printStats(const RunStats& stats) {
+    const auto& link = stats.link;
+    double averageDelay = link.queued > 0 ? (double)link.totalQueueDelay.count() / link.queued : 0.0;
+    double goodput = stats.seconds > 0.0 ? stats.receivedBytes * BITS_IN_BYTE / stats.seconds / 1000000.0 : 0.0;
+
+    qDebug().noquote() << QString("%1 goodput %2 Mbps, queueing delay avg %3 ms p50 %4 ms p95 %5 ms, "
+                                  "%6 queue drops, %7 random losses, %8 re-sends")
+        .arg(stats.name, -6).arg(goodput, 6, 'f', 2)
+        .arg(averageDelay / USECS_PER_MSEC, 6, 'f', 1)
+        .arg((double)link.getQueueDelayPercentile(0.5).count() / USECS_PER_MSEC, 6, 'f', 1)
+        .arg((double)link.getQueueDelayPercentile(0.95).count() / USECS_PER_MSEC, 6, 'f', 1)
+        .arg((qulonglong)link.queueDropped, 6).arg((qulonglong)link.randomlyLost, 6).arg(stats.retransmissions, 6);
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    LinkSettings settings;
+    if (argc > 1) {
+        settings.megabitsPerSecond = atof(argv[1]);
+    }
+    if (argc > 2) {
+        settings.oneWayDelayMsecs = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        settings.lossRate = atof(argv[3]) / 100.0;
+    }
+    if (argc > 4) {
+        settings.maxQueueMsecs = atoi(argv[4]);
+    }
+    int seconds = argc > 5 ? atoi(argv[5]) : 15;
+
+    if (settings.megabitsPerSecond <= 0.0 || settings.oneWayDelayMsecs < 0 || settings.lossRate < 0.0
+        || settings.lossRate >= 1.0 || settings.maxQueueMsecs <= 0 || seconds <= 0) {
+        qDebug() << "usage:" << argv[0] << "[Mbps] [one-way delay ms] [loss %] [max queue ms] [seconds per run]";
+        return -1;
+    }
+
+    qDebug().noquote() << QString("Emulating a %1 Mbps link with %2 ms one-way delay, %3% loss and a %4 ms queue")
+        .arg(settings.megabitsPerSecond).arg(settings.oneWayDelayMsecs).arg(settings.lossRate * 100.0)
+        .arg(settings.maxQueueMsecs);
+
+    printStats(runTransfer("udt", [] { return new udt::CongestionControlFactory<udt::DefaultCC>(); }, settings, seconds));
+    printStats(runTransfer("vegas", [] { return new udt::CongestionControlFactory<udt::TCPVegasCC>(); }, settings, seconds));
+    printStats(runTransfer("bbr", [] { return new udt::CongestionControlFactory<udt::BBRCC>(); }, settings, seconds));
+
+    return 0;
+}
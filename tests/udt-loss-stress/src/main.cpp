@@ -0,0 +1,368 @@
+//
+//  main.cpp
+//  tests/udt-loss-stress/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Stresses the reliable udt path at 5 to 20% packet loss.
+//
+//  The first phase replays a lossy transfer directly against the receiver's and sender's LossList and the sender's
+//  SentPacketHistory, the way Connection and SendQueue drive them, and reports the cost of processing each ACK and
+//  NAK. The second phase sends reliable packets between two udt::Sockets over loopback, with the receiver's packet
+//  filter dropping data packets at random, and reports the throughput and the ACK/NAK/re-send counts.
+//
+//  usage: udt-loss-stress-test [simulated packet count] [socket packet count]
+//
+
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <random>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <NumericalConstants.h>
+#include <udt/ControlPacket.h>
+#include <udt/LossList.h>
+#include <udt/Packet.h>
+#include <udt/SentPacketHistory.h>
+#include <udt/Socket.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static const double LOSS_RATES[] = { 0.05, 0.10, 0.15, 0.20 };
+
+struct SimulationStats {
+    double lossRate { 0.0 };
+    int delivered { 0 };
+    int retransmissions { 0 };
+    int duplicates { 0 };
+    int acks { 0 };
+    int naks { 0 };
+    int timeoutNAKs { 0 };
+    int ticks { 0 };
+    qint64 ackNsecs { 0 };
+    qint64 nakNsecs { 0 };
+    qint64 timeoutNAKNsecs { 0 };
+    qint64 totalNsecs { 0 };
+};
+
+// One packet leaves the sender per tick and reports travel back with the same fixed delay. A lost packet is only
+// recovered the way the real connection recovers it: from the gap it leaves, through the periodic timeout NAK, or
+// by the sender timing out with packets still unACKed.
+SimulationStats runSimulation(double lossRate, int packetCount) {
+    const int ONE_WAY_TICKS = 64;
+    const int ACK_INTERVAL_TICKS = 32;
+    const int TIMEOUT_NAK_INTERVAL_TICKS = 8 * ONE_WAY_TICKS;
+    const int SENDER_TIMEOUT_TICKS = 4 * ONE_WAY_TICKS;
+    const int MAX_TICKS = packetCount * 100;
+
+    const udt::SequenceNumber FIRST_SEQUENCE_NUMBER { 1000 };
+
+    SimulationStats stats;
+    stats.lossRate = lossRate;
+
+    std::mt19937 generator(12345);
+    std::bernoulli_distribution isLost(lossRate);
+
+    // packets are created up front so that the timed loop only measures the loss lists and the history
+    std::vector<std::unique_ptr<udt::Packet>> packets;
+    packets.reserve(packetCount);
+    for (int i = 0; i < packetCount; ++i) {
+        packets.push_back(udt::Packet::create(0, true));
+    }
+    auto timeoutNAKPacket = udt::ControlPacket::create(udt::ControlPacket::TimeoutNAK);
+    const int MAX_TIMEOUT_NAK_PAIRS = udt::ControlPacket::maxPayloadSize() / (2 * sizeof(udt::SequenceNumber));
+
+    struct Datagram {
+        int arrivalTick;
+        udt::SequenceNumber sequenceNumber;
+    };
+    struct Report {
+        int arrivalTick;
+        bool isACK;
+        udt::SequenceNumber first;
+        udt::SequenceNumber second;
+    };
+
+    std::deque<Datagram> toReceiver;
+    std::deque<Report> toSender;
+    int timeoutNAKArrivalTick = -1;
+
+    // receiver state
+    udt::LossList receiverLossList;
+    std::vector<bool> received(packetCount, false);
+    udt::SequenceNumber highestReceived = FIRST_SEQUENCE_NUMBER - 1;
+
+    // sender state
+    udt::LossList senderLossList;
+    udt::SentPacketHistory sentPackets;
+    udt::SequenceNumber nextSequenceNumber = FIRST_SEQUENCE_NUMBER;
+    udt::SequenceNumber lastACK = FIRST_SEQUENCE_NUMBER - 1;
+    int sentNew = 0;
+    int idleTicks = 0;
+
+    auto start = Clock::now();
+
+    int tick = 0;
+    for (; stats.delivered < packetCount && tick < MAX_TICKS; ++tick) {
+        // sender: re-sends take priority over new packets, as in SendQueue
+        bool hasPacket = false;
+        udt::SequenceNumber sequenceNumber;
+
+        while (!hasPacket && senderLossList.getLength() > 0) {
+            sequenceNumber = senderLossList.popFirstSequenceNumber();
+            auto entry = sentPackets.find(sequenceNumber);
+            if (entry) {
+                ++entry->resendCount;
+                ++stats.retransmissions;
+                hasPacket = true;
+            }
+        }
+
+        if (!hasPacket && sentNew < packetCount) {
+            sequenceNumber = nextSequenceNumber++;
+            sentPackets.add(sequenceNumber, std::move(packets[sentNew++]));
+            hasPacket = true;
+        }
+
+        if (hasPacket && !isLost(generator)) {
+            toReceiver.push_back({ tick + ONE_WAY_TICKS, sequenceNumber });
+        }
+
+        if (!hasPacket && toReceiver.empty()) {
+            if (++idleTicks > SENDER_TIMEOUT_TICKS && lastACK + 1 < nextSequenceNumber) {
+                // nothing left in flight but unACKed packets, the sender times out and re-sends all of them
+                senderLossList.insert(lastACK + 1, nextSequenceNumber - 1);
+                idleTicks = 0;
+            }
+        } else {
+            idleTicks = 0;
+        }
+
+        // receiver
+        while (!toReceiver.empty() && toReceiver.front().arrivalTick <= tick) {
+            auto arrived = toReceiver.front().sequenceNumber;
+            toReceiver.pop_front();
+
+            int index = udt::seqoff(FIRST_SEQUENCE_NUMBER, arrived);
+            if (received[index]) {
+                ++stats.duplicates;
+                continue;
+            }
+            received[index] = true;
+            ++stats.delivered;
+
+            if (arrived > highestReceived) {
+                if (arrived > highestReceived + 1) {
+                    // a gap, add it to the loss list and NAK it right away
+                    receiverLossList.append(highestReceived + 1, arrived - 1);
+                    toSender.push_back({ tick + ONE_WAY_TICKS, false, highestReceived + 1, arrived - 1 });
+                }
+                highestReceived = arrived;
+            } else {
+                receiverLossList.remove(arrived);
+            }
+        }
+
+        if (tick % ACK_INTERVAL_TICKS == 0) {
+            auto ack = receiverLossList.getLength() > 0 ? receiverLossList.getFirstSequenceNumber() - 1 : highestReceived;
+            toSender.push_back({ tick + ONE_WAY_TICKS, true, ack, ack });
+        }
+
+        if (tick % TIMEOUT_NAK_INTERVAL_TICKS == 0 && receiverLossList.getLength() > 0 && timeoutNAKArrivalTick < 0) {
+            auto writeStart = Clock::now();
+            timeoutNAKPacket->reset();
+            receiverLossList.write(*timeoutNAKPacket, MAX_TIMEOUT_NAK_PAIRS);
+            stats.timeoutNAKNsecs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - writeStart).count();
+
+            timeoutNAKArrivalTick = tick + ONE_WAY_TICKS;
+        }
+
+        // sender
+        while (!toSender.empty() && toSender.front().arrivalTick <= tick) {
+            auto report = toSender.front();
+            toSender.pop_front();
+
+            auto processStart = Clock::now();
+
+            if (report.isACK) {
+                sentPackets.removeUpTo(report.first);
+                if (senderLossList.getLength() > 0 && senderLossList.getFirstSequenceNumber() <= report.first) {
+                    senderLossList.remove(senderLossList.getFirstSequenceNumber(), report.first);
+                }
+                lastACK = report.first;
+            } else {
+                senderLossList.insert(report.first, report.second);
+            }
+
+            auto nsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - processStart).count();
+            if (report.isACK) {
+                ++stats.acks;
+                stats.ackNsecs += nsecs;
+            } else {
+                ++stats.naks;
+                stats.nakNsecs += nsecs;
+            }
+        }
+
+        if (timeoutNAKArrivalTick >= 0 && timeoutNAKArrivalTick <= tick) {
+            // same as SendQueue::overrideNAKListFromPacket
+            auto processStart = Clock::now();
+
+            senderLossList.clear();
+            timeoutNAKPacket->seek(0);
+
+            udt::SequenceNumber first, second;
+            while (timeoutNAKPacket->bytesLeftToRead() >= (qint64)(2 * sizeof(udt::SequenceNumber))) {
+                timeoutNAKPacket->readPrimitive(&first);
+                timeoutNAKPacket->readPrimitive(&second);
+
+                if (first == second) {
+                    senderLossList.append(first);
+                } else {
+                    senderLossList.append(first, second);
+                }
+            }
+
+            stats.timeoutNAKNsecs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - processStart).count();
+            ++stats.timeoutNAKs;
+            timeoutNAKArrivalTick = -1;
+        }
+    }
+
+    stats.totalNsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    stats.ticks = tick;
+
+    return stats;
+}
+
+void printSimulationStats(const SimulationStats& stats) {
+    auto average = [](qint64 nsecs, int count) { return count > 0 ? (double)nsecs / count : 0.0; };
+
+    qDebug().noquote() << QString("%1% loss: %2 delivered in %3 ticks, %4 re-sends, %5 duplicates - "
+                                  "ACK %6 ns (%7), NAK %8 ns (%9), timeout NAK %10 ns (%11), %12 ns/packet overall")
+        .arg(stats.lossRate * 100, 2, 'f', 0).arg(stats.delivered).arg(stats.ticks)
+        .arg(stats.retransmissions).arg(stats.duplicates)
+        .arg(average(stats.ackNsecs, stats.acks), 0, 'f', 1).arg(stats.acks)
+        .arg(average(stats.nakNsecs, stats.naks), 0, 'f', 1).arg(stats.naks)
+        .arg(average(stats.timeoutNAKNsecs, stats.timeoutNAKs), 0, 'f', 1).arg(stats.timeoutNAKs)
+        .arg(average(stats.totalNsecs, stats.delivered), 0, 'f', 1);
+}
+
+struct TransferStats {
+    double lossRate { 0.0 };
+    int sent { 0 };
+    int received { 0 };
+    int dropped { 0 };
+    qint64 receivedBytes { 0 };
+    qint64 elapsedUsecs { 0 };
+    double cpuSeconds { 0.0 };
+    udt::ConnectionStats::Stats senderStats;
+    udt::ConnectionStats::Stats receiverStats;
+};
+
+TransferStats runTransfer(double lossRate, int packetCount, const QByteArray& payload) {
+    const qint64 TRANSFER_TIMEOUT_MSECS = 120 * MSECS_PER_SECOND;
+    const int MAX_PACKETS_QUEUED = 2048;
+
+    TransferStats stats;
+    stats.lossRate = lossRate;
+
+    std::mt19937 generator(12345);
+    std::bernoulli_distribution isLost(lossRate);
+
+    udt::Socket receiver;
+    receiver.bind(QHostAddress::LocalHost);
+
+    // data packets dropped here never reach the connection, so they look lost to it and get NAKed
+    receiver.setPacketFilterOperator([&](const udt::Packet&) {
+        if (isLost(generator)) {
+            ++stats.dropped;
+            return false;
+        }
+        return true;
+    });
+    receiver.setPacketHandler([&](std::unique_ptr<udt::Packet> packet) {
+        ++stats.received;
+        stats.receivedBytes += packet->getPayloadSize();
+    });
+
+    udt::Socket sender;
+    sender.bind(QHostAddress::LocalHost);
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+    HifiSockAddr source(QHostAddress::LocalHost, sender.localPort());
+
+    QElapsedTimer timer;
+    timer.start();
+    std::clock_t cpuStart = std::clock();
+
+    while (stats.received < packetCount && timer.elapsed() < TRANSFER_TIMEOUT_MSECS) {
+        // keep a bounded number of packets queued so the sender's history doesn't just fill with the whole transfer
+        while (stats.sent < packetCount && stats.sent - stats.received < MAX_PACKETS_QUEUED) {
+            auto packet = udt::Packet::create(payload.size(), true);
+            packet->write(payload);
+            sender.writePacket(std::move(packet), destination);
+            ++stats.sent;
+        }
+
+        QCoreApplication::processEvents();
+    }
+
+    stats.elapsedUsecs = timer.nsecsElapsed() / 1000;
+    stats.cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    stats.senderStats = sender.sampleStatsForConnection(destination);
+    stats.receiverStats = receiver.sampleStatsForConnection(source);
+
+    return stats;
+}
+
+void printTransferStats(const TransferStats& stats) {
+    using Stats = udt::ConnectionStats::Stats;
+
+    double seconds = (double)stats.elapsedUsecs / USECS_PER_SECOND;
+    double megabitsPerSecond = seconds > 0.0 ? (stats.receivedBytes * BITS_IN_BYTE) / seconds / 1000000.0 : 0.0;
+    double cpuUsecsPerPacket = stats.received > 0 ? stats.cpuSeconds * USECS_PER_SECOND / stats.received : 0.0;
+
+    const auto& sent = stats.senderStats.events;
+    const auto& received = stats.receiverStats.events;
+
+    qDebug().noquote() << QString("%1% loss: %2 of %3 received in %4 s (%5 dropped) - %6 Mbps, %7 CPU usecs/packet")
+        .arg(stats.lossRate * 100, 2, 'f', 0).arg(stats.received).arg(stats.sent).arg(seconds, 0, 'f', 3)
+        .arg(stats.dropped).arg(megabitsPerSecond, 0, 'f', 1).arg(cpuUsecsPerPacket, 0, 'f', 2);
+    qDebug().noquote() << QString("          ACKs %1, NAKs %2, timeout NAKs %3, re-sends %4, duplicates %5")
+        .arg(sent[Stats::ReceivedACK]).arg(sent[Stats::ReceivedNAK]).arg(sent[Stats::ReceivedTimeoutNAK])
+        .arg(sent[Stats::Retransmission]).arg(received[Stats::Duplicate]);
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    int simulatedPacketCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    int socketPacketCount = argc > 2 ? atoi(argv[2]) : 50000;
+
+    if (simulatedPacketCount <= 0 || socketPacketCount <= 0) {
+        qDebug() << "usage:" << argv[0] << "[simulated packet count] [socket packet count]";
+        return -1;
+    }
+
+    qDebug() << "Replaying" << simulatedPacketCount << "packets against the loss lists and sent packet history";
+    for (double lossRate : LOSS_RATES) {
+        printSimulationStats(runSimulation(lossRate, simulatedPacketCount));
+    }
+
+    qDebug() << "Sending" << socketPacketCount << "reliable packets between two sockets over loopback";
+    QByteArray payload(udt::Packet::maxPayloadSize(true), 'x');
+    for (double lossRate : LOSS_RATES) {
+        printTransferStats(runTransfer(lossRate, socketPacketCount, payload));
+    }
+
+    return 0;
+}
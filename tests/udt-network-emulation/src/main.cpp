@@ -0,0 +1,264 @@
+//
+//  main.cpp
+//  tests/udt-network-emulation/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Measures udt transfers over emulated networks, reproducibly and in one process.
+//
+//  Two udt::Sockets talk on loopback with network emulation turned on for both: the sender's datagrams get the
+//  impairments of the scenario, the receiver's (the ACKs and NAKs) only get its latency. Each scenario sends a fixed
+//  number of reliable packets stamped with their send time through the real Connection and SendQueue, and we report
+//  how long the transfer took, its throughput, the one-way latency the packets saw and how many were re-sent.
+//
+//  Then, over a capped link, a batch of large messages (as for many assets at once) is sent on the bulk stream while
+//  small urgent messages are sent every few milliseconds, and we report how long the urgent messages took to arrive
+//  with each way of scheduling the streams.
+//
+//  usage: udt-network-emulation-test [packets per scenario] ["emulation description"]
+//
+//  A description (see udt::NetworkEmulator::Settings::fromString) replaces the built in scenarios with that one.
+//
+
+#include <algorithm>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <udt/Packet.h>
+#include <udt/PacketList.h>
+#include <udt/Socket.h>
+
+struct Scenario {
+    QString name;
+    QString description;
+};
+
+struct RunStats {
+    int received { 0 };
+    qint64 receivedBytes { 0 };
+    double seconds { 0.0 };
+    bool completed { false };
+    int retransmissions { 0 };
+    std::vector<quint64> latenciesUsecs;
+    udt::NetworkEmulator::Stats emulation;
+};
+
+RunStats runTransfer(const udt::NetworkEmulator::Settings& settings, int packetCount) {
+    const qint64 TIMEOUT_MSECS = 60 * MSECS_PER_SECOND;
+
+    RunStats stats;
+    stats.latenciesUsecs.reserve(packetCount);
+
+    udt::NetworkEmulator::Settings returnSettings;
+    returnSettings.latency = settings.latency;
+
+    udt::Socket receiver;
+    receiver.bind(QHostAddress::LocalHost);
+    receiver.startNetworkEmulation(returnSettings);
+    receiver.setPacketHandler([&](std::unique_ptr<udt::Packet> packet) {
+        quint64 sentAt = 0;
+        packet->readPrimitive(&sentAt);
+        stats.latenciesUsecs.push_back(usecTimestampNow() - sentAt);
+        stats.receivedBytes += packet->getPayloadSize();
+        ++stats.received;
+    });
+
+    udt::Socket sender;
+    sender.bind(QHostAddress::LocalHost);
+    sender.startNetworkEmulation(settings);
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+    QByteArray padding(udt::Packet::maxPayloadSize(true) - (int)sizeof(quint64), 'x');
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < packetCount; ++i) {
+        auto packet = udt::Packet::create(-1, true);
+        packet->writePrimitive(usecTimestampNow());
+        packet->write(padding);
+        sender.writePacket(std::move(packet), destination);
+
+        // let the sockets keep up rather than queueing the whole transfer before any of it goes out
+        if (i % 64 == 0) {
+            QCoreApplication::processEvents();
+        }
+    }
+
+    while (stats.received < packetCount && timer.elapsed() < TIMEOUT_MSECS) {
+        QCoreApplication::processEvents();
+    }
+
+    stats.completed = stats.received == packetCount;
+    stats.seconds = (double)timer.elapsed() / MSECS_PER_SECOND;
+    stats.retransmissions = sender.sampleStatsForConnection(destination).events[udt::ConnectionStats::Stats::Retransmission];
+    stats.emulation = sender.getNetworkEmulationStats();
+
+    return stats;
+}
+
+void printStats(const QString& name, const RunStats& stats) {
+    auto latencies = stats.latenciesUsecs;
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&](double fraction) {
+        return latencies.empty() ? 0.0 :
+            (double)latencies[std::min((size_t)(fraction * latencies.size()), latencies.size() - 1)] / USECS_PER_MSEC;
+    };
+
+    double throughput = stats.seconds > 0.0 ? stats.receivedBytes * BITS_IN_BYTE / stats.seconds / 1000000.0 : 0.0;
+
+    qDebug().noquote() << QString("%1 %2 in %3 s, %4 Mbps, latency p50 %5 ms p95 %6 ms p99 %7 ms, %8 re-sends")
+        .arg(name, -14).arg(stats.completed ? "done" : "TIMED OUT")
+        .arg(stats.seconds, 6, 'f', 2).arg(throughput, 7, 'f', 2)
+        .arg(percentile(0.5), 7, 'f', 1).arg(percentile(0.95), 7, 'f', 1).arg(percentile(0.99), 7, 'f', 1)
+        .arg(stats.retransmissions, 6);
+
+    const auto& emulation = stats.emulation;
+    qDebug().noquote() << QString("%1 emulator: %2 sent, %3 lost, %4 burst lost, %5 queue dropped, "
+                                  "%6 duplicated, %7 reordered")
+        .arg("", -14).arg(emulation.submitted).arg(emulation.randomlyLost).arg(emulation.burstLost)
+        .arg(emulation.queueDropped).arg(emulation.duplicated).arg(emulation.reordered);
+}
+
+struct StreamRunStats {
+    std::vector<quint64> urgentLatenciesUsecs;
+    double bulkSeconds { 0.0 };
+    bool completed { false };
+};
+
+// sends large messages on the bulk stream and, while they are going, a small message every few milliseconds on
+// urgentStream - with urgentStream also Bulk this is how everything shared a single queue before there were streams
+StreamRunStats runMixedTransfer(const udt::NetworkEmulator::Settings& settings, udt::StreamScheduling scheduling,
+                                udt::Stream urgentStream, int bulkPackets) {
+    const qint64 TIMEOUT_MSECS = 60 * MSECS_PER_SECOND;
+    const qint64 URGENT_INTERVAL_MSECS = 20;
+    const int BULK_MESSAGES = 16;
+
+    StreamRunStats stats;
+    int bulkReceived = 0;
+
+    udt::NetworkEmulator::Settings returnSettings;
+    returnSettings.latency = settings.latency;
+
+    udt::Socket receiver;
+    receiver.bind(QHostAddress::LocalHost);
+    receiver.startNetworkEmulation(returnSettings);
+    receiver.setMessageHandler([&](std::unique_ptr<udt::Packet> packet) {
+        auto position = packet->getPacketPosition();
+        if (position == udt::Packet::PacketPosition::ONLY) {
+            // the urgent messages are the only ones that fit in a packet
+            quint64 sentAt = 0;
+            packet->readPrimitive(&sentAt);
+            stats.urgentLatenciesUsecs.push_back(usecTimestampNow() - sentAt);
+        } else if (position == udt::Packet::PacketPosition::LAST) {
+            ++bulkReceived;
+        }
+    });
+
+    udt::Socket sender;
+    sender.bind(QHostAddress::LocalHost);
+    sender.startNetworkEmulation(settings);
+    sender.setStreamScheduling(scheduling);
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+
+    for (int i = 0; i < BULK_MESSAGES; ++i) {
+        auto bulk = udt::PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+        bulk->setStream(udt::Stream::Bulk);
+        bulk->write(QByteArray(std::max(bulkPackets / BULK_MESSAGES, 2) * bulk->getMaxSegmentSize(), 'x'));
+        sender.writePacketList(std::move(bulk), destination);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 nextUrgentMsecs = 0;
+
+    while (bulkReceived < BULK_MESSAGES && timer.elapsed() < TIMEOUT_MSECS) {
+        if (timer.elapsed() >= nextUrgentMsecs) {
+            auto urgent = udt::PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+            urgent->setStream(urgentStream);
+            urgent->writePrimitive(usecTimestampNow());
+            sender.writePacketList(std::move(urgent), destination);
+            nextUrgentMsecs += URGENT_INTERVAL_MSECS;
+        }
+
+        QCoreApplication::processEvents();
+    }
+
+    stats.completed = bulkReceived == BULK_MESSAGES;
+    stats.bulkSeconds = (double)timer.elapsed() / MSECS_PER_SECOND;
+
+    return stats;
+}
+
+void printStreamStats(const QString& name, const StreamRunStats& stats) {
+    auto latencies = stats.urgentLatenciesUsecs;
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&](double fraction) {
+        return latencies.empty() ? 0.0 :
+            (double)latencies[std::min((size_t)(fraction * latencies.size()), latencies.size() - 1)] / USECS_PER_MSEC;
+    };
+
+    qDebug().noquote() << QString("%1 bulk %2 in %3 s, %4 urgent messages p50 %5 ms p95 %6 ms max %7 ms")
+        .arg(name, -14).arg(stats.completed ? "done" : "TIMED OUT").arg(stats.bulkSeconds, 6, 'f', 2)
+        .arg((int)latencies.size(), 5)
+        .arg(percentile(0.5), 7, 'f', 1).arg(percentile(0.95), 7, 'f', 1).arg(percentile(1.0), 7, 'f', 1);
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    int packetCount = argc > 1 ? atoi(argv[1]) : 20000;
+
+    QVector<Scenario> scenarios {
+        { "clean", "" },
+        { "1% loss", "loss=0.01,latency=20" },
+        { "5% loss", "loss=0.05,latency=50,jitter=10" },
+        { "burst loss", "burst=0.005,burstexit=0.2,latency=30" },
+        { "reorder+dup", "reorder=0.02,reorderdelay=5,duplicate=0.01,latency=20" },
+        { "10 Mbps cap", "bandwidth=10000000,queue=100,latency=20" }
+    };
+
+    if (argc > 2) {
+        scenarios = { { "custom", argv[2] } };
+    }
+
+    if (packetCount <= 0) {
+        qDebug() << "usage:" << argv[0] << "[packets per scenario] [\"emulation description\"]";
+        return -1;
+    }
+
+    for (const auto& scenario : scenarios) {
+        udt::NetworkEmulator::Settings settings;
+        if (!udt::NetworkEmulator::Settings::fromString(scenario.description, settings)) {
+            qDebug() << "Could not understand the emulation description" << scenario.description;
+            return -1;
+        }
+
+        printStats(scenario.name, runTransfer(settings, packetCount));
+    }
+
+    udt::NetworkEmulator::Settings cappedLink;
+    udt::NetworkEmulator::Settings::fromString("bandwidth=20000000,queue=100,latency=20", cappedLink);
+
+    qDebug() << "Urgent messages during a bulk transfer over a 20 Mbps link:";
+    printStreamStats("one stream", runMixedTransfer(cappedLink, udt::StreamScheduling::WeightedFair,
+                                                    udt::Stream::Bulk, packetCount));
+    printStreamStats("weighted fair", runMixedTransfer(cappedLink, udt::StreamScheduling::WeightedFair,
+                                                       udt::Stream::Urgent, packetCount));
+    printStreamStats("strict", runMixedTransfer(cappedLink, udt::StreamScheduling::StrictPriority,
+                                                udt::Stream::Urgent, packetCount));
+
+    return 0;
+}
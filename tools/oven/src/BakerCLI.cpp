@@ -13,6 +13,8 @@
 #include <QImageReader>
 #include <QtCore/QDebug>
 #include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #include "ModelBakingLoggingCategory.h"
 #include "Oven.h"
@@ -50,7 +52,9 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
 
     // create our appropiate baker
     if (isFBX) {
-        _baker = std::unique_ptr<Baker> { new FBXBaker(inputUrl, []() -> QThread* { return qApp->getNextWorkerThread(); }, outputPath) };
+        auto fbxBaker = new FBXBaker(inputUrl, []() -> QThread* { return qApp->getNextWorkerThread(); }, outputPath);
+        fbxBaker->setShouldOptimizeMeshes(_shouldOptimizeMeshes);
+        _baker = std::unique_ptr<Baker> { fbxBaker };
         _baker->moveToThread(qApp->getNextWorkerThread());
     } else if (isSupportedImage) {
         _baker = std::unique_ptr<Baker> { new TextureBaker(inputUrl, image::TextureUsage::CUBE_TEXTURE, outputPath) };
@@ -80,6 +84,19 @@ void BakerCLI::handleFinishedBaker() {
             errorFile.write(_baker->getErrors().join('\n').toUtf8());
             errorFile.close();
         }
+    } else {
+        // let whoever ran the bake know where the time went
+        QJsonObject timings;
+        auto stageTimings = _baker->getStageTimings();
+        for (auto it = stageTimings.begin(); it != stageTimings.end(); ++it) {
+            timings[it.key()] = (double)it.value();
+        }
+
+        QFile timingsFile { _outputPath.absoluteFilePath(OVEN_TIMINGS_FILENAME) };
+        if (timingsFile.open(QFile::WriteOnly)) {
+            timingsFile.write(QJsonDocument(timings).toJson());
+            timingsFile.close();
+        }
     }
     QApplication::exit(exitCode);
 }
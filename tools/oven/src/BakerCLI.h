@@ -25,6 +25,7 @@ static const int OVEN_STATUS_CODE_FAIL { 1 };
 static const int OVEN_STATUS_CODE_ABORT { 2 };
 
 static const QString OVEN_ERROR_FILENAME = "errors.txt";
+static const QString OVEN_TIMINGS_FILENAME = "timings.json";
 
 class BakerCLI : public QObject {
     Q_OBJECT   
@@ -32,6 +33,7 @@ class BakerCLI : public QObject {
 public:
     BakerCLI(Oven* parent);
     void bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type = QString::null);
+    void setShouldOptimizeMeshes(bool shouldOptimizeMeshes) { _shouldOptimizeMeshes = shouldOptimizeMeshes; }
 
 private slots:
     void handleFinishedBaker();  
@@ -39,6 +41,7 @@ private slots:
 private:
     QDir _outputPath;
     std::unique_ptr<Baker> _baker;
+    bool _shouldOptimizeMeshes { false };
 };
 
 #endif // hifi_BakerCLI_h
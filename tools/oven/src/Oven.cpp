@@ -24,6 +24,7 @@ static const QString OUTPUT_FOLDER = "/Users/birarda/code/hifi/lod/test-oven/exp
 static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
 static const QString CLI_TYPE_PARAMETER = "t";
+static const QString CLI_OPTIMIZE_MESHES_PARAMETER = "optimize-meshes";
 
 Oven::Oven(int argc, char* argv[]) :
     QApplication(argc, argv)
@@ -34,7 +35,9 @@ Oven::Oven(int argc, char* argv[]) :
     parser.addOptions({
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
         { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
-        { CLI_TYPE_PARAMETER, "Type of asset.", "type" }
+        { CLI_TYPE_PARAMETER, "Type of asset.", "type" },
+        { CLI_OPTIMIZE_MESHES_PARAMETER, "Reorder the triangles of baked models for the vertex cache and overdraw "
+            "(compresses less)." }
     });
     parser.addHelpOption();
     parser.process(*this);
@@ -55,6 +58,7 @@ Oven::Oven(int argc, char* argv[]) :
             QUrl inputUrl(QDir::fromNativeSeparators(parser.value(CLI_INPUT_PARAMETER)));
             QUrl outputUrl(QDir::fromNativeSeparators(parser.value(CLI_OUTPUT_PARAMETER)));
             QString type = parser.isSet(CLI_TYPE_PARAMETER) ? parser.value(CLI_TYPE_PARAMETER) : QString::null;
+            cli->setShouldOptimizeMeshes(parser.isSet(CLI_OPTIMIZE_MESHES_PARAMETER));
             cli->bakeFile(inputUrl, outputUrl.toString(), type);
         } else {
             parser.showHelp();